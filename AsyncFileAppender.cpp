@@ -0,0 +1,209 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <sys/time.h>
+#include <sched.h>
+#include <boost/format.hpp>
+
+#include "exceptions.hpp"
+#include "AsyncFileAppender.hpp"
+
+// How long the background thread sleeps when the buffer is empty.
+static long const IDLE_SLEEP_NSEC(1000000);
+
+static double current_time()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec * 1e-6;
+}
+
+static void sleep_idle()
+{
+    struct timespec ts = { 0, IDLE_SLEEP_NSEC };
+    nanosleep(&ts, NULL);
+}
+
+static std::size_t copy_truncated(char* dst, std::size_t size, std::size_t offset, char const* src)
+{
+    std::size_t const len(std::min(std::strlen(src), size - 1 - offset));
+    std::memcpy(dst + offset, src, len);
+    return offset + len;
+}
+
+AsyncFileAppender::AsyncFileAppender(std::string const& filename,
+                                     std::size_t capacity,
+                                     enum Logger::level blocking_level)
+    : filename_(filename), file_(std::fopen(filename.c_str(), "a")),
+      blocking_level_(blocking_level), mask_(1), slots_(0),
+      stopping_(false), dropped_(0), reported_dropped_(0),
+      enqueue_pos_(0), dequeue_pos_(0)
+{
+    if (!file_)
+    {
+        throw illegal_argument((boost::format("cannot open log file %s") % filename).str());
+    }
+
+    while (mask_ + 1 < capacity)
+    {
+        mask_ = (mask_ << 1) | 1;
+    }
+
+    slots_ = new slot[mask_ + 1];
+    for (std::size_t i(0); i <= mask_; ++i)
+    {
+        slots_[i].sequence = i;
+    }
+
+    if (pthread_create(&thread_, NULL, &AsyncFileAppender::thread_main, this))
+    {
+        delete[] slots_;
+        std::fclose(file_);
+        throw illegal_state("cannot start the log writer thread");
+    }
+}
+
+AsyncFileAppender::~AsyncFileAppender()
+{
+    stopping_ = true;
+    __sync_synchronize();
+    pthread_join(thread_, NULL);
+    delete[] slots_;
+    std::fclose(file_);
+}
+
+void AsyncFileAppender::operator()(enum Logger::level lv, char const* name, char const** chunks)
+{
+    while (!try_push(lv, name, chunks))
+    {
+        if (lv < blocking_level_)
+        {
+            __sync_fetch_and_add(&dropped_, 1);
+            return;
+        }
+        sched_yield();
+    }
+}
+
+void AsyncFileAppender::flush()
+{
+    std::size_t const target(enqueue_pos_);
+    __sync_synchronize();
+    while (static_cast<long>(dequeue_pos_ - target) < 0)
+    {
+        sleep_idle();
+    }
+    std::fflush(file_);
+}
+
+// Claims the slot at enqueue_pos_ (D. Vyukov's bounded queue): a slot is
+// free for position pos when its sequence equals pos, and holds a record
+// for the consumer when its sequence equals pos + 1.
+bool AsyncFileAppender::try_push(enum Logger::level lv, char const* name, char const** chunks)
+{
+    std::size_t pos(enqueue_pos_);
+    slot* s;
+    for (;;)
+    {
+        s = &slots_[pos & mask_];
+        std::size_t const seq(s->sequence);
+        __sync_synchronize();
+        long const diff(static_cast<long>(seq - pos));
+        if (diff == 0)
+        {
+            std::size_t const prev(
+                __sync_val_compare_and_swap(&enqueue_pos_, pos, pos + 1));
+            if (prev == pos)
+                break;
+            pos = prev;
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = enqueue_pos_;
+        }
+    }
+
+    s->time = current_time();
+    s->level = lv;
+    s->name[copy_truncated(s->name, NAME_SIZE, 0, name)] = '\0';
+    std::size_t len(0);
+    for (char const** p = chunks; *p; ++p)
+        len = copy_truncated(s->message, MESSAGE_SIZE, len, *p);
+    s->message[len] = '\0';
+
+    __sync_synchronize();
+    s->sequence = pos + 1;
+    return true;
+}
+
+bool AsyncFileAppender::pop_and_write()
+{
+    std::size_t const pos(dequeue_pos_);
+    slot& s(slots_[pos & mask_]);
+    if (s.sequence != pos + 1)
+        return false;
+    __sync_synchronize();
+
+    std::fprintf(file_, "%.6f %s: %-8s %s\n", s.time, s.name,
+                 Logger::stringize_error_level(s.level), s.message);
+
+    __sync_synchronize();
+    s.sequence = pos + mask_ + 1;
+    dequeue_pos_ = pos + 1;
+    return true;
+}
+
+void AsyncFileAppender::write_dropped()
+{
+    unsigned long const dropped(dropped_);
+    if (dropped != reported_dropped_)
+    {
+        std::fprintf(file_, "%.6f %lu log records dropped\n",
+                     current_time(), dropped - reported_dropped_);
+        reported_dropped_ = dropped;
+    }
+}
+
+void AsyncFileAppender::run()
+{
+    bool written(false);
+    for (;;)
+    {
+        while (pop_and_write())
+        {
+            written = true;
+        }
+        write_dropped();
+
+        // Drain once more in case records were pushed after the buffer
+        // was found empty.
+        __sync_synchronize();
+        if (stopping_)
+        {
+            while (pop_and_write());
+            write_dropped();
+            break;
+        }
+
+        if (written)
+        {
+            std::fflush(file_);
+            written = false;
+        }
+        sleep_idle();
+    }
+}
+
+void* AsyncFileAppender::thread_main(void* self)
+{
+    static_cast<AsyncFileAppender*>(self)->run();
+    return NULL;
+}
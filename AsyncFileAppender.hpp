@@ -0,0 +1,102 @@
+#ifndef ASYNC_FILE_APPENDER_HPP
+#define ASYNC_FILE_APPENDER_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <pthread.h>
+#include <boost/noncopyable.hpp>
+
+#include "Logger.hpp"
+
+// A log appender that never waits for the file system.
+//
+// operator() copies the record (level, time stamp, logger name and the
+// message formatted by Logger::logv) into a fixed-size slot of a lock-free
+// ring buffer and returns; a background thread drains the buffer into the
+// file.  The memory used is bounded by capacity slots allocated up front.
+// When the buffer is full a record is dropped and counted, unless its level
+// is at least blocking_level, in which case the caller waits for a free
+// slot.  The number of dropped records is written to the file whenever it
+// changes, so gaps in a trace are visible.
+class AsyncFileAppender: public LogAppender, boost::noncopyable
+{
+public:
+    typedef LogAppender base_type;
+
+    enum
+    {
+        NAME_SIZE = 32,     // bytes kept of the logger name
+        MESSAGE_SIZE = 216  // bytes kept of the message
+    };
+
+public:
+    // capacity is rounded up to a power of two.
+    AsyncFileAppender(std::string const& filename,
+                      std::size_t capacity = 16384,
+                      enum Logger::level blocking_level = Logger::L_ERROR);
+
+    virtual ~AsyncFileAppender();
+
+    // Waits until the records appended so far have been written and flushes
+    // the file.
+    virtual void flush();
+
+    virtual void operator()(enum Logger::level lv, char const* name, char const** chunks);
+
+    std::size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+
+    unsigned long dropped() const
+    {
+        return dropped_;
+    }
+
+    std::string const& filename() const
+    {
+        return filename_;
+    }
+
+private:
+    struct slot
+    {
+        std::size_t volatile sequence;
+        double time;
+        enum Logger::level level;
+        char name[NAME_SIZE];
+        char message[MESSAGE_SIZE];
+    };
+
+    bool try_push(enum Logger::level lv, char const* name, char const** chunks);
+
+    bool pop_and_write();
+
+    void write_dropped();
+
+    void run();
+
+    static void* thread_main(void* self);
+
+private:
+    std::string const filename_;
+    std::FILE* file_;
+    enum Logger::level const blocking_level_;
+    std::size_t mask_;
+    slot* slots_;
+    pthread_t thread_;
+    bool volatile stopping_;
+    unsigned long volatile dropped_;
+    unsigned long reported_dropped_;
+    // Producers claim slots at enqueue_pos_; the background thread is the
+    // only consumer and advances dequeue_pos_.  Kept on separate cache
+    // lines so that producers and the consumer do not contend.
+    char pad0_[64];
+    std::size_t volatile enqueue_pos_;
+    char pad1_[64];
+    std::size_t volatile dequeue_pos_;
+    char pad2_[64];
+};
+
+#endif /* ASYNC_FILE_APPENDER_HPP */
@@ -0,0 +1,192 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <boost/array.hpp>
+
+#include "utils/mutex.hpp"
+#include "freeFunctions.hpp"
+#include "BDTable.hpp"
+
+namespace {
+
+// (dimension, sigma, t, D, v)
+typedef boost::array<Real, 5> key_type;
+typedef std::map<key_type, boost::shared_ptr<BDTable> > cache_type;
+
+// The number of parameter sets kept; the cache is emptied when it is full.
+std::size_t const MAX_CACHE_SIZE(256);
+
+// Nodes per sqrt(2 D t).
+Real const NODES_PER_LENGTH(16.);
+
+mutex cache_mutex = MUTEX_INITIALIZER;
+cache_type cache;
+
+} // namespace
+
+BDTable::BDTable(unsigned int dimension, Real sigma, Real t, Real D, Real v)
+    : dimension_(dimension), sigma_(sigma), t_(t), D_(D), v_(v),
+      I_(dimension == 3 ? ::I_bd_3D(sigma, t, D): ::I_bd_1D(sigma, t, D, v))
+{
+}
+
+Real BDTable::I_r(Real r) const
+{
+    return dimension_ == 3 ? I_bd_r_3D(r, sigma_, t_, D_):
+                             I_bd_r_1D(r, sigma_, t_, D_, v_);
+}
+
+Real BDTable::g(Real r) const
+{
+    return dimension_ == 3 ? g_bd_3D(r, sigma_, t_, D_):
+                             g_bd_1D(r, sigma_, t_, D_, v_);
+}
+
+// The nodes cover the same range as the brackets of the root searches in
+// drawR_gbd_3D and drawR_gbd_1D, but stop where I_bd_r has reached I_bd.
+void BDTable::tabulate()
+{
+    r_.push_back(sigma_);
+    I_r_.push_back(0.);
+    if (!(I_ > 0.))
+    {
+        return;
+    }
+
+    const Real h(std::sqrt(2.0 * D_ * t_) / NODES_PER_LENGTH);
+    const Real high(dimension_ == 3 ? sigma_ + 10.0 * std::sqrt(6.0 * D_ * t_):
+                                      sigma_ + 100.0 * std::sqrt(2.0 * D_ * t_));
+    const Real I_max(I_ * (1.0 - 1e-14));
+    for (unsigned int i(1); r_.back() < high && I_r_.back() < I_max; ++i)
+    {
+        const Real r(std::min(sigma_ + i * h, high));
+        r_.push_back(r);
+        // I_bd_r is increasing; do not let rounding errors break that.
+        I_r_.push_back(std::max(I_r(r), I_r_.back()));
+    }
+}
+
+Real BDTable::drawR(Real rnd) const
+{
+    const Real target(rnd * I_);
+    if (!(target > 0.))
+    {
+        return r_.front();
+    }
+
+    const std::size_t i(std::upper_bound(I_r_.begin(), I_r_.end(), target)
+                        - I_r_.begin());
+    if (i == I_r_.size())
+    {
+        // beyond the tabulated range; the root searches would end at the
+        // upper end of their bracket too.
+        return r_.back();
+    }
+
+    // Newton's method, starting from linear interpolation and falling back
+    // to bisection whenever a step leaves the bracket [low, high].
+    Real low(r_[i - 1]);
+    Real high(r_[i]);
+    Real r(low + (high - low) * (target - I_r_[i - 1]) / (I_r_[i] - I_r_[i - 1]));
+
+    const unsigned int maxIter(50);
+    for (unsigned int j(0); j < maxIter; ++j)
+    {
+        const Real f(I_r(r) - target);
+        if (f < 0.)
+        {
+            low = r;
+        }
+        else
+        {
+            high = r;
+        }
+
+        const Real dfdr(g(r));
+        Real next(dfdr > 0. ? r - f / dfdr: 0.5 * (low + high));
+        if (!(next > low && next < high))
+        {
+            next = 0.5 * (low + high);
+        }
+
+        // the tolerances of the root searches in freeFunctions.cpp.
+        if (std::fabs(next - r) <= 1e-18 + 1e-12 * next ||
+            high - low <= 1e-18 + 1e-12 * low)
+        {
+            return next;
+        }
+        r = next;
+    }
+
+    return r;
+}
+
+boost::shared_ptr<BDTable> BDTable::get(unsigned int dimension, Real sigma,
+                                        Real t, Real D, Real v,
+                                        bool tabulate)
+{
+    const key_type key = {{ static_cast<Real>(dimension), sigma, t, D, v }};
+
+    scoped_lock lock(cache_mutex);
+    cache_type::iterator i(cache.find(key));
+    if (i == cache.end())
+    {
+        if (cache.size() >= MAX_CACHE_SIZE)
+        {
+            cache.clear();
+        }
+        i = cache.insert(cache_type::value_type(key,
+            boost::shared_ptr<BDTable>(new BDTable(dimension, sigma, t, D, v)))).first;
+    }
+
+    // Tables are only modified here, with the lock held, and are never
+    // handed out for drawing before they are complete.
+    if (tabulate && !(*i).second->tabulated())
+    {
+        (*i).second->tabulate();
+    }
+    return (*i).second;
+}
+
+Real BDTable::I_bd_3D(Real sigma, Real t, Real D)
+{
+    return get(3, sigma, t, D, 0., false)->I();
+}
+
+Real BDTable::I_bd_1D(Real sigma, Real t, Real D, Real v)
+{
+    return get(1, sigma, t, D, v, false)->I();
+}
+
+Real BDTable::drawR_gbd_3D(Real rnd, Real sigma, Real t, Real D)
+{
+    return get(3, sigma, t, D, 0., true)->drawR(rnd);
+}
+
+Real BDTable::drawR_gbd_1D(Real rnd, Real sigma, Real t, Real D, Real v)
+{
+    return get(1, sigma, t, D, v, true)->drawR(rnd);
+}
+
+void BDTable::clear()
+{
+    scoped_lock lock(cache_mutex);
+    cache.clear();
+}
+
+std::size_t BDTable::memory_usage()
+{
+    scoped_lock lock(cache_mutex);
+    std::size_t retval(0);
+    for (cache_type::const_iterator i(cache.begin()); i != cache.end(); ++i)
+    {
+        retval += sizeof(cache_type::value_type) + sizeof(BDTable) +
+                  ((*i).second->r_.capacity() + (*i).second->I_r_.capacity()) *
+                  sizeof(Real);
+    }
+    return retval;
+}
@@ -0,0 +1,72 @@
+#ifndef BD_TABLE_HPP
+#define BD_TABLE_HPP
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "Defs.hpp"
+
+// Cached versions of the BD acceptance integrals I_bd_3D / I_bd_1D and of
+// drawR_gbd_3D / drawR_gbd_1D (see freeFunctions.hpp).
+//
+// Within a BD run sigma, t and D (and v) take only a few distinct values,
+// one set per species pair and time step.  For every set the integral is
+// computed once, and on the first draw the cumulative integral I_bd_r is
+// tabulated, so that a draw is a table lookup followed by a few Newton
+// steps inside the bracketing table interval instead of a root search over
+// the whole range.
+class BDTable
+{
+public:
+    static Real I_bd_3D(Real sigma, Real t, Real D);
+
+    static Real I_bd_1D(Real sigma, Real t, Real D, Real v);
+
+    static Real drawR_gbd_3D(Real rnd, Real sigma, Real t, Real D);
+
+    static Real drawR_gbd_1D(Real rnd, Real sigma, Real t, Real D, Real v);
+
+    // Forgets all cached values.
+    static void clear();
+
+    // Bytes taken by the cached tables.
+    static std::size_t memory_usage();
+
+    BDTable(unsigned int dimension, Real sigma, Real t, Real D, Real v);
+
+    Real I() const
+    {
+        return I_;
+    }
+
+    // Builds the table of I_bd_r; must be called before drawR().
+    void tabulate();
+
+    bool tabulated() const
+    {
+        return !r_.empty();
+    }
+
+    Real drawR(Real rnd) const;
+
+private:
+    Real I_r(Real r) const;
+
+    Real g(Real r) const;
+
+    static boost::shared_ptr<BDTable> get(unsigned int dimension, Real sigma,
+                                          Real t, Real D, Real v,
+                                          bool tabulate);
+
+private:
+    unsigned int const dimension_;
+    Real const sigma_;
+    Real const t_;
+    Real const D_;
+    Real const v_;
+    Real const I_;
+    std::vector<Real> r_;       // nodes
+    std::vector<Real> I_r_;     // I_bd_r at the nodes, increasing
+};
+
+#endif /* BD_TABLE_HPP */
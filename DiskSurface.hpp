@@ -5,6 +5,7 @@
 #include "Surface.hpp"
 #include "Disk.hpp"
 #include "freeFunctions.hpp"
+#include "BDTable.hpp"
 #include "StructureFunctions.hpp"
 #include "geometry.hpp"
 
@@ -293,179 +294,6 @@ public:
         return (cylinder_radius + radius) * traits_type::MINIMAL_SEPARATION_FACTOR - cylinder_radius;
     }
 */
-    /*** Boundary condition handling ***/
-    // FIXME This is a mess but it works. See ParticleContainerBase.hpp for explanation.
-    virtual position_structid_pair_type apply_boundary(position_structid_pair_type const& pos_struct_id,
-                                                       structure_container_type const& structure_container) const
-    {
-        return pos_struct_id;   // This seems a little strange, but we assume that particles are immobile on the disk
-    }
-
-    virtual position_structid_pair_type cyclic_transpose(position_structid_pair_type const& pos_struct_id,
-                                                         structure_container_type const& structure_container) const
-    {
-        return pos_struct_id;   // Disks can also not be connected, so no cyclic transpose.
-    }
-
-
-    // *** Dynamic dispatch for the structure functions *** //
-    // *** 1 *** - One new position
-    // This requires a double dynamic dispatch.
-    // First dispatch
-    virtual position_structid_pair_type get_pos_sid_pair(structure_type const& target_structure, position_type const& position,
-                                                         length_type const& offset, length_type const& reaction_length, rng_type& rng) const
-    {
-        return target_structure.get_pos_sid_pair_helper(*this, position, offset, reaction_length, rng);
-    }
-    // Second dispatch
-    virtual position_structid_pair_type get_pos_sid_pair_helper(CuboidalRegion<traits_type> const& origin_structure, position_type const& position,
-                                                        length_type const& offset, length_type const& rl, rng_type& rng) const
-    {
-        return this->get_pos_sid_pair_helper_any<CuboidalRegion<traits_type> >(origin_structure, position, offset, rl, rng);
-    }
-    virtual position_structid_pair_type get_pos_sid_pair_helper(SphericalSurface<traits_type> const& origin_structure, position_type const& position,
-                                                        length_type const& offset, length_type const& rl, rng_type& rng) const
-    {
-        return this->get_pos_sid_pair_helper_any<SphericalSurface<traits_type> >(origin_structure, position, offset, rl, rng);
-    }
-    virtual position_structid_pair_type get_pos_sid_pair_helper(CylindricalSurface<traits_type> const& origin_structure, position_type const& position,
-                                                        length_type const& offset, length_type const& rl, rng_type& rng) const
-    {
-        return this->get_pos_sid_pair_helper_any<CylindricalSurface<traits_type> >(origin_structure, position, offset, rl, rng);
-    }
-    virtual position_structid_pair_type get_pos_sid_pair_helper(DiskSurface<traits_type> const& origin_structure, position_type const& position,
-                                                        length_type const& offset, length_type const& rl, rng_type& rng) const
-    {
-        return this->get_pos_sid_pair_helper_any<DiskSurface<traits_type> >(origin_structure, position, offset, rl, rng);
-    }
-    virtual position_structid_pair_type get_pos_sid_pair_helper(PlanarSurface<traits_type> const& origin_structure, position_type const& position,
-                                                        length_type const& offset, length_type const& rl, rng_type& rng) const
-    {
-        return this->get_pos_sid_pair_helper_any<PlanarSurface<traits_type> >(origin_structure, position, offset, rl, rng);
-    }
-    // The template function that defines the actual final dispatch procedure.
-    template<typename Tstruct_>
-    position_structid_pair_type get_pos_sid_pair_helper_any(Tstruct_ const& origin_structure, position_type const& position,
-                                                            length_type const& offset, length_type const& rl, rng_type& rng) const
-    {
-        // redirect to structure function with well-defined typing
-        return ::get_pos_sid_pair<traits_type>(origin_structure, *this, position, offset, rl, rng); 
-    };
-                                                        
-    // *** 2 *** - Two new positions
-    // Same principle as above, but different return type
-    // First dispatch
-    virtual position_structid_pair_pair_type get_pos_sid_pair_pair(structure_type const& target_structure, position_type const& position,
-                                                                   species_type const& s1, species_type const& s2, length_type const& reaction_length, rng_type& rng) const
-    {
-        return target_structure.get_pos_sid_pair_pair_helper(*this, position, s1, s2, reaction_length, rng);
-    }
-    // Second dispatch
-    virtual position_structid_pair_pair_type get_pos_sid_pair_pair_helper(CuboidalRegion<traits_type> const& origin_structure, position_type const& position,
-                                                                          species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const
-    {
-        return this->get_pos_sid_pair_pair_helper_any<CuboidalRegion<traits_type> >(origin_structure, position, s_orig, s_targ, rl, rng);
-    }
-    virtual position_structid_pair_pair_type get_pos_sid_pair_pair_helper(SphericalSurface<traits_type> const& origin_structure, position_type const& position,
-                                                                          species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const
-    {
-        return this->get_pos_sid_pair_pair_helper_any<SphericalSurface<traits_type> >(origin_structure, position, s_orig, s_targ, rl, rng);
-    }
-    virtual position_structid_pair_pair_type get_pos_sid_pair_pair_helper(CylindricalSurface<traits_type> const& origin_structure, position_type const& position,
-                                                                          species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const
-    {
-        return this->get_pos_sid_pair_pair_helper_any<CylindricalSurface<traits_type> >(origin_structure, position, s_orig, s_targ, rl, rng);
-    }
-    virtual position_structid_pair_pair_type get_pos_sid_pair_pair_helper(DiskSurface<traits_type> const& origin_structure, position_type const& position,
-                                                                          species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const
-    {
-        return this->get_pos_sid_pair_pair_helper_any<DiskSurface<traits_type> >(origin_structure, position, s_orig, s_targ, rl, rng);
-    }
-    virtual position_structid_pair_pair_type get_pos_sid_pair_pair_helper(PlanarSurface<traits_type> const& origin_structure, position_type const& position,
-                                                                          species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const
-    {
-        return this->get_pos_sid_pair_pair_helper_any<PlanarSurface<traits_type> >(origin_structure, position, s_orig, s_targ, rl, rng);
-    }
-    // The template function that defines the actual final dispatch procedure.
-    template<typename Tstruct_>
-    position_structid_pair_pair_type get_pos_sid_pair_pair_helper_any(Tstruct_ const& origin_structure, position_type const& position,
-                                                                      species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const
-    {
-        // redirect to structure function with well-defined typing
-        return ::get_pos_sid_pair_pair<traits_type>(origin_structure, *this, position, s_orig, s_targ, rl, rng); 
-    };
-    
-    // *** 3 *** - Pair reactions => two origin structures
-    // First dispatch
-//     // Overloading get_pos_sid_pair with signature (origin_structure2, target_structure_type_id, ...)
-//    virtual position_structid_pair_type get_pos_sid_pair(structure_type const& origin_structure2, structure_type_id_type const& target_sid, position_type const& CoM,
-//                                                         length_type const& offset, length_type const& reaction_length, rng_type& rng) const
-//     {   
-//         // this just redirects
-//         return this->get_pos_sid_pair_2o(origin_structure2, target_sid, CoM, offset, reaction_length, rng);                            
-//     }
-//     // The actual implementation of the first dispatch
-    virtual position_structid_pair_type get_pos_sid_pair_2o(structure_type const& origin_structure2, structure_type_id_type const& target_sid,
-                                                         position_type const& CoM, length_type const& offset, length_type const& reaction_length, rng_type& rng) const
-    {
-        return origin_structure2.get_pos_sid_pair_2o_helper(*this, target_sid, CoM, offset, reaction_length, rng);
-    }
-    // Second dispatch
-    virtual position_structid_pair_type get_pos_sid_pair_2o_helper(CuboidalRegion<traits_type> const& origin_structure1, structure_type_id_type const& target_sid,
-                                                                            position_type const& CoM, length_type const& offset, length_type const& rl, rng_type& rng) const
-    {                          
-        return this->get_pos_sid_pair_2o_helper_any<CuboidalRegion<traits_type> >(origin_structure1, target_sid, CoM, offset, rl, rng);
-    }
-    virtual position_structid_pair_type get_pos_sid_pair_2o_helper(SphericalSurface<traits_type> const& origin_structure1, structure_type_id_type const& target_sid,
-                                                                            position_type const& CoM, length_type const& offset, length_type const& rl, rng_type& rng) const
-    {                          
-        return this->get_pos_sid_pair_2o_helper_any<SphericalSurface<traits_type> >(origin_structure1, target_sid, CoM, offset, rl, rng);
-    }
-    virtual position_structid_pair_type get_pos_sid_pair_2o_helper(CylindricalSurface<traits_type> const& origin_structure1, structure_type_id_type const& target_sid,
-                                                                            position_type const& CoM, length_type const& offset, length_type const& rl, rng_type& rng) const
-    {                          
-        return this->get_pos_sid_pair_2o_helper_any<CylindricalSurface<traits_type> >(origin_structure1, target_sid, CoM, offset, rl, rng);
-    }
-    virtual position_structid_pair_type get_pos_sid_pair_2o_helper(DiskSurface<traits_type> const& origin_structure1, structure_type_id_type const& target_sid,
-                                                                            position_type const& CoM, length_type const& offset, length_type const& rl, rng_type& rng) const
-    {                          
-        return this->get_pos_sid_pair_2o_helper_any<DiskSurface<traits_type> >(origin_structure1, target_sid, CoM, offset, rl, rng);
-    }
-    virtual position_structid_pair_type get_pos_sid_pair_2o_helper(PlanarSurface<traits_type> const& origin_structure1, structure_type_id_type const& target_sid,
-                                                                            position_type const& CoM, length_type const& offset, length_type const& rl, rng_type& rng) const
-    {                          
-        return this->get_pos_sid_pair_2o_helper_any<PlanarSurface<traits_type> >(origin_structure1, target_sid, CoM, offset, rl, rng);
-    }    
-    // The template function that defines the actual final dispatch procedure.
-    template<typename Tstruct_>
-    position_structid_pair_type get_pos_sid_pair_2o_helper_any(Tstruct_ const& origin_structure1, structure_type_id_type const& target_sid, position_type const& CoM,
-                                                                        length_type const& offset, length_type const& reaction_length, rng_type& rng) const
-    {
-        // This method has to figure out where the product will be placed in case of a bimolecular reaction.
-        // As a default, we place particles on the substructure or the lower-dimensional structure. If the structures
-        // have the same structure type (=> same dimensionality) it does not matter on which structure we put the product,
-        // as long as it has the structure type id of the product species. This is handled in cases '1' below.
-        
-        // 1 - Check whether one of the structures is the parent of the other. If yes, the daughter structure is the target.
-        if( this->is_parent_of_or_has_same_sid_as(origin_structure1) && origin_structure1.has_valid_target_sid(target_sid) )
-            // origin_structure1 is target
-            return ::get_pos_sid_pair<traits_type>(*this, origin_structure1, CoM, offset, reaction_length, rng);
-            
-        else if( origin_structure1.is_parent_of_or_has_same_sid_as(*this) && this->has_valid_target_sid(target_sid) )
-            // this structure is target
-            return ::get_pos_sid_pair<traits_type>(origin_structure1, *this, CoM, offset, reaction_length, rng);
-        
-        // 2 - Check which structures has the lower dimensionality / particle degrees of freedom, and put the product there.
-        else if( origin_structure1.shape().dof() < this->shape().dof() && origin_structure1.has_valid_target_sid(target_sid) )
-            // origin_structure1 is target
-            return ::get_pos_sid_pair<traits_type>(*this, origin_structure1, CoM, offset, reaction_length, rng);
-        
-        else if( this->shape().dof() < origin_structure1.shape().dof() && this->has_valid_target_sid(target_sid) )
-            // this structure is target
-            return ::get_pos_sid_pair<traits_type>(origin_structure1, *this, CoM, offset, reaction_length, rng);
-        
-        else throw propagation_error("Invalid target structure type: does not match product species structure type or has wrong hierarchy or dimensionality.");
-    }
     
 //     // *** 4 *** - Generalized functions for pair reactions with two origin structures and one target structure
 //     // NOTE: This is yet unused, but possibly useful in the future.
@@ -483,7 +311,7 @@ public:
     virtual length_type drawR_gbd(Real const& rnd, length_type const& r01, Real const& dt, Real const& D01, Real const& v) const
     {
          // TODO: This is part of the old BD scheme and should be removed at some point
-        return drawR_gbd_1D(rnd, r01, dt, D01, v);
+        return BDTable::drawR_gbd_1D(rnd, r01, dt, D01, v);
     }
     // DEPRECATED
     virtual Real p_acceptance(Real const& k_a, Real const& dt, length_type const& r01, position_type const& ipv, 
@@ -510,7 +338,7 @@ public:
             Also change v -> -v in drawR for the dissociation move.
         */
 
-        return 0.5*( k_a * dt / ( I_bd_1D(r01, dt, D0, v0) + I_bd_1D(r01, dt, D1, v1) ) );
+        return 0.5*( k_a * dt / ( BDTable::I_bd_1D(r01, dt, D0, v0) + BDTable::I_bd_1D(r01, dt, D1, v1) ) );
   
     }
     // DEPRECATED
@@ -532,7 +360,10 @@ public:
     }
         
     DiskSurface(structure_name_type const& name, structure_type_id_type const& sid, structure_id_type const& parent_struct_id, shape_type const& shape)
-        : base_type(name, sid, parent_struct_id, shape), IS_BARRIER(true), RADIAL_DISSOCIATION(true) {}
+        : base_type(name, sid, parent_struct_id, shape), IS_BARRIER(true), RADIAL_DISSOCIATION(true)
+    {
+        this->kind_ = DISK_SURFACE;
+    }
 };
 
 #endif /* DISK_SURFACE_HPP */
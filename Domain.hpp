@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
+#include "utils/pool_allocator.hpp"
 
 template<typename Ttraits_>
 class ImmutativeDomainVisitor;
@@ -16,8 +17,10 @@ class ImmutativeDomainVisitor;
 template<typename Ttraits_>
 class MutativeDomainVisitor;
 
+// Domains are created and destroyed at every step; they are allocated from
+// the object pools.
 template<typename Ttraits_>
-class Domain
+class Domain: public pooled_object
 {
 public:
     typedef Ttraits_ traits_type;
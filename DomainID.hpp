@@ -15,9 +15,9 @@
 #endif
 #include "Identifier.hpp"
 
-struct DomainID: public Identifier<DomainID, unsigned long long, int>
+struct DomainID: public Identifier<DomainID, identifier_serial_type, identifier_lot_type>
 {
-    typedef Identifier<DomainID, unsigned long long, int> base_type;
+    typedef Identifier<DomainID, identifier_serial_type, identifier_lot_type> base_type;
 
     DomainID(value_type const& value = value_type(0, 0))
         : base_type(value) {}
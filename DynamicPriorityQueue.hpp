@@ -35,7 +35,9 @@
 #include <iostream>
 #endif
 
+#include "utils/memory_usage.hpp"
 #include "utils/swap.hpp"
+#include "utils/tracking_allocator.hpp"
 
 template<typename Tid_>
 struct default_id_generator
@@ -116,6 +118,11 @@ public:
         index_map_.clear();
     }
 
+    memory_usage_type memory_usage() const
+    {
+        return node_memory_usage(index_map_);
+    }
+
 private:
     index_map index_map_;
     identifier_generator idgen_;
@@ -141,6 +148,11 @@ public:
     void pop(index_type, identifier_type, identifier_type) {}
 
     void clear() {}
+
+    memory_usage_type memory_usage() const
+    {
+        return memory_usage_type(0, 0);
+    }
 };
 
 
@@ -169,8 +181,8 @@ public:
     typedef Tcomparator comparator_type;
 
 protected:
-    typedef std::vector<value_type> value_vector;
-    typedef std::vector<index_type> index_vector;
+    typedef typename tracked<MEMORY_SCHEDULER>::template vector<value_type>::type value_vector;
+    typedef typename tracked<MEMORY_SCHEDULER>::template vector<index_type>::type index_vector;
 
 public:
     typedef typename value_vector::size_type size_type;
@@ -190,6 +202,16 @@ public:
 
     void clear();
 
+    // Bytes used by the items, the heap and the index of the identifiers.
+    memory_usage_type memory_usage() const
+    {
+        memory_usage_type retval(policy_type::memory_usage());
+        add_memory_usage(retval, vector_memory_usage(items_));
+        add_memory_usage(retval, vector_memory_usage(heap_));
+        add_memory_usage(retval, vector_memory_usage(position_vector_));
+        return retval;
+    }
+
     value_type const& top() const
     {
         return items_[top_index()];
@@ -219,6 +241,12 @@ public:
 
     identifier_type push(element_type const& item);
 
+    // Pushes all items of [first, last) and writes their identifiers to
+    // ids.  Large batches are appended as a whole and the heap is rebuilt
+    // once, instead of sifting every item up on its own.
+    template<typename Titer_, typename Toiter_>
+    Toiter_ push(Titer_ first, Titer_ last, Toiter_ ids);
+
     element_type const& operator[](identifier_type id) const
     {
         return get(id);
@@ -458,6 +486,50 @@ DynamicPriorityQueue<Titem_, Tcomparator_, Tpolicy_>::push(Titem_ const& item)
 }
 
 
+template<typename Titem_, typename Tcomparator_, typename Tpolicy_>
+template<typename Titer_, typename Toiter_>
+inline Toiter_
+DynamicPriorityQueue<Titem_, Tcomparator_, Tpolicy_>::push(Titer_ first, Titer_ last, Toiter_ ids)
+{
+    const index_type first_index(items_.size());
+    for (; first != last; ++first)
+    {
+        const index_type index(items_.size());
+        const identifier_type id(policy_type::push(index));
+        items_.push_back(value_type(id, *first));
+        heap_.push_back(index);
+        position_vector_.push_back(index);
+        *ids = id;
+        ++ids;
+    }
+
+    const index_type count(items_.size() - first_index);
+    index_type depth(0);
+    for (index_type n(size()); n > 0; n >>= 1)
+    {
+        ++depth;
+    }
+
+    if (count * depth > size())
+    {
+        // rebuild the heap bottom-up.
+        for (index_type pos(size() / 2); pos > 0;)
+        {
+            --pos;
+            move_down_pos(pos);
+        }
+    }
+    else
+    {
+        for (index_type index(first_index); index < size(); ++index)
+        {
+            move_up_pos(position_vector_[index]);
+        }
+    }
+    return ids;
+}
+
+
 template<typename Titem_, typename Tcomparator_, typename Tpolicy_>
 inline void DynamicPriorityQueue<Titem_, Tcomparator_, Tpolicy_>::pop_by_index(index_type index)
 {
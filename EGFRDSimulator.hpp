@@ -2,6 +2,9 @@
 #define EGFRDSIMULATOR_HPP
 
 #include <boost/bind.hpp>
+#include <iterator>
+#include <set>
+#include <vector>
 #include <boost/array.hpp>
 #include <boost/format.hpp>
 #include <boost/optional.hpp>
@@ -17,6 +20,7 @@
 #include <boost/variant.hpp>
 #include "utils/array_helper.hpp"
 #include "utils/get_mapper_mf.hpp"
+#include "utils/pool_allocator.hpp"
 #include "utils/fun_composition.hpp"
 #include "utils/fun_wrappers.hpp"
 #include "utils/pointer_as_ref.hpp"
@@ -27,6 +31,7 @@
 #include "DomainID.hpp"
 #include "Shell.hpp"
 #include "EventScheduler.hpp"
+#include "Profiler.hpp"
 #include "PairGreensFunction.hpp"
 #include "ParticleSimulator.hpp"
 #include "MatrixSpace.hpp"
@@ -251,9 +256,9 @@ protected:
     typedef boost::fusion::map<
         boost::fusion::pair<spherical_shell_type, 
                             MatrixSpace<spherical_shell_type,
-                                        shell_id_type, get_mapper_mf>&>,
+                                        shell_id_type, get_pooled_mapper_mf>&>,
         boost::fusion::pair<cylindrical_shell_type, MatrixSpace<cylindrical_shell_type,
-                                        shell_id_type, get_mapper_mf>&> >
+                                        shell_id_type, get_pooled_mapper_mf>&> >
             shell_matrix_map_type;
     typedef typename boost::remove_reference<
         typename boost::fusion::result_of::value_at_key<
@@ -265,7 +270,7 @@ protected:
             shell_matrix_map_type,
             cylindrical_shell_type>::type>::type
                 cylindrical_shell_matrix_type;
-    typedef typename get_mapper_mf<domain_id_type, boost::shared_ptr<domain_type> >::type domain_map;
+    typedef typename get_pooled_mapper_mf<domain_id_type, boost::shared_ptr<domain_type> >::type domain_map;
     typedef typename network_rules_type::reaction_rules reaction_rules;
     typedef typename network_rules_type::reaction_rule_type reaction_rule_type;
     typedef typename traits_type::rate_type rate_type;
@@ -334,15 +339,12 @@ protected:
                       std::numeric_limits<length_type>::infinity()) {}
 
         template<typename Titer>
-        void operator()(Titer const& i, position_type const& off)
+        void operator()(Titer const& i, length_type const& distance)
         {
             domain_id_type const& did((*i).second.did());
             if (did == ignore)
                 return;
 
-            length_type const distance(
-                    world.distance(
-                        shape(offset((*i).second, off)), cmp.position()));
             if (distance > cmp.radius())
             {
                 if (distance < closest.second)
@@ -375,6 +377,83 @@ protected:
         bool operator()(domain_id_type const&) const { return true; }
     };
 
+    // Domain filters for stop().
+    struct all_domains_filter
+    {
+        bool operator()(domain_type const&) const { return true; }
+    };
+
+    struct species_filter
+    {
+        bool operator()(domain_type const& domain) const
+        {
+            bool retval(false);
+            domain.accept(visitor(sids, retval));
+            return retval;
+        }
+
+        species_filter(std::set<species_id_type> const& sids): sids(sids) {}
+
+        struct visitor: ImmutativeDomainVisitor<traits_type>
+        {
+            virtual ~visitor() {}
+
+            virtual void operator()(multi_type const& domain) const
+            {
+                BOOST_FOREACH (particle_id_pair const& pp,
+                               domain.get_particles_range())
+                {
+                    retval = retval || sids.count(pp.second.sid());
+                }
+            }
+
+            virtual void operator()(spherical_single_type const& domain) const
+            {
+                retval = sids.count(domain.particle().second.sid());
+            }
+
+            virtual void operator()(cylindrical_single_type const& domain) const
+            {
+                retval = sids.count(domain.particle().second.sid());
+            }
+
+            virtual void operator()(spherical_pair_type const& domain) const
+            {
+                retval = sids.count(domain.particles()[0].second.sid()) ||
+                         sids.count(domain.particles()[1].second.sid());
+            }
+
+            virtual void operator()(cylindrical_pair_type const& domain) const
+            {
+                retval = sids.count(domain.particles()[0].second.sid()) ||
+                         sids.count(domain.particles()[1].second.sid());
+            }
+
+            visitor(std::set<species_id_type> const& sids, bool& retval)
+                : sids(sids), retval(retval) {}
+
+            std::set<species_id_type> const& sids;
+            bool& retval;
+        };
+
+        std::set<species_id_type> const& sids;
+    };
+
+    struct region_filter
+    {
+        bool operator()(domain_type const& domain) const
+        {
+            return outer.distance(domain, region.position()) < region.radius();
+        }
+
+        region_filter(EGFRDSimulator const& outer,
+                      particle_shape_type const& region)
+            : outer(outer), region(region) {}
+
+        EGFRDSimulator const& outer;
+        particle_shape_type const& region;
+    };
+
     struct one_id_filter
     {
         bool operator()(domain_id_type const& did) const { return did != ignore; }
@@ -394,14 +473,12 @@ protected:
             : world(world), cmp(cmp), filter(filter) {}
 
         template<typename Titer>
-        void operator()(Titer const& i, position_type const& off)
-
+        void operator()(Titer const& i, length_type const& distance)
         {
             domain_id_type const& did((*i).second.did());
             if (!filter(did))
                 return;
 
-            length_type const distance(world.distance(shape(offset((*i).second, off)), cmp.position()));
             if (distance < cmp.radius())
             {
                 if (!neighbors.container())
@@ -435,13 +512,12 @@ protected:
                       std::numeric_limits<length_type>::infinity()) {}
 
         template<typename Titer>
-        void operator()(Titer const& i, position_type const& off)
+        void operator()(Titer const& i, length_type const& distance)
         {
             domain_id_type const& did((*i).second.did());
             if (contains(ignore, did))
                 return;
 
-            length_type const distance(world.distance(shape(offset((*i).second, off)), cmp));
             if (distance < closest.second)
             {
                 closest.first = did;
@@ -467,7 +543,7 @@ protected:
         template<typename T>
         void operator()(T const& smat) const
         {
-            world_type::traits_type::each_neighbor(smat.second, col_, pos_);
+            world_type::traits_type::each_neighbor_distance(smat.second, col_, pos_);
         }
 
     private:
@@ -475,6 +551,23 @@ protected:
         position_type pos_;
     };
 
+    struct neighborhood_signature_accumulator
+    {
+        neighborhood_signature_accumulator(unsigned long& signature,
+                                           position_type const& pos)
+            : signature_(signature), pos_(pos) {}
+
+        template<typename T>
+        void operator()(T const& smat) const
+        {
+            signature_ += smat.second.last_modified_around(smat.second.index(pos_));
+        }
+
+    private:
+        unsigned long& signature_;
+        position_type pos_;
+    };
+
     template<typename Tmap_>
     struct domain_shell_map_builder
     {
@@ -924,7 +1017,9 @@ public:
                                      cylindrical_shell_matrix_type&>(csmat_)),
           single_shell_factor_(.1),
           multi_shell_factor_(.05),
-          rejected_moves_(0), zero_step_count_(0), dirty_(true)
+          rejected_moves_(0), zero_step_count_(0), avoided_burst_count_(0),
+          full_check_interval_(100), checks_since_full_check_(0),
+          touched_domains_complete_(false), dirty_(true)
     {
         std::fill(domain_count_per_type_.begin(), domain_count_per_type_.end(), 0);
         std::fill(single_step_count_.begin(), single_step_count_.end(), 0);
@@ -952,6 +1047,7 @@ public:
         typedef typename traits_type::template shell_generator<Tshape>::type shell_type;
         std::pair<const shell_id_type, shell_type> const retval(shidgen_(), shell_type(did, shape));
         boost::fusion::at_key<shell_type>(smatm_).update(retval);
+        touch_domain(did);
         return retval;
     }
 
@@ -1014,6 +1110,11 @@ public:
         return single_step_count_[kind];
     }
 
+    unsigned int num_avoided_bursts() const
+    {
+        return avoided_burst_count_;
+    }
+
     int num_pair_steps_per_type(pair_event_kind kind) const
     {
         return pair_step_count_[kind];
@@ -1027,6 +1128,7 @@ public:
     std::vector<domain_id_type>*
     get_neighbor_domains(particle_shape_type const& p)
     {
+        PROFILE_SCOPE("EGFRDSimulator::get_neighbor_domains");
         typedef domain_collector<no_filter> collector_type;
         no_filter f;
         collector_type col((*base_type::world_), p, f);
@@ -1037,6 +1139,7 @@ public:
     std::vector<domain_id_type>*
     get_neighbor_domains(particle_shape_type const& p, domain_id_type const& ignore)
     {
+        PROFILE_SCOPE("EGFRDSimulator::get_neighbor_domains");
         typedef domain_collector<one_id_filter> collector_type;
         one_id_filter f(ignore);
         collector_type col((*base_type::world_), p, f);
@@ -1047,6 +1150,7 @@ public:
     virtual void initialize()
     {
         domains_.clear();
+        touched_domains_.clear();
         ssmat_.clear();
         csmat_.clear();
 
@@ -1067,46 +1171,25 @@ public:
     virtual bool step(time_type upto)
     {
         LOG_INFO(("stop at %.16g", upto));
+        return stop(upto, all_domains_filter());
+    }
 
-        if (upto <= base_type::t_)
-        {
-            return false;
-        }
-
-        if (upto >= scheduler_.top().second->time())
-        {
-            _step();
-            return true;
-        }
-
-        base_type::t_ = upto;
-
-        std::vector<domain_id_type> non_singles;
-
-        // first burst all Singles.
-        BOOST_FOREACH (event_id_pair_type const& event, scheduler_.events())
-        {
-            single_event const* single_ev(
-                    dynamic_cast<single_event const*>(event.second.get()));
-            if (single_ev)
-            {
-                burst(single_ev->domain());
-            }
-            else
-            {
-                domain_event_base const* domain_ev(
-                    dynamic_cast<domain_event_base const*>(event.second.get()));
-                BOOST_ASSERT(domain_ev);
-                non_singles.push_back(domain_ev->domain().id());
-            }
-        }
-
-        // then burst all Pairs and Multis.
-        burst_domains(non_singles);
-
-        base_type::dt_ = 0.;
+    // Like step(upto), but only the particles of the species in 'sids'
+    // are synchronized; the domains holding none of them are not bursted.
+    // Counting particles never requires this, since the species of a
+    // particle only changes at an event.
+    bool observe(time_type upto, std::set<species_id_type> const& sids)
+    {
+        LOG_INFO(("observe species at %.16g", upto));
+        return stop(upto, species_filter(sids));
+    }
 
-        return false;
+    // Like step(upto), but only the particles within 'region' are
+    // synchronized; only the domains whose shells reach into it are bursted.
+    bool observe(time_type upto, particle_shape_type const& region)
+    {
+        LOG_INFO(("observe region at %.16g", upto));
+        return stop(upto, region_filter(*this, region));
     }
 
     // {{{ clear_volume
@@ -1214,18 +1297,113 @@ public:
         return retval;
     }
 
+    // Like check(), but only for the domains touched since the last check:
+    // those that were scheduled or removed, or whose shells were created
+    // or moved (see touch_domain).  The work is proportional to the number
+    // of these, not to the size of the system.
+    bool check_touched() const
+    {
+        LOG_INFO(("checking %zu touched domains", touched_domains_.size()));
+
+        bool retval(true);
+
+        CHECK(base_type::t_ >= 0.0);
+        CHECK(base_type::dt_ >= 0.0);
+        CHECK(scheduler_.size() == domains_.size());
+
+        BOOST_FOREACH (domain_id_type const& did, touched_domains_)
+        {
+            typename domain_map::const_iterator i(domains_.find(did));
+            if (i == domains_.end())
+            {
+                // removed; its shells went with it.
+                continue;
+            }
+            domain_type const& domain(*(*i).second);
+
+            CHECK(check_domain(domain));
+            CHECK(check_domain_references(domain));
+
+            try
+            {
+                CHECK(scheduler_.get(domain.event().first) == domain.event().second);
+            }
+            catch (std::out_of_range const&)
+            {
+                LOG_WARNING(("domain %s is not scheduled", boost::lexical_cast<std::string>(did).c_str()));
+                retval = false;
+            }
+        }
+        return retval;
+    }
+
+    // Runs check_touched(), and the full check() instead every
+    // full_check_interval() times (never if 0), or whenever domains changed
+    // while they were not tracked (at the first call, and after steps that
+    // were not paranoiac); called at every step when paranoiac, unless
+    // built with NDEBUG.
+    bool check_incremental()
+    {
+        bool retval;
+        if (!touched_domains_complete_ ||
+            (full_check_interval_ != 0 &&
+             ++checks_since_full_check_ >= full_check_interval_))
+        {
+            checks_since_full_check_ = 0;
+            touched_domains_complete_ = true;
+            retval = check();
+        }
+        else
+        {
+            retval = check_touched();
+        }
+        touched_domains_.clear();
+        return retval;
+    }
+
+    unsigned int const& full_check_interval() const
+    {
+        return full_check_interval_;
+    }
+
+    unsigned int& full_check_interval()
+    {
+        return full_check_interval_;
+    }
+
 protected:
+    // Remembers that the domain changed, for check_touched().  The
+    // domains are only tracked when paranoiac (and not under NDEBUG, where
+    // the steps do not check them), otherwise the next check_incremental()
+    // is a full one.
+    void touch_domain(domain_id_type const& did)
+    {
+#ifndef NDEBUG
+        if (base_type::paranoiac_)
+        {
+            touched_domains_.insert(did);
+            return;
+        }
+#endif
+        touched_domains_complete_ = false;
+    }
+
     template<typename Tshell>
     void move_shell(std::pair<const shell_id_type, Tshell> const& shell)
     {
         typedef Tshell shell_type;
         boost::fusion::at_key<shell_type>(smatm_).update(shell);
+        touch_domain(shell.second.did());
     }
 
     template<typename T>
     void update_shell_matrix(AnalyticalSingle<traits_type, T> const& domain)
     {
+        // the single's own shell is not part of its neighborhood.
+        bool const fresh(is_neighborhood_cache_fresh(domain));
         move_shell(domain.shell());
+        if (fresh)
+            domain.neighborhood().signature = neighborhood_signature(domain.position());
     }
 
     template<typename T>
@@ -1298,6 +1476,7 @@ protected:
     {
         LOG_DEBUG(("remove_domain_but_shell: %s", boost::lexical_cast<std::string>(domain.id()).c_str()));
         event_id_type const event_id(domain.event().first);
+        touch_domain(domain.id());
 
         // domains_.erase(domain.id()); // this hits a bug in gcc 4.4 (at least)'s unordered_map.
         typename domain_map::iterator domain_to_be_removed(domains_.find(domain.id()));
@@ -1396,20 +1575,51 @@ protected:
         if (base_type::paranoiac_)
             BOOST_ASSERT(domains_.find(domain.id()) != domains_.end());
 
-        boost::shared_ptr<event_type> new_event(
-            new single_event(base_type::t_ + domain.dt(), domain, kind));
+        boost::shared_ptr<event_type> new_event(pooled_shared_ptr<event_type>(
+            new single_event(base_type::t_ + domain.dt(), domain, kind)));
         domain.event() = std::make_pair(scheduler_.add(new_event), new_event);
+        touch_domain(domain.id());
         LOG_DEBUG(("add_event: #%d - %s", domain.event().first, boost::lexical_cast<std::string>(domain).c_str()));
     }
 
+    // Same as add_event, but inserts the events of all the singles into the
+    // scheduler at once.
+    void add_events(std::vector<boost::shared_ptr<single_type> > const& domains,
+                    single_event_kind const& kind)
+    {
+        std::vector<boost::shared_ptr<event_type> > new_events;
+        new_events.reserve(domains.size());
+        BOOST_FOREACH (boost::shared_ptr<single_type> const& domain, domains)
+        {
+            if (base_type::paranoiac_)
+                BOOST_ASSERT(domains_.find(domain->id()) != domains_.end());
+
+            new_events.push_back(pooled_shared_ptr<event_type>(
+                new single_event(base_type::t_ + domain->dt(), *domain, kind)));
+        }
+
+        std::vector<event_id_type> ids;
+        ids.reserve(new_events.size());
+        scheduler_.add(new_events.begin(), new_events.end(),
+                       std::back_inserter(ids));
+
+        for (std::size_t i(0); i < domains.size(); ++i)
+        {
+            domains[i]->event() = std::make_pair(ids[i], new_events[i]);
+            touch_domain(domains[i]->id());
+            LOG_DEBUG(("add_event: #%d - %s", domains[i]->event().first, boost::lexical_cast<std::string>(*domains[i]).c_str()));
+        }
+    }
+
     void add_event(pair_type& domain, pair_event_kind const& kind)
     {
         if (base_type::paranoiac_)
             BOOST_ASSERT(domains_.find(domain.id()) != domains_.end());
 
-        boost::shared_ptr<event_type> new_event(
-            new pair_event(base_type::t_ + domain.dt(), domain, kind));
+        boost::shared_ptr<event_type> new_event(pooled_shared_ptr<event_type>(
+            new pair_event(base_type::t_ + domain.dt(), domain, kind)));
         domain.event() = std::make_pair(scheduler_.add(new_event), new_event);
+        touch_domain(domain.id());
         LOG_DEBUG(("add_event: #%d - %s", domain.event().first, boost::lexical_cast<std::string>(domain).c_str()));
     }
 
@@ -1418,9 +1628,10 @@ protected:
         if (base_type::paranoiac_)
             BOOST_ASSERT(domains_.find(domain.id()) != domains_.end());
 
-        boost::shared_ptr<event_type> new_event(
-            new multi_event(base_type::t_ + domain.dt(), domain));
+        boost::shared_ptr<event_type> new_event(pooled_shared_ptr<event_type>(
+            new multi_event(base_type::t_ + domain.dt(), domain)));
         domain.event() = std::make_pair(scheduler_.add(new_event), new_event);
+        touch_domain(domain.id());
         LOG_DEBUG(("add_event: #%d - %s", domain.event().first, boost::lexical_cast<std::string>(domain).c_str()));
     }
 
@@ -1438,6 +1649,7 @@ protected:
     // create_single {{{
     boost::shared_ptr<single_type> create_single(particle_id_pair const& p)
     {
+        PROFILE_SCOPE("EGFRDSimulator::create_single");
         domain_kind kind(NONE);
         single_type* new_single(0);
         domain_id_type did(didgen_());
@@ -1523,7 +1735,8 @@ protected:
 
 //        species_type const& species((*base_type::world_).get_species(p.second.sid()));
         dynamic_cast<particle_simulation_structure_type const&>(*(*base_type::world_).get_structure(p.second.structure_id())).accept(factory(this, p, did, new_single, kind));
-        boost::shared_ptr<domain_type> const retval(new_single);
+        boost::shared_ptr<domain_type> const retval(
+            pooled_shared_ptr<domain_type>(new_single));
         domains_.insert(std::make_pair(did, retval));
         BOOST_ASSERT(kind != NONE);
         ++domain_count_per_type_[kind];
@@ -1538,6 +1751,7 @@ protected:
                                              position_type const& iv,
                                              length_type shell_size)
     {
+        PROFILE_SCOPE("EGFRDSimulator::create_pair");
         domain_kind kind(NONE);
         pair_type* new_pair(0);
         domain_id_type did(didgen_());
@@ -1635,7 +1849,8 @@ protected:
 //        species_type const& species((*base_type::world_).get_species(p0.second.sid()));
         dynamic_cast<particle_simulation_structure_type&>(*(*base_type::world_).get_structure(p0.second.structure_id())).accept(factory(this, p0, p1, com, iv, shell_size, did, new_pair, kind));
 
-        boost::shared_ptr<domain_type> const retval(new_pair);
+        boost::shared_ptr<domain_type> const retval(
+            pooled_shared_ptr<domain_type>(new_pair));
         domains_.insert(std::make_pair(did, retval));
         BOOST_ASSERT(kind != NONE);
         ++domain_count_per_type_[kind];
@@ -1648,7 +1863,8 @@ protected:
     {
         domain_id_type did(didgen_());
         multi_type* new_multi(new multi_type(did, *this, bd_dt_factor_));
-        boost::shared_ptr<domain_type> const retval(new_multi);
+        boost::shared_ptr<domain_type> const retval(
+            pooled_shared_ptr<domain_type>(new_multi));
         domains_.insert(std::make_pair(did, retval));
         ++domain_count_per_type_[MULTI];
         return boost::dynamic_pointer_cast<multi_type>(retval);
@@ -1931,19 +2147,186 @@ protected:
     // }}}
 
 
+    // Synchronizes the particles of the domains that pass 'filter' at
+    // 'upto', by bursting those domains; if 'upto' is not before the next
+    // event, takes an ordinary step instead and returns true.
+    template<typename Tfilter_>
+    bool stop(time_type upto, Tfilter_ const& filter)
+    {
+        if (upto <= base_type::t_)
+        {
+            return false;
+        }
+
+        if (upto >= scheduler_.top().second->time())
+        {
+            _step();
+            return true;
+        }
+
+        base_type::t_ = upto;
+
+        std::vector<domain_id_type> singles;
+        std::vector<domain_id_type> non_singles;
+
+        // first burst all Singles.
+        BOOST_FOREACH (event_id_pair_type const& event, scheduler_.events())
+        {
+            domain_event_base const* domain_ev(
+                dynamic_cast<domain_event_base const*>(event.second.get()));
+            BOOST_ASSERT(domain_ev);
+            if (!filter(domain_ev->domain()))
+            {
+                continue;
+            }
+
+            if (dynamic_cast<single_event const*>(domain_ev))
+            {
+                singles.push_back(domain_ev->domain().id());
+            }
+            else
+            {
+                non_singles.push_back(domain_ev->domain().id());
+            }
+        }
+
+        burst_domains(singles);
+
+        // then burst all Pairs and Multis.
+        burst_domains(non_singles);
+
+        base_type::dt_ = 0.;
+
+        return false;
+    }
+
     template<typename Trange>
     void burst_domains(Trange const& domain_ids, boost::optional<std::vector<boost::shared_ptr<domain_type> >&> const& result = boost::optional<std::vector<boost::shared_ptr<domain_type> >&>())
     {
-        BOOST_FOREACH(domain_id_type id, domain_ids)
+        PROFILE_SCOPE("EGFRDSimulator::burst_domains");
+        burst_batch(domain_ids, result, false);
+    }
+
+    // burst_batch {{{
+    /**
+     * Bursts all the domains in domain_ids as one batch.  The particles of
+     * all the domains are propagated first; the shells of the bursted
+     * singles are then updated in one pass over the shell matrices, and the
+     * escape events of all the resulting singles are inserted into the
+     * scheduler at once.
+     *
+     * Singles that are zero singles already (bursted earlier at the current
+     * time) are left alone; they are counted in num_avoided_bursts().
+     * If keep_multis is set, Multis are not bursted but put in result as
+     * they are.
+     */
+    template<typename Trange>
+    void burst_batch(Trange const& domain_ids,
+                     boost::optional<std::vector<boost::shared_ptr<domain_type> >&> const& result,
+                     bool keep_multis)
+    {
+        PROFILE_SCOPE("EGFRDSimulator::burst_batch");
+
+        // singles whose shell is to be updated.
+        std::vector<boost::shared_ptr<single_type> > propagated;
+        // singles that need a new event.
+        std::vector<boost::shared_ptr<single_type> > unscheduled;
+
+        BOOST_FOREACH (domain_id_type id, domain_ids)
         {
             boost::shared_ptr<domain_type> domain(get_domain(id));
-            burst(domain, result);
+            LOG_DEBUG(("burst: bursting %s", boost::lexical_cast<std::string>(*domain).c_str()));
+            {
+                boost::shared_ptr<single_type> _domain(
+                    boost::dynamic_pointer_cast<single_type>(domain));
+                if (_domain)
+                {
+                    if (is_zero_single(*_domain))
+                    {
+                        ++avoided_burst_count_;
+                    }
+                    else
+                    {
+                        propagate_on_burst(*_domain, false);
+                        propagated.push_back(_domain);
+                        if (remove_event_on_burst(*_domain))
+                            unscheduled.push_back(_domain);
+                    }
+                    if (result)
+                        result.get().push_back(domain);
+                    continue;
+                }
+            }
+            {
+                spherical_pair_type* _domain(dynamic_cast<spherical_pair_type*>(domain.get()));
+                if (_domain)
+                {
+                    length_type const dt(base_type::t_ - _domain->last_time());
+                    boost::array<boost::shared_ptr<single_type>, 2> const bursted(
+                        propagate(*_domain, draw_new_positions<draw_on_burst>(*_domain, dt)));
+                    unscheduled.insert(unscheduled.end(), bursted.begin(), bursted.end());
+                    if (result)
+                        result.get().insert(result.get().end(), bursted.begin(), bursted.end());
+                    continue;
+                }
+            }
+            {
+                cylindrical_pair_type* _domain(dynamic_cast<cylindrical_pair_type*>(domain.get()));
+                if (_domain)
+                {
+                    length_type const dt(base_type::t_ - _domain->last_time());
+                    boost::array<boost::shared_ptr<single_type>, 2> const bursted(
+                        propagate(*_domain, draw_new_positions<draw_on_burst>(*_domain, dt)));
+                    unscheduled.insert(unscheduled.end(), bursted.begin(), bursted.end());
+                    if (result)
+                        result.get().insert(result.get().end(), bursted.begin(), bursted.end());
+                    continue;
+                }
+            }
+            {
+                multi_type* _domain(dynamic_cast<multi_type*>(domain.get()));
+                if (_domain)
+                {
+                    if (keep_multis)
+                    {
+                        if (result)
+                            result.get().push_back(domain);
+                        continue;
+                    }
+                    BOOST_FOREACH(particle_id_pair p, _domain->get_particles_range())
+                    {
+                        boost::shared_ptr<single_type> s(create_single(p));
+                        unscheduled.push_back(s);
+                        if (result)
+                            result.get().push_back(boost::dynamic_pointer_cast<domain_type>(s));
+                    }
+                    remove_domain(*_domain);
+                    continue;
+                }
+            }
+            throw not_implemented("?");
         }
+
+        BOOST_FOREACH (boost::shared_ptr<single_type> const& single, propagated)
+        {
+            update_shell_matrix(*single);
+        }
+        add_events(unscheduled, SINGLE_EVENT_ESCAPE);
     }
+    // }}}
 
     // burst {{{
+    // A zero single has been bursted (or created) at the current time already;
+    // bursting it again would not change anything.
+    bool is_zero_single(single_type const& domain) const
+    {
+        return domain.last_time() == base_type::t_ && domain.dt() == 0. &&
+               domain.size() == domain.particle().second.radius();
+    }
+
     template<typename T>
-    void burst(AnalyticalSingle<traits_type, T>& domain)
+    void propagate_on_burst(AnalyticalSingle<traits_type, T>& domain,
+                            bool do_update_shell_matrix)
     {
         position_type const old_pos(domain.position());
         //length_type const old_shell_size(domain.size()); 
@@ -1955,27 +2338,65 @@ protected:
 
         position_type const new_pos(draw_new_position(domain, domain.dt()));
 
-        propagate(domain, new_pos, true);
+        propagate(domain, new_pos, do_update_shell_matrix);
 
         domain.last_time() = base_type::t_;
         domain.dt() = 0.;
+
+        // Displacement check is in draw_new_position.
+        // BOOST_ASSERT(
+        //     (*base_type::world_).distance(new_pos, old_pos)
+        //         <= old_shell_size - particle_radius);
+
+        BOOST_ASSERT(domain.size() == particle_radius);
+    }
+
+    void propagate_on_burst(single_type& domain, bool do_update_shell_matrix)
+    {
+        BOOST_ASSERT(base_type::t_ >= domain.last_time());
+        BOOST_ASSERT(base_type::t_ <= domain.last_time() + domain.dt());
+        {
+            spherical_single_type* _domain(dynamic_cast<spherical_single_type*>(&domain));
+            if (_domain)
+            {
+                propagate_on_burst(*_domain, do_update_shell_matrix);
+                return;
+            }
+        }
+        {
+            cylindrical_single_type* _domain(dynamic_cast<cylindrical_single_type*>(&domain));
+            if (_domain)
+            {
+                propagate_on_burst(*_domain, do_update_shell_matrix);
+                return;
+            }
+        }
+        throw not_implemented("?");
+    }
+
+    // Returns false if the event of the single is not in the scheduler
+    // anymore, in which case the single must not be rescheduled either.
+    bool remove_event_on_burst(single_type& domain)
+    {
         try
         {
             remove_event(domain);
-            add_event(domain, SINGLE_EVENT_ESCAPE);
         }
         catch (std::out_of_range const&)
         {
             // event may have been removed.
             LOG_DEBUG(("event %s already removed; ignoring.", boost::lexical_cast<std::string>(domain.event().first).c_str()));
+            return false;
         }
+        return true;
+    }
 
-        // Displacement check is in draw_new_position.
-        // BOOST_ASSERT(
-        //     (*base_type::world_).distance(new_pos, old_pos)
-        //         <= old_shell_size - particle_radius);
-
-        BOOST_ASSERT(domain.size() == particle_radius);
+    template<typename T>
+    void burst(AnalyticalSingle<traits_type, T>& domain)
+    {
+        propagate_on_burst(domain, true);
+        if (remove_event_on_burst(domain))
+            add_event(domain, SINGLE_EVENT_ESCAPE);
     }
 
     template<typename T>
@@ -2032,6 +2453,7 @@ protected:
 
     void burst(boost::shared_ptr<domain_type> domain, boost::optional<std::vector<boost::shared_ptr<domain_type> >&> const& result = boost::optional<std::vector<boost::shared_ptr<domain_type> >&>())
     {
+        PROFILE_SCOPE("EGFRDSimulator::burst");
         LOG_DEBUG(("burst: bursting %s", boost::lexical_cast<std::string>(*domain).c_str()));
         {
             spherical_single_type* _domain(dynamic_cast<spherical_single_type*>(domain.get()));
@@ -2419,6 +2841,7 @@ protected:
     get_intruders(particle_shape_type const& p,
                   domain_id_type const& ignore) const
     {
+        PROFILE_SCOPE("EGFRDSimulator::get_intruders");
         typedef intruder_collector collector_type;
 
         collector_type col((*base_type::world_), p, ignore);
@@ -2431,6 +2854,7 @@ protected:
     std::pair<domain_id_type, length_type>
     get_closest_domain(position_type const& p, TdidSet const& ignore) const
     {
+        PROFILE_SCOPE("EGFRDSimulator::get_closest_domain");
         typedef closest_object_finder<TdidSet> collector_type;
 
         collector_type col((*base_type::world_), p, ignore);
@@ -2438,13 +2862,56 @@ protected:
         return col.closest;
     }
 
-    void restore_domain(single_type& domain)
+    // Changes whenever a shell is added to, removed from, moved or resized
+    // in any of the shell-matrix cells a neighbor query around pos visits.
+    unsigned long neighborhood_signature(position_type const& pos) const
     {
+        unsigned long retval(0);
+        boost::fusion::for_each(smatm_, neighborhood_signature_accumulator(retval, pos));
+        return retval;
+    }
+
+    bool is_neighborhood_cache_fresh(single_type const& domain) const
+    {
+        typename single_type::neighborhood_cache const& cache(domain.neighborhood());
+        return cache.valid && cache.position == domain.position() &&
+               cache.signature == neighborhood_signature(domain.position());
+    }
+
+    void remember_neighborhood(single_type const& domain,
+                               std::pair<domain_id_type, length_type> const& closest) const
+    {
+        typename single_type::neighborhood_cache& cache(domain.neighborhood());
+        cache.valid = true;
+        cache.position = domain.position();
+        cache.signature = neighborhood_signature(domain.position());
+        cache.closest = closest;
+    }
+
+    // The closest shell to the single, ignoring the single's own one.
+    // Repeated bursting tends to ask this again and again for a single that
+    // stays put, so the previous answer is reused as long as nothing around
+    // the single changed.
+    std::pair<domain_id_type, length_type>
+    get_closest_domain(single_type const& domain) const
+    {
+        if (is_neighborhood_cache_fresh(domain))
+        {
+            PROFILE_COUNT("EGFRDSimulator::neighborhood_cache_hit");
+            return domain.neighborhood().closest;
+        }
+        PROFILE_COUNT("EGFRDSimulator::neighborhood_cache_miss");
         std::pair<domain_id_type, length_type> const closest(
             get_closest_domain(
                 domain.position(), 
                 array_gen(domain.id())));
-        restore_domain(domain, closest);
+        remember_neighborhood(domain, closest);
+        return closest;
+    }
+
+    void restore_domain(single_type& domain)
+    {
+        restore_domain(domain, get_closest_domain(domain));
     }
 
     template<typename T>
@@ -2495,6 +2962,9 @@ protected:
         }
         domain.size() = new_shell_size;
         update_shell_matrix(domain);
+        // closest was determined just before, and nothing but the own shell
+        // has changed since.
+        remember_neighborhood(domain, closest);
         BOOST_ASSERT(domain.size() == new_shell_size);
     }
 
@@ -2520,18 +2990,8 @@ protected:
     void burst_non_multis(Trange const& domain_ids,
                           std::vector<boost::shared_ptr<domain_type> >& bursted)
     {
-        BOOST_FOREACH (domain_id_type id, domain_ids)
-        {
-            boost::shared_ptr<domain_type> domain(get_domain(id));
-            if (dynamic_cast<multi_type*>(domain.get()))
-            {
-                bursted.push_back(domain);
-            }
-            else
-            {
-                burst(domain, bursted);
-            }
-        }
+        PROFILE_SCOPE("EGFRDSimulator::burst_non_multis");
+        burst_batch(domain_ids, bursted, true);
     }
 
     template<typename T>
@@ -3013,6 +3473,7 @@ protected:
         single_type& domain,
         std::vector<boost::shared_ptr<domain_type> > const& neighbors)
     {
+        PROFILE_SCOPE("EGFRDSimulator::form_pair_or_multi");
         BOOST_ASSERT(!neighbors.empty());
 
         domain_type* possible_partner(0);
@@ -3061,6 +3522,7 @@ protected:
     void fire_event(single_event const& event)
     {
         single_type& domain(event.domain());
+        PROFILE_SCOPE_ENTRY(fire_event_profile_entry(get_domain_kind(domain), event.kind()));
 #if 0
         BOOST_ASSERT(
             std::abs(domain.dt() + domain.last_time() - base_type::t_)
@@ -3110,6 +3572,16 @@ protected:
                 // boost::tie(intruders, closest) = get_intruders(
                 //     particle_shape_type(
                 //         domain.position(), min_shell_radius), domain.id());
+                if (is_neighborhood_cache_fresh(domain) &&
+                    domain.neighborhood().closest.second > min_shell_radius)
+                {
+                    // nothing can be within min_shell_radius if the
+                    // closest shell is not.
+                    PROFILE_COUNT("EGFRDSimulator::neighborhood_cache_hit");
+                    intruders = 0;
+                    closest = domain.neighborhood().closest;
+                }
+                else
                 {
                     std::pair<std::vector<domain_id_type>*, 
                         std::pair<domain_id_type, length_type> > 
@@ -3143,7 +3615,10 @@ protected:
                             boost::dynamic_pointer_cast<single_type>(_single));
                         if (!single)
                             continue;
-                        restore_domain(*single);
+                        // immobile singles keep their zero shell and only
+                        // wait for their reaction.
+                        if (single->D() != 0.)
+                            restore_domain(*single);
                         // reschedule events for the restored domains
                         remove_event(*single);
                         determine_next_event(*single);
@@ -3214,6 +3689,7 @@ protected:
 
         ++pair_step_count_[kind];
         LOG_DEBUG(("fire_pair: %s", stringize_event_kind(kind).c_str()));
+        PROFILE_SCOPE_ENTRY(fire_event_profile_entry(get_domain_kind(domain), kind));
 
         //  1. Single reaction
         //  2. Pair reaction
@@ -3334,6 +3810,7 @@ protected:
 
     void fire_event(multi_event& event)
     {
+        PROFILE_SCOPE("EGFRDSimulator::fire_event(multi)");
         multi_type& domain(event.domain());
         domain.step();
         LOG_DEBUG(("fire_multi: last_event=%s", boost::lexical_cast<std::string>(domain.last_event()).c_str()));
@@ -3386,11 +3863,18 @@ protected:
 
     void _step()
     {
+        PROFILE_SCOPE("EGFRDSimulator::_step");
         if (dirty_)
             initialize();
 
+#ifndef NDEBUG
         if (base_type::paranoiac_)
-            BOOST_ASSERT(check());
+        {
+            // not inside BOOST_ASSERT: the check clears the touched domains.
+            bool const ok(check_incremental());
+            BOOST_ASSERT(ok);
+        }
+#endif
 
         ++base_type::num_steps_;
 
@@ -3522,6 +4006,72 @@ protected:
         return (boost::format("Event(t=%.16g)") % ev.time()).str();
     }
 
+    static std::string stringize_domain_kind(enum domain_kind kind)
+    {
+        switch (kind)
+        {
+        default: /* never get here */ BOOST_ASSERT(0); break;
+        case NONE:
+            return "none";
+
+        case SPHERICAL_SINGLE:
+            return "spherical_single";
+
+        case CYLINDRICAL_SINGLE:
+            return "cylindrical_single";
+
+        case SPHERICAL_PAIR:
+            return "spherical_pair";
+
+        case CYLINDRICAL_PAIR:
+            return "cylindrical_pair";
+
+        case MULTI:
+            return "multi";
+        }
+    }
+
+    // name of the profiler entry the firing of an event is accounted to.
+    static std::string stringize_fire_event(enum domain_kind kind,
+                                            std::string const& event_kind)
+    {
+        return "EGFRDSimulator::fire_event(" + stringize_domain_kind(kind)
+               + ", " + event_kind + ")";
+    }
+
+    // the profiler entries of fire_event, looked up once per
+    // (domain kind, event kind) so that timing an event costs no lookup;
+    // the tables are shared by the simulators of all threads.
+    static Profiler::entry& fire_event_profile_entry(enum domain_kind kind,
+                                                     enum single_event_kind event_kind)
+    {
+        static boost::array<boost::array<Profiler::entry*, NUM_SINGLE_EVENT_KINDS>, NUM_DOMAIN_KINDS> entries;
+        static mutex entries_mutex = MUTEX_INITIALIZER;
+        scoped_lock lock(entries_mutex);
+        Profiler::entry*& entry(entries[kind][event_kind]);
+        if (!entry)
+        {
+            entry = &Profiler::instance().get(
+                stringize_fire_event(kind, stringize_event_kind(event_kind)));
+        }
+        return *entry;
+    }
+
+    static Profiler::entry& fire_event_profile_entry(enum domain_kind kind,
+                                                     enum pair_event_kind event_kind)
+    {
+        static boost::array<boost::array<Profiler::entry*, NUM_PAIR_EVENT_KINDS>, NUM_DOMAIN_KINDS> entries;
+        static mutex entries_mutex = MUTEX_INITIALIZER;
+        scoped_lock lock(entries_mutex);
+        Profiler::entry*& entry(entries[kind][event_kind]);
+        if (!entry)
+        {
+            entry = &Profiler::instance().get(
+                stringize_fire_event(kind, stringize_event_kind(event_kind)));
+        }
+        return *entry;
+    }
+
     static std::string stringize_event_kind(enum single_event_kind kind)
     {
         switch (kind)
@@ -3623,6 +4173,120 @@ protected:
         return retval;
     }
 
+    // Checks that the shells of the domain are in the shell matrices, and
+    // that its particles are in the world as the domain has them.
+    template<typename Tshell>
+    bool check_shell_reference(std::pair<const shell_id_type, Tshell> const& shell,
+                               domain_id_type const& did) const
+    {
+        typedef Tshell shell_type;
+        bool retval(true);
+        typename boost::remove_reference<
+            typename boost::fusion::result_of::value_at_key<
+                shell_matrix_map_type, shell_type>::type>::type const&
+            smat(boost::fusion::at_key<shell_type>(smatm_));
+        typename boost::remove_reference<
+            typename boost::fusion::result_of::value_at_key<
+                shell_matrix_map_type, shell_type>::type>::type::const_iterator
+            i(smat.find(shell.first));
+        CHECK(i != smat.end());
+        if (i != smat.end())
+        {
+            CHECK((*i).second == shell.second);
+            CHECK((*i).second.did() == did);
+        }
+        return retval;
+    }
+
+    bool check_particle_reference(particle_id_pair const& pp) const
+    {
+        bool retval(true);
+        bool const found((*base_type::world_).has_particle(pp.first));
+        CHECK(found);
+        if (found)
+        {
+            CHECK((*base_type::world_).get_particle(pp.first).second == pp.second);
+        }
+        return retval;
+    }
+
+    template<typename T>
+    bool check_domain_references(AnalyticalSingle<traits_type, T> const& domain) const
+    {
+        bool retval(true);
+        CHECK(check_shell_reference(domain.shell(), domain.id()));
+        CHECK(check_particle_reference(domain.particle()));
+        return retval;
+    }
+
+    template<typename T>
+    bool check_domain_references(AnalyticalPair<traits_type, T> const& domain) const
+    {
+        bool retval(true);
+        CHECK(check_shell_reference(domain.shell(), domain.id()));
+        CHECK(check_particle_reference(domain.particles()[0]));
+        CHECK(check_particle_reference(domain.particles()[1]));
+        return retval;
+    }
+
+    bool check_domain_references(multi_type const& domain) const
+    {
+        bool retval(true);
+        BOOST_FOREACH (typename multi_type::spherical_shell_id_pair const& shell,
+                       domain.get_shells())
+        {
+            CHECK(check_shell_reference(shell, domain.id()));
+        }
+        BOOST_FOREACH (particle_id_pair const& pp, domain.get_particles_range())
+        {
+            CHECK(check_particle_reference(pp));
+        }
+        return retval;
+    }
+
+    bool check_domain_references(domain_type const& domain) const
+    {
+        struct visitor: public ImmutativeDomainVisitor<traits_type>
+        {
+            virtual ~visitor() {}
+
+            virtual void operator()(multi_type const& domain) const
+            {
+                retval = self.check_domain_references(domain);
+            }
+
+            virtual void operator()(spherical_single_type const& domain) const
+            {
+                retval = self.check_domain_references(domain);
+            }
+
+            virtual void operator()(cylindrical_single_type const& domain) const
+            {
+                retval = self.check_domain_references(domain);
+            }
+
+            virtual void operator()(spherical_pair_type const& domain) const
+            {
+                retval = self.check_domain_references(domain);
+            }
+
+            virtual void operator()(cylindrical_pair_type const& domain) const
+            {
+                retval = self.check_domain_references(domain);
+            }
+
+            visitor(EGFRDSimulator const& self, bool& retval)
+                : self(self), retval(retval) {}
+
+            EGFRDSimulator const& self;
+            bool& retval;
+        };
+
+        bool retval;
+        domain.accept(visitor(*this, retval));
+        return retval;
+    }
+
     bool check_domain(domain_type const& domain) const
     {
         struct visitor: public ImmutativeDomainVisitor<traits_type>
@@ -3897,6 +4561,11 @@ protected:
     length_type multi_shell_factor_;
     unsigned int rejected_moves_;
     unsigned int zero_step_count_;
+    unsigned int avoided_burst_count_;
+    std::set<domain_id_type> touched_domains_;
+    unsigned int full_check_interval_;
+    unsigned int checks_since_full_check_;
+    bool touched_domains_complete_;
     bool dirty_;
     static Logger& log_;
 };
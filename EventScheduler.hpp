@@ -9,6 +9,8 @@
 #include <boost/shared_ptr.hpp>
 #include <stdexcept>
 #include "DynamicPriorityQueue.hpp"
+#include "Profiler.hpp"
+#include "utils/pool_allocator.hpp"
 
 /**
    Event scheduler.
@@ -24,7 +26,8 @@ class EventScheduler
 public:
     typedef Ttime_ time_type;
 
-    struct Event
+    // Events are allocated from the object pools, see pool_allocator.hpp.
+    struct Event: public pooled_object
     {
         typedef Ttime_ time_type;
 
@@ -83,6 +86,7 @@ public:
 
     value_type pop()
     {
+        PROFILE_SCOPE("EventScheduler::pop");
         if (eventPriorityQueue_.empty())
         {
             throw std::out_of_range("queue is empty");
@@ -111,16 +115,27 @@ public:
 
     identifier_type add(boost::shared_ptr<Event> const& event)
     {
+        PROFILE_SCOPE("EventScheduler::add");
         return eventPriorityQueue_.push(event);
     }
 
+    // Adds the events in [first, last) at once; writes their ids to ids.
+    template<typename Titer_, typename Toiter_>
+    Toiter_ add(Titer_ first, Titer_ last, Toiter_ ids)
+    {
+        PROFILE_SCOPE("EventScheduler::add_bulk");
+        return eventPriorityQueue_.push(first, last, ids);
+    }
+
     void remove(identifier_type const& id)
     {
+        PROFILE_SCOPE("EventScheduler::remove");
         eventPriorityQueue_.pop(id);
     }
 
     void update(value_type const& pair)
     {
+        PROFILE_SCOPE("EventScheduler::update");
         eventPriorityQueue_.replace(pair);
     }
 
@@ -129,6 +144,11 @@ public:
         return eventPriorityQueue_.check();
     }
 
+    memory_usage_type memory_usage() const
+    {
+        return eventPriorityQueue_.memory_usage();
+    }
+
     events_range events() const
     {
         return boost::make_iterator_range(eventPriorityQueue_.begin(),
@@ -0,0 +1,522 @@
+#ifndef GILLESPIE_SIMULATOR_HPP
+#define GILLESPIE_SIMULATOR_HPP
+
+#include <map>
+#include <set>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <boost/assert.hpp>
+#include <boost/foreach.hpp>
+#include <boost/format.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/const_iterator.hpp>
+#include "Defs.hpp"
+#include "exceptions.hpp"
+#include "Model.hpp"
+#include "DynamicPriorityQueue.hpp"
+#include "Logger.hpp"
+
+// Well-mixed stochastic simulator of a reaction network (the
+// next-reaction method of Gibson and Bruck, J. Phys. Chem. A 104, 1876).
+//
+// Every reaction rule of the network keeps its putative firing time in a
+// DynamicPriorityQueue. After a rule fires only the rules whose propensity
+// depends on a species changed by it are rescheduled (through a dependency
+// graph built once at construction), so that a step costs O(log R) in the
+// number of rules R.
+//
+// gillespie.py:GillespieSimulator wraps this simulator (as _GillespieSimulator);
+// it takes the species from the model and the reaction rules from the
+// NetworkRulesWrapper shared with the particle simulators.
+template<typename Ttraits_>
+class GillespieSimulator
+{
+public:
+    typedef Ttraits_ traits_type;
+    typedef typename traits_type::world_type::traits_type::rng_type rng_type;
+    typedef typename traits_type::time_type time_type;
+    typedef typename traits_type::rate_type rate_type;
+    typedef typename traits_type::network_rules_type network_rules_type;
+    typedef typename traits_type::reaction_rule_type reaction_rule_type;
+    typedef typename network_rules_type::reaction_rules reaction_rules;
+    typedef typename reaction_rule_type::species_id_type species_id_type;
+    typedef Model model_type;
+    typedef model_type::species_type_type species_type_type;
+    typedef unsigned long count_type;
+
+protected:
+    typedef std::map<species_id_type, std::size_t> species_index_map;
+    typedef std::vector<std::size_t> index_vector;
+
+    struct reaction
+    {
+        reaction_rule_type rule;
+        index_vector reactants;
+        index_vector products;
+        rate_type k;
+        Real propensity;
+        index_vector dependents;
+        count_type num_firings;
+    };
+
+    typedef std::vector<reaction> reaction_vector;
+
+    // The set of rules never changes, so the volatile id policy makes the
+    // queue identifier of a rule equal to its index in reactions_.
+    typedef DynamicPriorityQueue<time_type, std::less_equal<time_type>,
+                                 volatile_id_policy<> > queue_type;
+
+public:
+    GillespieSimulator(model_type const& model,
+                       boost::shared_ptr<network_rules_type const> network_rules,
+                       rng_type& rng, Real volume, bool convert_rates = true)
+        : model_(model), network_rules_(network_rules), rng_(rng),
+          volume_(volume), convert_rates_(convert_rates),
+          t_(0.), dt_(0.), num_steps_(0), last_reaction_(-1)
+    {
+        BOOST_FOREACH (boost::shared_ptr<species_type_type> st,
+                       model_.get_species_types())
+        {
+            typename species_index_map::value_type const v(st->id(), species_ids_.size());
+            species_index_.insert(v);
+            species_ids_.push_back(st->id());
+        }
+        pool_.resize(species_ids_.size(), 0);
+
+        for (std::size_t i(0); i < species_ids_.size(); ++i)
+        {
+            add_reactions((*network_rules_).query_reaction_rule(species_ids_[i]));
+            for (std::size_t j(i); j < species_ids_.size(); ++j)
+            {
+                add_reactions((*network_rules_).query_reaction_rule(
+                        species_ids_[i], species_ids_[j]));
+            }
+        }
+        build_dependency_graph();
+        initialize();
+    }
+
+    virtual ~GillespieSimulator() {}
+
+    // (Re)draws the firing times of all the rules from the current pool.
+    void initialize()
+    {
+        queue_.clear();
+        for (std::size_t i(0); i < reactions_.size(); ++i)
+        {
+            reaction& r(reactions_[i]);
+            r.propensity = propensity(r);
+            BOOST_VERIFY(queue_.push(t_ + draw_interval(r.propensity)) == i);
+        }
+        dt_ = next_time() - t_;
+    }
+
+    void step()
+    {
+        if (queue_.empty())
+        {
+            t_ = dt_ = std::numeric_limits<time_type>::infinity();
+            return;
+        }
+
+        typename queue_type::value_type const top(queue_.top());
+        if (top.second == std::numeric_limits<time_type>::infinity())
+        {
+            t_ = dt_ = std::numeric_limits<time_type>::infinity();
+            return;
+        }
+
+        t_ = top.second;
+        ++num_steps_;
+        fire(top.first);
+        dt_ = next_time() - t_;
+    }
+
+    bool step(time_type upto)
+    {
+        if (upto <= t_)
+        {
+            return false;
+        }
+
+        if (next_time() > upto)
+        {
+            t_ = upto;
+            dt_ = next_time() - t_;
+            return false;
+        }
+
+        step();
+        return true;
+    }
+
+    time_type next_time() const
+    {
+        return queue_.empty() ? std::numeric_limits<time_type>::infinity():
+                                queue_.top().second;
+    }
+
+    time_type t() const
+    {
+        return t_;
+    }
+
+    time_type dt() const
+    {
+        return dt_;
+    }
+
+    int num_steps() const
+    {
+        return num_steps_;
+    }
+
+    Real volume() const
+    {
+        return volume_;
+    }
+
+    void set_volume(Real volume)
+    {
+        volume_ = volume;
+        update_all();
+    }
+
+    count_type get_pool_size(species_id_type const& id) const
+    {
+        return pool_[species_index(id)];
+    }
+
+    void throw_in_particles(species_id_type const& id, count_type n)
+    {
+        std::size_t const i(species_index(id));
+        pool_[i] += n;
+        update_readers(i);
+    }
+
+    void remove_particles(species_id_type const& id, count_type n)
+    {
+        std::size_t const i(species_index(id));
+        if (pool_[i] < n)
+        {
+            throw illegal_state((boost::format(
+                "cannot remove %d particles of %s (%d present)") %
+                n % boost::lexical_cast<std::string>(id) % pool_[i]).str());
+        }
+        pool_[i] -= n;
+        update_readers(i);
+    }
+
+    std::vector<species_id_type> const& get_species_ids() const
+    {
+        return species_ids_;
+    }
+
+    std::size_t num_reaction_rules() const
+    {
+        return reactions_.size();
+    }
+
+    // the rate actually used for the rule (after conversion, see rate()).
+    rate_type get_rate(typename reaction_rule_type::identifier_type const& id) const
+    {
+        return get_reaction(id).k;
+    }
+
+    count_type num_firings(typename reaction_rule_type::identifier_type const& id) const
+    {
+        return get_reaction(id).num_firings;
+    }
+
+    reaction_rule_type const& last_reaction() const
+    {
+        if (last_reaction_ < 0)
+        {
+            throw illegal_state("no reaction has occurred yet");
+        }
+        return reactions_[last_reaction_].rule;
+    }
+
+    bool check() const
+    {
+        return queue_.check();
+    }
+
+protected:
+    std::size_t species_index(species_id_type const& id) const
+    {
+        typename species_index_map::const_iterator i(species_index_.find(id));
+        if (i == species_index_.end())
+        {
+            throw not_found((boost::format("species %s not found") %
+                             boost::lexical_cast<std::string>(id)).str());
+        }
+        return (*i).second;
+    }
+
+    template<typename Trange_>
+    bool has_species(Trange_ const& ids) const
+    {
+        for (typename boost::range_const_iterator<Trange_>::type
+                i(boost::begin(ids)), e(boost::end(ids)); i != e; ++i)
+        {
+            if (species_index_.find(*i) == species_index_.end())
+                return false;
+        }
+        return true;
+    }
+
+    reaction const& get_reaction(typename reaction_rule_type::identifier_type const& id) const
+    {
+        BOOST_FOREACH (reaction const& r, reactions_)
+        {
+            if (r.rule.id() == id)
+                return r;
+        }
+        throw not_found((boost::format("reaction rule %s not found") %
+                         boost::lexical_cast<std::string>(id)).str());
+    }
+
+    void add_reactions(reaction_rules const& rules)
+    {
+        for (typename boost::range_const_iterator<reaction_rules>::type
+                i(boost::begin(rules)), e(boost::end(rules)); i != e; ++i)
+        {
+            if ((*i).k() == 0.)
+                continue;
+
+            // rules involving structures have no well-mixed counterpart.
+            if (!has_species((*i).get_reactants()) ||
+                !has_species((*i).get_products()))
+            {
+                LOG_WARNING(("ignoring reaction rule %d: unknown species", (*i).id()));
+                continue;
+            }
+
+            reaction r;
+            r.rule = *i;
+            BOOST_FOREACH (species_id_type const& id, (*i).get_reactants())
+                r.reactants.push_back(species_index(id));
+            BOOST_FOREACH (species_id_type const& id, (*i).get_products())
+                r.products.push_back(species_index(id));
+            r.k = rate(*i);
+            r.propensity = 0.;
+            r.num_firings = 0;
+            reactions_.push_back(r);
+        }
+    }
+
+    // Rule j depends on rule i if i changes the pool of a reactant of j.
+    void build_dependency_graph()
+    {
+        std::vector<index_vector> readers(species_ids_.size());
+        for (std::size_t j(0); j < reactions_.size(); ++j)
+        {
+            BOOST_FOREACH (std::size_t s, reactions_[j].reactants)
+                readers[s].push_back(j);
+        }
+
+        for (std::size_t i(0); i < reactions_.size(); ++i)
+        {
+            reaction& r(reactions_[i]);
+            std::map<std::size_t, int> stoichiometry;
+            BOOST_FOREACH (std::size_t s, r.reactants)
+                --stoichiometry[s];
+            BOOST_FOREACH (std::size_t s, r.products)
+                ++stoichiometry[s];
+
+            std::set<std::size_t> dependents;
+            for (std::map<std::size_t, int>::const_iterator
+                    s(stoichiometry.begin()), e(stoichiometry.end()); s != e; ++s)
+            {
+                if ((*s).second == 0)
+                    continue;
+                dependents.insert(readers[(*s).first].begin(),
+                                  readers[(*s).first].end());
+            }
+            dependents.erase(i);
+            r.dependents.assign(dependents.begin(), dependents.end());
+        }
+        readers_.swap(readers);
+    }
+
+    // Converts the intrinsic rates of the particle model into the overall
+    // (well-mixed) rates, the same way gillespie.py does.
+    rate_type rate(reaction_rule_type const& rule) const
+    {
+        rate_type const k(rule.k());
+        if (!convert_rates_)
+            return k;
+
+        if (rule.get_reactants().size() == 1 && rule.get_products().size() == 2)
+        {
+            species_id_type const& p0(rule.get_products()[0]);
+            species_id_type const& p1(rule.get_products()[1]);
+            reaction_rules const& reverse_rules(
+                (*network_rules_).query_reaction_rule(p0, p1));
+            for (typename boost::range_const_iterator<reaction_rules>::type
+                    i(boost::begin(reverse_rules)), e(boost::end(reverse_rules));
+                 i != e; ++i)
+            {
+                if ((*i).get_products().size() != 1 ||
+                    (*i).get_products()[0] != rule.get_reactants()[0])
+                    continue;
+
+                // gillespie.py looks up the overall rate kon of the
+                // reverse rule and converts it back with utils.k_a before
+                // applying utils.k_off.
+                Real const kD(k_D(p0, p1));
+                Real const kon(rate(*i));
+                if (kD == 0. || kon == 0.)
+                    return k;
+                Real const ka(1. / (1. / kon - 1. / kD));
+                return 1. / (ka / (k * kD) + 1. / k);
+            }
+        }
+        else if (rule.get_reactants().size() == 2)
+        {
+            Real const kD(k_D(rule.get_reactants()[0], rule.get_reactants()[1]));
+            if (kD == 0.)
+                return 0.;
+            return 1. / (1. / kD + 1. / k);
+        }
+        return k;
+    }
+
+    Real k_D(species_id_type const& id0, species_id_type const& id1) const
+    {
+        species_type_type const&
+            st0(*model_.get_species_type_by_id(id0)),
+            st1(*model_.get_species_type_by_id(id1));
+        Real const D(boost::lexical_cast<Real>(st0["D"]) +
+                     boost::lexical_cast<Real>(st1["D"]));
+        Real const sigma(boost::lexical_cast<Real>(st0["radius"]) +
+                         boost::lexical_cast<Real>(st1["radius"]));
+        return 4. * M_PI * D * sigma;
+    }
+
+    Real propensity(reaction const& r) const
+    {
+        switch (r.reactants.size())
+        {
+        case 1:
+            return r.k * pool_[r.reactants[0]];
+        case 2:
+            if (r.reactants[0] == r.reactants[1])
+            {
+                Real const n(pool_[r.reactants[0]]);
+                return r.k * 0.5 * n * (n - 1.) / volume_;
+            }
+            return r.k * pool_[r.reactants[0]] * pool_[r.reactants[1]] / volume_;
+        }
+        throw not_implemented("reaction rules with more than two reactants are not supported");
+    }
+
+    time_type draw_interval(Real propensity)
+    {
+        if (propensity <= 0.)
+            return std::numeric_limits<time_type>::infinity();
+
+        Real rnd;
+        do
+        {
+            rnd = rng_.uniform(0., 1.);
+        } while (rnd == 0.);
+        return -std::log(rnd) / propensity;
+    }
+
+    // Rescales the remaining waiting time of a rule whose propensity changed
+    // (Gibson and Bruck, eq. 15) instead of drawing a new random number.
+    void update(std::size_t i)
+    {
+        reaction& r(reactions_[i]);
+        Real const old_propensity(r.propensity);
+        r.propensity = propensity(r);
+        if (r.propensity == old_propensity)
+            return;
+
+        time_type const old_time(queue_.get(i));
+        time_type new_time;
+        if (r.propensity <= 0.)
+            new_time = std::numeric_limits<time_type>::infinity();
+        else if (old_propensity <= 0. ||
+                 old_time == std::numeric_limits<time_type>::infinity())
+            new_time = t_ + draw_interval(r.propensity);
+        else
+            new_time = t_ + (old_propensity / r.propensity) * (old_time - t_);
+        queue_.replace(typename queue_type::value_type(i, new_time));
+    }
+
+    void update_readers(std::size_t species)
+    {
+        BOOST_FOREACH (std::size_t j, readers_[species])
+            update(j);
+        dt_ = next_time() - t_;
+    }
+
+    void update_all()
+    {
+        for (std::size_t i(0); i < reactions_.size(); ++i)
+            update(i);
+        dt_ = next_time() - t_;
+    }
+
+    void fire(std::size_t i)
+    {
+        reaction& r(reactions_[i]);
+        LOG_DEBUG(("fire: t=%.16g rule=%d", t_, r.rule.id()));
+
+        BOOST_FOREACH (std::size_t s, r.reactants)
+        {
+            if (pool_[s] == 0)
+            {
+                throw illegal_state("population size would become negative");
+            }
+            --pool_[s];
+        }
+        BOOST_FOREACH (std::size_t s, r.products)
+            ++pool_[s];
+
+        ++r.num_firings;
+        last_reaction_ = i;
+
+        r.propensity = propensity(r);
+        queue_.replace(typename queue_type::value_type(
+            i, t_ + draw_interval(r.propensity)));
+
+        BOOST_FOREACH (std::size_t j, r.dependents)
+            update(j);
+    }
+
+protected:
+    model_type const& model_;
+    boost::shared_ptr<network_rules_type const> network_rules_;
+    rng_type& rng_;
+    Real volume_;
+    bool const convert_rates_;
+    time_type t_;
+    time_type dt_;
+    int num_steps_;
+    int last_reaction_;
+
+    species_index_map species_index_;
+    std::vector<species_id_type> species_ids_;
+    std::vector<count_type> pool_;
+    reaction_vector reactions_;
+    std::vector<index_vector> readers_;
+    queue_type queue_;
+
+private:
+    static Logger& log_;
+};
+
+template<typename Ttraits_>
+Logger& GillespieSimulator<Ttraits_>::log_(Logger::get_logger("ecell.GillespieSimulator"));
+
+#endif /* GILLESPIE_SIMULATOR_HPP */
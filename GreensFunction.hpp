@@ -3,6 +3,9 @@
 
 #include "Defs.hpp"
 
+// Green's functions may fill mutable tables lazily (e.g. alphaTable), so an
+// instance must not be used from two threads at once.  Distinct instances
+// share no state and can be used concurrently.
 class GreensFunction
 {
 public:
@@ -19,6 +19,7 @@
 
 #include "findRoot.hpp"
 #include "GreensFunction1DAbsAbs.hpp"
+#include "Profiler.hpp"
 
 const unsigned int GreensFunction1DAbsAbs::MAX_TERMS;
 const unsigned int GreensFunction1DAbsAbs::MIN_TERMS;
@@ -400,6 +401,7 @@ GreensFunction1DAbsAbs::leavea(Real t) const
 GreensFunction1DAbsAbs::EventKind
 GreensFunction1DAbsAbs::drawEventType( Real rnd, Real t ) const
 {
+    PROFILE_SCOPE("GreensFunction1DAbsAbs::drawEventType");
     THROW_UNLESS( std::invalid_argument, rnd < 1.0 && rnd >= 0.0 );
     THROW_UNLESS( std::invalid_argument, t > 0.0 );
     // if t=0 nothing has happened => no event
@@ -455,6 +457,7 @@ Real GreensFunction1DAbsAbs::drawT_f (Real t, void *p)
 Real
 GreensFunction1DAbsAbs::drawTime (Real rnd) const
 {
+    PROFILE_SCOPE("GreensFunction1DAbsAbs::drawTime");
     THROW_UNLESS( std::invalid_argument, 0.0 <= rnd && rnd < 1.0 );
 
     const Real a(this->geta());
@@ -695,6 +698,7 @@ Real GreensFunction1DAbsAbs::drawR_f(Real r, void *p)
    that the particle is still in the domain */
 Real GreensFunction1DAbsAbs::drawR (Real rnd, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction1DAbsAbs::drawR");
     THROW_UNLESS( std::invalid_argument, 0.0 <= rnd && rnd < 1.0 );
     THROW_UNLESS( std::invalid_argument, t >= 0.0 );
 
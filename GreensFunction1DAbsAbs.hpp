@@ -6,6 +6,7 @@
 #include <cstdlib>
 #include <exception>
 #include <vector>
+#include <climits>
 
 #include <gsl/gsl_math.h>
 #include <gsl/gsl_sf_trig.h>
@@ -18,6 +18,7 @@
 
 #include "findRoot.hpp"
 #include "GreensFunction1DAbsSinkAbs.hpp"
+#include "Profiler.hpp"
 
 const unsigned int GreensFunction1DAbsSinkAbs::MAX_TERMS;
 const unsigned int GreensFunction1DAbsSinkAbs::MIN_TERMS;
@@ -647,6 +648,7 @@ Real GreensFunction1DAbsSinkAbs::flux_sink(Real t) const
 GreensFunction1DAbsSinkAbs::EventKind 
 GreensFunction1DAbsSinkAbs::drawEventType( Real rnd, Real t ) const
 {
+    PROFILE_SCOPE("GreensFunction1DAbsSinkAbs::drawEventType");
     THROW_UNLESS( std::invalid_argument, rnd < 1.0 && rnd >= 0.0 );
     THROW_UNLESS( std::invalid_argument, t > 0.0 );
 
@@ -721,6 +723,7 @@ Real GreensFunction1DAbsSinkAbs::drawT_f(Real t, void *p)
    into the form needed by the GSL root solver. */
 Real GreensFunction1DAbsSinkAbs::drawTime(Real rnd) const
 {
+    PROFILE_SCOPE("GreensFunction1DAbsSinkAbs::drawTime");
     THROW_UNLESS( std::invalid_argument, 0.0 <= rnd && rnd < 1.0 );
   
     const Real a( geta() );    
@@ -1010,6 +1013,7 @@ Real GreensFunction1DAbsSinkAbs::drawR_f(Real r, void *p)
 
 Real GreensFunction1DAbsSinkAbs::drawR(Real rnd, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction1DAbsSinkAbs::drawR");
     THROW_UNLESS( std::invalid_argument, 0.0 <= rnd && rnd <= 1.0 );
     THROW_UNLESS( std::invalid_argument, t >= 0.0 );
     
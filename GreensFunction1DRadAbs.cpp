@@ -18,6 +18,7 @@
 
 #include "findRoot.hpp"
 #include "GreensFunction1DRadAbs.hpp"
+#include "Profiler.hpp"
 
 const unsigned int GreensFunction1DRadAbs::MAX_TERMS;
 const unsigned int GreensFunction1DRadAbs::MIN_TERMS;
@@ -507,6 +508,7 @@ GreensFunction1DRadAbs::EventKind
 GreensFunction1DRadAbs::drawEventType( Real rnd, Real t )
 const
 {
+    PROFILE_SCOPE("GreensFunction1DRadAbs::drawEventType");
     THROW_UNLESS( std::invalid_argument, rnd < 1.0 && rnd >= 0.0 );
     THROW_UNLESS( std::invalid_argument, t > 0.0 );
     // if t=0 nothing has happened => no event
@@ -567,6 +569,7 @@ Real GreensFunction1DRadAbs::drawT_f (double t, void *p)
    into the form needed by the GSL root solver. */
 Real GreensFunction1DRadAbs::drawTime (Real rnd) const
 {
+    PROFILE_SCOPE("GreensFunction1DRadAbs::drawTime");
     THROW_UNLESS( std::invalid_argument, 0.0 <= rnd && rnd < 1.0 );
   
     const Real sigma(this->getsigma());
@@ -825,6 +828,7 @@ Real GreensFunction1DRadAbs::drawR_f(Real r, void *p)
 /* Return new position */
 Real GreensFunction1DRadAbs::drawR (Real rnd, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction1DRadAbs::drawR");
     THROW_UNLESS( std::invalid_argument, 0.0 <= rnd && rnd < 1.0 );
     THROW_UNLESS( std::invalid_argument, t >= 0.0 );
     
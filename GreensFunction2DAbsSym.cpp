@@ -16,6 +16,7 @@
 #include "findRoot.hpp"
 
 #include "GreensFunction2DAbsSym.hpp"
+#include "Profiler.hpp"
 
 
 
@@ -129,6 +130,7 @@ GreensFunction2DAbsSym::p_survival_F( const Real t,
 const Real 
 GreensFunction2DAbsSym::drawTime( const Real rnd ) const
 {
+    PROFILE_SCOPE("GreensFunction2DAbsSym::drawTime");
   
     THROW_UNLESS( std::invalid_argument, rnd < 1.0 && rnd >= 0.0 );
 
@@ -232,6 +234,7 @@ GreensFunction2DAbsSym::p_r_F( const Real r,
 const Real 
 GreensFunction2DAbsSym::drawR( const Real rnd, const Real t ) const 
 {
+    PROFILE_SCOPE("GreensFunction2DAbsSym::drawR");
   
     THROW_UNLESS( std::invalid_argument, rnd <= 1.0 && rnd >= 0.0 );
     THROW_UNLESS( std::invalid_argument, t >= 0.0 );
@@ -34,6 +34,7 @@
 #include "freeFunctions.hpp"
 #include "CylindricalBesselGenerator.hpp"
 #include "GreensFunction2DRadAbs.hpp"
+#include "Profiler.hpp"
 
 const Real GreensFunction2DRadAbs::MIN_T_FACTOR;
 const unsigned int GreensFunction2DRadAbs::MAX_ORDER;
@@ -942,6 +943,7 @@ GreensFunction2DRadAbs::p_int_r_F( const Real r,
 // the inner boundary)
 Real GreensFunction2DRadAbs::drawTime( const Real rnd) const
 {
+    PROFILE_SCOPE("GreensFunction2DRadAbs::drawTime");
   
     const Real D( this->getD() );
     const Real sigma( this->getSigma() );
@@ -1044,6 +1046,7 @@ GreensFunction2DRadAbs::EventKind
 GreensFunction2DRadAbs::drawEventType( const Real rnd, 
                                        const Real t     ) const
 {
+    PROFILE_SCOPE("GreensFunction2DRadAbs::drawEventType");
   
     const Real D( this->getD() );
     const Real sigma( this->getSigma() );
@@ -1106,6 +1109,7 @@ GreensFunction2DRadAbs::drawEventType( const Real rnd,
 Real GreensFunction2DRadAbs::drawR( const Real rnd, 
                                     const Real t        ) const
 {
+    PROFILE_SCOPE("GreensFunction2DRadAbs::drawR");
 
     // Diffusion constant, inner boundary, outer boundary, starting r.
     const Real D( this->getD() );
@@ -1543,6 +1547,7 @@ GreensFunction2DRadAbs::drawTheta( const Real rnd,
                                    const Real r, 
                                    const Real t   ) const
 {
+    PROFILE_SCOPE("GreensFunction2DRadAbs::drawTheta");
     
     const Real sigma( this->getSigma() );
     const Real a( this->geta() );
@@ -9,6 +9,7 @@
 
 #include "freeFunctions.hpp"
 #include "GreensFunction3D.hpp"
+#include "Profiler.hpp"
 
 GreensFunction3D::~GreensFunction3D()
 {
@@ -17,6 +18,7 @@ GreensFunction3D::~GreensFunction3D()
     
 Real GreensFunction3D::drawTime(Real rnd) const
 {
+    PROFILE_SCOPE("GreensFunction3D::drawTime");
     return INFINITY;
 }
 
@@ -83,6 +85,7 @@ static Real ip_r_F(Real r, ip_r_params const* params )
 
 Real GreensFunction3D::drawR(Real rnd, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction3D::drawR");
     // input parameter range checks.
     if ( !(rnd <= 1.0 && rnd >= 0.0 ) )
     {
@@ -182,6 +185,7 @@ static Real ip_theta_F(Real theta, ip_theta_params const* params)
 
 Real GreensFunction3D::drawTheta(Real rnd, Real r, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction3D::drawTheta");
     // input parameter range checks.
     if ( !(rnd <= 1.0 && rnd >= 0.0 ) )
     {
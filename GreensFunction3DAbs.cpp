@@ -23,6 +23,7 @@
 #include "freeFunctions.hpp"
 #include "SphericalBesselGenerator.hpp"
 #include "GreensFunction3DAbs.hpp"
+#include "Profiler.hpp"
 
 typedef GreensFunction3DAbs GF3DA;
 
@@ -587,6 +588,7 @@ GF3DA::idp_theta(Real theta, Real r, Real t) const
 Real 
 GF3DA::drawTime(Real rnd) const
 {
+   PROFILE_SCOPE("GreensFunction3DAbs::drawTime");
    const Real a(geta());
 
    if (!(rnd <= 1.0 && rnd >= 0.0))
@@ -690,6 +692,7 @@ GF3DA::drawTime(Real rnd) const
 Real 
 GF3DA::drawR(Real rnd, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction3DAbs::drawR");
     const Real a(geta());
 
     if (!(rnd <= 1.0 && rnd >= 0.0))
@@ -773,6 +776,7 @@ GF3DA::drawR(Real rnd, Real t) const
 Real 
 GF3DA::drawTheta(Real rnd, Real r, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction3DAbs::drawTheta");
     Real theta;
 
     const Real a(geta());
@@ -866,6 +870,7 @@ GF3DA::drawTheta(Real rnd, Real r, Real t) const
 
 GF3DA::EventKind GF3DA::drawEventType(Real rnd, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction3DAbs::drawEventType");
     assert(0);
 }
 
@@ -80,6 +80,17 @@ public:
         return "GreensFunction3DAbs";
     }
 
+    // Bytes allocated for the alpha tables filled so far.
+    size_t memory_usage() const
+    {
+        size_t retval(0);
+        for (size_t n(0); n < alphaTable.size(); ++n)
+        {
+            retval += alphaTable[n].capacity() * sizeof(Real);
+        }
+        return retval;
+    }
+
 protected:
 
     Real p_theta_table(Real theta, Real r, Real t, 
@@ -20,6 +20,7 @@
 
 #include "findRoot.hpp"
 #include "GreensFunction3DAbsSym.hpp"
+#include "Profiler.hpp"
 
 /**
   EllipticTheta[4,0,q]
@@ -211,6 +212,7 @@ static Real p_survival_F(Real t, p_survival_params const* params)
 
 Real GreensFunction3DAbsSym::drawTime(Real rnd) const
 {
+    PROFILE_SCOPE("GreensFunction3DAbsSym::drawTime");
     const Real D(getD());
 
     if (rnd >= 1.0 || rnd < 0.0)
@@ -328,6 +330,7 @@ static Real p_r_F(Real r, p_r_params const* params)
 
 Real GreensFunction3DAbsSym::drawR(Real rnd, Real t) const 
 {
+    PROFILE_SCOPE("GreensFunction3DAbsSym::drawR");
     if (rnd >= 1.0 || rnd < 0.0)
     {
         throw std::invalid_argument((boost::format("GreensFunction3DAbsSym: 0.0 <= %.16g < 1.0") % rnd).str());
@@ -11,22 +11,24 @@
 #include <boost/format.hpp>
 #include <gsl/gsl_errno.h>
 #include <gsl/gsl_math.h>
-#include <gsl/gsl_sf_legendre.h>
 #include <gsl/gsl_sf_bessel.h>
 #include <gsl/gsl_sf_lambert.h>
 #include <gsl/gsl_integration.h>
 
 #include "factorial.hpp"
 #include "funcSum.hpp"
+#include "legendreSum.hpp"
 #include "findRoot.hpp"
 #include "freeFunctions.hpp"
 #include "SphericalBesselGenerator.hpp"
 #include "GreensFunction3DRadAbs.hpp"
+#include "Profiler.hpp"
 
 const Real GreensFunction3DRadAbs::TOLERANCE;
 const Real GreensFunction3DRadAbs::MIN_T_FACTOR;
 const unsigned int GreensFunction3DRadAbs::MAX_ORDER;
 const unsigned int GreensFunction3DRadAbs::MAX_ALPHA_SEQ;
+const unsigned int GreensFunction3DRadAbs::THETA_TABLE_SIZE;
 
 
 GreensFunction3DRadAbs::GreensFunction3DRadAbs(
@@ -1326,6 +1328,7 @@ static Real p_int_r_F(Real r, p_int_r_params const* params)
 
 Real GreensFunction3DRadAbs::drawTime(Real rnd) const
 {
+    PROFILE_SCOPE("GreensFunction3DRadAbs::drawTime");
     const Real D(this->getD());
     const Real sigma(this->getSigma());
     const Real kf(this->getkf());
@@ -1448,6 +1451,7 @@ Real GreensFunction3DRadAbs::drawTime(Real rnd) const
 GreensFunction3DRadAbs::EventKind
 GreensFunction3DRadAbs::drawEventType(Real rnd, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction3DRadAbs::drawEventType");
     const Real D(this->getD());
     const Real sigma(this->getSigma());
     const Real kf(this->getkf());
@@ -1679,6 +1683,7 @@ GreensFunction3DRadAbs::drawPleaves(gsl_function const& F,
 
 Real GreensFunction3DRadAbs::drawR(Real rnd, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction3DRadAbs::drawR");
     const Real D(this->getD());
     const Real sigma(this->getSigma());
     const Real a(this->geta());
@@ -2207,31 +2212,19 @@ Real GreensFunction3DRadAbs::dp_theta(Real theta, Real r, Real t) const
 }
 
 
-static Real
-p_theta_n(unsigned int n,
-          GreensFunction3DRadAbs::RealVector const& p_nTable,
-          GreensFunction3DRadAbs::RealVector const& lgndTable)
-{
-    return p_nTable[n] * lgndTable[n] * (2 * n + 1);
-}
-
 Real
 GreensFunction3DRadAbs::p_theta_table(Real theta, Real r,
                                               Real t,
                                               RealVector const& p_nTable) const
 {
-    const unsigned int tableSize(p_nTable.size());
-
     Real sin_theta;
     Real cos_theta;
     sincos(theta, &sin_theta, &cos_theta);
 
-    RealVector lgndTable(tableSize);
-    gsl_sf_legendre_Pl_array(tableSize-1, cos_theta, &lgndTable[0]);
+    RealVector lgndCoefficients;
+    legendreSum_p_coefficients(lgndCoefficients, p_nTable);
 
-    return funcSum_all(
-            boost::bind(&p_theta_n, _1, p_nTable, lgndTable),
-            tableSize) * sin_theta;
+    return legendreSum(lgndCoefficients, cos_theta) * sin_theta;
 }
 
 void
@@ -2365,64 +2358,35 @@ GreensFunction3DRadAbs::idp_theta(Real theta, Real r, Real t) const
     return p;
 }
 
-static Real
-ip_theta_n(unsigned int n,
-           GreensFunction3DRadAbs::RealVector const& p_nTable,
-           GreensFunction3DRadAbs::RealVector const& lgndTable1)
-{
-    // lgndTable1 is offset by 1; lgndTable1[0] is for n=-1.
-
-    const Real lgnd_n_m1(lgndTable1[n]);   // n-1
-    const Real lgnd_n_p1(lgndTable1[n+2]); // n+1
-    
-    // the term (1 + 2 n) is canceled out.
-    return p_nTable[n] * (lgnd_n_m1 - lgnd_n_p1);
-}
-
-
 Real 
 GreensFunction3DRadAbs::ip_theta_table(Real theta, Real r,
                                                Real t, RealVector const& p_nTable) const
 {
-    const unsigned int tableSize(p_nTable.size());
-
-    const Real cos_theta(cos(theta));
+    RealVector lgndCoefficients;
+    legendreSum_ip_coefficients(lgndCoefficients, p_nTable);
 
-    // LgndTable is offset by 1 to incorporate the n=-1 case.
-    // For ex: LgndTable[0] is for n=-1, lgndTable[1] is for n=0 ...
-
-    RealVector lgndTable(tableSize + 2);
-    lgndTable[0] = 1.0;  // n = -1
-    gsl_sf_legendre_Pl_array(tableSize, cos_theta, &lgndTable[1]);
-
-    return funcSum_all(
-        boost::bind(&ip_theta_n, _1, p_nTable, lgndTable),
-        tableSize);
+    return legendreSum(lgndCoefficients, cos(theta));
 }
 
 struct GreensFunction3DRadAbs::ip_theta_params
 { 
-    GreensFunction3DRadAbs const* const gf;
-    const Real r;
-    const Real t;
-    RealVector const& p_nTable;
+    // Legendre coefficients of ip_theta, made once per draw.
+    RealVector const& lgndCoefficients;
     const Real value;
 };
 
 Real GreensFunction3DRadAbs::ip_theta_F(Real theta, ip_theta_params const* params)
 {
-    const GreensFunction3DRadAbs* const gf(params->gf); 
-    const Real r(params->r);
-    const Real t(params->t);
-    RealVector const& p_nTable(params->p_nTable);
+    RealVector const& lgndCoefficients(params->lgndCoefficients);
     const Real value(params->value);
 
-    return gf->ip_theta_table(theta, r, t, p_nTable) - value;
+    return legendreSum(lgndCoefficients, cos(theta)) - value;
 }
 
 Real 
 GreensFunction3DRadAbs::drawTheta(Real rnd, Real r, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction3DRadAbs::drawTheta");
     Real theta;
 
     const Real sigma(this->getSigma());
@@ -2470,16 +2434,58 @@ GreensFunction3DRadAbs::drawTheta(Real rnd, Real r, Real t) const
         makep_nTable(p_nTable, r, t);
     }
 
-    const Real ip_theta_pi(ip_theta_table(high, r, t, p_nTable));
+    // The root finder only sums this Legendre series, not p_nTable.
+    RealVector lgndCoefficients;
+    legendreSum_ip_coefficients(lgndCoefficients, p_nTable);
 
-    ip_theta_params params = { this, r, t, p_nTable, rnd * ip_theta_pi };
+    const Real ip_theta_pi(legendreSum(lgndCoefficients, cos(high)));
+
+    ip_theta_params params = { lgndCoefficients, rnd * ip_theta_pi };
 
     gsl_function F = 
         { reinterpret_cast<typeof(F.function)>(&ip_theta_F), &params };
 
+    // Bracket the root between two points of a regular theta grid, so
+    // that the solver starts from an interval of width pi/THETA_TABLE_SIZE.
+    // F(0) < 0 <= F(pi).  The bracket is doubled from theta = 0 and then
+    // bisected: short times put the root, and the most expensive series,
+    // near theta = 0, and no draw takes more than 2 log2(THETA_TABLE_SIZE)
+    // evaluations of F.
+    Real theta_low(0.0);
+    Real theta_high(high);
+    {
+        const Real thetaStep(high / THETA_TABLE_SIZE);
+        unsigned int j_low(0);
+        unsigned int j_high(1);
+        while (j_high < THETA_TABLE_SIZE &&
+               GSL_FN_EVAL(&F, thetaStep * j_high) < 0.0)
+        {
+            j_low = j_high;
+            j_high = 2 * j_high < THETA_TABLE_SIZE ?
+                2 * j_high: THETA_TABLE_SIZE;
+        }
+        while (j_high - j_low > 1)
+        {
+            const unsigned int j((j_low + j_high) / 2);
+            if (GSL_FN_EVAL(&F, thetaStep * j) >= 0.0)
+            {
+                j_high = j;
+            }
+            else
+            {
+                j_low = j;
+            }
+        }
+        theta_low = thetaStep * j_low;
+        if (j_high < THETA_TABLE_SIZE)
+        {
+            theta_high = thetaStep * j_high;
+        }
+    }
+
     const gsl_root_fsolver_type* solverType(gsl_root_fsolver_brent);
     gsl_root_fsolver* solver(gsl_root_fsolver_alloc(solverType));
-    gsl_root_fsolver_set(solver, &F, 0.0, high);
+    gsl_root_fsolver_set(solver, &F, theta_low, theta_high);
 
     const unsigned int maxIter(100);
 
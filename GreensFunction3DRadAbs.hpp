@@ -28,6 +28,9 @@ private:
     static const unsigned int MAX_ORDER = 50;
     static const unsigned int MAX_ALPHA_SEQ = 2000;
 
+    // Number of intervals of the theta grid drawTheta brackets its root in.
+    static const unsigned int THETA_TABLE_SIZE = 32;
+
 
 public:
     
@@ -147,6 +150,17 @@ public:
 
     Real p_survival_2i_exp(unsigned int i, Real t) const;
 
+    // Bytes allocated for the alpha tables filled so far.
+    size_t memory_usage() const
+    {
+        size_t retval(0);
+        for (size_t n(0); n < alphaTable.size(); ++n)
+        {
+            retval += alphaTable[n].capacity() * sizeof(Real);
+        }
+        return retval;
+    }
+
 
 protected:
 
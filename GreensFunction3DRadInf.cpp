@@ -9,12 +9,10 @@
 
 #include "compat.h"
 
-#include <boost/bind.hpp>
 #include <boost/format.hpp>
 
 #include <gsl/gsl_math.h>
 #include <gsl/gsl_errno.h>
-#include <gsl/gsl_sf_legendre.h>
 #include <gsl/gsl_sf_bessel.h>
 #include <gsl/gsl_integration.h>
 #include <gsl/gsl_interp.h>
@@ -23,10 +21,12 @@
 #include "freeFunctions.hpp"
 
 #include "funcSum.hpp"
+#include "legendreSum.hpp"
 
 #include "SphericalBesselGenerator.hpp"
 
 #include "GreensFunction3DRadInf.hpp"
+#include "Profiler.hpp"
 
 
 
@@ -230,6 +230,7 @@ static Real p_int_r_F(Real r, p_int_r_params* params)
 
 Real GreensFunction3DRadInf::drawTime(Real rnd) const
 {
+    PROFILE_SCOPE("GreensFunction3DRadInf::drawTime");
     const Real sigma(this->getSigma());
 
     if (!(rnd < 1.0 && rnd >= 0.0))
@@ -305,6 +306,7 @@ Real GreensFunction3DRadInf::drawTime(Real rnd) const
 
 Real GreensFunction3DRadInf::drawR(Real rnd, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction3DRadInf::drawR");
     const Real sigma(this->getSigma());
     const Real D(this->getD());
 
@@ -472,22 +474,6 @@ GreensFunction3DRadInf::Rn(unsigned int n, Real r, Real t,
 }
 
 
-Real GreensFunction3DRadInf::p_corr_n(unsigned int n, RealVector const& RnTable, RealVector const& lgndTable) const
-{
-    return RnTable[n] * lgndTable[n] * (2.0 * n + 1.0);
-}
-
-Real GreensFunction3DRadInf::ip_corr_n(unsigned int n, RealVector const& RnTable, RealVector const& lgndTable) const
-{
-    // lgndTable1 is offset by 1; lgndTable1[0] is for n=-1.
-
-    const Real lgnd_n_m1(lgndTable[n]);   // n-1
-    const Real lgnd_n_p1(lgndTable[n+2]); // n+1
-    
-    return RnTable[n] * (lgnd_n_m1 - lgnd_n_p1);// / (1.0 + 2.0 * n);
-}
-
-
 Real GreensFunction3DRadInf::p_corr_table(Real theta, Real r, Real t, RealVector const& RnTable) const
 {
     const size_t tableSize(RnTable.size());
@@ -503,15 +489,10 @@ Real GreensFunction3DRadInf::p_corr_table(Real theta, Real r, Real t, RealVector
     Real cos_theta;
     sincos(theta, &sin_theta, &cos_theta);
 
-    RealVector lgndTable(tableSize);
-    gsl_sf_legendre_Pl_array(tableSize-1, cos(theta), &lgndTable[0]);
+    RealVector lgndCoefficients;
+    legendreSum_p_coefficients(lgndCoefficients, RnTable);
 
-
-    const Real p(funcSum_all(boost::bind(&GreensFunction3DRadInf::
-                                            p_corr_n,
-                                            this,
-                                            _1, RnTable, lgndTable),
-                               tableSize));
+    const Real p(legendreSum(lgndCoefficients, cos_theta));
 
     result = - p * sin_theta;
 
@@ -530,19 +511,10 @@ Real GreensFunction3DRadInf::ip_corr_table(Real theta, Real r,
         return 0.0;
     }
 
-    const Real cos_theta(cos(theta));
-    
-    // lgndTable is offset by 1. lengTable[0] -> n = -1
+    RealVector lgndCoefficients;
+    legendreSum_ip_coefficients(lgndCoefficients, RnTable);
 
-    RealVector lgndTable(tableSize + 2);
-    lgndTable[0] = 1.0; // n = -1
-    gsl_sf_legendre_Pl_array(tableSize, cos_theta, &lgndTable[1]);
-
-    const Real p(funcSum_all(boost::bind(&GreensFunction3DRadInf::
-                                            ip_corr_n,
-                                            this,
-                                            _1, RnTable, lgndTable),
-                               tableSize));
+    const Real p(legendreSum(lgndCoefficients, cos(theta)));
 
     const Real result(- p / (4.0 * M_PI * sqrt(r * r0)));
     return result;
@@ -669,7 +641,8 @@ struct GreensFunction3DRadInf::p_theta_params
     const GreensFunction3DRadInf* const gf;
     const Real r;
     const Real t;
-    GreensFunction3DRadInf::RealVector const& RnTable;
+    // Legendre coefficients of ip_corr, made once per draw.
+    GreensFunction3DRadInf::RealVector const& lgndCoefficients;
     const Real value;
 };
     
@@ -678,15 +651,20 @@ Real GreensFunction3DRadInf::ip_theta_F(Real theta, p_theta_params* params)
     const GreensFunction3DRadInf* const gf(params->gf); 
     const Real r(params->r);
     const Real t(params->t);
-    GreensFunction3DRadInf::RealVector const& RnTable(params->RnTable);
+    GreensFunction3DRadInf::RealVector const& 
+        lgndCoefficients(params->lgndCoefficients);
     const Real value(params->value);
 
-    return gf->ip_theta_table(theta, r, t, RnTable) - value;
+    const Real ip_corr(- legendreSum(lgndCoefficients, cos(theta)) /
+                       (4.0 * M_PI * sqrt(r * gf->getr0())));
+
+    return gf->ip_free(theta, r, t) + ip_corr - value;
 }
 
 
 Real GreensFunction3DRadInf::drawTheta(Real rnd, Real r, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction3DRadInf::drawTheta");
     Real theta;
 
     const Real sigma(this->getSigma());
@@ -723,11 +701,16 @@ Real GreensFunction3DRadInf::drawTheta(Real rnd, Real r, Real t) const
     makeRnTable(RnTable, r, t);
 
 
-    // root finding with the integrand form.
+    // root finding with the integrand form; the root finder only sums
+    // this Legendre series, not RnTable.
+
+    RealVector lgndCoefficients;
+    legendreSum_ip_coefficients(lgndCoefficients, RnTable);
 
     const Real ip_theta_pi(ip_theta_table(M_PI, r, t, RnTable));
 
-    p_theta_params params = { this, r, t, RnTable, rnd * ip_theta_pi };
+    p_theta_params params = { this, r, t, lgndCoefficients, 
+                              rnd * ip_theta_pi };
 
     gsl_function F = 
         {
@@ -735,9 +718,47 @@ Real GreensFunction3DRadInf::drawTheta(Real rnd, Real r, Real t) const
             &params 
         };
 
+    // Bracket the root between two points of a regular theta grid, so
+    // that the solver starts from an interval of width pi/THETA_TABLE_SIZE.
+    // F(0) < 0 <= F(pi).  The bracket is doubled from theta = 0 and then
+    // bisected: short times put the root, and the most expensive series,
+    // near theta = 0, and no draw takes more than 2 log2(THETA_TABLE_SIZE)
+    // evaluations of F.
+    Real theta_low(0.0);
+    Real theta_high(M_PI);
+    {
+        const Real thetaStep(M_PI / THETA_TABLE_SIZE);
+        unsigned int j_low(0);
+        unsigned int j_high(1);
+        while (j_high < THETA_TABLE_SIZE &&
+               GSL_FN_EVAL(&F, thetaStep * j_high) < 0.0)
+        {
+            j_low = j_high;
+            j_high = 2 * j_high < THETA_TABLE_SIZE ?
+                2 * j_high: THETA_TABLE_SIZE;
+        }
+        while (j_high - j_low > 1)
+        {
+            const unsigned int j((j_low + j_high) / 2);
+            if (GSL_FN_EVAL(&F, thetaStep * j) >= 0.0)
+            {
+                j_high = j;
+            }
+            else
+            {
+                j_low = j;
+            }
+        }
+        theta_low = thetaStep * j_low;
+        if (j_high < THETA_TABLE_SIZE)
+        {
+            theta_high = thetaStep * j_high;
+        }
+    }
+
     const gsl_root_fsolver_type* solverType(gsl_root_fsolver_brent);
     gsl_root_fsolver* solver(gsl_root_fsolver_alloc(solverType));
-    gsl_root_fsolver_set(solver, &F, 0.0, M_PI);
+    gsl_root_fsolver_set(solver, &F, theta_low, theta_high);
 
     const unsigned int maxIter(100);
 
@@ -29,6 +29,9 @@ private:
 
     static const unsigned int MAX_ORDER = 70;
 
+    // Number of intervals of the theta grid drawTheta brackets its root in.
+    static const unsigned int THETA_TABLE_SIZE = 32;
+
     static const Real H = 4.0;
     
 
@@ -82,10 +85,6 @@ private:
     Real p_corr_R(Real alpha, unsigned int n, Real r, Real t) const;
 
     
-    Real p_corr_n(unsigned int n, RealVector const& RnTable, RealVector const& lgndTable) const;
-
-    Real ip_corr_n(unsigned int n, RealVector const& RnTable, RealVector const& lgndTable) const;
-
     Real p_corr_table(Real theta, Real r, Real t, RealVector const& RnTable) const;
 
     Real 
@@ -11,6 +11,7 @@
 #include <gsl/gsl_roots.h>
 
 #include "GreensFunction3DSym.hpp"
+#include "Profiler.hpp"
 
 Real GreensFunction3DSym::p_r(Real r, Real t) const
 {
@@ -62,6 +63,7 @@ static Real ip_r_F(Real r, ip_r_params const* params)
 
 Real GreensFunction3DSym::drawR(Real rnd, Real t) const
 {
+    PROFILE_SCOPE("GreensFunction3DSym::drawR");
     // input parameter range checks.
     if ( !(rnd <= 1.0 && rnd >= 0.0 ) )
     {
@@ -3,6 +3,22 @@
 
 #include <utility>
 
+// The serial and lot types of the particle, shell, domain, species and
+// structure identifiers.  With ENABLE_COMPACT_IDS (configure
+// --enable-compact-ids) the serial is a 32-bit number and the lot an
+// unsigned 16-bit generation that SerialIDGenerator advances (modulo 2^16)
+// whenever the serials wrap around.  The two stay separate members of the
+// (lot, serial) pair an Identifier holds, so an identifier takes 8 bytes
+// (2 of them padding) instead of 16; they are not packed into one 32-bit
+// word.
+#ifdef ENABLE_COMPACT_IDS
+typedef unsigned int identifier_serial_type;
+typedef unsigned short identifier_lot_type;
+#else
+typedef unsigned long long identifier_serial_type;
+typedef int identifier_lot_type;
+#endif
+
 struct DefaultLot
 {
     DefaultLot& operator=(DefaultLot const&) {
@@ -19,6 +19,7 @@
 #include "utils/fun_wrappers.hpp"
 #include "utils/assoc_container_traits.hpp"
 #include "utils/map_adapter.hpp"
+#include "utils/mutex.hpp"
 
 struct map_adapter_handler
 {
@@ -90,16 +91,22 @@ private:
 };
 
 static LoggerManagerRegistry registry;
+
+// Guards the registry, the set of loggers and the configuration of the
+// managers.  Logging itself does not take it once a logger is initialized.
+static mutex config_mutex = MUTEX_INITIALIZER;
     
 void LoggerManager::register_logger_manager(
         char const* logger_name_pattern,
         boost::shared_ptr<LoggerManager> const& manager)
 {
+    scoped_lock lock(config_mutex);
     registry.register_logger_manager(logger_name_pattern, manager);
 }
 
 boost::shared_ptr<LoggerManager> LoggerManager::get_logger_manager(char const* logger_name_pattern)
 {
+    scoped_lock lock(config_mutex);
     return registry(logger_name_pattern);
 }
 
@@ -114,6 +121,7 @@ Logger& Logger::get_logger(char const* name)
     typedef map_adapter<std::map<std::string, Logger*>, map_adapter_handler> loggers_type;
     static map_adapter_handler hdlr;
     static loggers_type loggers(hdlr);
+    scoped_lock lock(config_mutex);
     std::string _name(name);
     std::pair<loggers_type::iterator, bool> i(
             loggers.insert(loggers_type::value_type(_name, 0)));
@@ -200,6 +208,10 @@ void Logger::flush()
 
 inline void Logger::ensure_initialized()
 {
+    if (initialized_)
+        return;
+
+    scoped_lock lock(config_mutex);
     if (!manager_)
     {
         boost::shared_ptr<LoggerManager> manager(registry_(name_.c_str()));
@@ -208,19 +220,21 @@ inline void Logger::ensure_initialized()
         appenders_.swap(appenders);
         manager->manage(this);
         manager_ = manager;
+        // publish the members above before the flag
+        __sync_synchronize();
+        initialized_ = true;
     }
 }
 
 Logger::Logger(LoggerManagerRegistry const& registry, char const* name)
-        : registry_(registry), name_(name), manager_() {}
+        : registry_(registry), name_(name), manager_(), initialized_(false) {}
 
 void LoggerManager::level(enum Logger::level level)
 {
-    /* synchronized { */
+    scoped_lock lock(config_mutex);
     level_ = level;
     std::for_each(managed_loggers_.begin(), managed_loggers_.end(),
                   boost::bind(&Logger::level, _1, level));
-    /* } */
 }
 
 enum Logger::level LoggerManager::level() const
@@ -235,26 +249,22 @@ char const* LoggerManager::name() const
 
 std::vector<boost::shared_ptr<LogAppender> > const& LoggerManager::appenders() const
 {
-    /* synchronized() { */
     return appenders_;
-    /* } */
 }
 
 void LoggerManager::add_appender(boost::shared_ptr<LogAppender> const& appender)
 {
-    /* synchronized() { */
+    scoped_lock lock(config_mutex);
     appenders_.push_back(appender);
-    /* } */
 }
 
 LoggerManager::LoggerManager(char const* name, enum Logger::level level)
     : name_(name), level_(level) {}
 
+// Called by Logger::ensure_initialized() with config_mutex held.
 void LoggerManager::manage(Logger* logger)
 {
-    /* synchronized { */
     managed_loggers_.insert(logger);
-    /* }} */
 }
 
 LogAppender::~LogAppender() {}
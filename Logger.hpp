@@ -108,6 +108,7 @@ protected:
     boost::shared_ptr<LoggerManager> manager_;
     enum level level_;
     std::vector<boost::shared_ptr<LogAppender> > appenders_;
+    bool volatile initialized_;
 };
 
 class LoggerManager: boost::noncopyable
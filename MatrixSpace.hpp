@@ -4,15 +4,23 @@
 #include <cstddef>
 #include <algorithm>
 #include <iterator>
+#include <vector>
+#include <boost/assert.hpp>
 #include <boost/multi_array.hpp>
 #include <boost/mpl/if.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
 #include <boost/range/size.hpp>
 #include <boost/range/difference_type.hpp>
 #include "Vector3.hpp"
+#include "Profiler.hpp"
+#include "ShapeArrays.hpp"
 #include "sorted_list.hpp"
 #include "utils/array_helper.hpp"
 #include "utils/get_default_impl.hpp"
+#include "utils/memory_usage.hpp"
 #include "utils/range.hpp"
+#include "utils/tracking_allocator.hpp"
 #include "utils/unassignable_adapter.hpp"
 #include "utils/get_default_impl.hpp"
 
@@ -27,8 +35,10 @@ public:
     typedef Tobj_ mapped_type;
     typedef std::pair<const key_type, mapped_type> value_type;
     typedef Vector3<length_type> position_type;
-    typedef unassignable_adapter<value_type, get_default_impl::std::vector> all_values_type;
-    typedef sorted_list<std::vector<typename all_values_type::size_type> > cell_type;
+    typedef tracked<memory_subsystem_of<key_type>::value> tracked_type;
+    typedef unassignable_adapter<value_type, tracked_type::template vector> all_values_type;
+    typedef sorted_list<typename tracked_type::template vector<
+            typename all_values_type::size_type>::type> cell_type;
     typedef boost::multi_array<cell_type, 3> matrix_type;
     typedef typename cell_type::size_type size_type;
     typedef boost::array<typename matrix_type::size_type, 3>
@@ -42,6 +52,7 @@ public:
     typedef typename all_values_type::const_iterator const_iterator;
     typedef typename all_values_type::reference reference;
     typedef typename all_values_type::const_reference const_reference;
+    typedef typename shape_arrays_of<mapped_type>::type shape_arrays_type;
 
 private:
     typedef std::pair<key_type, mapped_type> nonconst_value_type;
@@ -51,10 +62,28 @@ public:
             typename matrix_type::size_type size = 1)
         : world_size_(world_size),
           cell_size_(world_size / size),
-          matrix_(boost::extents[size][size][size])
+          matrix_(boost::extents[size][size][size]),
+          generation_(0),
+          clock_(0),
+          stamps_(matrix_.num_elements(), 0)
     {
     }
 
+    // Bulk-loads the values of the range (see insert()).
+    template<typename Trange_>
+    MatrixSpace(length_type world_size,
+            typename matrix_type::size_type size,
+            Trange_ const& values)
+        : world_size_(world_size),
+          cell_size_(world_size / size),
+          matrix_(boost::extents[size][size][size]),
+          generation_(0),
+          clock_(0),
+          stamps_(matrix_.num_elements(), 0)
+    {
+        insert(boost::begin(values), boost::end(values));
+    }
+
     inline cell_index_type index(const position_type& pos,
             double t = 1e-10) const
     {
@@ -193,17 +222,78 @@ public:
         return values_.size();
     }
 
+    // Bytes used by the values, the cells and the index of the keys.
+    memory_usage_type memory_usage() const
+    {
+        memory_usage_type retval(node_memory_usage(rmap_));
+        add_memory_usage(retval, memory_usage_type(
+            values_.size() * sizeof(value_type),
+            values_.capacity() * sizeof(value_type)));
+        add_memory_usage(retval, vector_memory_usage(stamps_));
+        add_memory_usage(retval, shapes_.memory_usage());
+
+        const std::size_t cells_size(matrix_.num_elements() * sizeof(cell_type));
+        add_memory_usage(retval, memory_usage_type(cells_size, cells_size));
+        for (cell_type const* i(matrix_.data()), * const e(i + matrix_.num_elements());
+             i != e; ++i)
+        {
+            add_memory_usage(retval, vector_memory_usage((*i).container()));
+        }
+        return retval;
+    }
+
+    // Incremented whenever values are added, removed or moved around in the
+    // underlying storage (in-place updates leave it alone), so that anyone
+    // holding on to raw pointers into the storage can tell they went stale.
+    inline unsigned long generation() const
+    {
+        return generation_;
+    }
+
+    // Incremented on every modification, including in-place updates.
+    inline unsigned long last_modified() const
+    {
+        return clock_;
+    }
+
+    // The value last_modified() had when any of the (cyclic) neighbor cells
+    // of idx, the cells scanned by each_neighbor_cyclic(idx, ...), was last
+    // modified.  While this stays the same, a neighbor query around idx
+    // yields the same result.
+    inline unsigned long last_modified_around(const cell_index_type& idx) const
+    {
+        unsigned long retval(0);
+        cell_index_type _idx;
+        for (int i = -1; i <= 1; ++i)
+        {
+            _idx[2] = (idx[2] + matrix_.shape()[2] + i) % matrix_.shape()[2];
+            for (int j = -1; j <= 1; ++j)
+            {
+                _idx[1] = (idx[1] + matrix_.shape()[1] + j) % matrix_.shape()[1];
+                for (int k = -1; k <= 1; ++k)
+                {
+                    _idx[0] = (idx[0] + matrix_.shape()[0] + k) % matrix_.shape()[0];
+                    retval = std::max(retval, stamps_[&cell(_idx) - matrix_.origin()]);
+                }
+            }
+        }
+        return retval;
+    }
+
     inline iterator update(iterator const& old_value, const value_type& v)
     {
+        PROFILE_COUNT("MatrixSpace::update");
         cell_type* new_cell(&cell(index(v.second.position())));
         cell_type* old_cell(0);
 
         if (old_value != values_.end())
             old_cell = &cell(index((*old_value).second.position()));
 
+        touch(new_cell);
         if (new_cell == old_cell)
         {
             reinterpret_cast<nonconst_value_type&>(*old_value) = v;
+            shapes_.set(old_value - values_.begin(), v.second);
             return old_value;
         }
         else
@@ -212,11 +302,13 @@ public:
 
             if (old_cell)
             {
+                touch(old_cell);
                 reinterpret_cast<nonconst_value_type&>(*old_value) = v;
 
                 typename cell_type::iterator i(
                         old_cell->find(old_value - values_.begin()));
                 index = *i;
+                shapes_.set(index, v.second);
                 old_cell->erase(i);
                 new_cell->push(index);
             }
@@ -224,6 +316,8 @@ public:
             {
                 index = values_.size();
                 values_.push_back(v);
+                shapes_.push_back(v.second);
+                ++generation_;
                 new_cell->push(index);
                 rmap_[v.first] = index;
             }
@@ -233,6 +327,7 @@ public:
 
     inline std::pair<iterator, bool> update(const value_type& v)
     {
+        PROFILE_COUNT("MatrixSpace::update");
         cell_type* new_cell(&cell(index(v.second.position())));
         typename all_values_type::iterator old_value(values_.end());
         cell_type* old_cell(0);
@@ -246,9 +341,11 @@ public:
             }
         }
 
+        touch(new_cell);
         if (new_cell == old_cell)
         {
             reinterpret_cast<nonconst_value_type&>(*old_value) = v;
+            shapes_.set(old_value - values_.begin(), v.second);
             return std::pair<iterator, bool>(old_value, false);
         }
         else
@@ -257,11 +354,13 @@ public:
 
             if (old_cell)
             {
+                touch(old_cell);
                 reinterpret_cast<nonconst_value_type&>(*old_value) = v;
 
                 typename cell_type::iterator i(
                         old_cell->find(old_value - values_.begin()));
                 index = *i;
+                shapes_.set(index, v.second);
                 old_cell->erase(i);
                 new_cell->push(index);
                 return std::pair<iterator, bool>(values_.begin() + index, false);
@@ -270,6 +369,8 @@ public:
             {
                 index = values_.size();
                 values_.push_back(v);
+                shapes_.push_back(v.second);
+                ++generation_;
                 new_cell->push(index);
                 rmap_[v.first] = index;
                 return std::pair<iterator, bool>(values_.begin() + index, true);
@@ -277,8 +378,64 @@ public:
         }
     }
 
+    // Adds the values in [first, last), whose keys must be distinct and not
+    // present yet.  Equivalent to calling update() for each of them, but the
+    // new values are sorted by cell once and appended to each cell in a
+    // single pass.
+    template<typename Titer_>
+    inline void insert(Titer_ first, Titer_ last)
+    {
+        PROFILE_SCOPE("MatrixSpace::insert");
+        typedef typename all_values_type::size_type value_index_type;
+        typedef std::pair<std::size_t, value_index_type> cell_and_value_index;
+
+        std::size_t const n(std::distance(first, last));
+        if (n == 0)
+        {
+            return;
+        }
+
+        std::vector<cell_and_value_index> new_indices;
+        new_indices.reserve(n);
+        values_.reserve(values_.size() + n);
+        shapes_.reserve(values_.size() + n);
+        for (; first != last; ++first)
+        {
+            value_type const& v(*first);
+            BOOST_ASSERT(rmap_.find(v.first) == rmap_.end());
+            value_index_type const i(values_.size());
+            values_.push_back(v);
+            shapes_.push_back(v.second);
+            rmap_[v.first] = i;
+            new_indices.push_back(cell_and_value_index(
+                &cell(index(v.second.position())) - matrix_.origin(), i));
+        }
+        ++generation_;
+
+        std::sort(new_indices.begin(), new_indices.end());
+        for (typename std::vector<cell_and_value_index>::const_iterator
+                i(new_indices.begin()), e(new_indices.end()); i != e;)
+        {
+            cell_type& c(matrix_.origin()[(*i).first]);
+            typename std::vector<cell_and_value_index>::const_iterator j(i);
+            while (j != e && (*j).first == (*i).first)
+            {
+                ++j;
+            }
+            // The new indices are larger than the ones already in the cell,
+            // so appending them keeps the cell sorted.
+            c.container().reserve(c.size() + (j - i));
+            for (; i != j; ++i)
+            {
+                c.container().push_back((*i).second);
+            }
+            touch(&c);
+        }
+    }
+
     inline bool erase(iterator const& i)
     {
+        PROFILE_COUNT("MatrixSpace::erase");
         if (end() == i)
         {
             return false;
@@ -286,7 +443,9 @@ public:
 
         typename all_values_type::size_type const old_index(i - values_.begin());
 
-        BOOST_VERIFY(cell(index((*i).second.position())).erase(old_index));
+        cell_type& c(cell(index((*i).second.position())));
+        BOOST_VERIFY(c.erase(old_index));
+        touch(&c);
         rmap_.erase((*i).first);
 
         typename all_values_type::size_type const last_index(values_.size() - 1);
@@ -299,8 +458,11 @@ public:
             old_c.push(old_index);
             rmap_[last.first] = old_index;
             reinterpret_cast<nonconst_value_type&>(*i) = last; 
+            shapes_.move(last_index, old_index);
         }
         values_.pop_back();
+        shapes_.pop_back();
+        ++generation_;
         return true;
     }
 
@@ -324,6 +486,8 @@ public:
             (*p).clear();
         }
         rmap_.clear();
+        ++generation_;
+        std::fill(stamps_.begin(), stamps_.end(), ++clock_);
     }
 
     inline iterator begin()
@@ -418,7 +582,95 @@ public:
         each_neighbor_cyclic_loops<Tcollect_ const>(idx, collector);
     }
 
+    // Calls collector(i, distance) for the values i in the cells
+    // each_neighbor visits around pos, where distance is the distance
+    // between pos and the shape of *i.  The distances of the values of a
+    // cell are computed in a batch by shape_arrays_type::distances, so this
+    // is only available for values that have such a kernel.
+    template<typename Tcollect_>
+    inline void each_neighbor_distance(const position_type& pos,
+            Tcollect_& collector)
+    {
+        each_neighbor_distance_loops(pos, collector, false, values_.begin());
+    }
+
+    template<typename Tcollect_>
+    inline void each_neighbor_distance(const position_type& pos,
+            Tcollect_& collector) const
+    {
+        each_neighbor_distance_loops(pos, collector, false, values_.begin());
+    }
+
+    // The same for the cells each_neighbor_cyclic visits; the nearest
+    // periodic image of each shape is taken.
+    template<typename Tcollect_>
+    inline void each_neighbor_distance_cyclic(const position_type& pos,
+            Tcollect_& collector)
+    {
+        each_neighbor_distance_loops(pos, collector, true, values_.begin());
+    }
+
+    template<typename Tcollect_>
+    inline void each_neighbor_distance_cyclic(const position_type& pos,
+            Tcollect_& collector) const
+    {
+        each_neighbor_distance_loops(pos, collector, true, values_.begin());
+    }
+
 private:
+    template<typename Tcollect_, typename Titer_>
+    inline void each_neighbor_distance_loops(const position_type& pos,
+            Tcollect_& collector, bool cyclic, Titer_ const& values) const
+    {
+        PROFILE_SCOPE("MatrixSpace::each_neighbor_distance");
+        static const std::size_t batch_size(64);
+        length_type distances[batch_size];
+        const cell_index_type idx(index(pos));
+        const length_type world_size(cyclic ? world_size_: 0.);
+        cell_offset_type off;
+
+        for (off[2] = -1; off[2] <= 1; ++off[2])
+        {
+            for (off[1] = -1; off[1] <= 1; ++off[1])
+            {
+                for (off[0] = -1; off[0] <= 1; ++off[0])
+                {
+                    cell_index_type _idx(idx);
+                    if (cyclic)
+                    {
+                        offset_index_cyclic(_idx, off);
+                    }
+                    else if (!offset_index(_idx, off))
+                    {
+                        continue;
+                    }
+
+                    cell_type const& c(cell(_idx));
+                    if (c.size() == 0)
+                    {
+                        continue;
+                    }
+                    typename all_values_type::size_type const* const indices(
+                        &c.container()[0]);
+                    for (std::size_t first(0); first < c.size(); first += batch_size)
+                    {
+                        std::size_t const n(std::min(batch_size, c.size() - first));
+                        shapes_.distances(pos, world_size, indices + first, n, distances);
+                        for (std::size_t k(0); k < n; ++k)
+                        {
+                            collector(values + indices[first + k], distances[k]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    inline void touch(cell_type const* c)
+    {
+        stamps_[c - matrix_.origin()] = ++clock_;
+    }
+
     std::pair<cell_type*, cell_type*> cell_range()
     {
         return std::make_pair(
@@ -435,6 +687,7 @@ private:
     inline void each_neighbor_loops(const cell_index_type& idx,
                                     Tcollect_& collector) const
     {
+        PROFILE_SCOPE("MatrixSpace::each_neighbor");
         cell_offset_type off;
 
         for (off[2] = -1; off[2] <= 1; ++off[2])
@@ -461,6 +714,7 @@ private:
     inline void each_neighbor_loops(const cell_index_type& idx,
                                     Tcollect_& collector)
     {
+        PROFILE_SCOPE("MatrixSpace::each_neighbor");
         cell_offset_type off;
 
         for (off[2] = -1; off[2] <= 1; ++off[2])
@@ -487,6 +741,7 @@ private:
     inline void each_neighbor_cyclic_loops(const cell_index_type& idx,
                                            Tcollect_& collector) const
     {
+        PROFILE_SCOPE("MatrixSpace::each_neighbor_cyclic");
         cell_offset_type off;
 
         for (off[2] = -1; off[2] <= 1; ++off[2])
@@ -511,6 +766,7 @@ private:
     inline void each_neighbor_cyclic_loops(const cell_index_type& idx,
                                            Tcollect_& collector)
     {
+        PROFILE_SCOPE("MatrixSpace::each_neighbor_cyclic");
         cell_offset_type off;
 
         for (off[2] = -1; off[2] <= 1; ++off[2])
@@ -537,6 +793,10 @@ private:
     matrix_type matrix_;
     key_to_value_mapper_type rmap_;
     all_values_type values_;
+    shape_arrays_type shapes_;  // the shapes of values_, if mapped_type has a kernel
+    unsigned long generation_;
+    unsigned long clock_;
+    std::vector<unsigned long> stamps_;  // per cell, indexed like matrix_.data()
 };
 
 template<typename T_, typename Tkey_,
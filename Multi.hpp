@@ -14,6 +14,7 @@
 #include "Sphere.hpp"
 #include "BDSimulator.hpp"
 #include "BDPropagator.hpp"
+#include "Profiler.hpp"
 #include "Logger.hpp"
 #include "PairGreensFunction.hpp"
 #include "Transaction.hpp"
@@ -814,6 +815,7 @@ public:
        
     void step()
     {
+        PROFILE_SCOPE("Multi::step");
         boost::scoped_ptr<typename multi_particle_container_type::transaction_type> tx(pc_.create_transaction());  
         last_reaction_setter rs(*this);
         volume_clearer vc(*this);
@@ -2,12 +2,14 @@
 #define PARTICLE_CONTAINER_BASE_HPP
 #include "utils/range.hpp"
 #include "utils/get_mapper_mf.hpp"
+#include "utils/memory_usage.hpp"
 #include "utils/unassignable_adapter.hpp"
 #include "MatrixSpace.hpp"
 #include "abstract_set.hpp"
 #include "generator.hpp"
 #include "exceptions.hpp"
 #include "ParticleContainer.hpp"
+#include "Profiler.hpp"
 #include "StructureContainer.hpp"
 #include "Transaction.hpp"
 
@@ -165,6 +167,17 @@ public:
         return pmat_.matrix_size();
     }
 
+    // changes whenever particles are added or removed (see MatrixSpace).
+    unsigned long generation() const
+    {
+        return pmat_.generation();
+    }
+
+    memory_usage_type memory_usage() const
+    {
+        return pmat_.memory_usage();
+    }
+
     template<typename T_>
     length_type distance(T_ const& lhs, position_type const& rhs) const
     {
@@ -320,6 +333,7 @@ public:
     void surface_overlap_checker(particle_shape_type const& s, position_type const& old_pos, structure_id_type const& current,
                                  length_type const& sigma, Tfun_& checker ) const
     {
+        PROFILE_SCOPE("ParticleContainerBase::surface_overlap_checker");
         const structure_id_set visible_structure_IDs (structures_.get_visible_structures(current));
 
         // Get and temporarily store all the visibles structures (upto now we only had their IDs)
@@ -411,6 +425,7 @@ public:
     // Getter structure_id -> structure
     virtual boost::shared_ptr<structure_type> get_structure(structure_id_type const& id) const
     {
+        PROFILE_COUNT("ParticleContainerBase::get_structure");
         return structures_.get_structure(id);
     }
     
@@ -446,6 +461,7 @@ public:
     virtual structure_id_pair_and_distance_list* get_close_structures(position_type const& pos, structure_id_type const& current_struct_id,
                                                                       structure_id_type const& ignore) const
     {
+        PROFILE_SCOPE("ParticleContainerBase::get_close_structures");
         typename utils::template overlap_checker<structure_id_pair_and_distance_list, boost::array<structure_id_type, 1> > checker(array_gen(ignore));
         
         const structure_id_set visible_structure_IDs (structures_.get_visible_structures(current_struct_id));
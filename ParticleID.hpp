@@ -15,10 +15,10 @@
 #endif
 #include "Identifier.hpp"
 
-struct ParticleID: public Identifier<ParticleID, unsigned long long, int>
+struct ParticleID: public Identifier<ParticleID, identifier_serial_type, identifier_lot_type>
 // The ParticleID is a class for the identification of particles
 {
-    typedef Identifier<ParticleID, unsigned long long, int> base_type;
+    typedef Identifier<ParticleID, identifier_serial_type, identifier_lot_type> base_type;
 
     ParticleID(value_type const& value = value_type(0, 0))
         : base_type(value) {}
@@ -0,0 +1,93 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <ctime>
+#include <sstream>
+#include <iomanip>
+#include "Profiler.hpp"
+
+static void write_json_string(std::ostream& out, std::string const& str)
+{
+    out << '"';
+    for (std::string::const_iterator i(str.begin()), e(str.end()); i != e; ++i)
+    {
+        switch (*i)
+        {
+        case '"':
+            out << "\\\"";
+            break;
+        case '\\':
+            out << "\\\\";
+            break;
+        default:
+            out << *i;
+            break;
+        }
+    }
+    out << '"';
+}
+
+Profiler& Profiler::instance()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+bool Profiler::enabled()
+{
+#ifdef ENABLE_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+double Profiler::now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+void Profiler::reset()
+{
+    scoped_lock lock(mutex_);
+    for (entries_type::iterator i(entries_.begin()), e(entries_.end());
+         i != e; ++i)
+    {
+        (*i).second = entry();
+    }
+}
+
+void Profiler::dump_json(std::ostream& out) const
+{
+    std::ios_base::fmtflags const flags(out.flags());
+    std::streamsize const precision(out.precision());
+
+    entries_type const entries(this->entries());
+
+    out << std::setprecision(9);
+    out << "{\"enabled\": " << (enabled() ? "true": "false") << ", \"entries\": {";
+    for (entries_type::const_iterator i(entries.begin()), b(i), e(entries.end());
+         i != e; ++i)
+    {
+        if (i != b)
+            out << ", ";
+        write_json_string(out, (*i).first);
+        out << ": {\"count\": " << (*i).second.count
+            << ", \"total_time\": " << (*i).second.total_time
+            << ", \"max_time\": " << (*i).second.max_time << "}";
+    }
+    out << "}}";
+
+    out.flags(flags);
+    out.precision(precision);
+}
+
+std::string Profiler::to_json() const
+{
+    std::ostringstream out;
+    dump_json(out);
+    return out.str();
+}
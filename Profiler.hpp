@@ -0,0 +1,148 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <map>
+#include <string>
+#include <ostream>
+#include <boost/noncopyable.hpp>
+#include "utils/mutex.hpp"
+
+// Built-in wall-clock timers and event counters.
+//
+// The PROFILE_* macros below expand to nothing unless the tree is configured
+// with --enable-profiling (which defines ENABLE_PROFILING), so instrumented
+// code carries no cost in regular builds.  When enabled, every call site
+// aggregates into a named entry of the process-wide Profiler instance; the
+// entries can be inspected from Python or dumped as JSON.
+//
+// Note that _gfrd and _greens_functions each link their own copy of the
+// Profiler, so Green's functions used through the _greens_functions module
+// are reported by that module: _gfrd.Profiler.instance() reads the former,
+// _greens_functions.profiler_stats() and friends the latter.  Entries are updated under the lock of the
+// Profiler, as simulators may step in several threads at once (their
+// bindings release the GIL).
+class Profiler: boost::noncopyable
+{
+public:
+    struct entry
+    {
+        unsigned long count;
+        double total_time;
+        double max_time;
+
+        entry(): count(0), total_time(0.), max_time(0.) {}
+
+        void add(double elapsed)
+        {
+            ++count;
+            total_time += elapsed;
+            if (elapsed > max_time)
+                max_time = elapsed;
+        }
+    };
+
+    typedef std::map<std::string, entry> entries_type;
+
+    class scoped_timer: boost::noncopyable
+    {
+    public:
+        scoped_timer(entry& e): entry_(e), start_(Profiler::now()) {}
+
+        ~scoped_timer()
+        {
+            Profiler::instance().add(entry_, Profiler::now() - start_);
+        }
+
+    private:
+        entry& entry_;
+        double const start_;
+    };
+
+public:
+    static Profiler& instance();
+
+    // true if the library was built with --enable-profiling.
+    static bool enabled();
+
+    // monotonic wall-clock time in seconds.
+    static double now();
+
+    // The returned reference stays valid for the lifetime of the process;
+    // call sites cache it in a function-local static.
+    entry& get(std::string const& name)
+    {
+        scoped_lock lock(mutex_);
+        return entries_[name];
+    }
+
+    void add(entry& e, double elapsed)
+    {
+        scoped_lock lock(mutex_);
+        e.add(elapsed);
+    }
+
+    void count(entry& e)
+    {
+        scoped_lock lock(mutex_);
+        ++e.count;
+    }
+
+    // a copy, as the entries may change while the caller reads them.
+    entries_type entries() const
+    {
+        scoped_lock lock(mutex_);
+        return entries_;
+    }
+
+    // zeroes all entries (they are not removed, see get()).
+    void reset();
+
+    void dump_json(std::ostream& out) const;
+
+    std::string to_json() const;
+
+private:
+    Profiler()
+    {
+        mutex_.init();
+    }
+
+private:
+    entries_type entries_;
+    mutable mutex mutex_;
+};
+
+#ifdef ENABLE_PROFILING
+
+#define PROFILER_CONCAT_(a, b) a ## b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+
+// times the enclosing scope; name must be constant for the call site.
+#define PROFILE_SCOPE(name) \
+    static Profiler::entry& PROFILER_CONCAT(profile_entry_, __LINE__)( \
+        Profiler::instance().get(name)); \
+    Profiler::scoped_timer PROFILER_CONCAT(profile_timer_, __LINE__)( \
+        PROFILER_CONCAT(profile_entry_, __LINE__))
+
+// times the enclosing scope against an entry the call site looked up itself,
+// for call sites whose name varies; the caller should cache the entry, as
+// Profiler::get() builds a string key and takes a lock.
+#define PROFILE_SCOPE_ENTRY(entry) \
+    Profiler::scoped_timer PROFILER_CONCAT(profile_timer_, __LINE__)(entry)
+
+// counts the number of passes through the call site.
+#define PROFILE_COUNT(name) \
+    do { \
+        static Profiler::entry& profile_entry_(Profiler::instance().get(name)); \
+        Profiler::instance().count(profile_entry_); \
+    } while (0)
+
+#else /* ENABLE_PROFILING */
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_SCOPE_ENTRY(entry)
+#define PROFILE_COUNT(name) do {} while (0)
+
+#endif /* ENABLE_PROFILING */
+
+#endif /* PROFILER_HPP */
@@ -288,15 +288,30 @@ struct SerialIDGenerator
 {
     typedef Tid_ identifier_type;
     typedef typename identifier_lot<identifier_type>::type lot_type;
+    typedef typename identifier_serial<identifier_type>::type serial_type;
 
     SerialIDGenerator(lot_type const& lot = lot_type())
         : next_(lot_add(identifier_type(), lot))
     {
     }
 
+    // hands out the serials after 'last_serial' of 'lot' first.
+    SerialIDGenerator(lot_type const& lot, serial_type const& last_serial)
+        : next_(lot_add(identifier_type(), lot))
+    {
+        serial_advance(next_, last_serial);
+    }
+
     identifier_type operator()()
     {
-        return serial_advance(next_, 1);
+        if (!serial(serial_advance(next_, 1)))
+        {
+            // the serials wrapped around (and zero is not a valid serial);
+            // go on with the next lot.
+            lot_advance(next_, 1);
+            serial_advance(next_, 1);
+        }
+        return next_;
     }
 
 private:
@@ -0,0 +1,279 @@
+#ifndef SHAPE_ARRAYS_HPP
+#define SHAPE_ARRAYS_HPP
+
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include "Sphere.hpp"
+#include "Cylinder.hpp"
+#include "utils/memory_usage.hpp"
+
+template<typename Tshape_, typename Tdid_>
+struct Shell;
+
+// Struct-of-arrays copies of the shapes held by a MatrixSpace, kept in step
+// with its values, from which the distances between one point and all the
+// shapes of a cell are computed in a single loop (see
+// MatrixSpace::each_neighbor_distance).  The loops contain no branches or
+// calls, so that the compiler can vectorize them (configure with
+// --enable-vectorization), and pick the periodic image nearest to the point
+// arithmetically instead of through cyclic_transpose.
+
+// d shifted by world_size towards zero if it is more than half a world size
+// away from it; the image cyclic_transpose selects.  A world_size of zero
+// leaves d alone.
+template<typename T_>
+inline T_ nearest_image(T_ d, T_ world_size, T_ half_world_size)
+{
+    return d - world_size * ((d > half_world_size) - (d < -half_world_size));
+}
+
+// Kept for objects that have no distance kernel; keeps nothing.
+struct NoShapeArrays
+{
+    template<typename Tobj_>
+    void push_back(Tobj_ const&) {}
+
+    template<typename Tobj_>
+    void set(std::size_t, Tobj_ const&) {}
+
+    void move(std::size_t, std::size_t) {}
+
+    void pop_back() {}
+
+    void reserve(std::size_t) {}
+
+    memory_usage_type memory_usage() const
+    {
+        return memory_usage_type(0, 0);
+    }
+};
+
+template<typename Tshape_>
+class ShapeArrays;
+
+template<typename T_>
+class ShapeArrays<Sphere<T_> >
+{
+public:
+    typedef Sphere<T_> shape_type;
+    typedef typename shape_type::position_type position_type;
+    typedef typename shape_type::length_type length_type;
+
+public:
+    template<typename Tobj_>
+    void push_back(Tobj_ const& obj)
+    {
+        shape_type const& s(shape(obj));
+        x_.push_back(s.position()[0]);
+        y_.push_back(s.position()[1]);
+        z_.push_back(s.position()[2]);
+        radius_.push_back(s.radius());
+    }
+
+    template<typename Tobj_>
+    void set(std::size_t i, Tobj_ const& obj)
+    {
+        shape_type const& s(shape(obj));
+        x_[i] = s.position()[0];
+        y_[i] = s.position()[1];
+        z_[i] = s.position()[2];
+        radius_[i] = s.radius();
+    }
+
+    // Copies the shape at index from to index to.
+    void move(std::size_t from, std::size_t to)
+    {
+        x_[to] = x_[from];
+        y_[to] = y_[from];
+        z_[to] = z_[from];
+        radius_[to] = radius_[from];
+    }
+
+    void pop_back()
+    {
+        x_.pop_back();
+        y_.pop_back();
+        z_.pop_back();
+        radius_.pop_back();
+    }
+
+    void reserve(std::size_t n)
+    {
+        x_.reserve(n);
+        y_.reserve(n);
+        z_.reserve(n);
+        radius_.reserve(n);
+    }
+
+    memory_usage_type memory_usage() const
+    {
+        return memory_usage_type(4 * x_.size() * sizeof(length_type),
+                                 4 * x_.capacity() * sizeof(length_type));
+    }
+
+    // Writes the distances between pos and the shapes at indices[0] ..
+    // indices[n - 1] to out[0] .. out[n - 1], as distance(shape, pos) would.
+    template<typename Tindex_>
+    void distances(position_type const& pos, length_type world_size,
+                   Tindex_ const* indices, std::size_t n,
+                   length_type* out) const
+    {
+        length_type const half(world_size / 2);
+        for (std::size_t k(0); k < n; ++k)
+        {
+            std::size_t const i(indices[k]);
+            length_type const dx(nearest_image(pos[0] - x_[i], world_size, half));
+            length_type const dy(nearest_image(pos[1] - y_[i], world_size, half));
+            length_type const dz(nearest_image(pos[2] - z_[i], world_size, half));
+            out[k] = std::sqrt(dx * dx + dy * dy + dz * dz) - radius_[i];
+        }
+    }
+
+private:
+    std::vector<length_type> x_;
+    std::vector<length_type> y_;
+    std::vector<length_type> z_;
+    std::vector<length_type> radius_;
+};
+
+template<typename T_>
+class ShapeArrays<Cylinder<T_> >
+{
+public:
+    typedef Cylinder<T_> shape_type;
+    typedef typename shape_type::position_type position_type;
+    typedef typename shape_type::length_type length_type;
+
+    // the components of a cylinder
+    enum { X, Y, Z, UX, UY, UZ, RADIUS, HALF_LENGTH, NUM_ARRAYS };
+
+public:
+    template<typename Tobj_>
+    void push_back(Tobj_ const& obj)
+    {
+        length_type c[NUM_ARRAYS];
+        components(shape(obj), c);
+        for (int j(0); j < NUM_ARRAYS; ++j)
+        {
+            a_[j].push_back(c[j]);
+        }
+    }
+
+    template<typename Tobj_>
+    void set(std::size_t i, Tobj_ const& obj)
+    {
+        length_type c[NUM_ARRAYS];
+        components(shape(obj), c);
+        for (int j(0); j < NUM_ARRAYS; ++j)
+        {
+            a_[j][i] = c[j];
+        }
+    }
+
+    // Copies the shape at index from to index to.
+    void move(std::size_t from, std::size_t to)
+    {
+        for (int j(0); j < NUM_ARRAYS; ++j)
+        {
+            a_[j][to] = a_[j][from];
+        }
+    }
+
+    void pop_back()
+    {
+        for (int j(0); j < NUM_ARRAYS; ++j)
+        {
+            a_[j].pop_back();
+        }
+    }
+
+    void reserve(std::size_t n)
+    {
+        for (int j(0); j < NUM_ARRAYS; ++j)
+        {
+            a_[j].reserve(n);
+        }
+    }
+
+    memory_usage_type memory_usage() const
+    {
+        return memory_usage_type(
+            NUM_ARRAYS * a_[0].size() * sizeof(length_type),
+            NUM_ARRAYS * a_[0].capacity() * sizeof(length_type));
+    }
+
+    // Writes the distances between pos and the shapes at indices[0] ..
+    // indices[n - 1] to out[0] .. out[n - 1], as distance(shape, pos) would.
+    // The four cases distinguished there (beside an end cap, beside the
+    // side, beyond an edge and inside) come down to the sum of the
+    // distance outside the cylinder and the (negative) distance inside it.
+    template<typename Tindex_>
+    void distances(position_type const& pos, length_type world_size,
+                   Tindex_ const* indices, std::size_t n,
+                   length_type* out) const
+    {
+        length_type const* const x(&a_[X][0]);
+        length_type const* const y(&a_[Y][0]);
+        length_type const* const z(&a_[Z][0]);
+        length_type const* const ux(&a_[UX][0]);
+        length_type const* const uy(&a_[UY][0]);
+        length_type const* const uz(&a_[UZ][0]);
+        length_type const* const radius(&a_[RADIUS][0]);
+        length_type const* const half_length(&a_[HALF_LENGTH][0]);
+
+        length_type const half(world_size / 2);
+        for (std::size_t k(0); k < n; ++k)
+        {
+            std::size_t const i(indices[k]);
+            length_type const dx(nearest_image(pos[0] - x[i], world_size, half));
+            length_type const dy(nearest_image(pos[1] - y[i], world_size, half));
+            length_type const dz(nearest_image(pos[2] - z[i], world_size, half));
+
+            // (r, z) as in to_internal.
+            length_type const pz(dx * ux[i] + dy * uy[i] + dz * uz[i]);
+            length_type const rx(dx - ux[i] * pz);
+            length_type const ry(dy - uy[i] * pz);
+            length_type const rz(dz - uz[i] * pz);
+            length_type const pr(std::sqrt(rx * rx + ry * ry + rz * rz));
+
+            length_type const dr(pr - radius[i]);
+            length_type const dl(std::fabs(pz) - half_length[i]);
+            length_type const outr(dr > 0 ? dr: 0);
+            length_type const outl(dl > 0 ? dl: 0);
+            length_type const in(dr > dl ? dr: dl);
+            out[k] = std::sqrt(outr * outr + outl * outl) + (in < 0 ? in: 0);
+        }
+    }
+
+private:
+    static void components(shape_type const& s, length_type* c)
+    {
+        c[X] = s.position()[0];
+        c[Y] = s.position()[1];
+        c[Z] = s.position()[2];
+        c[UX] = s.unit_z()[0];
+        c[UY] = s.unit_z()[1];
+        c[UZ] = s.unit_z()[2];
+        c[RADIUS] = s.radius();
+        c[HALF_LENGTH] = s.half_length();
+    }
+
+private:
+    std::vector<length_type> a_[NUM_ARRAYS];
+};
+
+// The arrays a MatrixSpace of Tobj_ keeps; only shells get distance kernels.
+template<typename Tobj_>
+struct shape_arrays_of
+{
+    typedef NoShapeArrays type;
+};
+
+template<typename Tshape_, typename Tdid_>
+struct shape_arrays_of<Shell<Tshape_, Tdid_> >
+{
+    typedef ShapeArrays<Tshape_> type;
+};
+
+#endif /* SHAPE_ARRAYS_HPP */
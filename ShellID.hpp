@@ -15,9 +15,9 @@
 #endif
 #include "Identifier.hpp"
 
-struct ShellID: public Identifier<ShellID, unsigned long long, int>
+struct ShellID: public Identifier<ShellID, identifier_serial_type, identifier_lot_type>
 {
-    typedef Identifier<ShellID, unsigned long long, int> base_type;
+    typedef Identifier<ShellID, identifier_serial_type, identifier_lot_type> base_type;
 
     ShellID(value_type const& value = value_type(0, 0))
         : base_type(value) {}
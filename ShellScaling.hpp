@@ -0,0 +1,971 @@
+#ifndef SHELL_SCALING_HPP
+#define SHELL_SCALING_HPP
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <algorithm>
+#include <boost/array.hpp>
+#include <boost/variant.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <gsl/gsl_roots.h>
+
+#include "Defs.hpp"
+#include "Logger.hpp"
+#include "exceptions.hpp"
+#include "findRoot.hpp"
+#include "geometry.hpp"
+#include "linear_algebra.hpp"
+#include "utils/math.hpp"
+#include "Sphere.hpp"
+#include "Cylinder.hpp"
+#include "Disk.hpp"
+#include "Plane.hpp"
+
+// This file implements the geometric part of the making of new shells (the 'testShells' in shells.py).
+// Given the dimensions that a prospective shell would like to have, the functions below scale the shell down
+// such that it does not overlap with the shape of a neighboring shell or surface.
+//
+// SphericalShellScaling scales the radius of a spherical shell around a fixed center.
+// CylindricalShellScaling scales the dimensions (dr, dz_right, dz_left) of a cylindrical shell along the lines
+// r(z) = drdz * (z - z0) + r0 on either side ('right' is the side the orientation vector points to) of the
+// reference point.
+//
+// The algorithms are the same as in shells.py (get_dr_dzright_dzleft_to_*Shape and get_radius_to_*Shape), which
+// is kept as the reference implementation.
+
+
+template<typename Ttraits_>
+class SphericalShellScaling
+{
+public:
+    typedef Ttraits_                                traits_type;
+    typedef typename traits_type::length_type       length_type;
+    typedef typename traits_type::position_type     position_type;
+    typedef Sphere<length_type>                     sphere_type;
+    typedef Cylinder<length_type>                   cylinder_type;
+    typedef Disk<length_type>                       disk_type;
+    typedef Plane<length_type>                      plane_type;
+    typedef boost::variant<sphere_type, cylinder_type, disk_type, plane_type> shape_variant_type;
+
+public:
+    SphericalShellScaling(position_type const& center, length_type const& world_size)
+        : center_(center), world_size_(world_size) {}
+
+    position_type const& center() const
+    {
+        return center_;
+    }
+
+    length_type const& world_size() const
+    {
+        return world_size_;
+    }
+
+    // Returns the minimum of the radius 'r' and the distance from the center to 'shape'.
+    template<typename Tshape_>
+    length_type scale_to(Tshape_ const& shape, length_type const& r) const
+    {
+        return std::min(r, traits_type::distance(shape, center_, world_size_));
+    }
+
+    length_type scale_to(shape_variant_type const& shape, length_type const& r) const
+    {
+        return boost::apply_visitor(scale_visitor(*this, r), shape);
+    }
+
+    // Determines the largest radius <= max_radius that does not overlap with any of the
+    // 'surface_distances' (already calculated by the caller) and the 'shapes' of the neighboring
+    // shells. Throws no_space when the radius drops below 'min_radius'.
+    template<typename Tdistances_, typename Tshapes_>
+    length_type determine_possible_shell(Tdistances_ const& surface_distances, Tshapes_ const& shapes,
+                                         length_type const& min_radius, length_type const& max_radius) const
+    {
+        length_type radius(max_radius);
+
+        for (typename boost::range_const_iterator<Tdistances_>::type i(boost::begin(surface_distances));
+             i != boost::end(surface_distances); ++i)
+        {
+            radius = std::min(radius, static_cast<length_type>(*i));
+            if (radius < min_radius)
+            {
+                throw no_space("Surface too close to make spherical testshell, distance = "
+                               + boost::lexical_cast<std::string>(*i) + ", min_radius = "
+                               + boost::lexical_cast<std::string>(min_radius));
+            }
+        }
+
+        for (typename boost::range_const_iterator<Tshapes_>::type i(boost::begin(shapes));
+             i != boost::end(shapes); ++i)
+        {
+            radius = scale_to(*i, radius);
+            if (radius < min_radius)
+            {
+                throw no_space("Domain too close to make spherical testshell, radius = "
+                               + boost::lexical_cast<std::string>(radius) + ", min_radius = "
+                               + boost::lexical_cast<std::string>(min_radius));
+            }
+        }
+
+        return radius;
+    }
+
+private:
+    struct scale_visitor: public boost::static_visitor<length_type>
+    {
+        scale_visitor(SphericalShellScaling const& self, length_type const& r)
+            : self_(self), r_(r) {}
+
+        template<typename Tshape_>
+        length_type operator()(Tshape_ const& shape) const
+        {
+            return self_.scale_to(shape, r_);
+        }
+
+        SphericalShellScaling const& self_;
+        length_type const r_;
+    };
+
+private:
+    position_type center_;
+    length_type world_size_;
+};
+
+
+template<typename Ttraits_>
+class CylindricalShellScaling
+{
+public:
+    typedef Ttraits_                                traits_type;
+    typedef typename traits_type::length_type       length_type;
+    typedef typename traits_type::position_type     position_type;
+    typedef Sphere<length_type>                     sphere_type;
+    typedef Cylinder<length_type>                   cylinder_type;
+    typedef Disk<length_type>                       disk_type;
+    typedef Plane<length_type>                      plane_type;
+    typedef boost::variant<sphere_type, cylinder_type, disk_type, plane_type> shape_variant_type;
+    typedef boost::array<length_type, 3>            dimensions_type;   // (dr, dz_right, dz_left)
+
+public:
+    // 'plane_distance_offset' is added to the distance to a plane parallel to the axis of the
+    // cylinder (PlanarSurfaceSingles use this to overlap with the membranes they live on).
+    CylindricalShellScaling(position_type const& reference_point,
+                            position_type const& orientation_vector,
+                            length_type const& drdz_right, length_type const& dzdr_right,
+                            length_type const& r0_right, length_type const& z0_right,
+                            length_type const& drdz_left, length_type const& dzdr_left,
+                            length_type const& r0_left, length_type const& z0_left,
+                            length_type const& world_size,
+                            length_type const& plane_distance_offset = 0.)
+        : reference_point_(reference_point), orientation_vector_(orientation_vector),
+          drdz_right_(drdz_right), dzdr_right_(dzdr_right), r0_right_(r0_right), z0_right_(z0_right),
+          drdz_left_(drdz_left), dzdr_left_(dzdr_left), r0_left_(r0_left), z0_left_(z0_left),
+          right_scalingangle_(scalingangle(drdz_right)), left_scalingangle_(scalingangle(drdz_left)),
+          tan_right_scalingangle_(std::tan(right_scalingangle_)),
+          tan_left_scalingangle_(std::tan(left_scalingangle_)),
+          world_size_(world_size), plane_distance_offset_(plane_distance_offset) {}
+
+    position_type const& reference_point() const
+    {
+        return reference_point_;
+    }
+
+    position_type const& orientation_vector() const
+    {
+        return orientation_vector_;
+    }
+
+    length_type const& right_scalingangle() const
+    {
+        return right_scalingangle_;
+    }
+
+    length_type const& left_scalingangle() const
+    {
+        return left_scalingangle_;
+    }
+
+    length_type r_right(length_type const& z_right) const
+    {
+        return drdz_right_ * (z_right - z0_right_) + r0_right_;
+    }
+
+    length_type z_right(length_type const& r_right) const
+    {
+        return dzdr_right_ * (r_right - r0_right_) + z0_right_;
+    }
+
+    length_type r_left(length_type const& z_left) const
+    {
+        return drdz_left_ * (z_left - z0_left_) + r0_left_;
+    }
+
+    length_type z_left(length_type const& r_left) const
+    {
+        return dzdr_left_ * (r_left - r0_left_) + z0_left_;
+    }
+
+    dimensions_type scale_to(sphere_type const& shape, dimensions_type const& dims) const;
+
+    dimensions_type scale_to(cylinder_type const& shape, dimensions_type const& dims) const;
+
+    dimensions_type scale_to(plane_type const& shape, dimensions_type const& dims) const;
+
+    dimensions_type scale_to(disk_type const& shape, dimensions_type const& dims) const
+    {
+        // For now just consider the Disk as a special case of a cylinder
+        return scale_to(cylinder_type(shape.position(), shape.radius(), shape.unit_z(), 0.), dims);
+    }
+
+    dimensions_type scale_to(shape_variant_type const& shape, dimensions_type const& dims) const
+    {
+        return boost::apply_visitor(scale_visitor(*this, dims), shape);
+    }
+
+    // Scales the cylinder, starting from 'max_dims', successively to all the 'shapes' (first the
+    // surfaces, then the shells of the neighboring domains). Throws no_space as soon as one of the
+    // dimensions drops below 'min_dims'.
+    template<typename Tshapes_>
+    dimensions_type determine_possible_shell(Tshapes_ const& shapes, dimensions_type const& min_dims,
+                                             dimensions_type const& max_dims) const
+    {
+        dimensions_type dims(max_dims);
+
+        for (typename boost::range_const_iterator<Tshapes_>::type i(boost::begin(shapes));
+             i != boost::end(shapes); ++i)
+        {
+            dims = scale_to(*i, dims);
+            if (dims[0] < min_dims[0] || dims[1] < min_dims[1] || dims[2] < min_dims[2])
+            {
+                throw no_space("Shape too close to make cylindrical testshell, dr = "
+                               + boost::lexical_cast<std::string>(dims[0]) + ", dz_right = "
+                               + boost::lexical_cast<std::string>(dims[1]) + ", dz_left = "
+                               + boost::lexical_cast<std::string>(dims[2]) + ", min_dr = "
+                               + boost::lexical_cast<std::string>(min_dims[0]));
+            }
+        }
+
+        return dims;
+    }
+
+private:
+    // The scaling parameters of one side (right/left) of the cylinder.
+    struct side_type
+    {
+        int direction;
+        length_type scale_angle;
+        length_type tan_scale_angle;
+        length_type scale_center_r;
+        length_type scale_center_z;
+    };
+
+    // The collision situations for orthogonal cylinders, from the point of view of the scaled cylinder.
+    enum situation_type
+    {
+        BARREL_HITS_FLAT,
+        EDGE_HITS_EDGE,
+        BARREL_HITS_EDGE,
+        FLAT_HITS_BARREL,
+        EDGE_HITS_BARREL,
+        BARREL_HITS_BARREL
+    };
+
+    // The parameters of the EDGE_HITS_EDGE equation, passed to the GSL root finder.
+    struct edge_hits_edge_params
+    {
+        length_type tan_scale_angle;
+        length_type scale_center_to_shell_y;
+        length_type scale_center_to_shell_z;
+        length_type scale_center_to_shell_edge_x;
+        length_type shell_radius_sq;
+    };
+
+    struct scale_visitor: public boost::static_visitor<dimensions_type>
+    {
+        scale_visitor(CylindricalShellScaling const& self, dimensions_type const& dims)
+            : self_(self), dims_(dims) {}
+
+        template<typename Tshape_>
+        dimensions_type operator()(Tshape_ const& shape) const
+        {
+            return self_.scale_to(shape, dims_);
+        }
+
+        CylindricalShellScaling const& self_;
+        dimensions_type const& dims_;
+    };
+
+private:
+    static length_type scalingangle(length_type const& drdz)
+    {
+        if (drdz == std::numeric_limits<length_type>::infinity())
+        {
+            return M_PI / 2.;       // atan(infinity) == Pi/2 -> angle is 90 degrees
+        }
+        else if (drdz == 0.)
+        {
+            return 0.;
+        }
+        return std::atan(drdz);
+    }
+
+    // Returns the angle of (r, z) with the z-axis in the range (-Pi/2, 3Pi/2).
+    static length_type angle_from_axis(length_type const& r, length_type const& z)
+    {
+        length_type angle(std::atan(r / z));
+        if (z < 0.)
+        {
+            angle += M_PI;
+        }
+        return angle;
+    }
+
+    side_type side(length_type const& ref_to_shell_z) const
+    {
+        side_type retval;
+        // use the right side also if the shell is in plane with the reference_point
+        if (ref_to_shell_z >= 0)
+        {
+            retval.direction = 1;
+            retval.scale_angle = right_scalingangle_;
+            retval.tan_scale_angle = tan_right_scalingangle_;
+            retval.scale_center_r = r0_right_;
+            retval.scale_center_z = z0_right_;
+        }
+        else
+        {
+            retval.direction = -1;
+            retval.scale_angle = left_scalingangle_;
+            retval.tan_scale_angle = tan_left_scalingangle_;
+            retval.scale_center_r = r0_left_;
+            retval.scale_center_z = z0_left_;
+        }
+        return retval;
+    }
+
+    // r1/z1 are the functions of the scaling side, z2 the one of the opposite side.
+    length_type r1(side_type const& s, length_type const& z) const
+    {
+        return s.direction == 1 ? r_right(z): r_left(z);
+    }
+
+    length_type z1(side_type const& s, length_type const& r) const
+    {
+        return s.direction == 1 ? z_right(r): z_left(r);
+    }
+
+    length_type z2(side_type const& s, length_type const& r) const
+    {
+        return s.direction == 1 ? z_left(r): z_right(r);
+    }
+
+    static dimensions_type make_dimensions(side_type const& s, length_type const& r,
+                                           length_type const& z1, length_type const& z2)
+    {
+        dimensions_type retval;
+        retval[0] = r;
+        retval[1] = s.direction == 1 ? z1: z2;
+        retval[2] = s.direction == 1 ? z2: z1;
+        return retval;
+    }
+
+    static Real edge_hits_edge_h1_eq(Real x, void* params);
+
+    static Real edge_hits_edge_r1_eq(Real x, void* params);
+
+    static Real find_edge_hits_edge_root(gsl_function& F, Real interval_min, Real interval_max);
+
+private:
+    position_type reference_point_;
+    position_type orientation_vector_;
+    length_type drdz_right_;
+    length_type dzdr_right_;
+    length_type r0_right_;
+    length_type z0_right_;
+    length_type drdz_left_;
+    length_type dzdr_left_;
+    length_type r0_left_;
+    length_type z0_left_;
+    length_type right_scalingangle_;
+    length_type left_scalingangle_;
+    length_type tan_right_scalingangle_;
+    length_type tan_left_scalingangle_;
+    length_type world_size_;
+    length_type plane_distance_offset_;
+
+    static Logger& log_;
+};
+
+template<typename Ttraits_>
+typename CylindricalShellScaling<Ttraits_>::dimensions_type
+CylindricalShellScaling<Ttraits_>::scale_to(sphere_type const& shape, dimensions_type const& dims) const
+{
+    const length_type r(dims[0]);
+    const length_type shell_radius(shape.radius());
+
+    // determine on what side the midpoint of the shell is relative to the reference_point
+    const position_type ref_to_shell_vec(subtract(
+        traits_type::cyclic_transpose(shape.position(), reference_point_, world_size_), reference_point_));
+    length_type ref_to_shell_z(dot_product(ref_to_shell_vec, orientation_vector_));
+    const side_type s(side(ref_to_shell_z));
+    const length_type z1_old(s.direction == 1 ? dims[1]: dims[2]);
+    const length_type z2_old(s.direction == 1 ? dims[2]: dims[1]);
+
+    // calculate ref_to_shell_r/z in the cylindrical coordinate system on the right/left side
+    const length_type ref_to_shell_r(length(subtract(ref_to_shell_vec,
+                                                     multiply(orientation_vector_, ref_to_shell_z))));
+    ref_to_shell_z *= s.direction;
+
+    // calculate the distances in r/z from the scaling center to the shell
+    const length_type scale_center_to_shell_r(ref_to_shell_r - s.scale_center_r);
+    const length_type scale_center_to_shell_z(ref_to_shell_z - s.scale_center_z);
+
+    // the angle of the vector from the scale center to the shell with the axis of the cylinder
+    const length_type shell_angle(angle_from_axis(scale_center_to_shell_r, scale_center_to_shell_z));
+
+    // The shell can hit the cylinder on the flat side (situation 1), on the edge (situation 2),
+    // or on the round side (situation 3).
+    int situation;
+    if (shell_angle <= 0.0)
+    {
+        // The midpoint of the shell lies on the axis of the cylinder
+        situation = 1;
+    }
+    else if (0.0 < shell_angle && shell_angle < s.scale_angle)
+    {
+        // The spherical shell can touch the cylinder on its flat side or its edge
+        const length_type scale_center_to_shell_z_thres(s.scale_angle == M_PI / 2. ?
+            0.: std::fabs(scale_center_to_shell_r) / s.tan_scale_angle);
+        situation = shell_radius < scale_center_to_shell_z - scale_center_to_shell_z_thres ? 1: 2;
+    }
+    else if (s.scale_angle <= shell_angle && shell_angle < M_PI / 2.)
+    {
+        // The shell can touch the cylinder on its edge or its radial side
+        const length_type shell_radius_thres(scale_center_to_shell_r - scale_center_to_shell_z * s.tan_scale_angle);
+        situation = shell_radius > shell_radius_thres ? 2: 3;
+    }
+    else if (M_PI / 2. <= shell_angle)
+    {
+        // The shell is always only on the radial side of the cylinder
+        situation = 3;
+    }
+    else
+    {
+        throw illegal_state("shell_angle was not in valid range. shell_angle = "
+                            + boost::lexical_cast<std::string>(shell_angle) + ", scale_angle = "
+                            + boost::lexical_cast<std::string>(s.scale_angle));
+    }
+
+    length_type r_new, z1_new;
+    switch (situation)
+    {
+    case 1:
+        // the spherical shell hits cylinder on the flat side
+        z1_new = std::min(z1_old, ref_to_shell_z - shell_radius);
+        r_new  = std::min(r, r1(s, z1_new));
+        break;
+    case 2:
+        {
+            // the spherical shell hits cylinder on the edge
+            const length_type ss_sq(scale_center_to_shell_z * scale_center_to_shell_z +
+                                    scale_center_to_shell_r * scale_center_to_shell_r);
+            const length_type angle_diff(shell_angle - s.scale_angle);
+            const length_type sin_angle_diff(std::sin(angle_diff));
+            const length_type scale_center_shell_dist(std::sqrt(ss_sq) * std::cos(angle_diff) -
+                std::sqrt(shell_radius * shell_radius - ss_sq * sin_angle_diff * sin_angle_diff));
+
+            if (s.scale_angle <= M_PI / 4.)
+            {
+                z1_new = std::min(z1_old, s.scale_center_z + std::cos(s.scale_angle) * scale_center_shell_dist);
+                r_new  = std::min(r, r1(s, z1_new));
+            }
+            else
+            {
+                r_new  = std::min(r, s.scale_center_r + std::sin(s.scale_angle) * scale_center_shell_dist);
+                z1_new = std::min(z1_old, z1(s, r_new));
+            }
+        }
+        break;
+    default:
+        // the spherical shell hits cylinder on the round side
+        r_new  = std::min(r, ref_to_shell_r - shell_radius);
+        z1_new = std::min(z1_old, z1(s, r_new));
+        break;
+    }
+
+    return make_dimensions(s, r_new, z1_new, std::min(z2_old, z2(s, r_new)));
+}
+
+template<typename Ttraits_>
+typename CylindricalShellScaling<Ttraits_>::dimensions_type
+CylindricalShellScaling<Ttraits_>::scale_to(cylinder_type const& shape, dimensions_type const& dims) const
+{
+    const length_type r(dims[0]);
+    const length_type shell_radius(shape.radius());
+    const length_type shell_half_length(shape.half_length());
+
+    // Determine on what side the midpoint of the shell is relative to the reference_point
+    const position_type ref_to_shell_vec(subtract(
+        traits_type::cyclic_transpose(shape.position(), reference_point_, world_size_), reference_point_));
+    length_type ref_to_shell_z(dot_product(ref_to_shell_vec, orientation_vector_));
+    const side_type s(side(ref_to_shell_z));
+    const length_type z1_old(s.direction == 1 ? dims[1]: dims[2]);
+    const length_type z2_old(s.direction == 1 ? dims[2]: dims[1]);
+    const length_type scale_angle(s.scale_angle);
+    const length_type tan_scale_angle(s.tan_scale_angle);
+    const length_type scale_center_r(s.scale_center_r);
+    const length_type scale_center_z(s.scale_center_z);
+
+    // Check how the cylinders are oriented with respect to each other
+    const length_type relative_orientation(std::fabs(dot_product(orientation_vector_, shape.unit_z())));
+
+    length_type r_new, z1_new;
+    if (feq(relative_orientation, 1.0))
+    {
+        // The cylinders are parallel
+        const length_type ref_to_shell_r(length(subtract(ref_to_shell_vec,
+                                                         multiply(orientation_vector_, ref_to_shell_z))));
+        ref_to_shell_z *= s.direction;
+
+        const length_type scale_center_to_shell_r(ref_to_shell_r - scale_center_r);
+        const length_type scale_center_to_shell_z(ref_to_shell_z - scale_center_z);
+
+        const length_type to_edge_angle(angle_from_axis(scale_center_to_shell_r - shell_radius,
+                                                        scale_center_to_shell_z - shell_half_length));
+
+        if (to_edge_angle <= scale_angle)
+        {
+            // shell hits the scaling cylinder on top
+            z1_new = std::min(z1_old, ref_to_shell_z - shell_half_length);
+            r_new  = std::min(r, r1(s, z1_new));
+        }
+        else
+        {
+            // shell hits the scaling cylinder on the radial side
+            r_new  = std::min(r, ref_to_shell_r - shell_radius);
+            z1_new = std::min(z1_old, z1(s, r_new));
+        }
+    }
+    else if (feq(relative_orientation, 0.))
+    {
+        // The cylinders are oriented perpendicularly.
+        // Construct a local coordinate system with the x-axis along the axis of the neighboring shell,
+        // the z-axis along the axis of the scaling cylinder, and the y-axis perpendicular to both; all
+        // axes point from the reference_point of the scaling cylinder towards the neighboring shell.
+        const position_type local_x(dot_product(ref_to_shell_vec, shape.unit_z()) >= 0 ?
+                                    shape.unit_z(): multiply(shape.unit_z(), -1.));
+        const position_type local_z(multiply(orientation_vector_, s.direction));
+        const position_type cross(cross_product(local_x, local_z));
+        const position_type local_y(dot_product(ref_to_shell_vec, cross) >= 0 ?
+                                    cross: multiply(cross, -1.));
+
+        // Transform the vector pointing from the ref. point towards the shell into the local coordinate system
+        const length_type ref_to_shell_x(dot_product(ref_to_shell_vec, local_x));
+        const length_type ref_to_shell_y(dot_product(ref_to_shell_vec, local_y));
+        ref_to_shell_z = dot_product(ref_to_shell_vec, local_z);
+
+        const length_type scale_center_to_shell_x(ref_to_shell_x);
+        length_type scale_center_to_shell_y(ref_to_shell_y);
+        const length_type scale_center_to_shell_z(ref_to_shell_z - scale_center_z);
+        // The coordinates of the closest corner of a box surrounding the shape
+        const length_type ref_to_shell_x2(ref_to_shell_x - shell_half_length);
+        const length_type ref_to_shell_y2(ref_to_shell_y - shell_radius);
+
+        //// (1) Determine which type of collision happens
+        situation_type situation;
+        if (ref_to_shell_x2 < 0 && ref_to_shell_y2 < 0)
+        {
+            // Quadrant 1
+            const length_type r1_touch((scale_center_to_shell_z - shell_radius) * tan_scale_angle);
+            situation = r1_touch >= scale_center_to_shell_y ? FLAT_HITS_BARREL: EDGE_HITS_BARREL;
+        }
+        else if (ref_to_shell_x2 >= 0 && ref_to_shell_y2 < 0)
+        {
+            // Quadrant 2
+            const length_type scale_center_to_shell_x_minus_half_length(scale_center_to_shell_x - shell_half_length);
+            const length_type lowpoint_r(std::sqrt(
+                scale_center_to_shell_x_minus_half_length * scale_center_to_shell_x_minus_half_length +
+                scale_center_to_shell_y * scale_center_to_shell_y));
+
+            if (scale_angle == 0)
+            {
+                // The radius remains constant at scaling; if the lowest point of the static cylinder is within
+                // the radius of the scaling cylinder the flat side hits the barrel.
+                situation = lowpoint_r < r ? FLAT_HITS_BARREL: EDGE_HITS_EDGE;
+            }
+            else
+            {
+                // The "lowpoint" is the point on the edge of the static cylinder with the minimal z-distance to the
+                // scale center in the zy-plane, the "critpoint" the point on the edge closest to the scale center.
+                const length_type scale_center_to_flatend_x(scale_center_to_shell_x_minus_half_length - scale_center_r);
+                const length_type scale_center_to_lowpoint_x(lowpoint_r - scale_center_r);
+                const length_type scale_center_to_critpoint_z(scale_center_to_shell_z -
+                    std::sqrt(shell_radius * shell_radius - scale_center_to_shell_y * scale_center_to_shell_y));
+                const length_type scale_center_to_lowpoint_z(scale_center_to_shell_z - shell_radius);
+
+                const length_type crit_angle(scale_center_to_critpoint_z == 0 ? M_PI / 2:
+                    angle_from_axis(scale_center_to_flatend_x, scale_center_to_critpoint_z));
+                const length_type low_angle(scale_center_to_lowpoint_z == 0 ? M_PI / 2:
+                    angle_from_axis(scale_center_to_lowpoint_x, scale_center_to_lowpoint_z));
+
+                if (scale_angle <= crit_angle)
+                {
+                    situation = BARREL_HITS_FLAT;
+                }
+                else if (scale_angle >= low_angle)
+                {
+                    situation = FLAT_HITS_BARREL;
+                }
+                else
+                {
+                    situation = EDGE_HITS_EDGE;
+                }
+            }
+        }
+        else if (ref_to_shell_x2 < 0 && ref_to_shell_y2 >= 0)
+        {
+            // Quadrant 3
+            if (scale_angle == 0)
+            {
+                if (scale_center_to_shell_y < r)
+                {
+                    situation = FLAT_HITS_BARREL;
+                }
+                else if (scale_center_to_shell_y - shell_radius <= r)
+                {
+                    situation = EDGE_HITS_BARREL;
+                }
+                else
+                {
+                    // the cylinders do not hit; this is treated properly by the BARREL_HITS_BARREL case
+                    situation = BARREL_HITS_BARREL;
+                }
+            }
+            else
+            {
+                scale_center_to_shell_y -= scale_center_r;
+                const length_type scale_center_to_critpoint_y(scale_center_to_shell_y - shell_radius);
+                const length_type scale_center_to_lowpoint_z(scale_center_to_shell_z - shell_radius);
+
+                const length_type crit_angle(scale_center_to_shell_z == 0. ? M_PI / 2.:
+                    angle_from_axis(scale_center_to_critpoint_y, scale_center_to_shell_z));
+                const length_type low_angle(scale_center_to_lowpoint_z == 0. ? M_PI / 2.:
+                    angle_from_axis(scale_center_to_shell_y, scale_center_to_lowpoint_z));
+
+                if (scale_angle <= crit_angle)
+                {
+                    situation = BARREL_HITS_BARREL;
+                }
+                else if (low_angle <= scale_angle)
+                {
+                    situation = FLAT_HITS_BARREL;
+                }
+                else
+                {
+                    situation = EDGE_HITS_BARREL;
+                }
+            }
+        }
+        else
+        {
+            // Quadrant 4
+            const length_type scale_center_to_shell_x_minus_half_length(scale_center_to_shell_x - shell_half_length);
+            const length_type scale_center_to_shell_y_minus_radius(scale_center_to_shell_y - shell_radius);
+
+            const length_type scale_center_to_critpoint_r(std::sqrt(
+                scale_center_to_shell_y_minus_radius * scale_center_to_shell_y_minus_radius +
+                scale_center_to_shell_x_minus_half_length * scale_center_to_shell_x_minus_half_length) - scale_center_r);
+            const length_type scale_center_to_lowpoint_r(std::sqrt(
+                scale_center_to_shell_y * scale_center_to_shell_y +
+                scale_center_to_shell_x_minus_half_length * scale_center_to_shell_x_minus_half_length) - scale_center_r);
+            const length_type scale_center_to_lowpoint_z(scale_center_to_shell_z - shell_radius);
+
+            const length_type crit_angle(scale_center_to_shell_z == 0. ? M_PI / 2.:
+                angle_from_axis(scale_center_to_critpoint_r, scale_center_to_shell_z));
+            const length_type low_angle(scale_center_to_lowpoint_z == 0. ? M_PI / 2.:
+                angle_from_axis(scale_center_to_lowpoint_r, scale_center_to_lowpoint_z));
+
+            if (scale_center_to_critpoint_r <= 0.0)
+            {
+                // The scale center is further away from the z-axis than the critpoint (in the xy-plane)
+                situation = scale_center_to_lowpoint_r <= 0.0 ? FLAT_HITS_BARREL: EDGE_HITS_EDGE;
+            }
+            else if (scale_angle <= crit_angle)
+            {
+                situation = BARREL_HITS_EDGE;
+            }
+            else if (low_angle <= scale_angle)
+            {
+                situation = FLAT_HITS_BARREL;
+            }
+            else
+            {
+                situation = EDGE_HITS_EDGE;
+            }
+        }
+
+        //// (2) Treat the situation accordingly
+        switch (situation)
+        {
+        case BARREL_HITS_FLAT:
+            r_new  = std::min(r, ref_to_shell_x - shell_half_length);
+            z1_new = std::min(z1_old, z1(s, r_new));
+            break;
+
+        case EDGE_HITS_EDGE:
+            {
+                edge_hits_edge_params params;
+                params.tan_scale_angle = tan_scale_angle;
+                params.scale_center_to_shell_y = scale_center_to_shell_y;
+                params.scale_center_to_shell_z = scale_center_to_shell_z;
+                params.scale_center_to_shell_edge_x = scale_center_to_shell_x - shell_half_length;
+                params.shell_radius_sq = shell_radius * shell_radius;
+                const length_type scale_center_to_shell_edge_x(params.scale_center_to_shell_edge_x);
+                const length_type scale_center_to_shell_edge_y(scale_center_to_shell_y - shell_radius);
+
+                if (scale_angle == 0.0)
+                {
+                    // The radius r stays constant at scaling; if the projected edge of the static shell lies
+                    // outside of the circle defined by r there will be no collision.
+                    if (r < std::sqrt(scale_center_to_shell_edge_x * scale_center_to_shell_edge_x +
+                                      scale_center_to_shell_edge_y * scale_center_to_shell_edge_y))
+                    {
+                        r_new  = r;
+                        z1_new = z1_old;
+                    }
+                    else
+                    {
+                        const length_type y1_collide(std::sqrt(r * r - scale_center_to_shell_edge_x * scale_center_to_shell_edge_x));
+                        const length_type y2_collide(scale_center_to_shell_y - y1_collide);
+                        const length_type h_collide(std::sqrt(shell_radius * shell_radius - y2_collide * y2_collide));
+
+                        z1_new = std::min(z1_old, scale_center_to_shell_z - h_collide);
+                        r_new  = std::min(r, r1(s, z1_new));
+                    }
+                }
+                else
+                {
+                    // The touching point can only be found with a root finder. The bounds between which the
+                    // equation has exactly one root are known; the search interval is enlarged towards them.
+                    const length_type r1_interval_min(scale_center_to_shell_edge_x);
+                    const length_type r1_interval_max(std::sqrt(
+                        scale_center_to_shell_y * scale_center_to_shell_y +
+                        scale_center_to_shell_edge_x * scale_center_to_shell_edge_x));
+
+                    gsl_function F;
+                    F.params = &params;
+
+                    if (scale_angle <= M_PI / 4.)
+                    {
+                        F.function = &edge_hits_edge_h1_eq;
+                        const length_type h_touch(scale_center_z + find_edge_hits_edge_root(F,
+                            z1(s, r1_interval_min) - scale_center_z, z1(s, r1_interval_max) - scale_center_z));
+                        z1_new = std::min(z1_old, h_touch);
+                        r_new  = std::min(r, r1(s, z1_new));
+                    }
+                    else
+                    {
+                        F.function = &edge_hits_edge_r1_eq;
+                        const length_type r_touch(find_edge_hits_edge_root(F, r1_interval_min, r1_interval_max));
+                        r_new  = std::min(r, r_touch);
+                        z1_new = std::min(z1_old, z1(s, r_new));
+                    }
+                }
+            }
+            break;
+
+        case BARREL_HITS_EDGE:
+            r_new  = std::min(r, std::sqrt(
+                (ref_to_shell_x - shell_half_length) * (ref_to_shell_x - shell_half_length) +
+                (ref_to_shell_y - shell_radius) * (ref_to_shell_y - shell_radius)));
+            z1_new = std::min(z1_old, z1(s, r_new));
+            break;
+
+        case FLAT_HITS_BARREL:
+            z1_new = std::min(z1_old, ref_to_shell_z - shell_radius);
+            r_new  = std::min(r, r1(s, z1_new));
+            break;
+
+        case EDGE_HITS_BARREL:
+            {
+                // If scale_angle == 0, the scale center is offset from the reference point; in general
+                // scale_center_r == 0 so that this only affects the scale_angle == 0 cases.
+                scale_center_to_shell_y -= scale_center_r;
+
+                const length_type scale_center_to_shell(std::sqrt(
+                    scale_center_to_shell_z * scale_center_to_shell_z +
+                    scale_center_to_shell_y * scale_center_to_shell_y));
+                const length_type shell_angle_yz(std::atan(scale_center_to_shell_y / scale_center_to_shell_z));
+                const length_type angle_diff(std::fabs(shell_angle_yz - scale_angle));
+                const length_type ss_angle(M_PI - std::asin(std::sin(angle_diff) * scale_center_to_shell / shell_radius));
+                const length_type scale_center_shell_dist(
+                    shell_radius * std::sin(M_PI - (angle_diff + ss_angle)) / std::sin(angle_diff));
+
+                if (scale_center_shell_dist > scale_center_to_shell * (1.0 + 1e-7))
+                {
+                    LOG_WARNING(("Orthogonal cylinder scaling, EDGE_HITS_BARREL case: scale-center-to-shell distance is out of foreseen bounds: distance=%.7g, scale_center_to_shell_y=%.7g, scale_center_to_shell_z=%.7g",
+                                 scale_center_shell_dist, scale_center_to_shell_y, scale_center_to_shell_z));
+                }
+
+                if (scale_angle <= M_PI / 4.)
+                {
+                    z1_new = std::min(z1_old, scale_center_z + std::cos(scale_angle) * scale_center_shell_dist);
+                    r_new  = std::min(r, r1(s, z1_new));
+                }
+                else
+                {
+                    r_new  = std::min(r, scale_center_r + std::sin(scale_angle) * scale_center_shell_dist);
+                    z1_new = std::min(z1_old, z1(s, r_new));
+                }
+            }
+            break;
+
+        case BARREL_HITS_BARREL:
+            if (scale_angle == 0.0)
+            {
+                // In this case the cylinders can never hit
+                r_new  = r;
+                z1_new = z1_old;
+            }
+            else
+            {
+                r_new  = std::min(r, ref_to_shell_y - shell_radius);
+                z1_new = std::min(z1_old, z1(s, r_new));
+            }
+            break;
+        }
+    }
+    else
+    {
+        throw not_implemented("CylindricalShellScaling: Cylinders should be oriented parallel or perpendicular.");
+    }
+
+    const dimensions_type retval(make_dimensions(s, r_new, z1_new, std::min(z2_old, z2(s, r_new))));
+    if (retval[0] < 0 || retval[1] < 0 || retval[2] < 0)
+    {
+        throw no_space("CylindricalShellScaling: Negative length in shell scaling: r="
+                            + boost::lexical_cast<std::string>(retval[0]) + ", z_right="
+                            + boost::lexical_cast<std::string>(retval[1]) + ", z_left="
+                            + boost::lexical_cast<std::string>(retval[2]));
+    }
+    return retval;
+}
+
+template<typename Ttraits_>
+typename CylindricalShellScaling<Ttraits_>::dimensions_type
+CylindricalShellScaling<Ttraits_>::scale_to(plane_type const& shape, dimensions_type const& dims) const
+{
+    length_type r(dims[0]), dz_right(dims[1]), dz_left(dims[2]);
+
+    // determine what parameter of the cylinder (dr or dz) to scale.
+    const length_type relative_orientation(dot_product(orientation_vector_, shape.unit_z()));
+
+    if (feq(relative_orientation, 0.))
+    {
+        // The unit_z of the plane is perpendicular to the cylinder -> scale r
+        r        = std::min(r, traits_type::distance(shape, reference_point_, world_size_) + plane_distance_offset_);
+        dz_right = std::min(dz_right, z_right(r));
+        dz_left  = std::min(dz_left, z_left(r));
+    }
+    else if (feq(std::fabs(relative_orientation), 1.))
+    {
+        // The unit_z of the plane is parallel to the axis of the cylinder -> scale z_right/z_left
+        const position_type ref_to_plane_vec(subtract(
+            traits_type::cyclic_transpose(shape.position(), reference_point_, world_size_), reference_point_));
+
+        if (dot_product(ref_to_plane_vec, orientation_vector_) >= 0)
+        {
+            dz_right = std::min(dz_right, traits_type::distance(shape, reference_point_, world_size_));
+            r        = std::min(r, r_right(dz_right));
+            dz_left  = std::min(dz_left, z_left(r));
+        }
+        else
+        {
+            dz_left  = std::min(dz_left, traits_type::distance(shape, reference_point_, world_size_));
+            r        = std::min(r, r_left(dz_left));
+            dz_right = std::min(dz_right, z_right(r));
+        }
+    }
+    else
+    {
+        throw not_implemented("CylindricalShellScaling: Only perpendicular planes are supported.");
+    }
+
+    dimensions_type retval;
+    retval[0] = r;
+    retval[1] = dz_right;
+    retval[2] = dz_left;
+    return retval;
+}
+
+template<typename Ttraits_>
+Real CylindricalShellScaling<Ttraits_>::edge_hits_edge_h1_eq(Real x, void* params)
+{
+    edge_hits_edge_params const& p(*static_cast<edge_hits_edge_params const*>(params));
+    const Real r1(x * p.tan_scale_angle);
+    Real sqrt_arg(r1 * r1 - p.scale_center_to_shell_edge_x * p.scale_center_to_shell_edge_x);
+
+    // prevent domain errors when sqrt_arg is the difference of two nearly equal numbers
+    if (sqrt_arg < 0.0 && std::fabs(sqrt_arg) <= 1e-7 * p.scale_center_to_shell_edge_x * p.scale_center_to_shell_edge_x)
+    {
+        sqrt_arg = 0.0;
+    }
+
+    const Real dy(p.scale_center_to_shell_y - std::sqrt(sqrt_arg));
+    const Real dz(p.scale_center_to_shell_z - x);
+    return dz * dz - p.shell_radius_sq + dy * dy;
+}
+
+template<typename Ttraits_>
+Real CylindricalShellScaling<Ttraits_>::edge_hits_edge_r1_eq(Real x, void* params)
+{
+    edge_hits_edge_params const& p(*static_cast<edge_hits_edge_params const*>(params));
+    Real sqrt_arg(x * x - p.scale_center_to_shell_edge_x * p.scale_center_to_shell_edge_x);
+
+    if (sqrt_arg < 0.0 && std::fabs(sqrt_arg) <= 1e-7 * p.scale_center_to_shell_edge_x * p.scale_center_to_shell_edge_x)
+    {
+        sqrt_arg = 0.0;
+    }
+
+    const Real dy(p.scale_center_to_shell_y - std::sqrt(sqrt_arg));
+    const Real dz(p.scale_center_to_shell_z - x / p.tan_scale_angle);
+    return dz * dz - p.shell_radius_sq + dy * dy;
+}
+
+template<typename Ttraits_>
+Real CylindricalShellScaling<Ttraits_>::find_edge_hits_edge_root(gsl_function& F, Real interval_min, Real interval_max)
+{
+    // The interval is enlarged with the factor tau^n starting from safe bounds, towards the bounds beyond
+    // which there are unwanted solutions, until F certainly changes sign within the interval.
+    const Real tau(std::min(1e-7, 0.5 * (interval_max - interval_min) / (interval_max + interval_min)));
+    const unsigned int nmax(100);
+
+    Real tau_n(tau), start, end;
+    for (unsigned int n(1);; ++n)
+    {
+        start = (1.0 + tau_n) * interval_min;
+        end   = (1.0 - tau_n) * interval_max;
+        if (!(GSL_FN_EVAL(&F, start) * GSL_FN_EVAL(&F, end) > 0.0))
+        {
+            break;
+        }
+        if (n >= nmax)
+        {
+            throw no_space("CylindricalShellScaling: Could not find suitable rootfinder boundaries in EDGE_HITS_EDGE cylinder scaling. nmax="
+                                + boost::lexical_cast<std::string>(nmax));
+        }
+        tau_n *= tau;
+    }
+
+    // freed also when findRoot throws.
+    const boost::shared_ptr<gsl_root_fsolver> solver(
+        gsl_root_fsolver_alloc(gsl_root_fsolver_brent), &gsl_root_fsolver_free);
+    return findRoot(F, solver.get(), start, end, 2e-12, 4 * std::numeric_limits<Real>::epsilon(),
+                    "CylindricalShellScaling::find_edge_hits_edge_root");
+}
+
+template<typename Ttraits_>
+Logger& CylindricalShellScaling<Ttraits_>::log_(Logger::get_logger("ecell.ShellScaling"));
+
+#endif /* SHELL_SCALING_HPP */
@@ -16,6 +16,19 @@ public:
     typedef typename traits_type::domain_id_type identifier_type;
     typedef typename traits_type::world_type::traits_type::D_type D_type;
 
+    // The outcome of the last closest-shell query around the particle of
+    // this single, together with the signature of the shell-matrix cells
+    // the query looked at (see EGFRDSimulator::get_closest_domain()).
+    struct neighborhood_cache
+    {
+        neighborhood_cache(): valid(false), signature(0) {}
+
+        bool valid;
+        position_type position;
+        unsigned long signature;
+        std::pair<identifier_type, length_type> closest;
+    };
+
 public:
     virtual ~Single() {}
 
@@ -38,8 +51,15 @@ public:
         return particle_.second.D();
     }
 
+    // a cache; may be updated through a const reference.
+    neighborhood_cache& neighborhood() const
+    {
+        return neighborhood_;
+    }
+
 protected:
     particle_id_pair particle_;
+    mutable neighborhood_cache neighborhood_;
 };
 
 #endif /* SINGLE_HPP */
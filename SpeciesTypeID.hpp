@@ -15,12 +15,12 @@
 #endif
 #include "Identifier.hpp"
 
-struct SpeciesTypeID: public Identifier<SpeciesTypeID, unsigned long long, int>
+struct SpeciesTypeID: public Identifier<SpeciesTypeID, identifier_serial_type, identifier_lot_type>
 // The SpeciesTypeID is an indentifier structure (same as class) for species types (species) but is also used for structure types
 // NOTE The superclass is parameterized with the SpeciesTypeID class itself.
 {
     // shorthand name for the super class
-    typedef Identifier<SpeciesTypeID, unsigned long long, int> base_type;
+    typedef Identifier<SpeciesTypeID, identifier_serial_type, identifier_lot_type> base_type;
 
     // The constructor
     SpeciesTypeID(value_type const& value = value_type(0, 0))
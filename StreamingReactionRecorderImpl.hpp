@@ -0,0 +1,369 @@
+#ifndef STREAMING_REACTION_RECORDER_IMPL_HPP
+#define STREAMING_REACTION_RECORDER_IMPL_HPP
+
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/format.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include "exceptions.hpp"
+#include "ReactionRecorder.hpp"
+
+// A ReactionRecorder that does not keep the records, but counts the
+// reactions per rule and writes the reactions of the selected rules as
+// compact binary records to a file (stream_to) and/or a ring buffer that
+// holds the last records (keep_last).
+//
+// A record is, in native byte order:
+//
+//   double     time (set_time; the propagators do not know it)
+//   int32      reaction rule id
+//   uint8      number of reactants, number of products, flags, (padding)
+//   reactants  uint64 serial, int32 lot each
+//   products   uint64 serial, int32 lot each
+//   positions  3 doubles per product, if flags & HAS_POSITIONS
+//
+// The positions of the products are looked up in the particle container,
+// if one is set.  The file starts with the 8 byte magic "EGFRDRR1",
+// followed by chunks of a uint32 size in bytes, a uint32 number of records
+// and the records; a chunk is written whenever chunk_size bytes of records
+// have been collected, and on flush() and close().
+template<typename Trr_, typename Tcontainer_>
+class StreamingReactionRecorderImpl
+    : public ReactionRecorder<Trr_>, boost::noncopyable
+{
+public:
+    typedef ReactionRecorder<Trr_> base_type;
+    typedef Trr_ reaction_record_type;
+    typedef Tcontainer_ particle_container_type;
+    typedef typename reaction_record_type::particle_id_type particle_id_type;
+    typedef typename reaction_record_type::reaction_rule_id_type reaction_rule_id_type;
+    typedef typename reaction_record_type::products_type products_type;
+    typedef typename particle_container_type::position_type position_type;
+    typedef double time_type;
+    typedef unsigned long long count_type;
+    typedef std::map<reaction_rule_id_type, count_type> counts_type;
+
+    enum flags
+    {
+        HAS_POSITIONS = 1
+    };
+
+public:
+    virtual ~StreamingReactionRecorderImpl()
+    {
+        if (file_)
+        {
+            write_chunk();
+            std::fclose(file_);
+        }
+    }
+
+    virtual void operator()(reaction_record_type const& rec)
+    {
+        record(rec.reaction_rule_id(), rec.reactants(), rec.products());
+    }
+
+    template<typename Treactants, typename Tproducts>
+    void record(reaction_rule_id_type const& rid,
+                Treactants const& reactants, Tproducts const& products)
+    {
+        ++counts_[rid];
+        ++total_;
+
+        last_rule_id_ = rid;
+        last_reactants_.assign(boost::begin(reactants), boost::end(reactants));
+        last_products_.assign(boost::begin(products), boost::end(products));
+
+        if (!is_selected(rid))
+        {
+            return;
+        }
+        ++streamed_;
+
+        if (!file_ && ring_.empty())
+        {
+            return;
+        }
+
+        encode();
+
+        if (file_)
+        {
+            chunk_.append(record_);
+            ++chunk_records_;
+            if (chunk_.size() >= chunk_size_)
+            {
+                flush();
+            }
+        }
+
+        if (!ring_.empty())
+        {
+            ring_[ring_pos_] = record_;
+            ring_pos_ = (ring_pos_ + 1) % ring_.size();
+            if (ring_count_ < ring_.size())
+            {
+                ++ring_count_;
+            }
+        }
+    }
+
+    time_type const& time() const
+    {
+        return time_;
+    }
+
+    void set_time(time_type const& time)
+    {
+        time_ = time;
+    }
+
+    void set_particle_container(particle_container_type const* container)
+    {
+        container_ = container;
+    }
+
+    // Only the reactions of the selected rules are streamed; as long as no
+    // rule is selected, all are.  The counters include all reactions.
+    void select(reaction_rule_id_type const& rid)
+    {
+        selected_.insert(rid);
+    }
+
+    void deselect(reaction_rule_id_type const& rid)
+    {
+        selected_.erase(rid);
+    }
+
+    void select_all()
+    {
+        selected_.clear();
+    }
+
+    bool is_selected(reaction_rule_id_type const& rid) const
+    {
+        return selected_.empty() || selected_.find(rid) != selected_.end();
+    }
+
+    count_type total() const
+    {
+        return total_;
+    }
+
+    count_type streamed() const
+    {
+        return streamed_;
+    }
+
+    count_type count(reaction_rule_id_type const& rid) const
+    {
+        typename counts_type::const_iterator i(counts_.find(rid));
+        return i != counts_.end() ? (*i).second: 0;
+    }
+
+    counts_type const& counts() const
+    {
+        return counts_;
+    }
+
+    void reset_counters()
+    {
+        counts_.clear();
+        total_ = 0;
+        streamed_ = 0;
+    }
+
+    // The last reaction, whether selected or not.
+    reaction_record_type last_record() const
+    {
+        switch (last_reactants_.size())
+        {
+        case 1:
+            return reaction_record_type(last_rule_id_, last_products_,
+                                        last_reactants_[0]);
+        case 2:
+            return reaction_record_type(last_rule_id_, last_products_,
+                                        last_reactants_[0], last_reactants_[1]);
+        }
+        return reaction_record_type();
+    }
+
+    void stream_to(std::string const& filename, std::size_t chunk_size)
+    {
+        close();
+
+        file_ = std::fopen(filename.c_str(), "wb");
+        if (!file_)
+        {
+            throw illegal_argument((boost::format("cannot open reaction log %s") % filename).str());
+        }
+        chunk_size_ = chunk_size;
+        chunk_.reserve(chunk_size + 1024);
+        if (std::fwrite("EGFRDRR1", 1, 8, file_) != 8)
+        {
+            throw illegal_state((boost::format("cannot write reaction log %s") % filename).str());
+        }
+        filename_ = filename;
+    }
+
+    void flush()
+    {
+        if (!file_)
+        {
+            return;
+        }
+        if (!write_chunk() || std::fflush(file_))
+        {
+            throw illegal_state((boost::format("cannot write reaction log %s") % filename_).str());
+        }
+    }
+
+    void close()
+    {
+        if (!file_)
+        {
+            return;
+        }
+        flush();
+        std::fclose(file_);
+        file_ = 0;
+    }
+
+    // Keep the last n streamed records in memory (0 to stop).
+    void keep_last(std::size_t n)
+    {
+        ring_.clear();
+        ring_.resize(n);
+        ring_pos_ = 0;
+        ring_count_ = 0;
+    }
+
+    // The records in the ring buffer, oldest first.
+    std::string buffer() const
+    {
+        std::string retval;
+        if (ring_.empty())
+        {
+            return retval;
+        }
+        std::size_t i((ring_pos_ + ring_.size() - ring_count_) % ring_.size());
+        for (std::size_t n(0); n < ring_count_; ++n)
+        {
+            retval.append(ring_[i]);
+            i = (i + 1) % ring_.size();
+        }
+        return retval;
+    }
+
+    StreamingReactionRecorderImpl(particle_container_type const* container = 0)
+        : container_(container), time_(0.), total_(0), streamed_(0),
+          last_rule_id_(), file_(0), chunk_size_(0), chunk_records_(0),
+          ring_pos_(0), ring_count_(0) {}
+
+private:
+    template<typename T>
+    void put(T const& value)
+    {
+        record_.append(reinterpret_cast<char const*>(&value), sizeof(T));
+    }
+
+    void put_id(particle_id_type const& pid)
+    {
+        put(static_cast<unsigned long long>(pid.serial()));
+        put(static_cast<int>(pid.lot()));
+    }
+
+    void encode()
+    {
+        bool has_positions(container_ != 0);
+        if (has_positions)
+        {
+            for (typename products_type::const_iterator i(last_products_.begin());
+                    i != last_products_.end(); ++i)
+            {
+                if (!container_->has_particle(*i))
+                {
+                    has_positions = false;
+                    break;
+                }
+            }
+        }
+
+        record_.clear();
+        put(static_cast<double>(time_));
+        put(static_cast<int>(last_rule_id_));
+        put(static_cast<unsigned char>(last_reactants_.size()));
+        put(static_cast<unsigned char>(last_products_.size()));
+        put(static_cast<unsigned char>(has_positions ? HAS_POSITIONS: 0));
+        put(static_cast<unsigned char>(0));
+
+        for (typename std::vector<particle_id_type>::const_iterator i(last_reactants_.begin());
+                i != last_reactants_.end(); ++i)
+        {
+            put_id(*i);
+        }
+        for (typename products_type::const_iterator i(last_products_.begin());
+                i != last_products_.end(); ++i)
+        {
+            put_id(*i);
+        }
+
+        if (has_positions)
+        {
+            for (typename products_type::const_iterator i(last_products_.begin());
+                    i != last_products_.end(); ++i)
+            {
+                position_type const pos(container_->get_particle(*i).second.position());
+                put(static_cast<double>(pos[0]));
+                put(static_cast<double>(pos[1]));
+                put(static_cast<double>(pos[2]));
+            }
+        }
+    }
+
+    bool write_chunk()
+    {
+        if (chunk_records_ == 0)
+        {
+            return true;
+        }
+        unsigned int const header[2] = { static_cast<unsigned int>(chunk_.size()),
+                                         static_cast<unsigned int>(chunk_records_) };
+        bool const ok(std::fwrite(header, sizeof(header), 1, file_) == 1 &&
+                      std::fwrite(chunk_.data(), 1, chunk_.size(), file_) == chunk_.size());
+        chunk_.clear();
+        chunk_records_ = 0;
+        return ok;
+    }
+
+private:
+    particle_container_type const* container_;
+    time_type time_;
+    std::set<reaction_rule_id_type> selected_;
+    counts_type counts_;
+    count_type total_;
+    count_type streamed_;
+
+    reaction_rule_id_type last_rule_id_;
+    std::vector<particle_id_type> last_reactants_;
+    products_type last_products_;
+
+    std::string record_;
+
+    std::FILE* file_;
+    std::string filename_;
+    std::size_t chunk_size_;
+    std::string chunk_;
+    std::size_t chunk_records_;
+
+    std::vector<std::string> ring_;
+    std::size_t ring_pos_;
+    std::size_t ring_count_;
+};
+
+#endif /* STREAMING_REACTION_RECORDER_IMPL_HPP */
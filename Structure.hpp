@@ -16,6 +16,7 @@
 #include "freeFunctions.hpp"
 #include "SpeciesTypeID.hpp"
 #include "StructureFunctions.hpp"
+#include "StructureDispatch.hpp"
 
 // Forward declarations
 template <typename Tobj_, typename Tid, typename Ttraits_>
@@ -102,6 +103,12 @@ public:
         return parent_struct_id_;
     }
 
+    // Get the kind (most derived class) of the structure
+    structure_kind kind() const
+    {
+        return kind_;
+    }
+
     virtual bool operator==(Structure const& rhs) const
     {
         return id_ == rhs.id() && sid_ == rhs.sid();
@@ -147,84 +154,57 @@ public:
     virtual position_flag_pair_type deflect(position_type const& pos0, position_type const& displacement) const = 0;
 //    virtual position_type deflect_back(position_type const& pos, position_type const& u_z) const = 0;
 
-    virtual position_structid_pair_type apply_boundary(position_structid_pair_type const& pos_struct_id,
-                                                       structure_container_type const& structure_container) const = 0;
-    virtual position_structid_pair_type cyclic_transpose(position_structid_pair_type const& pos_struct_id,
-                                                         structure_container_type const& structure_container) const = 0;
-                                                         
-    // *** Structure functions dynamic dispatch ***
+    // *** Boundary condition handling ***
+    // These are resolved statically on the kind of the structure (see StructureDispatch.hpp).
+    position_structid_pair_type apply_boundary(position_structid_pair_type const& pos_struct_id,
+                                               structure_container_type const& structure_container) const
+    {
+        return visit_structure(*this, apply_boundary_visitor(pos_struct_id, structure_container));
+    }
+    position_structid_pair_type cyclic_transpose(position_structid_pair_type const& pos_struct_id,
+                                                 structure_container_type const& structure_container) const
+    {
+        return visit_structure(*this, cyclic_transpose_visitor(pos_struct_id, structure_container));
+    }
+
+    // *** Structure functions dispatch ***
     // 
-    // FIXME For now the second dispatch requires the helper functions to be defined here for each structure type separately.
-    // This is because C++ does not allow virtual templates. The current solution is functional, but ugly, and may be replaced
-    // by a more elegant solution in the future.
+    // The structure functions (StructureFunctions.hpp) are defined for each combination of origin and target
+    // structure type. Both types are determined in one go by a static dispatch on the kinds of the two
+    // structures (see StructureDispatch.hpp).
     // 
     // *** 1 *** - Producing one new position
-    // First dispatch
-    virtual position_structid_pair_type get_pos_sid_pair(structure_type const& target_structure, position_type const& position,
-                                                         length_type const& offset, length_type const& rl, rng_type& rng) const = 0;
-    // Second dispatch
-    // The helper functions are the dispatch acceptors and have to be declared for each derived structure class because C++ does not support virtual templates.
-    virtual position_structid_pair_type get_pos_sid_pair_helper(CuboidalRegion<traits_type> const& origin_structure, position_type const& position,
-                                                        length_type const& offset, length_type const& rl, rng_type& rng) const = 0;
-    virtual position_structid_pair_type get_pos_sid_pair_helper(SphericalSurface<traits_type> const& origin_structure, position_type const& position,
-                                                        length_type const& offset, length_type const& rl, rng_type& rng) const = 0;
-    virtual position_structid_pair_type get_pos_sid_pair_helper(CylindricalSurface<traits_type> const& origin_structure, position_type const& position,
-                                                        length_type const& offset, length_type const& rl, rng_type& rng) const = 0;
-    virtual position_structid_pair_type get_pos_sid_pair_helper(DiskSurface<traits_type> const& origin_structure, position_type const& position,
-                                                        length_type const& offset, length_type const& rl, rng_type& rng) const = 0;
-    virtual position_structid_pair_type get_pos_sid_pair_helper(PlanarSurface<traits_type> const& origin_structure, position_type const& position,
-                                                        length_type const& offset, length_type const& rl, rng_type& rng) const = 0;
+    // This is called as a method of the origin structure.
+    position_structid_pair_type get_pos_sid_pair(structure_type const& target_structure, position_type const& position,
+                                                 length_type const& offset, length_type const& rl, rng_type& rng) const
+    {
+        return visit_structure_pair(*this, target_structure, get_pos_sid_pair_visitor(position, offset, rl, rng));
+    }
     // *** 2 *** - Producing two new positions
-    // First dispatch
-    virtual position_structid_pair_pair_type get_pos_sid_pair_pair(structure_type const& target_structure, position_type const& position,
-                                                                   species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const = 0;
-    // Second dispatch
-    // The helper functions are dispatch acceptors and have to be declared for each derived structure class because C++ does not support virtual templates.
-    virtual position_structid_pair_pair_type get_pos_sid_pair_pair_helper(CuboidalRegion<traits_type> const& origin_structure, position_type const& position,
-                                                                          species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const = 0;
-    virtual position_structid_pair_pair_type get_pos_sid_pair_pair_helper(SphericalSurface<traits_type> const& origin_structure, position_type const& position,
-                                                                          species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const = 0;
-    virtual position_structid_pair_pair_type get_pos_sid_pair_pair_helper(CylindricalSurface<traits_type> const& origin_structure, position_type const& position,
-                                                                          species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const = 0;
-    virtual position_structid_pair_pair_type get_pos_sid_pair_pair_helper(DiskSurface<traits_type> const& origin_structure, position_type const& position,
-                                                                          species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const = 0;
-    virtual position_structid_pair_pair_type get_pos_sid_pair_pair_helper(PlanarSurface<traits_type> const& origin_structure, position_type const& position,
-                                                                          species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const = 0;                                                                          
+    position_structid_pair_pair_type get_pos_sid_pair_pair(structure_type const& target_structure, position_type const& position,
+                                                           species_type const& s_orig, species_type const& s_targ, length_type const& rl, rng_type& rng) const
+    {
+        return visit_structure_pair(*this, target_structure, get_pos_sid_pair_pair_visitor(position, s_orig, s_targ, rl, rng));
+    }
     
     // *** 3 *** - Pair reactions => two origin structures
     // The following functions handle the case of two origin structures.
-    // First again the (C++) structure types have to be determined by a double dispatch.
-    // As a next step, the helper function has to determine which of the two structures
-    // is the target structure.
+    // After the (C++) structure types have been determined by the dispatch, get_pos_sid_pair_2o_visitor
+    // determines which of the two structures is the target structure.
     // For now, the target structure is either:
     //   - the lower hierarchy level structure, i.e. one of the origin structures has
     //     to be the daughter structure of the other and the particle will end up on
     //     the daughter structure; or:
     //   - in case of equal structure type id's it can end up on either origin structure
     //     and apply_boundary will handle the right placement afterwards.
-       
-    // First dispatch
     // This is called as a method of origin_structure1 with origin_structure2 as an argument.
-    virtual position_structid_pair_type get_pos_sid_pair_2o(structure_type const& origin_structure2, structure_type_id_type const& target_sid, position_type const& CoM,
-                                                            length_type const& offset, length_type const& reaction_length, rng_type& rng) const = 0;
-//     // Some convenient method overloading; this is just a redirect to the above                                       
-//     virtual position_structid_pair_type get_pos_sid_pair(structure_type const& origin_structure2, structure_type_id_type const& target_sid, position_type const& CoM,
-//                                                          length_type const& offset, length_type const& reaction_length, rng_type& rng) const = 0;
-    // Second dispatch
-    // The helper functions are the dispatch acceptors and have to be declared for each derived structure class because C++ does not support virtual templates.
-    virtual position_structid_pair_type get_pos_sid_pair_2o_helper(CuboidalRegion<traits_type> const& origin_structure1, structure_type_id_type const& target_sid, position_type const& CoM,
-                                                                   length_type const& offset, length_type const& reaction_length, rng_type& rng) const = 0;
-    virtual position_structid_pair_type get_pos_sid_pair_2o_helper(SphericalSurface<traits_type> const& origin_structure1, structure_type_id_type const& target_sid, position_type const& CoM,
-                                                                   length_type const& offset, length_type const& reaction_length, rng_type& rng) const = 0;
-    virtual position_structid_pair_type get_pos_sid_pair_2o_helper(CylindricalSurface<traits_type> const& origin_structure1, structure_type_id_type const& target_sid, position_type const& CoM,
-                                                                   length_type const& offset, length_type const& reaction_length, rng_type& rng) const = 0;
-    virtual position_structid_pair_type get_pos_sid_pair_2o_helper(DiskSurface<traits_type> const& origin_structure1, structure_type_id_type const& target_sid, position_type const& CoM,
-                                                                   length_type const& offset, length_type const& reaction_length, rng_type& rng) const = 0;
-    virtual position_structid_pair_type get_pos_sid_pair_2o_helper(PlanarSurface<traits_type> const& origin_structure1, structure_type_id_type const& target_sid, position_type const& CoM,
-                                                                   length_type const& offset, length_type const& reaction_length, rng_type& rng) const = 0;
+    position_structid_pair_type get_pos_sid_pair_2o(structure_type const& origin_structure2, structure_type_id_type const& target_sid, position_type const& CoM,
+                                                    length_type const& offset, length_type const& reaction_length, rng_type& rng) const
+    {
+        return visit_structure_pair(*this, origin_structure2, get_pos_sid_pair_2o_visitor(target_sid, CoM, offset, reaction_length, rng));
+    }
     
-    // Some further helper functions used by template<typename Tstruct_> get_pos_sid_pair_helper_two_origins_any(...),
-    // which is the final dispatch template defined in each of the derived classes and makes use of the two following checker functions:
+    // Some further helper functions used by get_pos_sid_pair_2o_visitor:
     template<typename Tstruct_>
     inline bool is_parent_of_or_has_same_sid_as(Tstruct_ const& s) const
     {    
@@ -298,8 +278,157 @@ public:
     }
 
     // Constructor
+    // The kind is filled in by the constructor of the most derived class.
     Structure(structure_name_type const& name, structure_type_id_type const& sid, structure_id_type const& parent_struct_id)
-        : name_(name), sid_(sid), parent_struct_id_(parent_struct_id) {}
+        : name_(name), sid_(sid), parent_struct_id_(parent_struct_id), kind_(NUM_STRUCTURE_KINDS) {}
+
+private:
+    // Visitors used with visit_structure and visit_structure_pair.
+    struct apply_boundary_visitor
+    {
+        typedef position_structid_pair_type result_type;
+
+        apply_boundary_visitor(position_structid_pair_type const& pos_struct_id, structure_container_type const& structure_container)
+            : pos_struct_id_(pos_struct_id), structure_container_(structure_container) {}
+
+        result_type operator()(CuboidalRegion<traits_type> const&) const
+        {
+            return pos_struct_id_;
+        }
+        result_type operator()(SphericalSurface<traits_type> const&) const
+        {
+            return pos_struct_id_;
+        }
+        // FIXME This is a mess but it works. See ParticleContainerBase.hpp for explanation.
+        result_type operator()(CylindricalSurface<traits_type> const& structure) const
+        {
+            return structure_container_.apply_boundary(structure, pos_struct_id_);
+        }
+        result_type operator()(DiskSurface<traits_type> const&) const
+        {
+            return pos_struct_id_;   // This seems a little strange, but we assume that particles are immobile on the disk
+        }
+        result_type operator()(PlanarSurface<traits_type> const& structure) const
+        {
+            return structure_container_.apply_boundary(structure, pos_struct_id_);
+        }
+
+        position_structid_pair_type const& pos_struct_id_;
+        structure_container_type const& structure_container_;
+    };
+
+    struct cyclic_transpose_visitor
+    {
+        typedef position_structid_pair_type result_type;
+
+        cyclic_transpose_visitor(position_structid_pair_type const& pos_struct_id, structure_container_type const& structure_container)
+            : pos_struct_id_(pos_struct_id), structure_container_(structure_container) {}
+
+        result_type operator()(CuboidalRegion<traits_type> const&) const
+        {
+            return pos_struct_id_;       // The cyclic_transpose does nothing because we'll apply world cyclic transpose later.
+        }
+        result_type operator()(SphericalSurface<traits_type> const&) const
+        {
+            return pos_struct_id_;       // Two spherical surface cannot be connected (there is no boundary!)
+        }
+        result_type operator()(CylindricalSurface<traits_type> const&) const
+        {
+            return pos_struct_id_;       // for now we do not support connected cylindrical surfaces.
+        }
+        result_type operator()(DiskSurface<traits_type> const&) const
+        {
+            return pos_struct_id_;       // Disks can also not be connected, so no cyclic transpose.
+        }
+        result_type operator()(PlanarSurface<traits_type> const& structure) const
+        {
+            return structure_container_.cyclic_transpose(structure, pos_struct_id_);
+        }
+
+        position_structid_pair_type const& pos_struct_id_;
+        structure_container_type const& structure_container_;
+    };
+
+    struct get_pos_sid_pair_visitor
+    {
+        typedef position_structid_pair_type result_type;
+
+        get_pos_sid_pair_visitor(position_type const& position, length_type const& offset, length_type const& rl, rng_type& rng)
+            : position_(position), offset_(offset), rl_(rl), rng_(rng) {}
+
+        template<typename Torigin_, typename Ttarget_>
+        result_type operator()(Torigin_ const& origin_structure, Ttarget_ const& target_structure) const
+        {
+            // redirect to structure function with well-defined typing
+            return ::get_pos_sid_pair<traits_type>(origin_structure, target_structure, position_, offset_, rl_, rng_);
+        }
+
+        position_type const& position_;
+        length_type const& offset_;
+        length_type const& rl_;
+        rng_type& rng_;
+    };
+
+    struct get_pos_sid_pair_pair_visitor
+    {
+        typedef position_structid_pair_pair_type result_type;
+
+        get_pos_sid_pair_pair_visitor(position_type const& position, species_type const& s_orig, species_type const& s_targ,
+                                      length_type const& rl, rng_type& rng)
+            : position_(position), s_orig_(s_orig), s_targ_(s_targ), rl_(rl), rng_(rng) {}
+
+        template<typename Torigin_, typename Ttarget_>
+        result_type operator()(Torigin_ const& origin_structure, Ttarget_ const& target_structure) const
+        {
+            // redirect to structure function with well-defined typing
+            return ::get_pos_sid_pair_pair<traits_type>(origin_structure, target_structure, position_, s_orig_, s_targ_, rl_, rng_);
+        }
+
+        position_type const& position_;
+        species_type const& s_orig_;
+        species_type const& s_targ_;
+        length_type const& rl_;
+        rng_type& rng_;
+    };
+
+    struct get_pos_sid_pair_2o_visitor
+    {
+        typedef position_structid_pair_type result_type;
+
+        get_pos_sid_pair_2o_visitor(structure_type_id_type const& target_sid, position_type const& CoM, length_type const& offset,
+                                    length_type const& reaction_length, rng_type& rng)
+            : target_sid_(target_sid), CoM_(CoM), offset_(offset), reaction_length_(reaction_length), rng_(rng) {}
+
+        template<typename Tstruct1_, typename Tstruct2_>
+        result_type operator()(Tstruct1_ const& origin_structure1, Tstruct2_ const& origin_structure2) const
+        {
+            // 1 - Check whether one of the structures is the parent of the other. If yes, the daughter structure is the target.
+            if( origin_structure2.is_parent_of_or_has_same_sid_as(origin_structure1) && origin_structure1.has_valid_target_sid(target_sid_) )
+                // origin_structure1 is target
+                return ::get_pos_sid_pair<traits_type>(origin_structure2, origin_structure1, CoM_, offset_, reaction_length_, rng_);
+                
+            else if( origin_structure1.is_parent_of_or_has_same_sid_as(origin_structure2) && origin_structure2.has_valid_target_sid(target_sid_) )
+                // origin_structure2 is target
+                return ::get_pos_sid_pair<traits_type>(origin_structure1, origin_structure2, CoM_, offset_, reaction_length_, rng_);
+            
+            // 2 - Check which structures has the lower dimensionality / particle degrees of freedom, and put the product there.
+            else if( origin_structure1.shape().dof() < origin_structure2.shape().dof() && origin_structure1.has_valid_target_sid(target_sid_) )
+                // origin_structure1 is target
+                return ::get_pos_sid_pair<traits_type>(origin_structure2, origin_structure1, CoM_, offset_, reaction_length_, rng_);
+            
+            else if( origin_structure2.shape().dof() < origin_structure1.shape().dof() && origin_structure2.has_valid_target_sid(target_sid_) )
+                // origin_structure2 is target
+                return ::get_pos_sid_pair<traits_type>(origin_structure1, origin_structure2, CoM_, offset_, reaction_length_, rng_);
+            
+            else throw propagation_error("Invalid target structure type: does not match product species structure type or has wrong hierarchy or dimensionality.");
+        }
+
+        structure_type_id_type const& target_sid_;
+        position_type const& CoM_;
+        length_type const& offset_;
+        length_type const& reaction_length_;
+        rng_type& rng_;
+    };
 
 ////// Member variables
 protected:
@@ -307,6 +436,7 @@ protected:
     structure_type_id_type  sid_;               // id of the structure_type of the structure    
     structure_id_type       id_;                // id of the structure (filled in later)
     structure_id_type       parent_struct_id_;  // id of the parent structure (filled in later)    
+    structure_kind          kind_;              // kind of the most derived class (see StructureDispatch.hpp)
 };
 
 
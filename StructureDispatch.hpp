@@ -0,0 +1,110 @@
+#ifndef STRUCTURE_DISPATCH_HPP
+#define STRUCTURE_DISPATCH_HPP
+
+#include "exceptions.hpp"
+
+// Static dispatch over the closed set of structure classes.
+//
+// Every Structure carries the kind of its most derived class, so operations
+// on one or two structures can be resolved with a single switch (compiled
+// to an indexed jump) into fully typed code, instead of going through one
+// or two levels of virtual calls.  Adding a structure class means adding a
+// kind here and a case to the tables below.
+
+template<typename T_>
+class Structure;
+
+template<typename T_>
+class CuboidalRegion;
+
+template<typename T_>
+class SphericalSurface;
+
+template<typename T_>
+class CylindricalSurface;
+
+template<typename T_>
+class DiskSurface;
+
+template<typename T_>
+class PlanarSurface;
+
+enum structure_kind
+{
+    CUBOIDAL_REGION = 0,
+    SPHERICAL_SURFACE,
+    CYLINDRICAL_SURFACE,
+    DISK_SURFACE,
+    PLANAR_SURFACE,
+    NUM_STRUCTURE_KINDS
+};
+
+template<template<typename> class Tstruct_>
+struct structure_kind_of;
+
+template<> struct structure_kind_of<CuboidalRegion>      { enum { value = CUBOIDAL_REGION }; };
+template<> struct structure_kind_of<SphericalSurface>    { enum { value = SPHERICAL_SURFACE }; };
+template<> struct structure_kind_of<CylindricalSurface>  { enum { value = CYLINDRICAL_SURFACE }; };
+template<> struct structure_kind_of<DiskSurface>         { enum { value = DISK_SURFACE }; };
+template<> struct structure_kind_of<PlanarSurface>       { enum { value = PLANAR_SURFACE }; };
+
+// Calls fun(s) with s cast to its most derived type.
+template<typename Ttraits_, typename Tfun_>
+inline typename Tfun_::result_type
+visit_structure(Structure<Ttraits_> const& s, Tfun_ const& fun)
+{
+    switch (s.kind())
+    {
+    case CUBOIDAL_REGION:
+        return fun(static_cast<CuboidalRegion<Ttraits_> const&>(s));
+    case SPHERICAL_SURFACE:
+        return fun(static_cast<SphericalSurface<Ttraits_> const&>(s));
+    case CYLINDRICAL_SURFACE:
+        return fun(static_cast<CylindricalSurface<Ttraits_> const&>(s));
+    case DISK_SURFACE:
+        return fun(static_cast<DiskSurface<Ttraits_> const&>(s));
+    case PLANAR_SURFACE:
+        return fun(static_cast<PlanarSurface<Ttraits_> const&>(s));
+    default:
+        break;
+    }
+    throw not_implemented("unsupported structure kind");
+}
+
+// Calls fun(s0, s1) with both structures cast to their most derived types.
+template<typename Ttraits_, typename Tfun_>
+inline typename Tfun_::result_type
+visit_structure_pair(Structure<Ttraits_> const& s0, Structure<Ttraits_> const& s1,
+                     Tfun_ const& fun)
+{
+#define STRUCTURE_DISPATCH_CASE(T0, T1) \
+    case structure_kind_of<T0>::value * NUM_STRUCTURE_KINDS + structure_kind_of<T1>::value: \
+        return fun(static_cast<T0<Ttraits_> const&>(s0), \
+                   static_cast<T1<Ttraits_> const&>(s1));
+#define STRUCTURE_DISPATCH_ROW(T0) \
+    STRUCTURE_DISPATCH_CASE(T0, CuboidalRegion) \
+    STRUCTURE_DISPATCH_CASE(T0, SphericalSurface) \
+    STRUCTURE_DISPATCH_CASE(T0, CylindricalSurface) \
+    STRUCTURE_DISPATCH_CASE(T0, DiskSurface) \
+    STRUCTURE_DISPATCH_CASE(T0, PlanarSurface)
+
+    if (s0.kind() < NUM_STRUCTURE_KINDS && s1.kind() < NUM_STRUCTURE_KINDS)
+    {
+        switch (s0.kind() * NUM_STRUCTURE_KINDS + s1.kind())
+        {
+        STRUCTURE_DISPATCH_ROW(CuboidalRegion)
+        STRUCTURE_DISPATCH_ROW(SphericalSurface)
+        STRUCTURE_DISPATCH_ROW(CylindricalSurface)
+        STRUCTURE_DISPATCH_ROW(DiskSurface)
+        STRUCTURE_DISPATCH_ROW(PlanarSurface)
+        default:
+            break;
+        }
+    }
+    throw not_implemented("unsupported structure kind");
+
+#undef STRUCTURE_DISPATCH_ROW
+#undef STRUCTURE_DISPATCH_CASE
+}
+
+#endif /* STRUCTURE_DISPATCH_HPP */
@@ -15,10 +15,10 @@
 #endif
 #include "Identifier.hpp"
 
-struct StructureID: public Identifier<StructureID, unsigned long long, int>
+struct StructureID: public Identifier<StructureID, identifier_serial_type, identifier_lot_type>
 // The StructureID is a class for the identification of structures
 {
-    typedef Identifier<StructureID, unsigned long long, int> base_type;
+    typedef Identifier<StructureID, identifier_serial_type, identifier_lot_type> base_type;
 
     StructureID(value_type const& value = value_type(0, 0))
         : base_type(value) {}
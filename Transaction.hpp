@@ -9,6 +9,7 @@
 #include "ParticleContainer.hpp"
 #include "sorted_list.hpp"
 #include "generator.hpp"
+#include "utils/memory_usage.hpp"
 #include "utils/unassignable_adapter.hpp"
 #include "utils/stringizer.hpp"
 
@@ -352,6 +353,17 @@ public:
         return pc_.cyclic_transpose(pos_struct_id, structure);
     }
 
+    // The ids of the added, modified and removed particles and the copies of
+    // the original particles kept for rollback().
+    memory_usage_type memory_usage() const
+    {
+        memory_usage_type retval(node_memory_usage(orig_particles_));
+        add_memory_usage(retval, vector_memory_usage(added_particles_.container()));
+        add_memory_usage(retval, vector_memory_usage(modified_particles_.container()));
+        add_memory_usage(retval, vector_memory_usage(removed_particles_.container()));
+        return retval;
+    }
+
     virtual ~TransactionImpl() {}
 
     TransactionImpl(particle_container_type& pc): pc_(pc) {}
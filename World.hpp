@@ -12,6 +12,7 @@
 #include <boost/type_traits/is_same.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/foreach.hpp>
+#include "Defs.hpp"
 #include "exceptions.hpp"
 #include "generator.hpp"
 #include "filters.hpp"
@@ -117,6 +118,14 @@ public:
         oc.each_neighbor(oc.index(pos), fun);
     }
 
+    // Calls fun(i, distance) instead of fun(i, offset); see
+    // MatrixSpace::each_neighbor_distance.
+    template<typename Toc_, typename Tfun_, typename Tpos_>
+    static void each_neighbor_distance(Toc_ const& oc, Tfun_& fun, Tpos_ const& pos)
+    {
+        oc.each_neighbor_distance(pos, fun);
+    }
+
     template<typename Toc_, typename Tfun_, typename Tsphere_>
     static void take_neighbor(Toc_& oc, Tfun_& fun, const Tsphere_& cmp)
     {
@@ -181,6 +190,12 @@ public:
         oc.each_neighbor_cyclic(oc.index(pos), fun);
     }
 
+    template<typename Toc_, typename Tfun_, typename Tpos_>
+    static void each_neighbor_distance(Toc_ const& oc, Tfun_& fun, Tpos_ const& pos)
+    {
+        oc.each_neighbor_distance_cyclic(pos, fun);
+    }
+
     template<typename Toc_, typename Tfun_, typename Tsphere_>
     static void take_neighbor(Toc_& oc, Tfun_& fun, const Tsphere_& cmp)
     {
@@ -221,6 +236,7 @@ public:
     typedef typename traits_type::structure_id_generator    structure_id_generator;
     typedef typename traits_type::structure_type_type       structure_type_type;
     typedef typename traits_type::structure_type_id_type    structure_type_id_type;
+    typedef typename traits_type::rng_type                  rng_type;
 
     //
     typedef typename base_type::particle_id_pair                    particle_id_pair;      // defines the pid_particle_pair tuple
@@ -283,6 +299,91 @@ public:
         update_particle(retval);
         return retval;
     }
+    // To create n particles of species sid at random positions on the structures of its structure type,
+    // restricted to the box spanned by lower and upper.
+    // A position is rejected when the particle would overlap a particle (one already in the world or one placed
+    // earlier in this call) or, unless ignore_structure_overlaps is set, a structure. The accepted particles are
+    // collected in a separate matrix, which serves the overlap checks between them, and inserted in one batch.
+    // Throws no_space when max_trials positions in a row are rejected.
+    void throw_in_particles(species_id_type const& sid, size_type n, rng_type& rng,
+                            position_type const& lower, position_type const& upper,
+                            bool ignore_structure_overlaps, size_type max_trials)
+    {
+        PROFILE_SCOPE("World::throw_in_particles");
+        typedef typename base_type::particle_matrix_type particle_matrix_type;
+        typedef typename base_type::position_structid_pair_type position_structid_pair_type;
+        typedef typename base_type::structure_id_pair_and_distance_list structure_id_pair_and_distance_list;
+
+        species_type const& species(get_species(sid));
+        const structure_id_set structure_ids(get_structure_ids(species.structure_type_id()));
+        if (structure_ids.empty())
+        {
+            throw not_found(std::string("No structures of the structure_type of species (id=") +
+                            boost::lexical_cast<std::string>(sid) + ")");
+        }
+        std::vector<boost::shared_ptr<const structure_type> > structures;
+        BOOST_FOREACH(structure_id_type const& id, structure_ids)
+        {
+            structures.push_back(base_type::get_structure(id));
+        }
+
+        particle_matrix_type placed(base_type::world_size(), base_type::matrix_size());
+        size_type trials(0);
+        while (placed.size() < n)
+        {
+            if (++trials > max_trials)
+            {
+                throw no_space(std::string("Could not place particle of species (id=") +
+                               boost::lexical_cast<std::string>(sid) + ") after " +
+                               boost::lexical_cast<std::string>(max_trials) + " trials");
+            }
+
+            boost::shared_ptr<const structure_type> const& structure(
+                structures[rng.uniform_int(0, structures.size() - 1)]);
+            const position_type pos(structure->random_position(rng));
+            // Reject positions outside the box before and after applying the boundary conditions.
+            if (!within_box(pos, lower, upper))
+            {
+                continue;
+            }
+            const position_structid_pair_type pos_struct_id(
+                this->apply_boundary(std::make_pair(pos, structure->id())));
+            if (!within_box(pos_struct_id.first, lower, upper))
+            {
+                continue;
+            }
+
+            const particle_shape_type shape(pos_struct_id.first, species.radius());
+            if (overlaps(base_type::pmat_, shape) || overlaps(placed, shape))
+            {
+                continue;
+            }
+            if (!ignore_structure_overlaps)
+            {
+                boost::scoped_ptr<structure_id_pair_and_distance_list> surface_overlaps(
+                    this->check_surface_overlap(
+                        particle_shape_type(pos_struct_id.first, species.radius() * MINIMAL_SEPARATION_FACTOR),
+                        pos_struct_id.first, pos_struct_id.second, species.radius()));
+                if (surface_overlaps && surface_overlaps->size() > 0)
+                {
+                    continue;
+                }
+            }
+
+            placed.update(particle_id_pair(pidgen_(),
+                                           particle_type(sid, shape, pos_struct_id.second,
+                                                         species.D(), species.v())));
+            trials = 0;
+        }
+
+        base_type::pmat_.insert(placed.begin(), placed.end());
+        particle_id_set& species_pool(particle_pool_[sid]);
+        for (typename particle_matrix_type::const_iterator i(placed.begin()), e(placed.end()); i != e; ++i)
+        {
+            species_pool.insert((*i).first);
+            particleonstruct_pool_[(*i).second.structure_id()].insert((*i).first);
+        }
+    }
     // To update particles
     virtual bool update_particle(particle_id_pair const& pi_pair)
     {
@@ -455,6 +556,22 @@ public:
         return (*i).second;
     }
     
+    // The particle matrix plus the per species and per structure particle
+    // id sets.
+    memory_usage_type memory_usage() const
+    {
+        memory_usage_type retval(base_type::memory_usage());
+        BOOST_FOREACH (typename per_species_particle_id_set::value_type const& i, particle_pool_)
+        {
+            add_memory_usage(retval, node_memory_usage(i.second));
+        }
+        BOOST_FOREACH (typename per_structure_particle_id_set::value_type const& i, particleonstruct_pool_)
+        {
+            add_memory_usage(retval, node_memory_usage(i.second));
+        }
+        return retval;
+    }
+
     // Get and set the default structure of the World
     // The getter
     virtual structure_id_type get_def_structure_id() const
@@ -536,6 +653,41 @@ public:
         default_structure_type_id_ = sid;
     }
 
+private:
+    // Flags any item reported by take_neighbor.
+    struct overlap_detector
+    {
+        template<typename Titer_>
+        void operator()(Titer_ const&, length_type const&)
+        {
+            found = true;
+        }
+
+        overlap_detector(): found(false) {}
+
+        bool found;
+    };
+
+    template<typename Tmatrix_>
+    static bool overlaps(Tmatrix_ const& matrix, particle_shape_type const& shape)
+    {
+        overlap_detector detector;
+        traits_type::take_neighbor(matrix, detector, shape);
+        return detector.found;
+    }
+
+    static bool within_box(position_type const& pos, position_type const& lower, position_type const& upper)
+    {
+        for (std::size_t i(0); i < 3; ++i)
+        {
+            if (pos[i] < lower[i] || pos[i] > upper[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
 ///////////// Member variables
 private:
     particle_id_generator               pidgen_;            // generator used to produce the unique ids for the particles
@@ -57,6 +57,11 @@ class BDSimulatorCore(object):
         self.step_counter = 0
         self.reaction_events = 0
 
+        # counts the reactions without calling back into Python; can be
+        # replaced by one that also streams them (see
+        # StreamingReactionRecorder).
+        self.reaction_recorder = _gfrd.StreamingReactionRecorder()
+
     def initialize(self):
         self.determine_dt()
 
@@ -76,17 +81,20 @@ class BDSimulatorCore(object):
     def step(self):
         self.step_counter += 1
 
-        def increment_reaction_events(rr):
-            self.reaction_events += 1
-
         def dummy(shape, ignore0, ignore1=None):
             return True
 
+        rrec = self.reaction_recorder
+        rrec.time = self.t
+        reactions = rrec.total
+
         ppg = _gfrd.newBDPropagator(self.world, self.network_rules,
                      self.rng, self.dt, self.dissociation_retry_moves,
-                     increment_reaction_events, dummy, self.world.particle_ids)
+                     rrec, dummy, self.world.particle_ids)
         ppg.propagate_all()
 
+        self.reaction_events += rrec.total - reactions
+
         self.t += self.dt
 
     def check(self):
@@ -129,6 +137,14 @@ class BDSimulator(ParticleSimulatorBase):
 
     dt_factor = property(get_dt_factor, set_dt_factor)
 
+    def get_reaction_recorder(self):
+        return self.core.reaction_recorder
+
+    def set_reaction_recorder(self, reaction_recorder):
+        self.core.reaction_recorder = reaction_recorder
+
+    reaction_recorder = property(get_reaction_recorder, set_reaction_recorder)
+
 
     def initialize(self):
         self.core.initialize()
@@ -0,0 +1,152 @@
+#!/usr/env python
+
+import math
+
+__all__ = [ 'BDZones', 'bd_time_step' ]
+
+
+def bd_time_step(radius, D, step_size_factor):
+    # The time step of a Multi holding only this particle, as set by the
+    # diffusive part of determine_dt_and_reaction_length (Multi.hpp).
+    return 2.0 * (step_size_factor * radius) ** 2 / D
+
+
+class BDZones(object):
+    """Density-adaptive BD zones.
+
+    The world is divided into nbins^3 cells.  For every cell an
+    exponential moving average is kept of the cost ratio of eGFRD over BD:
+    the BD time step of a particle divided by the time step of the domain
+    made for it there, i.e. the number of domain events per BD step (see
+    record_domain).  Inside BD zones, where no analytical
+    domains are made, the ratio is estimated from the free space around
+    the particles of the Multis instead (see sample_multi).
+
+    A cell is promoted to a BD zone once its average exceeds 'promote',
+    and demoted again once it drops below 'demote'; with demote < promote
+    cells do not flip back and forth around a single threshold.  Cells
+    only change after 'min_samples' samples since the last change.
+
+    Cells are only created when sampled, so sparse systems keep few.
+
+    """
+
+    # The ratio recorded for particles that could not get a domain with a
+    # time step of their own (that went into a Multi).
+    MAX_RATIO = 10.0
+
+    def __init__(self, world_size, nbins=10, promote=1.0, demote=0.1,
+                 memory=20, min_samples=10, sample_interval=10):
+
+        if not demote < promote:
+            raise ValueError('demote (%g) must be smaller than promote (%g)' %
+                             (demote, promote))
+
+        self.world_size      = world_size
+        self.nbins           = nbins
+        self.cell_size       = float(world_size) / nbins
+        self.promote         = promote
+        self.demote          = demote
+        self.weight          = 1.0 / memory
+        self.min_samples     = min_samples
+        self.sample_interval = sample_interval
+
+        # cell index -> [average ratio, samples since last change, is BD zone]
+        self.cells = {}
+
+        self.promotions = 0
+        self.demotions  = 0
+
+    def cell_index(self, pos):
+        return tuple(int(math.floor(pos[d] / self.cell_size)) % self.nbins
+                     for d in [0, 1, 2])
+
+    def is_bd_zone(self, pos):
+        cell = self.cells.get(self.cell_index(pos))
+        return cell is not None and cell[2]
+
+    def record(self, pos, ratio):
+        """Add a sample of the cost ratio at pos; returns True if this
+        changed whether the cell is a BD zone."""
+
+        index = self.cell_index(pos)
+        cell = self.cells.get(index)
+        if cell is None:
+            cell = [ratio, 0, False]
+            self.cells[index] = cell
+        else:
+            cell[0] += self.weight * (ratio - cell[0])
+        cell[1] += 1
+
+        if cell[1] < self.min_samples:
+            return False
+
+        if not cell[2] and cell[0] > self.promote:
+            cell[2] = True
+            self.promotions += 1
+        elif cell[2] and cell[0] < self.demote:
+            cell[2] = False
+            self.demotions += 1
+        else:
+            return False
+
+        cell[1] = 0
+        return True
+
+    def record_domain(self, pos, dt, bd_dt):
+        """Record the time step dt of the domain just made for the particle
+        at pos, whose BD time step would be bd_dt; a dt of zero stands for
+        a Multi."""
+
+        if dt > 0.0:
+            self.record(pos, min(bd_dt / dt, self.MAX_RATIO))
+        else:
+            self.record(pos, self.MAX_RATIO)
+
+    def sample_multi(self, multi, world, step_size_factor):
+        """Every sample_interval steps of the multi, record the cost ratio
+        for each of its particles as estimated from the free space around
+        it: a single there would get about half the gap to the closest
+        other particle.  Returns True if the multi was sampled."""
+
+        if multi.num_steps % self.sample_interval:
+            return False
+
+        for pid, particle in multi.particle_container:
+            if particle.D <= 0.0:
+                continue
+
+            radius = particle.radius
+            # look twice as far as the gap at which the ratio drops below
+            # the demotion threshold.
+            probe = radius * (1.0 + 4.0 * step_size_factor /
+                              math.sqrt(self.demote))
+            neighbors = world.check_overlap((particle.position, probe), pid)
+            if neighbors:
+                gap = max(neighbors[0][1] - radius, 0.0)
+            else:
+                gap = probe - radius
+
+            if gap > 0.0:
+                ratio = min((2.0 * step_size_factor * radius / gap) ** 2,
+                            self.MAX_RATIO)
+            else:
+                ratio = self.MAX_RATIO
+            self.record(particle.position, ratio)
+
+        return True
+
+    def releases(self, multi):
+        """True if none of the particles of the multi is in a BD zone any
+        longer."""
+        for pid, particle in multi.particle_container:
+            if self.is_bd_zone(particle.position):
+                return False
+        return True
+
+    def num_zones(self):
+        return len([cell for cell in self.cells.values() if cell[2]])
+
+    def __str__(self):
+        return 'BDZones(nbins=%d, zones=%d, promotions=%d, demotions=%d)' % \
+               (self.nbins, self.num_zones(), self.promotions, self.demotions)
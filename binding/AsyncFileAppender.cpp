@@ -0,0 +1,32 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <boost/python.hpp>
+#include "peer/util/gil.hpp"
+#include "binding_common.hpp"
+#include "../AsyncFileAppender.hpp"
+
+namespace binding {
+
+
+////// Registering master function
+boost::python::objects::class_base
+register_async_file_appender_class(char const* name)
+{
+    using namespace boost::python;
+    typedef AsyncFileAppender impl_type;
+
+    return class_<impl_type, bases<impl_type::base_type>,
+                  boost::shared_ptr<impl_type>, boost::noncopyable>(name,
+            init<std::string const&, optional<std::size_t, enum Logger::level> >())
+        .add_property("filename",
+            make_function(&impl_type::filename,
+                return_value_policy<copy_const_reference>()))
+        .add_property("capacity", &impl_type::capacity)
+        .add_property("dropped", &impl_type::dropped)
+        .def("flush", peer::util::release_gil(&impl_type::flush))
+        ;
+}
+
+} // namespace binding
@@ -0,0 +1,13 @@
+#ifndef BINDING_ASYNC_FILE_APPENDER_HPP
+#define BINDING_ASYNC_FILE_APPENDER_HPP
+
+#include <boost/python.hpp>
+
+namespace binding {
+
+boost::python::objects::class_base
+register_async_file_appender_class(char const* name);
+
+} // namespace binding
+
+#endif /* BINDING_ASYNC_FILE_APPENDER_HPP */
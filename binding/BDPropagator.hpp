@@ -6,6 +6,7 @@
 #include "peer/utils.hpp"
 #include "peer/wrappers/range/pyiterable_range.hpp"
 #include "peer/converters/sequence.hpp"
+#include "peer/util/gil.hpp"
 
 namespace binding {
 
@@ -13,6 +14,7 @@ namespace binding {
 template<typename Timpl_>
 static void BDPropagator_propagate_all(Timpl_& self)
 {
+    peer::util::gil_release nogil;
     while (self());
 }
 
@@ -48,7 +50,7 @@ inline boost::python::objects::class_base register_bd_propagator_class(char cons
             typename get_select_first_range<typename world_type::particle_id_pair_range>::type>())
         .add_property("rejected_move_count",
             &impl_type::get_rejected_move_count)
-        .def("__call__", &impl_type::operator())
+        .def("__call__", peer::util::release_gil(&impl_type::operator()))
         .def("propagate_all", &BDPropagator_propagate_all<impl_type>)
         ;
 }
@@ -1,12 +1,15 @@
 #ifndef EGFRD_SIMULATOR_HPP
 #define EGFRD_SIMULATOR_HPP
 
+#include <set>
+#include <boost/python/stl_iterator.hpp>
 #include <boost/variant/static_visitor.hpp>
 #include <boost/variant/apply_visitor.hpp>
 #include "peer/util/to_native_converter.hpp"
 #include "peer/wrappers/generator/generator_wrapper.hpp"
 #include "peer/converters/tuple.hpp"
 #include "peer/util/shared_const_ptr.hpp"
+#include "peer/util/reference_accessor_wrapper.hpp"
 
 namespace binding {
 
@@ -51,6 +54,21 @@ struct shell_variant_converter
     }
 };
 
+template<typename Timpl>
+static bool EGFRDSimulator_observe_species(Timpl& self,
+        typename Timpl::time_type upto, boost::python::object const& sids)
+{
+    typedef typename Timpl::species_id_type species_id_type;
+    std::set<species_id_type> _sids;
+    boost::python::stl_input_iterator<boost::python::object> end;
+    for (boost::python::stl_input_iterator<boost::python::object> i(sids);
+         i != end; ++i)
+    {
+        _sids.insert(boost::python::extract<species_id_type>(*i)());
+    }
+    return self.observe(upto, _sids);
+}
+
 
 ////// Registering master function
 template<typename Timpl>
@@ -107,7 +125,23 @@ void register_egfrd_simulator_class(char const* name)
         .def("num_single_steps_per_type", &impl_type::num_single_steps_per_type)
         .def("num_pair_steps_per_type", &impl_type::num_pair_steps_per_type)
         .def("num_multi_steps_per_type", &impl_type::num_multi_steps_per_type)
+        .def("num_avoided_bursts", &impl_type::num_avoided_bursts)
+        .def("observe", &EGFRDSimulator_observe_species<impl_type>)
+        .def("observe", static_cast<bool(impl_type::*)(typename impl_type::time_type, typename impl_type::particle_shape_type const&)>(&impl_type::observe))
         .def("check", &impl_type::check)
+        .def("check_touched", &impl_type::check_touched)
+        .add_property("full_check_interval",
+            make_function(
+                &peer::util::reference_accessor_wrapper<
+                    impl_type, unsigned int,
+                    &impl_type::full_check_interval,
+                    &impl_type::full_check_interval>::get,
+                return_value_policy<return_by_value>()),
+            make_function(
+                &peer::util::reference_accessor_wrapper<
+                    impl_type, unsigned int,
+                    &impl_type::full_check_interval,
+                    &impl_type::full_check_interval>::set))
         .def("__len__", &impl_type::num_domains)
         .def("__getitem__", &impl_type::get_domain)
         .def("__iter__", &impl_type::get_domains,
@@ -1,12 +1,41 @@
 #ifndef BINDING_PYEVENT_SCHEDULER_HPP
 #define BINDING_PYEVENT_SCHEDULER_HPP
 
+#include <iterator>
+#include <vector>
 #include <boost/python.hpp>
+#include <boost/python/stl_iterator.hpp>
 #include "peer/converters/tuple.hpp"
 #include "peer/converters/iterator.hpp"
 
 namespace binding {
 
+template<typename Timpl>
+static boost::python::list EventScheduler_add_events(Timpl& self,
+        boost::python::object const& events)
+{
+    typedef boost::shared_ptr<typename Timpl::Event> event_ptr;
+    std::vector<event_ptr> _events;
+    boost::python::stl_input_iterator<boost::python::object> end;
+    for (boost::python::stl_input_iterator<boost::python::object> i(events);
+         i != end; ++i)
+    {
+        _events.push_back(boost::python::extract<event_ptr>(*i)());
+    }
+
+    std::vector<typename Timpl::identifier_type> ids;
+    ids.reserve(_events.size());
+    self.add(_events.begin(), _events.end(), std::back_inserter(ids));
+
+    boost::python::list retval;
+    for (typename std::vector<typename Timpl::identifier_type>::const_iterator
+            i(ids.begin()); i != ids.end(); ++i)
+    {
+        retval.append(*i);
+    }
+    return retval;
+}
+
 
 ////// Registering master function
 template<typename Timpl>
@@ -40,8 +69,10 @@ register_event_scheduler_class(char const* name)
         .def("pop", &impl_type::pop,
             return_value_policy<return_by_value>())
         .def("clear", &impl_type::clear)
-        .def("add", &impl_type::add)
+        .def("add", static_cast<typename impl_type::identifier_type(impl_type::*)(boost::shared_ptr<typename impl_type::Event> const&)>(&impl_type::add))
+        .def("add_events", &EventScheduler_add_events<impl_type>)
         .def("check", &impl_type::check)
+        .def("memory_usage", &impl_type::memory_usage)
         .def("__getitem__", &impl_type::get,
             return_value_policy<return_by_value>())
         .def("__delitem__", &impl_type::remove)
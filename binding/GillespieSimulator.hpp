@@ -0,0 +1,68 @@
+#ifndef BINDING_GILLESPIE_SIMULATOR_HPP
+#define BINDING_GILLESPIE_SIMULATOR_HPP
+
+#include <boost/python.hpp>
+#include "peer/util/shared_const_ptr.hpp"
+#include "peer/util/gil.hpp"
+
+namespace binding {
+
+template<typename Timpl_>
+static boost::python::list GillespieSimulator_get_species_ids(Timpl_ const& impl)
+{
+    boost::python::list retval;
+    for (typename std::vector<typename Timpl_::species_id_type>::const_iterator
+            i(impl.get_species_ids().begin()), e(impl.get_species_ids().end());
+         i != e; ++i)
+    {
+        retval.append(*i);
+    }
+    return retval;
+}
+
+////// Registering master function
+template<typename Timpl_>
+void register_gillespie_simulator_class(char const* name)
+{
+    using namespace boost::python;
+    typedef Timpl_ impl_type;
+
+    class_<impl_type, boost::noncopyable>(
+            name,
+            init<typename impl_type::model_type const&,
+                 boost::shared_ptr<typename impl_type::network_rules_type const>,
+                 typename impl_type::rng_type&, Real>()[
+                    with_custodian_and_ward<1, 2,
+                        with_custodian_and_ward<1, 4> >()])
+        .def(init<typename impl_type::model_type const&,
+                 boost::shared_ptr<typename impl_type::network_rules_type const>,
+                 typename impl_type::rng_type&, Real, bool>()[
+                    with_custodian_and_ward<1, 2,
+                        with_custodian_and_ward<1, 4> >()])
+        .add_property("t", &impl_type::t)
+        .add_property("dt", &impl_type::dt)
+        .add_property("next_time", &impl_type::next_time)
+        .add_property("num_steps", &impl_type::num_steps)
+        .add_property("volume", &impl_type::volume, &impl_type::set_volume)
+        .add_property("num_reaction_rules", &impl_type::num_reaction_rules)
+        .add_property("last_reaction",
+            make_function(&impl_type::last_reaction,
+                return_value_policy<return_by_value>()))
+        .def("initialize", &impl_type::initialize)
+        .def("step", peer::util::release_gil(static_cast<void(impl_type::*)()>(&impl_type::step)))
+        .def("step", peer::util::release_gil(static_cast<bool(impl_type::*)(typename impl_type::time_type)>(&impl_type::step)))
+        .def("get_pool_size", &impl_type::get_pool_size)
+        .def("throw_in_particles", &impl_type::throw_in_particles)
+        .def("remove_particles", &impl_type::remove_particles)
+        .def("get_species_ids", &GillespieSimulator_get_species_ids<impl_type>)
+        .def("get_rate", &impl_type::get_rate)
+        .def("num_firings", &impl_type::num_firings)
+        .def("check", &impl_type::check)
+        ;
+
+    peer::util::register_shared_const_ptr_from_python<typename impl_type::network_rules_type>();
+}
+
+} // namespace binding
+
+#endif /* BINDING_GILLESPIE_SIMULATOR_HPP */
@@ -298,22 +298,60 @@ public:
         build_all_neighbors_array(result_type& retval,
                 impl_type const& cntnr, const position_type& pos)
         {
-            distance_calculator distance(pos);
-            all_neighbors_collector<distance_calculator> col(retval, distance);
-            cntnr.each_neighbor(cntnr.index(pos), col);
+            collect_all_neighbors(retval, cntnr, pos,
+                typename has_distance_kernel<impl_type>::type());
             std::sort(retval.begin(), retval.end(), distance_comparator());
         }
 
         inline static void
         build_all_neighbors_array_cyclic(result_type& retval,
                 impl_type const& cntnr, const position_type& pos)
+        {
+            collect_all_neighbors_cyclic(retval, cntnr, pos,
+                typename has_distance_kernel<impl_type>::type());
+            std::sort(retval.begin(), retval.end(), distance_comparator());
+        }
+
+    private:
+        inline static void
+        collect_all_neighbors(result_type& retval,
+                impl_type const& cntnr, const position_type& pos,
+                boost::mpl::false_)
+        {
+            distance_calculator distance(pos);
+            all_neighbors_collector<distance_calculator> col(retval, distance);
+            cntnr.each_neighbor(cntnr.index(pos), col);
+        }
+
+        inline static void
+        collect_all_neighbors(result_type& retval,
+                impl_type const& cntnr, const position_type& pos,
+                boost::mpl::true_)
+        {
+            collector col(retval);
+            cntnr.each_neighbor_distance(pos, col);
+        }
+
+        inline static void
+        collect_all_neighbors_cyclic(result_type& retval,
+                impl_type const& cntnr, const position_type& pos,
+                boost::mpl::false_)
         {
             cyclic_distance_calculator distance(pos, cntnr.world_size());
             all_neighbors_collector<cyclic_distance_calculator> col(retval, distance);
             cntnr.each_neighbor_cyclic(cntnr.index(pos), col);
-            std::sort(retval.begin(), retval.end(), distance_comparator());
         }
 
+        inline static void
+        collect_all_neighbors_cyclic(result_type& retval,
+                impl_type const& cntnr, const position_type& pos,
+                boost::mpl::true_)
+        {
+            collector col(retval);
+            cntnr.each_neighbor_distance_cyclic(pos, col);
+        }
+
+    public:
         static void __register_converter()
         {
             collector_result_converter_type::__register_converter();
@@ -477,6 +515,7 @@ inline void register_matrix_space_class(char const* class_name)
                 return_value_policy<copy_const_reference>())
         .def("__delitem__", &extras_type::__delitem__)
         .def("check", &extras_type::check)
+        .def("memory_usage", &impl_type::memory_usage)
         ;
 }
 
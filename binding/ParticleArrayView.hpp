@@ -0,0 +1,175 @@
+#ifndef BINDING_PARTICLE_ARRAY_VIEW_HPP
+#define BINDING_PARTICLE_ARRAY_VIEW_HPP
+
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+#include <boost/range/begin.hpp>
+#include <boost/python.hpp>
+#include <numpy/arrayobject.h>
+
+#include "peer/numpy/type_mappings.hpp"
+#include "../exceptions.hpp"
+
+namespace binding {
+
+// Read-only numpy arrays of the particle state of a World.
+//
+// These are snapshot copies, not views: every array is a newly allocated
+// numpy array, filled element by element in one strided pass over the
+// contiguous value vector of the world's MatrixSpace (the values are
+// (id, Particle) pairs, so no column can be taken with a memcpy).  An array
+// owns its data, so it stays valid whatever happens to the world
+// afterwards, but it does not follow later moves.
+//
+// The view remembers the generation of the world it was created at and
+// refuses to hand out new arrays once particles were added to or removed
+// from the world, as its rows would no longer match; the arrays it already
+// handed out are unaffected and keep their old contents.  Check 'valid'
+// (or simply create a new view) after every step that may have created or
+// destroyed particles.
+template<typename Tworld_>
+class ParticleArrayView
+{
+public:
+    typedef Tworld_ world_type;
+    typedef typename world_type::particle_id_pair particle_id_pair;
+    typedef typename world_type::length_type length_type;
+    typedef typename world_type::particle_type::D_type D_type;
+    typedef typename world_type::particle_id_type::serial_type particle_serial_type;
+    typedef typename world_type::species_id_type::serial_type species_serial_type;
+
+public:
+    ParticleArrayView(boost::shared_ptr<world_type> const& world)
+        : world_(world), generation_(world->generation()) {}
+
+    bool valid() const
+    {
+        return world_->generation() == generation_;
+    }
+
+    unsigned long generation() const
+    {
+        return generation_;
+    }
+
+    typename world_type::size_type size() const
+    {
+        ensure_valid();
+        return world_->num_particles();
+    }
+
+    // (N, 3) array of the particle positions.
+    PyObject* positions() const
+    {
+        particle_id_pair const* const first(this->first());
+        return copy(3, first ? &first->second.position()[0]: 0);
+    }
+
+    PyObject* radii() const
+    {
+        particle_id_pair const* const first(this->first());
+        return copy(1, first ? &first->second.radius(): 0);
+    }
+
+    PyObject* D() const
+    {
+        particle_id_pair const* const first(this->first());
+        return copy(1, first ? &first->second.D(): 0);
+    }
+
+    // serial numbers of the particle ids; together with lots() they
+    // identify a particle.
+    PyObject* serials() const
+    {
+        particle_id_pair const* const first(this->first());
+        return copy(1, first ? &first->first.serial(): 0);
+    }
+
+    // lots of the particle ids (nonzero only after the serials wrapped
+    // around, which the compact ids make reachable).
+    PyObject* lots() const
+    {
+        particle_id_pair const* const first(this->first());
+        return copy(1, first ? &first->first.lot(): 0);
+    }
+
+    PyObject* species_serials() const
+    {
+        particle_id_pair const* const first(this->first());
+        return copy(1, first ? &first->second.sid().serial(): 0);
+    }
+
+private:
+    void ensure_valid() const
+    {
+        if (!valid())
+        {
+            throw illegal_state("particles were added to or removed from the world since the view was created");
+        }
+    }
+
+    particle_id_pair const* first() const
+    {
+        ensure_valid();
+        if (world_->num_particles() == 0)
+            return 0;
+        return &*boost::begin(world_->get_particles_range());
+    }
+
+    // Copies 'width' consecutive values of type T_ out of every particle,
+    // 'data' pointing at those of the first one, into a new (N,) or
+    // (N, width) array.
+    template<typename T_>
+    PyObject* copy(npy_intp width, T_ const* data) const
+    {
+        npy_intp const dims[2] = { static_cast<npy_intp>(size()), width };
+        PyObject* retval(PyArray_SimpleNew(width == 1 ? 1: 2,
+                const_cast<npy_intp*>(dims),
+                peer::util::get_numpy_typecode<T_>::value));
+        if (!retval)
+            return NULL;
+
+        PyArrayObject* const array(reinterpret_cast<PyArrayObject*>(retval));
+        T_* out(reinterpret_cast<T_*>(PyArray_DATA(array)));
+        char const* row(reinterpret_cast<char const*>(data));
+        for (npy_intp i(0); i < dims[0]; ++i, row += sizeof(particle_id_pair))
+        {
+            out = std::copy(reinterpret_cast<T_ const*>(row),
+                            reinterpret_cast<T_ const*>(row) + width, out);
+        }
+
+#if NPY_API_VERSION >= 0x00000007
+        PyArray_CLEARFLAGS(array, NPY_ARRAY_WRITEABLE);
+#else
+        array->flags &= ~NPY_WRITEABLE;
+#endif
+        return retval;
+    }
+
+private:
+    boost::shared_ptr<world_type> world_;
+    unsigned long const generation_;
+};
+
+template<typename Tworld_>
+inline boost::python::objects::class_base register_particle_array_view_class(char const* name)
+{
+    using namespace boost::python;
+    typedef ParticleArrayView<Tworld_> impl_type;
+
+    return class_<impl_type>(name, init<boost::shared_ptr<Tworld_> >())
+        .add_property("valid", &impl_type::valid)
+        .add_property("generation", &impl_type::generation)
+        .add_property("positions", &impl_type::positions)
+        .add_property("radii", &impl_type::radii)
+        .add_property("D", &impl_type::D)
+        .add_property("serials", &impl_type::serials)
+        .add_property("lots", &impl_type::lots)
+        .add_property("species_serials", &impl_type::species_serials)
+        .def("__len__", &impl_type::size)
+        ;
+}
+
+} // namespace binding
+
+#endif /* BINDING_PARTICLE_ARRAY_VIEW_HPP */
@@ -18,6 +18,7 @@
 #include "../utils/get_default_impl.hpp"
 #include "../generator.hpp"
 #include "../utils/pair.hpp"
+#include "peer/util/gil.hpp"
 
 #include "peer/compat.h"
 #include "peer/wrappers/generator/pyiterator_generator.hpp"
@@ -373,6 +374,7 @@ public:
 
     virtual size_type num_particles() const
     {
+        peer::util::gil_ensure gil;
         boost::python::handle<> retval(
             boost::python::allow_null(
                 PyObject_GetAttrString(
@@ -383,6 +385,7 @@ public:
 
     virtual length_type world_size() const
     {
+        peer::util::gil_ensure gil;
         boost::python::handle<> retval(
             boost::python::allow_null(
                 PyObject_GetAttrString(
@@ -393,47 +396,56 @@ public:
 
     virtual species_type const& get_species(species_id_type const& id) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("get_species")(id).template unchecked<species_type const&>();
     }
 
     // structure stuff
     virtual boost::shared_ptr<structure_type> get_structure(structure_id_type const& id) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("get_structure")(id);
     }
     
     virtual structures_range get_structures() const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("get_structures")();
     }
     
     virtual boost::shared_ptr<structure_type> get_some_structure_of_type(structure_type_id_type const& sid) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("get_some_structure_of_type")(sid);
     }
 /*
     virtual bool update_structure(cuboidal_region_id_pair_type const& structid_pair)
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("update_structure")(structid_pair);
     }
 
     virtual bool update_structure(planar_surface_id_pair_type const& structid_pair)
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("update_structure")(structid_pair);
     }
 
     virtual bool update_structure(cylindrsurf_id_pair_type const& structid_pair)
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("update_structure")(structid_pair);
     }
 
     virtual bool update_structure(disk_surface_id_pair_type const& structid_pair)
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("update_structure")(structid_pair);
     }
 
     virtual bool update_structure(spherical_surface_id_pair_type const& structid_pair)
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("update_structure")(structid_pair);
     }
 
@@ -446,22 +458,26 @@ public:
     
     virtual bool remove_structure(structure_id_type const& id)
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("remove_structure")(id);
     }
 
     virtual structure_id_set get_structure_ids(structure_type_id_type const& sid) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("get_structure_ids")(sid);
     }
 
     virtual structure_id_type get_def_structure_id() const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("get_def_structure_id")();
     }
 
     virtual structure_id_pair_and_distance_list* get_close_structures(position_type const& pos, structure_id_type const& current_struct_id,
                                                                       structure_id_type const& ignore) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("get_close_structures")(
                 pos, current_struct_id, boost::python::make_tuple(ignore))
                .template unchecked<structure_id_pair_and_distance_list*>();
@@ -472,16 +488,19 @@ public:
     // Begin StructureType stuff
     virtual structure_type_type get_structure_type(structure_type_id_type const& sid) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("get_structure_type")(sid);
     }
 
     virtual structure_types_range get_structure_types() const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("get_structure_types")();
     }
 
     virtual structure_type_id_type get_def_structure_type_id() const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("get_def_structure_type_id")();
     }
     // end StructureType stuff
@@ -489,31 +508,37 @@ public:
     virtual particle_id_pair new_particle(species_id_type const& sid,
             structure_id_type const& structure_id, position_type const& pos)
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("new_particle")(sid, structure_id, pos);
     }
 
     virtual bool update_particle(particle_id_pair const& pi_pair)
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("update_particle")(pi_pair);
     }
 
     virtual bool remove_particle(particle_id_type const& id)
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("remove_particle")(id);
     }
 
     virtual particle_id_pair get_particle(particle_id_type const& id) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("get_particle")(id);
     }
 
     virtual bool has_particle(particle_id_type const& id) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("has_particle")(id);
     }
 
     virtual particle_id_pair_and_distance_list* check_overlap(particle_id_pair const& s) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("check_overlap")(
                 s.second.shape(), boost::python::make_tuple(s.first))
                 .template unchecked<particle_id_pair_and_distance_list*>();
@@ -521,12 +546,14 @@ public:
 
     virtual particle_id_pair_and_distance_list* check_overlap(particle_shape_type const& s) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("check_overlap")(s, boost::python::tuple())
                 .template unchecked<particle_id_pair_and_distance_list*>();
     }
 
     virtual particle_id_pair_and_distance_list* check_overlap(particle_shape_type const& s, particle_id_type const& ignore) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("check_overlap")(
                 s, boost::python::make_tuple(ignore))
                .template unchecked<particle_id_pair_and_distance_list*>();
@@ -534,6 +561,7 @@ public:
 
     virtual particle_id_pair_and_distance_list* check_overlap(particle_shape_type const& s, particle_id_type const& ignore1, particle_id_type const& ignore2) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("check_overlap")(
                 s, boost::python::make_tuple(ignore1, ignore2))
                .template unchecked<particle_id_pair_and_distance_list*>();
@@ -542,6 +570,7 @@ public:
     virtual structure_id_pair_and_distance_list* check_surface_overlap(particle_shape_type const& s, position_type const& old_pos, structure_id_type const& current,
                                                                        length_type const& sigma) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("check_surface_overlap")(
                 s, old_pos, current, sigma)
                .template unchecked<structure_id_pair_and_distance_list*>();
@@ -550,6 +579,7 @@ public:
     virtual structure_id_pair_and_distance_list* check_surface_overlap(particle_shape_type const& s, position_type const& old_pos, structure_id_type const& current,
                                                                        length_type const& sigma, structure_id_type const& ignore) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("check_surface_overlap")(
                 s, old_pos, current, sigma, ignore)
                .template unchecked<structure_id_pair_and_distance_list*>();
@@ -558,6 +588,7 @@ public:
     virtual structure_id_pair_and_distance_list* check_surface_overlap(particle_shape_type const& s, position_type const& old_pos, structure_id_type const& current,
                                                                        length_type const& sigma, structure_id_type const& ignore1, structure_id_type const& ignore2) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("check_surface_overlap")(
                 s, old_pos, current, sigma, ignore1, ignore2)
                .template unchecked<structure_id_pair_and_distance_list*>();
@@ -565,12 +596,14 @@ public:
 
     virtual particle_id_pair_generator* get_particles() const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("__iter__")()
                 .template unchecked<particle_id_pair_generator*>();
     }
 
     virtual transaction_type* create_transaction()
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("create_transaction")()
                 .template unchecked<transaction_type*>();
     }
@@ -578,37 +611,44 @@ public:
     virtual length_type distance(position_type const& lhs,
                                  position_type const& rhs) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("distance")(lhs, rhs);
     }
 
     virtual position_type apply_boundary(position_type const& v) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("apply_boundary")(v);
     }
 
     virtual length_type apply_boundary(length_type const& v) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("apply_boundary")(v);
     }
 
     virtual position_structid_pair_type apply_boundary(position_structid_pair_type const& pos_struct_id) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("apply_boundary")(pos_struct_id);
     }
 
     virtual position_type cyclic_transpose(position_type const& p0, position_type const& p1) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("cyclic_transpose")(p0, p1);
     }
 
     virtual length_type cyclic_transpose(length_type const& p0, length_type const& p1) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("cyclic_transpose")(p0, p1);
     }
 
     virtual position_structid_pair_type cyclic_transpose(position_structid_pair_type const& pos_struct_id,
                                                          structure_type const& structure) const
     {
+        peer::util::gil_ensure gil;
         return py_wrapper_type::get_override("cyclic_transpose")(pos_struct_id, structure);
     }
 
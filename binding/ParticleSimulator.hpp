@@ -6,6 +6,7 @@
 #include "peer/util/to_native_converter.hpp"
 #include "peer/wrappers/generator/generator_wrapper.hpp"
 #include "peer/converters/tuple.hpp"
+#include "peer/util/gil.hpp"
 
 namespace binding {
 
@@ -56,8 +57,8 @@ void register_particle_simulator_class(char const* name)
         .add_property("t", &impl_type::t)
         .add_property("dt", &impl_type::dt)
         .add_property("num_steps", &impl_type::num_steps)
-        .def("step", static_cast<void(impl_type::*)()>(&impl_type::step))
-        .def("step", static_cast<bool(impl_type::*)(typename impl_type::time_type)>(&impl_type::step))
+        .def("step", peer::util::release_gil(static_cast<void(impl_type::*)()>(&impl_type::step)))
+        .def("step", peer::util::release_gil(static_cast<bool(impl_type::*)(typename impl_type::time_type)>(&impl_type::step)))
         ;
 }
 
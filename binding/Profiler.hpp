@@ -0,0 +1,80 @@
+#ifndef BINDING_PROFILER_HPP
+#define BINDING_PROFILER_HPP
+
+#include <string>
+#include <boost/python.hpp>
+#include "../Profiler.hpp"
+
+namespace binding {
+
+// Returns {name: (count, total_time, max_time)}.
+template<typename Timpl_>
+static boost::python::dict Profiler_stats(Timpl_ const& impl)
+{
+    boost::python::dict retval;
+    typename Timpl_::entries_type const entries(impl.entries());
+    for (typename Timpl_::entries_type::const_iterator i(entries.begin()),
+                                                       e(entries.end());
+         i != e; ++i)
+    {
+        retval[(*i).first] = boost::python::make_tuple(
+            (*i).second.count, (*i).second.total_time, (*i).second.max_time);
+    }
+    return retval;
+}
+
+template<typename Timpl_>
+inline void register_profiler_class(char const* name)
+{
+    using namespace boost::python;
+    typedef Timpl_ impl_type;
+
+    class_<impl_type, boost::noncopyable>(name, no_init)
+        .def("instance", &impl_type::instance,
+            return_value_policy<reference_existing_object>())
+        .staticmethod("instance")
+        .def("enabled", &impl_type::enabled)
+        .staticmethod("enabled")
+        .def("now", &impl_type::now)
+        .staticmethod("now")
+        .def("stats", &Profiler_stats<impl_type>)
+        .def("reset", &impl_type::reset)
+        .def("to_json", &impl_type::to_json)
+        ;
+}
+
+template<typename Timpl_>
+static boost::python::dict profiler_stats()
+{
+    return Profiler_stats(Timpl_::instance());
+}
+
+template<typename Timpl_>
+static void reset_profiler()
+{
+    Timpl_::instance().reset();
+}
+
+template<typename Timpl_>
+static std::string profiler_to_json()
+{
+    return Timpl_::instance().to_json();
+}
+
+// For a module other than the one that registers the Profiler class:
+// boost.python allows one class per C++ type in a process, so the
+// Profiler instance of this module is reached through plain functions.
+template<typename Timpl_>
+inline void register_profiler_functions()
+{
+    using namespace boost::python;
+
+    def("profiler_enabled", &Timpl_::enabled);
+    def("profiler_stats", &profiler_stats<Timpl_>);
+    def("reset_profiler", &reset_profiler<Timpl_>);
+    def("profiler_to_json", &profiler_to_json<Timpl_>);
+}
+
+} // namespace binding
+
+#endif /* BINDING_PROFILER_HPP */
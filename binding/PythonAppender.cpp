@@ -7,6 +7,7 @@
 #include <boost/foreach.hpp>
 #include "PythonAppender.hpp"
 #include "binding_common.hpp"
+#include "peer/util/gil.hpp"
 
 namespace binding {
 
@@ -42,6 +43,7 @@ public:
     virtual void operator()(enum Logger::level lv,
                             char const* name, char const** chunks)
     {
+        peer::util::gil_ensure gil;
         std::string msg;
         for (char const** p = chunks; *p; ++p)
             msg.append(*p);
@@ -50,6 +52,7 @@ public:
 
     virtual void flush()
     {
+        peer::util::gil_ensure gil;
         flush_();
     }
 
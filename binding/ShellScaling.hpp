@@ -0,0 +1,147 @@
+#ifndef BINDING_SHELL_SCALING_HPP
+#define BINDING_SHELL_SCALING_HPP
+
+#include <vector>
+#include <boost/python.hpp>
+#include <boost/python/stl_iterator.hpp>
+#include "peer/utils.hpp"
+
+namespace binding {
+
+// Converts a python sequence of Sphere, Cylinder, Disk and Plane objects into a vector of shape variants.
+template<typename Timpl_>
+static std::vector<typename Timpl_::shape_variant_type> ShellScaling_shapes(boost::python::object const& seq)
+{
+    using namespace boost::python;
+    std::vector<typename Timpl_::shape_variant_type> retval;
+
+    for (stl_input_iterator<object> i(seq), e; i != e; ++i)
+    {
+        extract<typename Timpl_::sphere_type const&> sphere(*i);
+        extract<typename Timpl_::cylinder_type const&> cylinder(*i);
+        extract<typename Timpl_::disk_type const&> disk(*i);
+        extract<typename Timpl_::plane_type const&> plane(*i);
+
+        if (sphere.check())
+            retval.push_back(sphere());
+        else if (cylinder.check())
+            retval.push_back(cylinder());
+        else if (disk.check())
+            retval.push_back(disk());
+        else if (plane.check())
+            retval.push_back(plane());
+        else
+        {
+            PyErr_SetString(PyExc_TypeError, "shape must be one of Sphere, Cylinder, Disk or Plane");
+            throw_error_already_set();
+        }
+    }
+    return retval;
+}
+
+template<typename Timpl_>
+static typename Timpl_::length_type SphericalShellScaling_scale_to(Timpl_ const& impl,
+        boost::python::object const& shape, typename Timpl_::length_type const& r)
+{
+    return impl.scale_to(ShellScaling_shapes<Timpl_>(boost::python::make_tuple(shape)).front(), r);
+}
+
+template<typename Timpl_>
+static typename Timpl_::length_type SphericalShellScaling_determine_possible_shell(Timpl_ const& impl,
+        boost::python::object const& surface_distances, boost::python::object const& shapes,
+        typename Timpl_::length_type const& min_radius, typename Timpl_::length_type const& max_radius)
+{
+    using namespace boost::python;
+    typedef typename Timpl_::length_type length_type;
+
+    const std::vector<length_type> distances((stl_input_iterator<length_type>(surface_distances)),
+                                             stl_input_iterator<length_type>());
+    return impl.determine_possible_shell(distances, ShellScaling_shapes<Timpl_>(shapes), min_radius, max_radius);
+}
+
+template<typename Tdims_>
+static boost::python::tuple ShellScaling_dims_to_tuple(Tdims_ const& dims)
+{
+    return boost::python::make_tuple(dims[0], dims[1], dims[2]);
+}
+
+template<typename Timpl_>
+static typename Timpl_::dimensions_type ShellScaling_dims_from_tuple(boost::python::object const& dims)
+{
+    using namespace boost::python;
+    typename Timpl_::dimensions_type retval;
+    retval[0] = extract<typename Timpl_::length_type>(dims[0]);
+    retval[1] = extract<typename Timpl_::length_type>(dims[1]);
+    retval[2] = extract<typename Timpl_::length_type>(dims[2]);
+    return retval;
+}
+
+template<typename Timpl_>
+static boost::python::tuple CylindricalShellScaling_scale_to(Timpl_ const& impl,
+        boost::python::object const& shape, typename Timpl_::length_type const& r,
+        typename Timpl_::length_type const& z_right, typename Timpl_::length_type const& z_left)
+{
+    typename Timpl_::dimensions_type dims;
+    dims[0] = r;
+    dims[1] = z_right;
+    dims[2] = z_left;
+    return ShellScaling_dims_to_tuple(
+        impl.scale_to(ShellScaling_shapes<Timpl_>(boost::python::make_tuple(shape)).front(), dims));
+}
+
+template<typename Timpl_>
+static boost::python::tuple CylindricalShellScaling_determine_possible_shell(Timpl_ const& impl,
+        boost::python::object const& shapes, boost::python::object const& min_dims,
+        boost::python::object const& max_dims)
+{
+    return ShellScaling_dims_to_tuple(impl.determine_possible_shell(
+        ShellScaling_shapes<Timpl_>(shapes),
+        ShellScaling_dims_from_tuple<Timpl_>(min_dims),
+        ShellScaling_dims_from_tuple<Timpl_>(max_dims)));
+}
+
+
+////// Registering master functions
+template<typename Timpl_>
+inline boost::python::objects::class_base register_spherical_shell_scaling_class(char const* name)
+{
+    using namespace boost::python;
+    typedef Timpl_ impl_type;
+
+    return class_<impl_type>(name, init<typename impl_type::position_type,
+                                        typename impl_type::length_type>())
+        .add_property("center",
+            make_function(&impl_type::center, return_value_policy<return_by_value>()))
+        .def("scale_to", &SphericalShellScaling_scale_to<impl_type>)
+        .def("determine_possible_shell", &SphericalShellScaling_determine_possible_shell<impl_type>)
+        ;
+}
+
+template<typename Timpl_>
+inline boost::python::objects::class_base register_cylindrical_shell_scaling_class(char const* name)
+{
+    using namespace boost::python;
+    typedef Timpl_ impl_type;
+    typedef typename impl_type::length_type length_type;
+    typedef typename impl_type::position_type position_type;
+
+    return class_<impl_type>(name, init<position_type, position_type,
+                                        length_type, length_type, length_type, length_type,
+                                        length_type, length_type, length_type, length_type,
+                                        length_type, optional<length_type> >())
+        .add_property("right_scalingangle",
+            make_function(&impl_type::right_scalingangle, return_value_policy<return_by_value>()))
+        .add_property("left_scalingangle",
+            make_function(&impl_type::left_scalingangle, return_value_policy<return_by_value>()))
+        .def("r_right", &impl_type::r_right)
+        .def("z_right", &impl_type::z_right)
+        .def("r_left", &impl_type::r_left)
+        .def("z_left", &impl_type::z_left)
+        .def("scale_to", &CylindricalShellScaling_scale_to<impl_type>)
+        .def("determine_possible_shell", &CylindricalShellScaling_determine_possible_shell<impl_type>)
+        ;
+}
+
+} // namespace binding
+
+#endif /* BINDING_SHELL_SCALING_HPP */
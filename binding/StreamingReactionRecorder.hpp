@@ -0,0 +1,86 @@
+#ifndef BINDING_STREAMING_REACTION_RECORDER_HPP
+#define BINDING_STREAMING_REACTION_RECORDER_HPP
+
+#include <boost/python.hpp>
+#include "peer/wrappers/range/pyiterable_range.hpp"
+
+namespace binding {
+
+template<typename Timpl_>
+struct streaming_reaction_recorder_helpers
+{
+    typedef Timpl_ impl_type;
+    typedef typename impl_type::particle_id_type particle_id_type;
+    typedef peer::wrappers::pyiterable_range<particle_id_type> particle_id_range;
+
+    static boost::python::dict counts(impl_type const& impl)
+    {
+        boost::python::dict retval;
+        typename impl_type::counts_type const& counts(impl.counts());
+        for (typename impl_type::counts_type::const_iterator i(counts.begin());
+                i != counts.end(); ++i)
+        {
+            retval[(*i).first] = (*i).second;
+        }
+        return retval;
+    }
+
+    static void record(impl_type& impl,
+                       typename impl_type::reaction_rule_id_type const& rid,
+                       particle_id_range const& reactants,
+                       particle_id_range const& products)
+    {
+        impl.record(rid, reactants, products);
+    }
+
+    static void stream_to(impl_type& impl, std::string const& filename,
+                          std::size_t chunk_size)
+    {
+        impl.stream_to(filename, chunk_size);
+    }
+
+    static void set_particle_container(impl_type& impl,
+            typename impl_type::particle_container_type const& container)
+    {
+        impl.set_particle_container(&container);
+    }
+};
+
+template<typename Timpl_>
+boost::python::objects::class_base register_streaming_reaction_recorder_class(char const* name)
+{
+    using namespace boost::python;
+    typedef Timpl_ impl_type;
+    typedef streaming_reaction_recorder_helpers<impl_type> helpers;
+
+    return class_<impl_type, bases<typename impl_type::base_type>,
+                  boost::shared_ptr<impl_type>, boost::noncopyable>(name, init<>())
+        .add_property("time",
+            make_function(&impl_type::time,
+                          return_value_policy<return_by_value>()),
+            &impl_type::set_time)
+        .add_property("total", &impl_type::total)
+        .add_property("streamed", &impl_type::streamed)
+        .add_property("last_record", &impl_type::last_record)
+        .def("count", &impl_type::count)
+        .def("counts", &helpers::counts)
+        .def("reset_counters", &impl_type::reset_counters)
+        .def("select", &impl_type::select)
+        .def("deselect", &impl_type::deselect)
+        .def("select_all", &impl_type::select_all)
+        .def("is_selected", &impl_type::is_selected)
+        .def("record", &helpers::record)
+        .def("set_particle_container", &helpers::set_particle_container,
+             with_custodian_and_ward<1, 2>())
+        .def("stream_to", &helpers::stream_to,
+             (arg("self"), arg("filename"), arg("chunk_size") = 65536))
+        .def("flush", &impl_type::flush)
+        .def("close", &impl_type::close)
+        .def("keep_last", &impl_type::keep_last)
+        .def("buffer", &impl_type::buffer)
+        ;
+}
+
+} // namespace binding
+
+#endif /* BINDING_STREAMING_REACTION_RECORDER_HPP */
@@ -34,7 +34,9 @@ register_transaction_impl_class(char const* name)
     using namespace boost::python;
 
     return class_<Timpl_, bases<Tbase_>, boost::noncopyable>(
-            name, init<typename Timpl_::particle_container_type&>());
+            name, init<typename Timpl_::particle_container_type&>())
+        .def("memory_usage", &Timpl_::memory_usage)
+        ;
 }
 
 } // namesapce binding
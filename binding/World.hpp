@@ -392,6 +392,7 @@ inline boost::python::objects::class_base register_world_class(char const* name)
         "World", init<typename impl_type::length_type, typename impl_type::size_type>())
         .add_property("cell_size", &impl_type::cell_size)
         .add_property("matrix_size", &impl_type::matrix_size)
+        .add_property("generation", &impl_type::generation)
         .add_property("species",
             make_function(
                 (typename impl_type::species_range(impl_type::*)() const)&impl_type::get_species, species_range_converter_type()))
@@ -406,6 +407,8 @@ inline boost::python::objects::class_base register_world_class(char const* name)
         .def("get_particle_ids", &impl_type::get_particle_ids)
         .def("get_particle_ids_on_struct", &impl_type::get_particle_ids_on_struct)
         .def("add_species", &impl_type::add_species)
+        .def("throw_in_particles", &impl_type::throw_in_particles)
+        .def("memory_usage", &impl_type::memory_usage)
         // Structure stuff
         .def("add_structure", &impl_type::template add_structure<typename impl_type::planar_surface_type>)
         .def("add_structure", &impl_type::template add_structure<typename impl_type::cuboidal_region_type>)
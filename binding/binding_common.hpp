@@ -31,11 +31,14 @@
 #include "../BDPropagator.hpp"
 #include "../newBDPropagator.hpp"
 #include "../BDSimulator.hpp"
+#include "../GillespieSimulator.hpp"
 #include "../StructureUtils.hpp"
+#include "../ShellScaling.hpp"
 #include "../AnalyticalSingle.hpp"
 #include "../AnalyticalPair.hpp"
 #include "../EventScheduler.hpp"
 #include "../Logger.hpp"
+#include "../StreamingReactionRecorderImpl.hpp"
 #include "../StructureType.hpp"
 
 #include "peer/wrappers/range/pyiterable_range.hpp"
@@ -45,6 +48,7 @@ namespace binding {
 typedef ::not_found             NotFound;
 typedef ::already_exists        AlreadyExists;
 typedef ::illegal_state         IllegalState;
+typedef ::no_space              NoSpace;
 typedef ::GSLRandomNumberGenerator GSLRandomNumberGenerator;
 
 typedef ::CyclicWorldTraits<Real, Real> WorldTraits;            // parameterize the World traits here -> determines many types!!
@@ -71,6 +75,7 @@ typedef ::EGFRDSimulatorTraitsBase<World>               EGFRDSimulatorTraits;
 typedef ::ParticleSimulator<EGFRDSimulatorTraits>       ParticleSimulator;
 typedef ::BDSimulator<EGFRDSimulatorTraits>             BDSimulator;
 typedef ::EGFRDSimulator<EGFRDSimulatorTraits>          EGFRDSimulator;
+typedef ::GillespieSimulator<EGFRDSimulatorTraits>      GillespieSimulator;
 typedef ::MultiParticleContainer<EGFRDSimulatorTraits>  MultiParticleContainer;
 
 typedef EGFRDSimulator::box_type        Box;
@@ -100,6 +105,8 @@ typedef EGFRDSimulator::multi_type                          Multi;
 typedef ::MatrixSpace<SphericalShell, ShellID>              SphericalShellContainer;
 typedef ::MatrixSpace<CylindricalShell, ShellID>            CylindricalShellContainer;
 typedef ::StructureUtils<EGFRDSimulator>                    StructureUtils;
+typedef ::SphericalShellScaling<WorldTraits>                SphericalShellScaling;
+typedef ::CylindricalShellScaling<WorldTraits>              CylindricalShellScaling;
 typedef EGFRDSimulator::particle_simulation_structure_type  ParticleSimulationStructure;
 
 typedef EGFRDSimulator::surface_type                Surface;
@@ -112,6 +119,7 @@ typedef EGFRDSimulator::cuboidal_region_type        CuboidalRegion;
 
 typedef EGFRDSimulatorTraits::reaction_record_type ReactionRecord;
 typedef EGFRDSimulatorTraits::reaction_recorder_type ReactionRecorder;
+typedef ::StreamingReactionRecorderImpl<ReactionRecord, ParticleContainer> StreamingReactionRecorder;
 typedef EGFRDSimulatorTraits::volume_clearer_type VolumeClearer;
 typedef ::Logger Logger;
 typedef ::LogAppender LogAppender;
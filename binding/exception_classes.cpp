@@ -12,6 +12,7 @@ void register_exception_classes()
     peer::wrappers::exception_wrapper<NotFound, peer::wrappers::py_exc_traits<&PyExc_LookupError> >::__register_class("NotFound");
     peer::wrappers::exception_wrapper<AlreadyExists, peer::wrappers::py_exc_traits<&PyExc_StandardError> >::__register_class("AlreadyExists");
     peer::wrappers::exception_wrapper<IllegalState, peer::wrappers::py_exc_traits<&PyExc_StandardError> >::__register_class("IllegalState");
+    peer::wrappers::exception_wrapper<NoSpace, peer::wrappers::py_exc_traits<&PyExc_StandardError> >::__register_class("NoSpace");
 }
 
 } // namespace binding
@@ -0,0 +1,15 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "binding_common.hpp"
+#include "GillespieSimulator.hpp"
+
+namespace binding {
+
+void register_gillespie_simulator_class()
+{
+    register_gillespie_simulator_class<GillespieSimulator>("_GillespieSimulator");
+}
+
+} // namespace binding
@@ -0,0 +1,10 @@
+#ifndef BINDING_GILLESPIE_SIMULATOR_CLASS_HPP
+#define BINDING_GILLESPIE_SIMULATOR_CLASS_HPP
+
+namespace binding {
+
+void register_gillespie_simulator_class();
+
+} // namespace binding
+
+#endif /* BINDING_GILLESPIE_SIMULATOR_CLASS_HPP */
@@ -4,6 +4,11 @@
 
 #include <boost/python.hpp>
 #include <boost/python/docstring_options.hpp>
+#include "peer/converters/tuple.hpp"
+#include "../utils/memory_usage.hpp"
+#include "../utils/tracking_allocator.hpp"
+#include "../utils/pool_allocator.hpp"
+#include "../BDTable.hpp"
 #include "binding_common.hpp"
 
 namespace binding {
@@ -26,6 +31,38 @@ calculate_pair_CoM(Position const& p1,
         world_size);
 }
 
+// The bytes allocated through the tracking allocators, by subsystem; all
+// zeros unless built with --enable-memory-tracking.
+static boost::python::dict tracked_memory_usage()
+{
+    boost::python::dict retval;
+    for (int i(0); i < NUM_MEMORY_SUBSYSTEMS; ++i)
+    {
+        retval[memory_subsystem_name(static_cast<memory_subsystem>(i))] =
+            tracked_memory()[i];
+    }
+    return retval;
+}
+
+// {block size: (allocations, live, slabs)} for the size classes of the
+// object pools that have been used.
+static boost::python::dict object_pool_statistics()
+{
+    boost::python::dict retval;
+    std::vector<fixed_size_pool::statistics> const stats(pool_statistics());
+    for (std::size_t i(0); i < stats.size(); ++i)
+    {
+        retval[stats[i].block_size] = boost::python::make_tuple(
+            stats[i].allocations, stats[i].live, stats[i].slabs);
+    }
+    return retval;
+}
+
+static unsigned long oversized_pool_allocations()
+{
+    return get_size_class_pools().oversized_allocations;
+}
+
 void register_module_functions()
 {
     using namespace boost::python;
@@ -57,6 +94,15 @@ void register_module_functions()
             return_value_policy<manage_new_object>());
     def("_random_vector", (Position(*)(Structure const&, Length const&, GSLRandomNumberGenerator&))&StructureUtils::random_vector);
     def("random_position", (Position(*)(Structure const&, GSLRandomNumberGenerator&))&StructureUtils::random_position);
+
+    peer::converters::register_tuple_converter<memory_usage_type>();
+    def("tracked_memory_usage", &tracked_memory_usage);
+    def("object_pool_statistics", &object_pool_statistics);
+    def("oversized_pool_allocations", &oversized_pool_allocations);
+
+    // the tables newBDPropagator fills are those of this module's copy of
+    // BDTable, not of _greens_functions'.
+    def("tabulated_memory_usage", &BDTable::memory_usage);
 }
 
 } // namespace binding
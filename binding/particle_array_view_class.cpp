@@ -0,0 +1,16 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "ParticleArrayView.hpp"
+#include "binding_common.hpp"
+#include "particle_array_view_class.hpp"
+
+namespace binding {
+
+void register_particle_array_view_class()
+{
+    register_particle_array_view_class<World>("ParticleArrayView");
+}
+
+} // namespace binding
@@ -0,0 +1,10 @@
+#ifndef BINDING_PARTICLE_ARRAY_VIEW_CLASS_HPP
+#define BINDING_PARTICLE_ARRAY_VIEW_CLASS_HPP
+
+namespace binding {
+
+void register_particle_array_view_class();
+
+} // namespace binding
+
+#endif /* BINDING_PARTICLE_ARRAY_VIEW_CLASS_HPP */
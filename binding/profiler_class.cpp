@@ -0,0 +1,15 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "Profiler.hpp"
+#include "profiler_class.hpp"
+
+namespace binding {
+
+void register_profiler_class()
+{
+    register_profiler_class< ::Profiler>("Profiler");
+}
+
+} // namespace binding
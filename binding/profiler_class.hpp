@@ -0,0 +1,10 @@
+#ifndef BINDING_PROFILER_CLASS_HPP
+#define BINDING_PROFILER_CLASS_HPP
+
+namespace binding {
+
+void register_profiler_class();
+
+} // namespace binding
+
+#endif /* BINDING_PROFILER_CLASS_HPP */
@@ -7,6 +7,7 @@
 #include "LoggerManager.hpp"
 #include "LogAppender.hpp"
 #include "ConsoleAppender.hpp"
+#include "AsyncFileAppender.hpp"
 
 namespace binding {
 
@@ -17,6 +18,7 @@ void register_python_logger_classes()
     register_logger_manager_class("LoggerManager");
     register_log_appender_class("LogAppender");
     register_console_appender_class("ConsoleAppender");
+    register_async_file_appender_class("AsyncFileAppender");
     register_python_appender_class("PythonAppender");
     register_logger_level_enum("LogLevel");
 }
@@ -5,6 +5,7 @@
 #include <boost/python.hpp>
 #include "ReactionRecord.hpp"
 #include "reaction_recorder_converter.hpp"
+#include "StreamingReactionRecorder.hpp"
 #include "binding_common.hpp"
 
 namespace binding {
@@ -13,6 +14,8 @@ void register_reaction_record_classes()
 {
     register_reaction_record_class<ReactionRecord>("ReactionRecord");
     register_reaction_recorder_converter<ReactionRecorder>();
+    boost::python::class_<ReactionRecorder, boost::noncopyable>("ReactionRecorder", boost::python::no_init);
+    register_streaming_reaction_recorder_class<StreamingReactionRecorder>("StreamingReactionRecorder");
 }
 
 } // namespace binding
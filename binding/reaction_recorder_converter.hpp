@@ -5,6 +5,7 @@
 #include <boost/utility/in_place_factory.hpp>
 #include <boost/scoped_ptr.hpp>
 #include "peer/utils.hpp"
+#include "peer/util/gil.hpp"
 
 namespace binding {
 
@@ -20,6 +21,7 @@ public:
 
     virtual void operator()(reaction_record_type const& rr)
     {
+        peer::util::gil_ensure gil;
         boost::python::decref(PyObject_CallObject(callable_, boost::python::make_tuple(boost::python::object(rr)).ptr()));
     }
 
@@ -46,9 +48,11 @@ struct reaction_recorder_lvalue_converter
             return 0;
         }
 
+        // leave the instances of the recorders implemented in C++ to the
+        // converters of their classes.
         if (!PyCallable_Check(pyo))
         {
-            boost::python::throw_error_already_set();
+            return 0;
         }
 
         native_type* retval(new native_type(pyo));
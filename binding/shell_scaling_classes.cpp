@@ -0,0 +1,16 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "ShellScaling.hpp"
+#include "binding_common.hpp"
+
+namespace binding {
+
+void register_shell_scaling_classes()
+{
+    register_spherical_shell_scaling_class<SphericalShellScaling>("SphericalShellScaling");
+    register_cylindrical_shell_scaling_class<CylindricalShellScaling>("CylindricalShellScaling");
+}
+
+} // namespace binding
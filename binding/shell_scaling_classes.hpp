@@ -0,0 +1,10 @@
+#ifndef BINDING_SHELL_SCALING_CLASSES_HPP
+#define BINDING_SHELL_SCALING_CLASSES_HPP
+
+namespace binding {
+
+void register_shell_scaling_classes();
+
+} // namespace binding
+
+#endif /* BINDING_SHELL_SCALING_CLASSES_HPP */
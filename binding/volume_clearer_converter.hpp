@@ -5,6 +5,7 @@
 #include <boost/utility/in_place_factory.hpp>
 #include <boost/scoped_ptr.hpp>
 #include "peer/utils.hpp"
+#include "peer/util/gil.hpp"
 
 namespace binding {
 
@@ -22,6 +23,7 @@ public:
 
     virtual bool operator()(particle_shape_type const& shape, particle_id_type const& ignore)
     {
+        peer::util::gil_ensure gil;
         PyObject* retobj(PyObject_CallObject(callable_, boost::python::make_tuple(boost::python::object(shape), boost::python::object(ignore)).ptr()));
         bool const retval(retobj == Py_True);
         boost::python::decref(retobj);
@@ -30,6 +32,7 @@ public:
 
     virtual bool operator()(particle_shape_type const& shape, particle_id_type const& ignore0, particle_id_type const& ignore1)
     {
+        peer::util::gil_ensure gil;
         PyObject* retobj(PyObject_CallObject(callable_, boost::python::make_tuple(boost::python::object(shape), boost::python::object(ignore0), boost::python::object(ignore1)).ptr()));
         bool const retval(retobj == Py_True);
         boost::python::decref(retobj);
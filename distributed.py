@@ -0,0 +1,527 @@
+#!/usr/env python
+
+import bisect
+import itertools
+import math
+import time
+import resource
+import multiprocessing
+
+import numpy
+
+import _gfrd
+
+from gfrdbase import *
+from egfrd import EGFRDSimulator
+from utils import *
+import model
+import myrandom
+
+__all__ = [
+    'GHOST_PREFIX',
+    'BlockDecomposition',
+    'SlabDecomposition',
+    'balanced_shape',
+    'synchronize',
+    'LocalCommunicator',
+    'MPICommunicator',
+    'DistributedEGFRD',
+    'run_local',
+    'run_mpi',
+    ]
+
+# the name of the immobile twin of a species that stands in for the
+# particles of the neighboring ranks.
+GHOST_PREFIX = 'ghost:'
+
+
+def balanced_shape(size):
+    """The (nx, ny, nz) grid of size blocks of which the sides differ
+    the least, so that the blocks have the least surface."""
+
+    factors = []
+    n, p = size, 2
+    while n > 1:
+        while n % p == 0:
+            factors.append(p)
+            n //= p
+        p += 1
+
+    shape = [1, 1, 1]
+    for p in reversed(factors):
+        shape[shape.index(min(shape))] *= p
+    return tuple(sorted(shape, reverse=True))
+
+
+class BlockDecomposition(object):
+    """Divides the world into a grid of shape[0] x shape[1] x shape[2]
+    blocks, one per rank, each a box of whole cells of the MatrixSpace
+    grid.  Rank ix + shape[0] * (iy + shape[1] * iz) owns block
+    (ix, iy, iz).
+
+    """
+
+    def __init__(self, world_size, matrix_size, shape):
+        if matrix_size < max(shape):
+            raise RuntimeError('BlockDecomposition: %d blocks along an axis, '
+                               'but only %d cells.' % (max(shape), matrix_size))
+
+        self.world_size = world_size
+        self.matrix_size = matrix_size
+        self.shape = tuple(shape)
+        self.size = shape[0] * shape[1] * shape[2]
+        cell_size = float(world_size) / matrix_size
+        # the first cell of every block along each axis.
+        self.first_cells = [[i * matrix_size // n for i in range(n)] + [matrix_size]
+                            for n in self.shape]
+        self.axis_bounds = [[cell_size * cell for cell in cells[:-1]] + [world_size]
+                            for cells in self.first_cells]
+
+    def rank(self, block):
+        return block[0] + self.shape[0] * (block[1] + self.shape[1] * block[2])
+
+    def block(self, rank):
+        return (rank % self.shape[0],
+                rank // self.shape[0] % self.shape[1],
+                rank // (self.shape[0] * self.shape[1]))
+
+    def cells(self, rank):
+        """The number of cells of the block of rank."""
+        retval = 1
+        for cells, i in zip(self.first_cells, self.block(rank)):
+            retval *= cells[i + 1] - cells[i]
+        return retval
+
+    def min_width(self):
+        """The width of the narrowest block along the divided axes."""
+        return min([bounds[i + 1] - bounds[i]
+                    for bounds, n in zip(self.axis_bounds, self.shape) if n > 1
+                    for i in range(n)] + [self.world_size])
+
+    def owner_block(self, pos):
+        return tuple(min(bisect.bisect_right(bounds, x % self.world_size) - 1, n - 1)
+                     for bounds, n, x in zip(self.axis_bounds, self.shape, pos))
+
+    def owner(self, pos):
+        return self.rank(self.owner_block(pos))
+
+    def ghost_ranks(self, pos, width):
+        """The ranks other than the owner of pos of which the block is
+        within width of pos, along the axes or diagonally; width may not
+        exceed min_width()."""
+
+        block = self.owner_block(pos)
+
+        offsets = []
+        for bounds, i, x in zip(self.axis_bounds, block, pos):
+            x %= self.world_size
+            axis_offsets = [0]
+            if x - bounds[i] < width:
+                axis_offsets.append(-1)
+            if bounds[i + 1] - x < width:
+                axis_offsets.append(1)
+            offsets.append(axis_offsets)
+
+        ranks = set(self.rank([(i + offset) % n for i, offset, n in
+                               zip(block, block_offsets, self.shape)])
+                    for block_offsets in itertools.product(*offsets))
+        ranks.discard(self.rank(block))
+        return ranks
+
+
+class SlabDecomposition(BlockDecomposition):
+    """Divides the world along x into one slab per rank, each a
+    contiguous range of columns of cells of the MatrixSpace grid.
+
+    """
+
+    def __init__(self, world_size, matrix_size, size):
+        BlockDecomposition.__init__(self, world_size, matrix_size, (size, 1, 1))
+        self.bounds = self.axis_bounds[0]
+
+    def lower(self, rank):
+        return self.bounds[rank]
+
+    def upper(self, rank):
+        return self.bounds[rank + 1]
+
+
+def synchronize(sim, t):
+    """Steps the EGFRDSimulator sim to t and synchronizes all its
+    particles there."""
+
+    while sim.get_next_time() <= t:
+        sim.step()
+    if sim.t < t:
+        sim.stop(t)
+    else:
+        # An event fell on t itself, and stop refuses to stop at the time
+        # of the next event and does nothing at the current time.
+        sim.burst_all_domains()
+
+
+class LocalCommunicator(object):
+    """Exchanges messages between the processes of one machine through
+    multiprocessing queues, as a stand-in for MPI.
+
+    """
+
+    def __init__(self, rank, queues):
+        self.rank = rank
+        self.size = len(queues)
+        self.queues = queues
+        self.tag = 0
+        # messages of later exchanges that came in early
+        self.pending = {}
+
+    def alltoall(self, messages):
+        """Sends messages[r] to every rank r and returns the list of the
+        messages sent to this rank, by source."""
+
+        self.tag += 1
+        for rank in range(self.size):
+            if rank != self.rank:
+                self.queues[rank].put((self.tag, self.rank, messages[rank]))
+
+        retval = [None] * self.size
+        retval[self.rank] = messages[self.rank]
+        received = 1
+        for source in range(self.size):
+            key = (self.tag, source)
+            if key in self.pending:
+                retval[source] = self.pending.pop(key)
+                received += 1
+
+        while received < self.size:
+            tag, source, message = self.queues[self.rank].get()
+            if tag == self.tag:
+                retval[source] = message
+                received += 1
+            else:
+                self.pending[(tag, source)] = message
+
+        return retval
+
+    def gather(self, message):
+        """Returns the list of the messages of all ranks on rank 0, and None
+        on the others."""
+
+        retval = self.alltoall([message] * self.size)
+        return retval if self.rank == 0 else None
+
+
+class MPICommunicator(object):
+    """Exchanges messages between MPI processes (requires mpi4py)."""
+
+    def __init__(self):
+        from mpi4py import MPI
+        self.comm = MPI.COMM_WORLD
+        self.rank = self.comm.Get_rank()
+        self.size = self.comm.Get_size()
+
+    def alltoall(self, messages):
+        return self.comm.alltoall(messages)
+
+    def gather(self, message):
+        return self.comm.gather(message, root=0)
+
+
+class DistributedEGFRD(object):
+    """The part of a spatially decomposed eGFRD simulation owned by one
+    rank.
+
+    Every rank runs an EGFRDSimulator on its own World, holding the
+    particles in its block of the world (see BlockDecomposition) and, as
+    immobile 'ghosts', copies of the particles of the neighboring ranks
+    within ghost_width of its block.  The ghosts bound the domains of the
+    particles near the faces of the block just as the real particles
+    would at the start of the window.
+
+    Every World still spans the whole world, so every rank allocates the
+    full matrix_size^3 grid of cells; the empty cells of the other blocks
+    cost memory but no time.
+
+    The ranks advance in windows of simulated time (conservative
+    synchronization).  At the end of a window every rank synchronizes its
+    particles, hands the particles that left its block over to their new
+    owners and sends fresh ghosts to its neighbors.  The default window
+    is the lookahead within which the fastest particle is unlikely to
+    cover a third of the ghost width: ghost_width^2 / (54 D_max).
+    Particles near a slab edge therefore see the particles they could
+    meet, but only as they were at the start of the window; reactions
+    between particles of different ranks happen at the earliest in the
+    next window after they are handed over.
+
+    A migrating particle that overlaps a particle of the receiving rank
+    is moved out of the overlap as EGFRDSimulator.remove_overlap would.
+
+    Arguments:
+        - comm
+            a LocalCommunicator or MPICommunicator.
+        - make_model
+            a function returning the ParticleModel (with its species,
+            structure types and reaction rules).
+        - populate
+            a function that adds the structures and particles to the
+            world it is passed.  It is called on every rank with the same
+            seed, and has to produce the same state each time; every rank
+            then keeps the particles in its block.
+        - matrix_size
+            the matrix size of the worlds.
+        - shape (optional)
+            the (nx, ny, nz) grid of blocks, with nx * ny * nz the number
+            of ranks; by default balanced_shape of the number of ranks.
+        - ghost_width (optional)
+            by default the size of a cell.
+        - window (optional)
+            the length of the windows; see above.
+        - seed (optional)
+
+    """
+
+    def __init__(self, comm, make_model, populate, matrix_size, shape=None,
+                 ghost_width=None, window=None, seed=0):
+
+        self.comm = comm
+        self.rank = comm.rank
+
+        m = make_model()
+        self.species_by_name = {}
+        self.ghost_sid = {}
+        for species in list(m.species_types):
+            ghost = _gfrd.SpeciesType()
+            ghost['name'] = GHOST_PREFIX + species['name']
+            ghost['D'] = '0'
+            ghost['v'] = '0'
+            ghost['radius'] = species['radius']
+            ghost['structure_type'] = species['structure_type']
+            m.add_species_type(ghost)
+            self.species_by_name[species['name']] = species.id
+            self.ghost_sid[species.id] = ghost.id
+        self.ghost_sids = set(self.ghost_sid.values())
+
+        self.world = create_world(m, matrix_size)
+        myrandom.seed(seed)
+        populate(self.world)
+
+        self.structure_by_name = dict((structure.name, structure.id)
+                                      for structure in self.world.structures)
+        if len(self.structure_by_name) != len(list(self.world.structures)):
+            raise RuntimeError('DistributedEGFRD: structures need unique names.')
+
+        if shape is None:
+            shape = balanced_shape(comm.size)
+        if shape[0] * shape[1] * shape[2] != comm.size:
+            raise RuntimeError('DistributedEGFRD: %s blocks for %d ranks.' %
+                               (shape, comm.size))
+        self.decomposition = BlockDecomposition(self.world.world_size,
+                                                matrix_size, shape)
+        if ghost_width is None:
+            ghost_width = self.world.cell_size
+        if ghost_width > self.decomposition.min_width():
+            raise RuntimeError('DistributedEGFRD: ghost_width (%g) is larger '
+                               'than the narrowest block (%g).' %
+                               (ghost_width, self.decomposition.min_width()))
+        self.ghost_width = ghost_width
+
+        if window is None:
+            D_max = max([float(species['D']) for species in m.species_types] + [0.0])
+            window = ghost_width ** 2 / (54.0 * D_max) if D_max > 0.0 else numpy.inf
+        self.window = window
+
+        # keep the own particles, and let the ranks draw different numbers.
+        for pid, particle in list(self.world):
+            if self.decomposition.owner(particle.position) != self.rank:
+                self.world.remove_particle(pid)
+        myrandom.seed(seed + 1 + self.rank)
+
+        self.sim = EGFRDSimulator(self.world, myrandom.rng)
+
+        self.windows = 0
+        self.migrated = 0
+        self.ghosts = 0
+        self.conflicts = 0
+        self.step_time = 0.0
+        self.exchange_time = 0.0
+        # the number of particles of every species at the end of every
+        # window, before the exchange.
+        self.counts = []
+
+        self.exchange()
+
+    def pack(self, particle):
+        return (self.world.model.get_species_type_by_id(particle.sid)['name'],
+                self.world.get_structure(particle.structure_id).name,
+                tuple(particle.position))
+
+    def run(self, t_end):
+        """Advances the simulation to t_end, window by window."""
+
+        while self.sim.t < t_end:
+            start = time.time()
+            self.advance(min(self.sim.t + self.window, t_end))
+            self.step_time += time.time() - start
+            self.windows += 1
+            self.counts.append(self.count_particles())
+
+            start = time.time()
+            self.exchange()
+            self.exchange_time += time.time() - start
+
+    def advance(self, t):
+        # Steps the simulator to t and synchronizes all its particles there.
+
+        if self.world.num_particles == 0:
+            self.sim.t = t
+            return
+
+        synchronize(self.sim, t)
+
+    def exchange(self):
+        # Hands over the particles that left the block and replaces the ghosts.
+
+        outgoing = [([], []) for rank in range(self.comm.size)]
+        for pid, particle in list(self.world):
+            if particle.sid in self.ghost_sids:
+                self.world.remove_particle(pid)
+                continue
+
+            record = self.pack(particle)
+            owner = self.decomposition.owner(particle.position)
+            if owner != self.rank:
+                self.world.remove_particle(pid)
+                outgoing[owner][0].append(record)
+                self.migrated += 1
+            for rank in self.decomposition.ghost_ranks(particle.position, self.ghost_width):
+                outgoing[rank][1].append(record)
+
+        incoming = self.comm.alltoall(outgoing)
+
+        for migrants, _ in incoming:
+            for record in migrants:
+                self.add_migrant(record)
+        self.ghosts = 0
+        for _, ghosts in incoming:
+            for record in ghosts:
+                self.add_ghost(record)
+
+        # The simulator makes new domains for all particles at its next step.
+        self.sim.is_dirty = True
+
+    def add_migrant(self, record):
+        name, structure_name, position = record
+        sid = self.species_by_name[name]
+        structure_id = self.structure_by_name[structure_name]
+        position = numpy.array(position)
+        radius = self.world.get_species(sid).radius
+
+        overlaps = self.world.check_overlap((position, radius))
+        if overlaps:
+            self.conflicts += 1
+            if structure_id != self.world.get_def_structure_id():
+                raise RuntimeError('DistributedEGFRD: migrating particle %s '
+                                   'overlaps %s.' % (record, overlaps[0][0][0]))
+
+            (_, other), _ = overlaps[0]
+            direction = self.world.cyclic_transpose(position, other.position) - \
+                        other.position
+            position = self.world.apply_boundary(
+                other.position + SAFETY * (radius + other.radius) * normalize(direction))
+            if self.world.check_overlap((position, radius)):
+                raise RuntimeError('DistributedEGFRD: could not remove the '
+                                   'overlap of migrating particle %s.' % (record,))
+
+        self.world.new_particle(sid, structure_id, position)
+
+    def add_ghost(self, record):
+        name, structure_name, position = record
+        sid = self.ghost_sid[self.species_by_name[name]]
+        position = numpy.array(position)
+
+        # A migrant may already have been moved onto the spot.
+        if self.world.check_overlap((position, self.world.get_species(sid).radius)):
+            return
+
+        self.world.new_particle(sid, self.structure_by_name[structure_name], position)
+        self.ghosts += 1
+
+    def particles(self):
+        """The records of the particles (not the ghosts) of this rank."""
+        return [self.pack(particle) for pid, particle in self.world
+                if particle.sid not in self.ghost_sids]
+
+    def count_particles(self):
+        """The number of particles (not ghosts) of this rank by species
+        name."""
+        return dict((name, len(self.world.get_particle_ids(sid)))
+                    for name, sid in self.species_by_name.items())
+
+    def statistics(self):
+        return {'rank': self.rank,
+                'particles': self.world.num_particles - self.ghosts,
+                'ghosts': self.ghosts,
+                'cells': self.decomposition.cells(self.rank),
+                'grid_cells': self.decomposition.matrix_size ** 3,
+                'world_memory': self.world.memory_usage(),
+                'peak_rss_kb':
+                    resource.getrusage(resource.RUSAGE_SELF).ru_maxrss,
+                'counts': self.counts,
+                'steps': self.sim.step_counter,
+                'window': self.window,
+                'windows': self.windows,
+                'migrated': self.migrated,
+                'conflicts': self.conflicts,
+                'step_time': self.step_time,
+                'exchange_time': self.exchange_time}
+
+
+def _run(comm, make_model, populate, matrix_size, t_end, collect, kwargs):
+    part = DistributedEGFRD(comm, make_model, populate, matrix_size, **kwargs)
+    part.run(t_end)
+
+    retval = part.statistics()
+    if collect:
+        retval['final_particles'] = part.particles()
+    return comm.gather(retval)
+
+
+def _local_worker(rank, queues, args):
+    _run(LocalCommunicator(rank, queues), *args)
+
+
+def run_local(size, make_model, populate, matrix_size, t_end, collect=False,
+              **kwargs):
+    """Runs a simulation decomposed over size processes on this machine
+    until t_end.  Returns the statistics of every rank (see
+    DistributedEGFRD.statistics), with its final particles if collect is
+    set.  Further keyword arguments go to DistributedEGFRD."""
+
+    queues = [multiprocessing.Queue() for rank in range(size)]
+    args = (make_model, populate, matrix_size, t_end, collect, kwargs)
+
+    workers = [multiprocessing.Process(target=_local_worker,
+                                       args=(rank, queues, args))
+               for rank in range(1, size)]
+    for worker in workers:
+        worker.start()
+
+    # rank 0 runs in this process.
+    retval = _run(LocalCommunicator(0, queues), *args)
+
+    for worker in workers:
+        worker.join()
+        if worker.exitcode != 0:
+            raise RuntimeError('run_local: a rank failed (exit code %d).' %
+                               worker.exitcode)
+    return retval
+
+
+def run_mpi(make_model, populate, matrix_size, t_end, collect=False, **kwargs):
+    """As run_local, but over the processes of an MPI job, e.g.
+
+    $ mpirun -n 4 python script.py
+
+    Returns the statistics on rank 0 and None on the other ranks."""
+
+    return _run(MPICommunicator(), make_model, populate, matrix_size, t_end,
+                collect, kwargs)
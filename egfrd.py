@@ -69,7 +69,10 @@ from shells import (
     )
 
 import loadsave
+import _gfrd
 from histograms import *
+from bdzones import *
+from reservoir import *
 from time import sleep
 
 import logging
@@ -358,6 +361,8 @@ class EGFRDSimulator(ParticleSimulatorBase):
                 used, which uses Mersenne Twister from the GSL library.
                 You can set the seed of it with the function 
                 myrandom.seed.
+                Simulators that run concurrently in different threads
+                need their own generator, e.g. myrandom.create_gsl_rng().
             - network_rules
                 you don't need to use this, for backward compatibility only.
 
@@ -400,6 +405,9 @@ class EGFRDSimulator(ParticleSimulatorBase):
         self.domains = {}                       # a dictionary containing references to the domains that are defined
                                                 # in the simulation system. The id of the domain (domain_id) is the key.
                                                 # The domains can be a single, pair or multi of any type.
+        self.touched_domains = None             # the ids of the domains changed since the last consistency check,
+                                                # tracked once checking is switched on (see check_incremental)
+        self.checks_since_full_check = 0
         self.world = world
 
         # spatial histograms of domain type creation
@@ -415,6 +423,11 @@ class EGFRDSimulator(ParticleSimulatorBase):
         if self.UPDATES_HISTOGRAMS:
             self.activate_histograms('updates')
 
+        if reset:
+            self.bd_zones = None                # density-adaptive BD zones, see set_adaptive_BD()
+            self.reservoirs = {}                # species id -> Reservoir, see add_reservoir()
+            self.reaction_recorder = None       # a StreamingReactionRecorder that is given all reactions
+
         # other stuff
         self.is_dirty = True                    # The simulator is dirty if the state if the simulator is not
                                                 # consistent with the content of the world that it represents
@@ -430,9 +443,14 @@ class EGFRDSimulator(ParticleSimulatorBase):
         is completed.        
         """ #~MW
         if self.scheduler.size == 0:
-            return self.t                       # self.t is the current time of the simulator
+            next_time = self.t                  # self.t is the current time of the simulator
         else:
-            return self.scheduler.top[1].time
+            next_time = self.scheduler.top[1].time
+
+        if self.reservoirs:
+            next_time = min(next_time, self.next_reservoir().next_exchange)
+
+        return next_time
 
     # Some alias methods for the one above
     def get_next_event_time(self):        
@@ -486,11 +504,15 @@ class EGFRDSimulator(ParticleSimulatorBase):
 
         self.rejected_moves = 0
         self.reaction_events = 0
+        self.avoided_bursts = 0         # zero-shell singles that were not bursted again
         self.last_event = None
         self.last_reaction = None
 
 	self.t0 = 0.0
 
+        for reservoir in self.reservoirs.values():
+            reservoir.next_exchange = self.t + reservoir.interval
+
         self.is_dirty = True            # simulator needs to be re-initialized
 
 
@@ -511,6 +533,9 @@ class EGFRDSimulator(ParticleSimulatorBase):
 
         # create/clear other datastructures
         self.geometrycontainer = ShellContainer(self.world)
+        if self.touched_domains is not None:
+            self.touched_domains.clear()
+            self.geometrycontainer.touched_domains = self.touched_domains
 
         # 2. Couple all the particles in 'world' to a new 'single' in the eGFRD simulator
         # Fix order of adding particles (always, or at least in debug mode).
@@ -600,6 +625,115 @@ class EGFRDSimulator(ParticleSimulatorBase):
         self.dt = 0.0
 
 
+    def observe(self, t, species=None, region=None):
+        """Synchronize only the particles an observer needs at time t, 
+        and return them.
+
+        Unlike stop, which bursts all domains, this method bursts only 
+        the domains that hold a particle of one of the given species 
+        and/or have a shell reaching into the given region. All other 
+        domains keep their shells and events, so frequent sampling does 
+        not force the simulator to rebuild all its domains.
+
+        Arguments:
+            - t
+                the time at which to synchronize the particles. Should 
+                be between the current time of the simulator and the 
+                time of the next event; see stop.
+            - species
+                a list of species ids, or None for all species.
+            - region
+                a (position, radius) tuple describing a sphere, or None 
+                for the whole world.
+
+        Returns a list of the (pid, particle) pairs of the given species 
+        within the region, with their positions at time t.
+
+        Use count_particles to count the particles of a species; that 
+        does not require any bursting.
+
+        """
+        if __debug__:
+            log.info('observe at %s' % (FORMAT_DOUBLE % t))
+
+        # Apply the changes triggered by the last event first; see 
+        # burst_all_domains.
+        while self.dt == 0.0:
+            self.step()
+
+        if t >= self.scheduler.top[1].time:     # Can't observe later than the next event time
+            raise RuntimeError('observe: observation time (%g) >= next event time (%g).' % (t, self.next_time()))
+
+        if t < self.t:
+            raise RuntimeError('observe: observation time (%g) < current time (%g).' % (t, self.t))
+
+        self.t = t
+
+        if species is not None:
+            species = set(species)
+
+        if region is None:
+            domain_ids = self.domains.keys()
+        else:
+            domain_ids = self.geometrycontainer.get_neighbors_within_radius_no_sort(region[0], region[1])
+
+        if species is not None:
+            domain_ids = [domain_id for domain_id in domain_ids
+                          if any(pid_particle_pair[1].sid in species 
+                                 for pid_particle_pair in self.domains[domain_id].particles)]
+
+        self.burst_domains(list(domain_ids), [])
+
+        self.dt = self.next_time() - self.t
+
+        if species is None:
+            pid_particle_pairs = self.world
+        else:
+            pid_particle_pairs = (self.world.get_particle(pid) 
+                                  for sid in species 
+                                  for pid in self.world.get_particle_ids(sid))
+
+        if region is None:
+            return list(pid_particle_pairs)
+        else:
+            return [pid_particle_pair for pid_particle_pair in pid_particle_pairs
+                    if self.world.distance(pid_particle_pair[1].position, region[0]) <= region[1]]
+
+
+    def count_particles(self, species=None):
+        """Return the number of particles per species id.
+
+        The species of a particle only changes at an event, so the 
+        counts are those at any time up to the next event and no domain 
+        needs to be bursted.  The particles held by a reservoir (see 
+        add_reservoir) are included.
+
+        Arguments:
+            - species
+                a list of species ids, or None for all species.
+
+        """
+        if species is None:
+            species = [s.id for s in self.world.species]
+
+        counts = dict((sid, len(self.world.get_particle_ids(sid))) for sid in species)
+        for sid, reservoir in self.reservoirs.items():
+            if sid in counts:
+                counts[sid] += reservoir.count
+        return counts
+
+
+    def record_reaction(self, reaction):
+        """Give a reaction of a Single or Pair, as (rule, reactants,
+        products), to the reaction recorder."""
+        rr, reactants, products = reaction
+        rrec = self.reaction_recorder
+        rrec.time = self.t
+        rrec.record(rr.id,
+                    [pid_particle_pair[0] for pid_particle_pair in reactants
+                     if pid_particle_pair is not None],
+                    [pid_particle_pair[0] for pid_particle_pair in products])
+
     def step(self):
         """Execute one eGFRD step.
 
@@ -609,15 +743,28 @@ class EGFRDSimulator(ParticleSimulatorBase):
         if self.is_dirty:
             self.initialize()
             
+        # ECELL_CHECK=K checks the consistency of everything every K steps,
+        # and of the domains that changed in between.
         if __debug__:
-            if int("0" + os.environ.get("ECELL_CHECK", ""), 10):
-                self.check()
+            full_check_interval = int("0" + os.environ.get("ECELL_CHECK", ""), 10)
+            if full_check_interval:
+                self.check_incremental(full_check_interval)
 
         if __debug__ and self.control_bounds:
             self.check_particle_consistency()
         
         self.step_counter += 1
 
+        # 0. Let particles flow in from a reservoir if that is due first
+        #
+        if self.reservoirs:
+            reservoir = self.next_reservoir()
+            if self.scheduler.size == 0 or \
+               reservoir.next_exchange < self.scheduler.top[1].time:
+                self.exchange_with_reservoir(reservoir)
+                self.dt = self.get_next_time() - self.t
+                return
+
         if __debug__:
             if self.scheduler.size == 0:
                 raise RuntimeError('step: no Events in scheduler.')
@@ -657,13 +804,18 @@ class EGFRDSimulator(ParticleSimulatorBase):
                 if self.UPDATES_HISTOGRAMS:
                     self.DomainUpdatesHists.bin_domain(domain)
 
+        # Reactions in Multis are given to the recorder by the propagator.
+        if self.reaction_recorder is not None and \
+           isinstance(self.last_reaction, tuple):
+            self.record_reaction(self.last_reaction)
+
         if __debug__:
-            if self.scheduler.size == 0:
+            if self.scheduler.size == 0 and not self.reservoirs:
                 raise RuntimeError('step: zero events left.')
 
         # 3. Adjust the simulation time
         #
-        next_time = self.scheduler.top[1].time
+        next_time = self.get_next_time()
         log.info('step: next_time=%s' % next_time)
         self.dt = next_time - self.t
 
@@ -675,7 +827,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
             domain_counts = self.count_domains()
             log.info('\n\n%d: t=%s dt=%e (next_time=%s)\t' %
                      (self.step_counter, self.t,
-                      self.dt, self.scheduler.top[1].time) + 
+                      self.dt, next_time) + 
                      'Singles: %d, Pairs: %d, Multis: %d\n' % domain_counts + 
                      'event=#%d reactions=%d rejectedmoves=%d' %
                      (id, self.reaction_events, self.rejected_moves))
@@ -698,10 +850,12 @@ class EGFRDSimulator(ParticleSimulatorBase):
     #####################################
     #### METHODS FOR DOMAIN CREATION ####
     #####################################
-    def create_single(self, pid_particle_pair):
+    def create_single(self, pid_particle_pair, update_shell=True):
     # Create a new single domain from a particle.
     # The interaction can be any NonInteractionSingle (SphericalSingle, PlanarSurface or CylindricalSurface
     # NonInteractionSingle).
+    # If 'update_shell' is False the shell is not put in the shell container; the caller
+    # has to do that.
 
         # 1. generate identifiers for the domain and shell. The event_id is
         # generated by the scheduler
@@ -728,7 +882,8 @@ class EGFRDSimulator(ParticleSimulatorBase):
         self.domains[domain_id] = single
 
         # 3. update the proper shell container
-        self.geometrycontainer.move_shell(single.shell_id_shell_pair)
+        if update_shell:
+            self.geometrycontainer.move_shell(single.shell_id_shell_pair)
 
         #if __debug__:
             ## Used in __str__.
@@ -984,6 +1139,8 @@ class EGFRDSimulator(ParticleSimulatorBase):
             log.info("remove: %s" % obj)
         # TODO assert that the domain is not still in the scheduler
         del self.domains[obj.domain_id]
+        if self.touched_domains is not None:
+            self.touched_domains.add(obj.domain_id)
         for shell_id_shell_pair in obj.shell_list:
             self.geometrycontainer.remove_shell(shell_id_shell_pair)
 
@@ -1009,6 +1166,26 @@ class EGFRDSimulator(ParticleSimulatorBase):
                      (domain.domain_id, event_id, event_time )
                     )
         domain.event_id = event_id                      # FIXME side effect programming -> unclear!!
+        if self.touched_domains is not None:
+            self.touched_domains.add(domain.domain_id)
+
+
+    def add_domain_events(self, domains):
+    # Same as add_domain_event, but adds the events of all the 'domains' to the
+    # scheduler in one go.
+        events = []
+        for domain in domains:
+            domain.dt = round(domain.dt, SCHEDULER_DIGITS)
+            events.append(DomainEvent(self.t + domain.dt, domain))
+
+        event_ids = self.scheduler.add_events(events)
+        for domain, event_id in zip(domains, event_ids):
+            if __debug__:
+                log.info('add_event: %s, event=#%d, t=%s' %
+                         (domain.domain_id, event_id, self.t + domain.dt))
+            domain.event_id = event_id
+            if self.touched_domains is not None:
+                self.touched_domains.add(domain.domain_id)
 
 
     # TODO This method can be made a method to the scheduler class
@@ -1024,14 +1201,19 @@ class EGFRDSimulator(ParticleSimulatorBase):
             log.info('update_event: %s, event=#%d, t=%s' %
                      (domain.domain_id, domain.event_id, t))
         self.scheduler.update((domain.event_id, DomainEvent(t, domain)))
+        if self.touched_domains is not None:
+            self.touched_domains.add(domain.domain_id)
 
 
     #####################################
     #### METHODS FOR DOMAIN BURSTING ####
     #####################################
-    def burst_domain(self, domain, ignore):
+    def burst_domain(self, domain, ignore, deferred=None):
     # Reduces 'domain' (Single, Pair or Multi) to 'zero_singles', singles
     # with the zero shell, and dt=0.
+    # If 'deferred' is a list, the new zero_singles are appended to it and are
+    # neither put in the shell container nor scheduled, and the domains around
+    # them are not bursted; see burst_batch.
     # returns:
     # - list of zero_singles that was the result of the bursting
     # - updated ignore list
@@ -1043,12 +1225,12 @@ class EGFRDSimulator(ParticleSimulatorBase):
 
         if isinstance(domain, Single):  # Single
             # TODO. Compare with gfrd.
-            zero_singles, ignore = self.burst_single(domain, ignore)
+            zero_singles, ignore = self.burst_single(domain, ignore, deferred)
         elif isinstance(domain, Pair):  # Pair
-            zero_singles, ignore = self.burst_pair(domain, ignore)
+            zero_singles, ignore = self.burst_pair(domain, ignore, deferred)
         else:                           # Multi
             assert isinstance(domain, Multi)
-            zero_singles, ignore = self.burst_multi(domain, ignore)
+            zero_singles, ignore = self.burst_multi(domain, ignore, deferred)
 
         if __debug__:
             # After a burst, the domain should be gone and should be on the ignore list.
@@ -1061,7 +1243,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
         return zero_singles, ignore
 
 
-    def burst_single(self, single, ignore):
+    def burst_single(self, single, ignore, deferred=None):
         # Bursts the 'single' domain and updates the 'ignore' list.
         # Returns:
         # - zero_singles that are the result of bursting the single (can be multiple
@@ -1083,10 +1265,10 @@ class EGFRDSimulator(ParticleSimulatorBase):
         # to simulate the natural occurence of the event we have to remove it from the scheduler
         self.remove_event(single)
 
-        return self.process_single_event(single, ignore)
+        return self.process_single_event(single, ignore, deferred)
 
 
-    def burst_pair(self, pair, ignore):
+    def burst_pair(self, pair, ignore, deferred=None):
         # Bursts the 'pair' domain and updates the 'ignore' list.
         # Returns:
         # - zero_singles that are the result of bursting the pair (can be more than two
@@ -1108,10 +1290,10 @@ class EGFRDSimulator(ParticleSimulatorBase):
         # to simulate the natural occurence of the event we have to remove it from the scheduler
         self.remove_event(pair)
 
-        return self.process_pair_event(pair, ignore)
+        return self.process_pair_event(pair, ignore, deferred)
 
 
-    def burst_multi(self, multi, ignore):
+    def burst_multi(self, multi, ignore, deferred=None):
         # Bursts the 'multi' domain and updates the 'ignore' list.
         # Returns:
         # - zero_singles that are the result of bursting the multi (note that the burst is
@@ -1131,7 +1313,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
         # to simulate the natural occurence of the event we have to remove it from the scheduler
         self.remove_event(multi)        # The old event was still in the scheduler
 
-        return self.break_up_multi(multi, ignore)
+        return self.break_up_multi(multi, ignore, deferred)
 
 
     def burst_volume(self, pos, radius, ignore=[]):
@@ -1201,16 +1383,25 @@ class EGFRDSimulator(ParticleSimulatorBase):
         # - updated ignore list
 
         zero_singles = []
+        domains = []
         for domain_id in domain_ids:
             if domain_id not in ignore:
                 domain = self.domains[domain_id]
 
-                # add the domain_id to the list of domains that is already bursted (ignore list),
-                # and burst the domain.
+                # add the domain_id to the list of domains that is already bursted (ignore list)
                 ignore.append(domain_id)
-                more_zero_singles, ignore = self.burst_domain(domain, ignore)
-                # add the resulting zero_singles from the burst to the total list of zero_singles.
-                zero_singles.extend(more_zero_singles)
+
+                if isinstance(domain, NonInteractionSingle) and domain.has_zero_shell():
+                    # The domain is a zero_single already (or an immobile single, of which
+                    # the particle did not move); bursting it would only replace it by a
+                    # new, identical zero_single.
+                    self.avoided_bursts += 1
+                    zero_singles.append(domain)
+                else:
+                    domains.append(domain)
+
+        more_zero_singles, ignore = self.burst_batch(domains, ignore)
+        zero_singles.extend(more_zero_singles)
 
         return zero_singles, ignore
 
@@ -1221,17 +1412,24 @@ class EGFRDSimulator(ParticleSimulatorBase):
         # Returns:
         # - the updated list domains that are already bursted -> ignore list
         # - zero_singles that were the result of the burst
+        return self.burst_batch(self.collect_non_multis(pos, radius, ignore), ignore)
+
+
+    def collect_non_multis(self, pos, radius, ignore):
+        # Returns the domains within 'radius' centered around 'pos' that are to be
+        # bursted by burst_non_multis, and puts them on the 'ignore' list.
         # get the neighbors in the burstradius that are not already bursted.
         neighbor_ids = self.geometrycontainer.get_neighbors_within_radius_no_sort(pos, SAFETY*radius, ignore)        
 
-        zero_singles = []
+        domains = []
         for domain_id in neighbor_ids:
             if domain_id not in ignore:                 # the list 'ignore' may have been updated in a
                 domain = self.domains[domain_id]        # previous iteration of the loop
 
-                if isinstance(domain, NonInteractionSingle) and domain.is_reset():
+                if isinstance(domain, NonInteractionSingle) and domain.has_zero_shell():
                     # If the domain was already bursted, but was not on the ignore list yet, put it there.
                     # NOTE: we assume that the domain has already bursted around it when it was made!                    
+                    # Immobile singles never need bursting; their particle did not move.
                     ignore.append(domain_id)
 
                 elif (not isinstance(domain, Multi)): #and (self.t != domain.last_time): ## TESTING TESTING TESTING
@@ -1246,12 +1444,9 @@ class EGFRDSimulator(ParticleSimulatorBase):
                                               # of new domains that will not be bursted at the second Multi-breakup 
                                               # because dt=0. This may lead to overlaps.
  
-                    # add the domain_id to the list of domains that is already bursted (ignore list),
-                    # and burst the domain.
+                    # add the domain_id to the list of domains that is already bursted (ignore list)
                     ignore.append(domain_id)
-                    more_zero_singles, ignore = self.burst_domain(domain, ignore)
-                    # add the resulting zero_singles from the burst to the total list of zero_singles.
-                    zero_singles.extend(more_zero_singles)
+                    domains.append(domain)
 
                 #else:
                     # Don't burst domain if (OR):
@@ -1263,6 +1458,49 @@ class EGFRDSimulator(ParticleSimulatorBase):
                     # NOTE that the domain id is NOT added to the ignore list since it may be bursted at a later
                     # time
 
+        return domains
+
+
+    def collect_around(self, zero_singles, ignore):
+        # Returns the domains to be bursted around the newly made 'zero_singles', and puts
+        # them on the 'ignore' list.
+        # For each zero_single the burst radius equals the particle radius * SINGLE_SHELL_FACTOR
+        domains = []
+        for zero_single in zero_singles:
+            domains.extend(self.collect_non_multis(zero_single.pid_particle_pair[1].position,
+                                                   zero_single.pid_particle_pair[1].radius*SINGLE_SHELL_FACTOR,
+                                                   ignore))
+        return domains
+
+
+    def burst_around(self, zero_singles, ignore):
+        # Recursively bursts the domains around the newly made 'zero_singles'.
+        # Returns the resulting zero_singles and the updated ignore list.
+        return self.burst_batch(self.collect_around(zero_singles, ignore), ignore)
+
+
+    def burst_batch(self, domains, ignore):
+        # Bursts the 'domains' (which should already be on the 'ignore' list) in waves.
+        # All the domains of a wave are propagated first; then the shells of the
+        # resulting zero_singles are put in the shell container in one pass and their
+        # events are added to the scheduler in one go. The next wave consists of the
+        # domains around these zero_singles.
+        # Returns:
+        # - zero_singles that were the result of the burst
+        # - the updated ignore list
+        zero_singles = []
+        while domains:
+            new_zero_singles = []
+            for domain in domains:
+                more_zero_singles, ignore = self.burst_domain(domain, ignore, new_zero_singles)
+                zero_singles.extend(more_zero_singles)
+
+            for zero_single in new_zero_singles:
+                self.geometrycontainer.move_shell(zero_single.shell_id_shell_pair)
+            self.add_domain_events(new_zero_singles)
+
+            domains = self.collect_around(new_zero_singles, ignore)
+
         return zero_singles, ignore
 
 
@@ -2029,15 +2267,6 @@ class EGFRDSimulator(ParticleSimulatorBase):
         assert isinstance(single, NonInteractionSingle)
         assert single.is_reset()
         
-        # Special case: When D=0, nothing needs to change and only new event
-        # time is drawn
-        # TODO find nicer construction than just this if statement
-       #if single.getD() == 0:
-           #single.dt, single.event_type = single.determine_next_event() 
-           #single.last_time = self.t
-           #self.add_domain_event(single)
-           #return single
-
 
         # 0. Get generic info
         single_pos = single.pid_particle_pair[1].position
@@ -2069,9 +2298,17 @@ class EGFRDSimulator(ParticleSimulatorBase):
         #
         # Note that we do not differentiate between directions. This means that we
         # look around in a sphere, the horizons are spherical.
+        # Two static particles can never meet; they are not each others partners.
+        single_is_static = single.is_static()
+
+        # In BD zones, as everywhere in BD-only mode, every particle goes into a Multi.
+        in_bd_zone = self.in_bd_zone(single_pos)
+        force_multi = self.BD_ONLY_FLAG or in_bd_zone
+
         pair_interaction_partners = []
         for domain, _ in neighbor_distances:
-            if (isinstance (domain, NonInteractionSingle) and domain.is_reset()):
+            if (isinstance (domain, NonInteractionSingle) and domain.has_zero_shell()) and \
+               not (single_is_static and domain.is_static()):
                 # distance from the center of the particles/domains
                 pair_distance = self.world.distance(single_pos, domain.shell.shape.position)
                 pair_horizon  = (single_radius + domain.pid_particle_pair[1].radius) * SINGLE_SHELL_FACTOR
@@ -2094,7 +2331,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
         domain = None
         for obj, hor_overlap in pair_interaction_partners:
 
-            if hor_overlap > 0.0 or domain or self.BD_ONLY_FLAG :
+            if hor_overlap > 0.0 or domain or force_multi :
                 # there are no more potential partners (everything is out of range)
                 # or a domain was formed successfully previously
                 # or the user wants to force the system into BD mode = Multi creation
@@ -2123,7 +2360,9 @@ class EGFRDSimulator(ParticleSimulatorBase):
             multi_partners = []
             for domain, dist_to_shell in neighbor_distances:
 
-                if (isinstance (domain, NonInteractionSingle) and domain.is_reset()):
+                if (isinstance (domain, NonInteractionSingle) and domain.has_zero_shell()):
+                    if single_is_static and domain.is_static():
+                        continue
                     multi_horizon = (single_radius + domain.pid_particle_pair[1].radius) * MULTI_SHELL_FACTOR
                     distance = self.world.distance(single_pos, domain.shell.shape.position)
                     multi_partners.append((domain, distance - multi_horizon))                    
@@ -2168,7 +2407,17 @@ class EGFRDSimulator(ParticleSimulatorBase):
             # If the closest partner is within the multi horizon we do Multi, otherwise Single
             # Here we also check whether the uses force-deactivated the construction of this particular
             # Single type, or wants to run the simulator in BD mode only anyhow
-            if  closest_overlap > 0.0 and not self.BD_ONLY_FLAG:
+            if  closest_overlap > 0.0 and not force_multi and single_is_static:
+                # A static particle does not need a shell; make an immobile single
+                # that keeps its zero shell and only waits for its reaction.
+                single.make_immobile(self.t)
+                self.add_domain_event(single)
+                if __debug__:
+                    log.info('        * Immobile single: %s, dt=%s' % (single, FORMAT_DOUBLE % single.dt))
+                    assert self.check_domain(single)
+                bin_domain = single
+
+            elif closest_overlap > 0.0 and not force_multi:
                 try:
                     if allowed_to_make[single.testShell.__class__]:                    
                         # Just make a normal NonInteractionSingle
@@ -2188,6 +2437,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
                 # An object was closer than the Multi horizon
                 # Form a multi with everything that is in the multi_horizon
                 domain = self.form_multi(single, multi_partners)
+                domain.bd_zone = domain.bd_zone or in_bd_zone
                 bin_domain = domain
 
         else:
@@ -2199,6 +2449,14 @@ class EGFRDSimulator(ParticleSimulatorBase):
         if self.CREATION_HISTOGRAMS:
             self.DomainCreationHists.bin_domain(bin_domain)
 
+        # Tell the BD zones how long a time step the domain got; domains
+        # forced into a Multi tell nothing.
+        particle = single.pid_particle_pair[1]
+        if self.bd_zones is not None and not force_multi and particle.D > 0.0:
+            self.bd_zones.record_domain(single_pos,
+                0.0 if isinstance(bin_domain, Multi) else bin_domain.dt,
+                bd_time_step(particle.radius, particle.D, self.DEFAULT_STEP_SIZE_FACTOR))
+
         self.single_steps['MAKE_NEW_DOMAIN'] += 1
 
         return domain
@@ -2295,7 +2553,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
         return single
 
 
-    def process_single_event(self, single, ignore):
+    def process_single_event(self, single, ignore, deferred=None):
     # This method handles the things that need to be done when the current event was
     # produced by a single. The single can be a NonInteractionSingle or an InteractionSingle.
     # Note that this method is also called when a single is bursted, in that case the event
@@ -2310,6 +2568,9 @@ class EGFRDSimulator(ParticleSimulatorBase):
     #   Note that these could be many since the event can induce recursive bursting. 
     # - the updated ignore list. This contains the id of the 'single' domain, IDs of domains
     #   bursted in the process and the IDs of zero-dt singles.
+    #
+    # If 'deferred' is a list, the zero-dt singles around the particles are left to the
+    # caller (see burst_domain).
 
         if __debug__:
            ## TODO assert that there is no event associated with this domain in the scheduler
@@ -2320,11 +2581,15 @@ class EGFRDSimulator(ParticleSimulatorBase):
         ### SPECIAL CASE 1:
         # If just need to make new domain.
         if single.is_reset():
-            if __debug__:
-                log.info('FIRE SINGLE: make_new_domain()')
-                log.info('single = %s' % single)
-            domains = [self.make_new_domain(single)]
-            # domain is already scheduled in make_new_domain
+            if self.absorb_into_reservoir(single):
+                # the particle has left the buffer layer of its reservoir
+                domains = []
+            else:
+                if __debug__:
+                    log.info('FIRE SINGLE: make_new_domain()')
+                    log.info('single = %s' % single)
+                domains = [self.make_new_domain(single)]
+                # domain is already scheduled in make_new_domain
 
         ### SPECIAL CASE 2:
         # In case nothing is scheduled to happen: do nothing and just reschedule
@@ -2421,8 +2686,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
             zero_singles = []
             for pid_particle_pair in particles:
 #               single.pid_particle_pair = pid_particle_pair         # TODO reuse single
-                zero_single = self.create_single(pid_particle_pair)  # TODO re-use NonInteractionSingle domain if possible
-                self.add_domain_event(zero_single)                   # TODO re-use event if possible
+                zero_single = self.create_single(pid_particle_pair, deferred is None)  # TODO re-use NonInteractionSingle domain if possible
                 zero_singles.append(zero_single)       # Add the newly made zero-dt singles to the list
                 ignore.append(zero_single.domain_id)   # Ignore these newly made singles (they should not be bursted)
             domains.extend(zero_singles)
@@ -2430,11 +2694,12 @@ class EGFRDSimulator(ParticleSimulatorBase):
             ### 6. Recursively burst around the newly made zero-dt NonInteractionSingles that surround the particles.
             #      For each zero_single the burst radius equals the particle radius * SINGLE_SHELL_FACTOR
             #      Add the resulting zero_singles to the already existing list.
-            for zero_single in zero_singles:
-                more_zero_singles, ignore = self.burst_non_multis(zero_single.pid_particle_pair[1].position,
-                                                                  zero_single.pid_particle_pair[1].radius*SINGLE_SHELL_FACTOR,
-                                                                  ignore)
+            if deferred is None:
+                self.add_domain_events(zero_singles)
+                more_zero_singles, ignore = self.burst_around(zero_singles, ignore)
                 domains.extend(more_zero_singles)
+            else:
+                deferred.extend(zero_singles)
 
             if __debug__:
                 # check that at least all the zero_singles are on the ignore list
@@ -2458,7 +2723,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
         return domains, ignore
 
 
-    def process_pair_event(self, pair, ignore):
+    def process_pair_event(self, pair, ignore, deferred=None):
     # This method handles the things that need to be done when the current event was
     # produced by a pair. The pair can be any type of pair (Simple or Mixed).
     # Note that this method is also called when a pair is bursted, in that case the event
@@ -2470,6 +2735,8 @@ class EGFRDSimulator(ParticleSimulatorBase):
     #   recursive bursting.
     # - the updated ignore list. This contains the id of the 'pair' domain, ids of domains
     #   bursted in the process and the ids of zero-dt singles.
+    # If 'deferred' is a list, the zero-dt singles around the particles are left to the
+    # caller (see burst_domain).
 
         if __debug__:
             log.info('FIRE PAIR: %s' % pair.event_type)
@@ -2573,8 +2840,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
             zero_singles = []
             for pid_particle_pair in particles:
                 # 5. make a new single and schedule
-                zero_single = self.create_single(pid_particle_pair)  # TODO reuse the non-reacting single domain
-                self.add_domain_event(zero_single)
+                zero_single = self.create_single(pid_particle_pair, deferred is None)  # TODO reuse the non-reacting single domain
                 zero_singles.append(zero_single)
 
         #
@@ -2588,8 +2854,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
             zero_singles = []
             for pid_particle_pair in particles:
                 # 5. make a new single and schedule
-                zero_single = self.create_single(pid_particle_pair)
-                self.add_domain_event(zero_single)
+                zero_single = self.create_single(pid_particle_pair, deferred is None)
                 zero_singles.append(zero_single)
 
         # Just moving the particles
@@ -2608,8 +2873,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
             zero_singles = []
             for pid_particle_pair in particles:
                 # 5. make a new single and schedule
-                zero_single = self.create_single(pid_particle_pair)  # TODO reuse domains that were cached in the pair
-                self.add_domain_event(zero_single)
+                zero_single = self.create_single(pid_particle_pair, deferred is None)  # TODO reuse domains that were cached in the pair
                 zero_singles.append(zero_single)
 
         else:
@@ -2670,13 +2934,13 @@ class EGFRDSimulator(ParticleSimulatorBase):
         zero_singles_fin.extend(zero_singles)       # Add the zero-dt singles around the particles
 
         ### 6. Recursively burst around the newly made zero-dt NonInteractionSingles that surround the particles.
-        for zero_single in zero_singles:
-            
-            more_zero_singles, ignore = self.burst_non_multis(zero_single.pid_particle_pair[1].position,
-                                                              zero_single.pid_particle_pair[1].radius*SINGLE_SHELL_FACTOR,
-                                                              ignore)
+        if deferred is None:
+            self.add_domain_events(zero_singles)
+            more_zero_singles, ignore = self.burst_around(zero_singles, ignore)
             # Also add the zero-dt singles from this bursting to the final list
             zero_singles_fin.extend(more_zero_singles)
+        else:
+            deferred.extend(zero_singles)
 
         # Some usefull checks in debugging mode
         # Check that at least all the zero_singles are on the ignore list
@@ -2729,9 +2993,16 @@ class EGFRDSimulator(ParticleSimulatorBase):
             self.reaction_events += 1
             self.last_reaction = multi.last_reaction
 
+        if self.bd_zones is not None:
+            self.bd_zones.sample_multi(multi, self.world, self.DEFAULT_STEP_SIZE_FACTOR)
+
         if multi.last_event is not EventType.MULTI_DIFFUSION:                # if an event took place
             zero_singles, ignore = self.break_up_multi(multi, ignore)
             #self.multi_steps[multi.last_event] += 1
+        elif multi.bd_zone and self.bd_zones is not None and self.bd_zones.releases(multi):
+            # The BD zone the multi was made in has thinned out; let its particles get
+            # analytical domains again.
+            zero_singles, ignore = self.break_up_multi(multi, ignore)
         else:
             multi.last_time = self.t
             self.add_domain_event(multi)
@@ -2741,9 +3012,10 @@ class EGFRDSimulator(ParticleSimulatorBase):
         return zero_singles, ignore
 
 
-    def break_up_multi(self, multi, ignore):
+    def break_up_multi(self, multi, ignore, deferred=None):
         # Dissolves 'multi' into zero_singles, single with a zero shell (dt=0)
         # - 'ignore' contains domain ids that should be ignored
+        # - if 'deferred' is a list, the zero_singles are left to the caller (see burst_domain)
         # returns:
         # - updated ignore list
         # - zero_singles that were the product of the breakup
@@ -2752,19 +3024,19 @@ class EGFRDSimulator(ParticleSimulatorBase):
 
         zero_singles = []
         for pid_particle_pair in multi.particles:
-            zero_single = self.create_single(pid_particle_pair)
-            self.add_domain_event(zero_single)
+            zero_single = self.create_single(pid_particle_pair, deferred is None)
             zero_singles.append(zero_single)
             ignore.append(zero_single.domain_id)
 
-        zero_singles_fin = zero_singles     # Put the zero-dt singles around the particles into the final list
+        zero_singles_fin = list(zero_singles)   # Put the zero-dt singles around the particles into the final list
 
         ### Recursively burst around the newly made zero-dt NonInteractionSingles that surround the particles.
-        for zero_single in zero_singles:
-            more_zero_singles, ignore = self.burst_non_multis(zero_single.pid_particle_pair[1].position,
-                                                              zero_single.pid_particle_pair[1].radius*SINGLE_SHELL_FACTOR,
-                                                              ignore)
+        if deferred is None:
+            self.add_domain_events(zero_singles)
+            more_zero_singles, ignore = self.burst_around(zero_singles, ignore)
             zero_singles_fin.extend(more_zero_singles)
+        else:
+            deferred.extend(zero_singles)
 
         # check that at least all the zero_singles are on the ignore list
         if __debug__:
@@ -2938,7 +3210,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
         # The 'multi_partners' are neighboring NonInteractionSingles, Multis and surfaces which
         # can be added to the Multi (this can also be empty)
         for partner, overlap in multi_partners:
-            assert ((isinstance(partner, NonInteractionSingle) and partner.is_reset()) or \
+            assert ((isinstance(partner, NonInteractionSingle) and partner.has_zero_shell()) or \
                     isinstance(partner, Multi) or \
                     isinstance(partner, PlanarSurface) or \
                     isinstance(partner, DiskSurface) or \
@@ -2975,7 +3247,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
 
         # Add all partner domains (multi and dt=0 NonInteractionSingles) in the horizon to the multi
         for partner in neighbors:            
-            if (isinstance(partner, NonInteractionSingle) and partner.is_reset()) or \
+            if (isinstance(partner, NonInteractionSingle) and partner.has_zero_shell()) or \
                isinstance(partner, Multi):
                 self.add_to_multi_recursive(partner, multi)
             else:
@@ -3006,7 +3278,7 @@ class EGFRDSimulator(ParticleSimulatorBase):
             log.debug('add_to_multi_recursive:\t domain: %s, multi: %s' % (domain, multi))
 
         if isinstance(domain, NonInteractionSingle):
-            assert domain.is_reset()        # domain must be zero-dt NonInteractionSingle
+            assert domain.has_zero_shell()  # domain must be zero-dt or immobile NonInteractionSingle
 
             # check that the particles were not already added to the multi previously
             if multi.has_particle(domain.pid_particle_pair[0]):
@@ -3034,7 +3306,8 @@ class EGFRDSimulator(ParticleSimulatorBase):
             #    - are just bursted (initialized) NonInteractionSingles
             for neighbor, dist_to_shell in neighbor_distances:
 
-                if (isinstance (neighbor, NonInteractionSingle) and neighbor.is_reset()):
+                if (isinstance (neighbor, NonInteractionSingle) and neighbor.has_zero_shell()) and \
+                   not (domain.is_static() and neighbor.is_static()):
                     multi_horizon = (domain.pid_particle_pair[1].radius + neighbor.pid_particle_pair[1].radius) * \
                                     MULTI_SHELL_FACTOR
                     # distance from the center of the particles/domains
@@ -3176,6 +3449,7 @@ updates: %d
 \tmulti hardcore time step minimum: %s
 total reactions:     %d
 rejected moves:      %d
+avoided bursts:      %d
 overlap remover was: %s
 max. overlap error:  %g
 ''' \
@@ -3214,12 +3488,26 @@ max. overlap error:  %g
                ('inactive' if self.BD_DT_HARDCORE_MIN < 0.0 else self.BD_DT_HARDCORE_MIN),
                self.reaction_events,
                self.rejected_moves,
+               self.avoided_bursts,
                ('active' if self.REMOVE_OVERLAPS else 'inactive'),
                self.max_overlap_error               
                )
 
         print >> out, report
 
+    def memory_usage(self):
+        """Return the (live, reserved) bytes taken by the main data 
+        structures of the simulator, by subsystem.
+
+        The sizes of tree nodes are estimates; see 
+        utils/memory_usage.hpp.
+
+        """
+        return {'world': self.world.memory_usage(),
+                'shells': self.geometrycontainer.memory_usage(),
+                'scheduler': self.scheduler.memory_usage(),
+                'tables': (_gfrd.tabulated_memory_usage(), ) * 2}
+
 
     def activate_histograms(self, modes=['creation', 'updates']):
         """ Activate and initialize the shell creation and / or updates histograms.
@@ -3380,10 +3668,10 @@ max. overlap error:  %g
             # testing overlap criteria
             for neighbor, _ in neighbors:
                 # note that the shell of a MixedPair or Multi that has have just been bursted can stick into each other.
-                if not (((isinstance(domain, hasCylindricalShell)   and isinstance(domain, NonInteractionSingle)   and domain.is_reset()) and \
-                         (isinstance(neighbor, hasSphericalShell)   and isinstance(neighbor, NonInteractionSingle) and domain.is_reset()) ) or \
-                        ((isinstance(domain, hasSphericalShell)     and isinstance(domain, NonInteractionSingle)   and domain.is_reset()) and \
-                         (isinstance(neighbor, hasCylindricalShell) and isinstance(neighbor, NonInteractionSingle) and domain.is_reset()) )):
+                if not (((isinstance(domain, hasCylindricalShell)   and isinstance(domain, NonInteractionSingle)   and domain.has_zero_shell()) and \
+                         (isinstance(neighbor, hasSphericalShell)   and isinstance(neighbor, NonInteractionSingle) and domain.has_zero_shell()) ) or \
+                        ((isinstance(domain, hasSphericalShell)     and isinstance(domain, NonInteractionSingle)   and domain.has_zero_shell()) and \
+                         (isinstance(neighbor, hasCylindricalShell) and isinstance(neighbor, NonInteractionSingle) and domain.has_zero_shell()) )):
 
                     for _, neighbor_shell in neighbor.shell_list:
                         overlap = self.check_shape_overlap(shell.shape, neighbor_shell.shape)
@@ -3772,6 +4060,66 @@ max. overlap error:  %g
             raise RuntimeError('check_domains: following domains in self.domains are not in '
                                'event scheduler: %s' % str(tuple(event_ids)))
 
+    def check_touched(self):
+        ### checks the domains that changed since the last check: the
+        #   domains that were (re)scheduled or removed, or whose shells were
+        #   moved.  This takes time in proportion to the number of these
+        #   rather than to the size of the system.
+        assert self.t >= 0.0
+        assert self.dt >= 0.0
+
+        if self.scheduler.size != len(self.domains):
+            raise RuntimeError('check_touched: %d events in scheduler != %d domains' %
+                               (self.scheduler.size, len(self.domains)))
+
+        for domain_id in self.touched_domains:
+            domain = self.domains.get(domain_id)
+            if domain is None:
+                # removed; remove_domain took its shells out.
+                continue
+
+            # the event of the domain is in the scheduler.
+            try:
+                event = self.scheduler[domain.event_id]
+            except (IndexError, KeyError):
+                raise RuntimeError('check_touched: event for domain_id %s could not be found in scheduler' %
+                                   str(domain_id))
+            assert event.data == domain_id
+            assert abs(domain.last_time + domain.dt - event.time) <= TIME_TOLERANCE * event.time
+
+            # the shells of the domain are in the shell containers.
+            for shell_id, shell in domain.shell_list:
+                container = self.geometrycontainer.get_container(shell)
+                if not container.contains(shell_id):
+                    raise RuntimeError('check_touched: shell %s of domain %s not in shell container' %
+                                       (str(shell_id), str(domain_id)))
+                assert container[shell_id].did == domain_id
+
+            # the particles of the domain are in the world.
+            for pid, _ in domain.particles:
+                if pid not in self.world:
+                    raise RuntimeError('check_touched: particle %s of domain %s not in world' %
+                                       (str(pid), str(domain_id)))
+
+            self.check_domain(domain)
+
+    def check_incremental(self, full_check_interval):
+        # Runs check_touched, and the full check instead every
+        # full_check_interval calls.  The domains are only tracked from the
+        # first call on, which therefore does the full check.
+        if self.touched_domains is None or \
+           self.checks_since_full_check + 1 >= full_check_interval:
+            self.check()
+            self.checks_since_full_check = 0
+            if self.touched_domains is None:
+                self.touched_domains = set()
+                self.geometrycontainer.touched_domains = self.touched_domains
+        else:
+            self.check_touched()
+            self.checks_since_full_check += 1
+
+        self.touched_domains.clear()
+
     def check_pair_pos(self, pair, pos1, pos2, com, radius):
         particle1 = pair.pid_particle_pair1[1]
         particle2 = pair.pid_particle_pair2[1]
@@ -3898,7 +4246,7 @@ max. overlap error:  %g
         # Re-initialize the simulator using the seed
         # from the input file
         self.reset_seed(seed)
-        self.__init__(world, myrandom.rng, reset=False)
+        self.__init__(world, self.rng, reset=False)
             # reset=False ensures the statistics are not lost
 
         # Set the simulator time to the time it had at output
@@ -3954,6 +4302,111 @@ max. overlap error:  %g
 
         self.BD_ONLY_FLAG = False
 
+    def set_adaptive_BD(self, nbins=10, promote=1.0, demote=0.1, **kwargs):
+        """Let crowded regions switch to BD by themselves.
+
+        The world is divided into nbins^3 cells, in which the simulator
+        compares the time steps the domains get with the BD time step
+        (see bdzones.BDZones).  A cell where the domains fire more than
+        'promote' times per BD step becomes a BD zone: its particles go
+        into Multis, which keep propagating them with newBDPropagator.  It
+        turns back into a regular region once the free space around its
+        particles would let singles fire less than 'demote' times per BD
+        step; Multis made in the zone are then broken up.
+
+        """
+        self.bd_zones = BDZones(self.world.world_size, nbins, promote, demote, **kwargs)
+
+    def unset_adaptive_BD(self):
+
+        self.bd_zones = None
+
+    def in_bd_zone(self, pos):
+
+        return self.bd_zones is not None and self.bd_zones.is_bd_zone(pos)
+
+    def add_reservoir(self, species, surfaces, buffer, count=0, **kwargs):
+        """Represent the particles of a bulk species that are farther
+        than 'buffer' from the given surfaces by their number only.
+
+        Arguments:
+            - species
+                a bulk Species.
+            - surfaces
+                the PlanarSurfaces and CylindricalSurfaces (or their 
+                ids) near which the particles are simulated explicitly.
+            - buffer
+                the thickness of the layer around the surfaces in which 
+                the particles are simulated explicitly.
+            - count
+                the number of particles in the reservoir to start with.
+                Explicit particles of the species beyond the layer are 
+                moved into the reservoir at the first step, so one can 
+                also throw in all of them as usual.
+
+        Further keyword arguments (bound_1, bound_2, interval) are passed 
+        on to reservoir.Reservoir, which describes the scheme.  Returns 
+        the Reservoir; its 'count' is the number of particles it holds.
+
+        """
+        reservoir = Reservoir(self.world, species, surfaces, buffer, count, **kwargs)
+        reservoir.next_exchange = self.t + reservoir.interval
+        self.reservoirs[reservoir.sid] = reservoir
+        return reservoir
+
+    def next_reservoir(self):
+
+        return min(self.reservoirs.values(), key=lambda reservoir: reservoir.next_exchange)
+
+    def exchange_with_reservoir(self, reservoir):
+        # Puts the particles that flowed in from 'reservoir' since its last
+        # exchange into the world, each in a zero_single.
+
+        self.t = max(self.t, reservoir.next_exchange)
+        reservoir.next_exchange = self.t + reservoir.interval
+
+        radius = reservoir.species.radius
+        def_struct_id = self.world.get_def_structure_id()
+        ignore = []
+        for pos in reservoir.draw_inflow(self.rng):
+            pos, struct_id = self.world.apply_boundary((pos, def_struct_id))
+
+            # The particles around pos have to be propagated to see whether
+            # there is room for the new one.
+            _, ignore = self.burst_volume(pos, radius * SINGLE_SHELL_FACTOR, ignore)
+            if self.world.check_overlap((pos, radius)) or \
+               reservoir.distance_to_surfaces(pos) < radius * MINIMAL_SEPARATION_FACTOR:
+                reservoir.rejected += 1
+                continue
+
+            pid_particle_pair = self.world.new_particle(reservoir.sid, struct_id, pos)
+            zero_single = self.create_single(pid_particle_pair)
+            self.add_domain_event(zero_single)
+            ignore.append(zero_single.domain_id)
+            reservoir.count -= 1
+            reservoir.inserted += 1
+
+        if __debug__:
+            log.info('exchange with %s' % reservoir)
+
+    def absorb_into_reservoir(self, single):
+        # Moves the particle of the zero_single 'single' into the reservoir of
+        # its species if it is beyond the buffer layer. The event of the single
+        # should already be gone.
+
+        pid, particle = single.pid_particle_pair
+        reservoir = self.reservoirs.get(particle.sid)
+        if reservoir is None or \
+           particle.structure_id != self.world.get_def_structure_id() or \
+           not reservoir.absorbs(particle.position):
+            return False
+
+        self.remove_domain(single)
+        self.world.remove_particle(pid)
+        reservoir.count += 1
+        reservoir.absorbed += 1
+        return True
+
 
     dispatch = [
         (Single, process_single_event),
@@ -6,7 +6,10 @@
 #include <boost/range/iterator.hpp>
 #include <boost/utility/enable_if.hpp>
 #include <boost/type_traits/is_const.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/mpl/bool.hpp>
 #include "Shape.hpp"
+#include "ShapeArrays.hpp"
 #include "geometry.hpp"
 
 template<typename Toc_, typename Tfun_, typename Tsphere_>
@@ -43,32 +46,92 @@ private:
     const sphere_type   cmp_;   // The spherical particle whose neighbors are being checked.
 };
 
+// The same for the distances computed in batches by
+// MatrixSpace::each_neighbor_distance.
+template<typename Tfun_, typename Tsphere_>
+class distance_filter
+{
+    typedef Tsphere_ sphere_type;
+
+public:
+    inline distance_filter(Tfun_& next, const sphere_type& cmp)
+        : next_(next), cmp_(cmp) {}
+
+    template<typename Titer_>
+    inline void operator()(Titer_ const& i,
+            typename sphere_type::length_type const& dist) const
+    {
+        if (dist < cmp_.radius())
+        {
+            next_(i, dist);
+        }
+    }
+
+private:
+    Tfun_&              next_;
+    const sphere_type&  cmp_;
+};
+
+// Whether the distances to the values of Toc_ are computed in batches.
+template<typename Toc_>
+struct has_distance_kernel
+    : boost::mpl::bool_<!boost::is_same<
+            typename Toc_::shape_arrays_type, NoShapeArrays>::value> {};
+
 template<typename Toc_, typename Tfun_, typename Tsphere_>
-inline void take_neighbor(Toc_& oc, Tfun_& fun, const Tsphere_& cmp)
+inline void take_neighbor(Toc_& oc, Tfun_& fun, const Tsphere_& cmp,
+                          boost::mpl::false_)
 {
     oc.each_neighbor(oc.index(cmp.position()),
                      neighbor_filter<Toc_, Tfun_, Tsphere_>(fun, cmp));
 }
 
 template<typename Toc_, typename Tfun_, typename Tsphere_>
-inline void take_neighbor(Toc_ const& oc, Tfun_& fun, const Tsphere_& cmp)
+inline void take_neighbor(Toc_& oc, Tfun_& fun, const Tsphere_& cmp,
+                          boost::mpl::true_)
 {
-    oc.each_neighbor(oc.index(cmp.position()),
-                     neighbor_filter<Toc_ const, Tfun_, Tsphere_>(fun, cmp));
+    distance_filter<Tfun_, Tsphere_> filter(fun, cmp);
+    oc.each_neighbor_distance(cmp.position(), filter);
 }
 
 template<typename Toc_, typename Tfun_, typename Tsphere_>
-inline void take_neighbor_cyclic(Toc_& oc, Tfun_& fun, const Tsphere_& cmp)
+inline void take_neighbor_cyclic(Toc_& oc, Tfun_& fun, const Tsphere_& cmp,
+                                 boost::mpl::false_)
 {
     oc.each_neighbor_cyclic(oc.index(cmp.position()),
             neighbor_filter<Toc_, Tfun_, Tsphere_>(fun, cmp));
 }
 
+template<typename Toc_, typename Tfun_, typename Tsphere_>
+inline void take_neighbor_cyclic(Toc_& oc, Tfun_& fun, const Tsphere_& cmp,
+                                 boost::mpl::true_)
+{
+    distance_filter<Tfun_, Tsphere_> filter(fun, cmp);
+    oc.each_neighbor_distance_cyclic(cmp.position(), filter);
+}
+
+template<typename Toc_, typename Tfun_, typename Tsphere_>
+inline void take_neighbor(Toc_& oc, Tfun_& fun, const Tsphere_& cmp)
+{
+    take_neighbor(oc, fun, cmp, typename has_distance_kernel<Toc_>::type());
+}
+
+template<typename Toc_, typename Tfun_, typename Tsphere_>
+inline void take_neighbor(Toc_ const& oc, Tfun_& fun, const Tsphere_& cmp)
+{
+    take_neighbor(oc, fun, cmp, typename has_distance_kernel<Toc_>::type());
+}
+
+template<typename Toc_, typename Tfun_, typename Tsphere_>
+inline void take_neighbor_cyclic(Toc_& oc, Tfun_& fun, const Tsphere_& cmp)
+{
+    take_neighbor_cyclic(oc, fun, cmp, typename has_distance_kernel<Toc_>::type());
+}
+
 template<typename Toc_, typename Tfun_, typename Tsphere_>
 inline void take_neighbor_cyclic(Toc_ const& oc, Tfun_& fun, const Tsphere_& cmp)
 {
-    oc.each_neighbor_cyclic(oc.index(cmp.position()),
-            neighbor_filter<Toc_ const, Tfun_, Tsphere_>(fun, cmp));
+    take_neighbor_cyclic(oc, fun, cmp, typename has_distance_kernel<Toc_>::type());
 }
 
 #endif /* ALGORITHM_HPP */
@@ -1,20 +1,158 @@
 #if !defined( __FUNCSUM_HPP )
 #define __FUNCSUM_HPP
 
-#include <boost/function.hpp>
+#include <cmath>
 #include <cstddef>
+#include <vector>
+#include <boost/noncopyable.hpp>
 
 #include "Defs.hpp"
 
 static const Real TOLERANCE( 1e-8 );
 
-Real funcSum_all(boost::function<Real(unsigned int i)> f, std::size_t max_i);
+// The summation kernels below are templated on the term functor (typically
+// the result of boost::bind), so that evaluating a term is an inlinable
+// call instead of a call through boost::function.
 
-Real funcSum_all_accel(boost::function<Real(unsigned int i)> f,
-                       std::size_t max_i, Real tolerance = TOLERANCE);
+// Levin-u acceleration of the series given by the terms in table; logs an
+// error if the estimated error exceeds the sum times error_tolerance.
+Real funcSum_levin_accel(Real const* table, std::size_t size,
+                         Real error_tolerance);
 
-Real funcSum(boost::function<Real(unsigned int i)> f,
-             std::size_t max_i, Real tolerance = TOLERANCE);
+// Table of the terms of a series, kept on the stack unless the series may
+// be longer than STACK_SIZE terms.
+class funcSum_table: boost::noncopyable
+{
+public:
+    enum { STACK_SIZE = 2048 };
+
+    explicit funcSum_table(std::size_t max_size)
+        : data_(stack_), size_(0)
+    {
+        if (max_size > STACK_SIZE)
+        {
+            heap_.resize(max_size);
+            data_ = &heap_[0];
+        }
+    }
+
+    void push_back(Real value)
+    {
+        data_[size_++] = value;
+    }
+
+    Real const* data() const
+    {
+        return data_;
+    }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+private:
+    Real stack_[STACK_SIZE];
+    std::vector<Real> heap_;
+    Real* data_;
+    std::size_t size_;
+};
+
+
+// Sums the first max_i terms of the series.
+template<typename Tfun_>
+inline Real funcSum_all(Tfun_ f, std::size_t max_i)
+{
+    const Real p_0(f(0));
+    if (p_0 == 0.0)
+    {
+        return 0.0;
+    }
+
+    Real sum(p_0);
+    for (std::size_t i(1); i < max_i; ++i)
+    {
+        sum += f(i);
+    }
+
+    return sum;
+}
+
+// Sums the first max_i terms of the series using Levin-u acceleration.
+template<typename Tfun_>
+inline Real funcSum_all_accel(Tfun_ f, std::size_t max_i,
+                              Real tolerance = TOLERANCE)
+{
+    const Real p_0(f(0));
+    if (p_0 == 0.0)
+    {
+        return 0.0;
+    }
+
+    funcSum_table pTable(max_i);
+    pTable.push_back(p_0);
+    for (std::size_t i(1); i < max_i; ++i)
+    {
+        pTable.push_back(f(i));
+    }
+
+    return funcSum_levin_accel(pTable.data(), pTable.size(), tolerance);
+}
+
+// funcSum
+// ==
+// Will simply calculate the sum over a certain function f, until it converges
+// (i.e. the sum > tolerance*current_term for a CONVERGENCE_CHECK number of
+// terms), or a maximum number of terms is summed (usually 2000). In the
+// latter case the sum is extrapolated using Levin-u acceleration.
+//
+// Input:
+// - f: A       function object, called as f(i) for term i
+// - max_i:     maximum number of terms it will evaluate
+// - tolerance: convergence condition, default value 1-e8 (see above)
+template<typename Tfun_>
+inline Real funcSum(Tfun_ f, std::size_t max_i,
+                    Real tolerance = TOLERANCE)
+{
+    // DEFAULT = 4
+    const unsigned int CONVERGENCE_CHECK(4);
+
+    const Real p_0(f(0));
+    if (p_0 == 0.0)
+    {
+        return 0.0;
+    }
+
+    funcSum_table pTable(max_i);
+    pTable.push_back(p_0);
+    Real sum(p_0);
+
+    unsigned int convergenceCounter(0);
+
+    for (std::size_t i(1); i < max_i; ++i)
+    {
+        const Real p_i(f(i));
+        pTable.push_back(p_i);
+        sum += p_i;
+
+        if (std::fabs(sum) * tolerance >= std::fabs(p_i)) // '=' is important
+        {
+            ++convergenceCounter;
+        }
+        // this screws it up; why?
+        else
+        {
+            convergenceCounter = 0;
+        }
+
+        if (convergenceCounter >= CONVERGENCE_CHECK)
+        {
+            return sum;
+        }
+    }
+
+    return funcSum_levin_accel(pTable.data(), pTable.size(), tolerance * 10);
+}
 
 
 #endif /* __FUNCSUM_HPP */
@@ -48,6 +48,9 @@ __all__ = [
 
 World = _gfrd.World
 
+# Number of positions throw_in_particles rejects in a row before giving up.
+THROW_IN_MAX_TRIALS = 100000
+
 log = None
 
 def setup_logging():
@@ -570,47 +573,20 @@ def throw_in_particles(world, sid, n, bound_1=[0,0,0], bound_2=[0,0,0], ignore_s
 
     assert(correct_bounding_box)
 
-    i = 0
-    while i < int(n):
-        # This is messy, but it works.
-        myrandom.shuffle(structure_list)
-        structure = world.get_structure(structure_list[0])
-        position = structure.random_position(myrandom.rng)
-
-        # Check immediately whether the position is out of the bounding box
-        # If yes, discard before applying any boundary conditions
-        out_of_bounds = ( any(position < bound_1) or any(position > bound_2) )
-        if out_of_bounds:
-            log.info('random position rejected. Out of bounding box. I will keep trying.')
-            continue
-
-        # OK, now apply boundary conditions
-        position, structure_id = world.apply_boundary((position, structure.id))
-
-        # Check overlap. TODO put in 'if' statement for improved efficiency?
-        particle_overlaps = world.check_overlap((position, species.radius))
-        surface_overlaps  = world.check_surface_overlap((position, species.radius*MINIMAL_SEPARATION_FACTOR),
-                                                        position, structure_id, species.radius)
-
-        # Check again whether we are within the imposed bounds
-        out_of_bounds = ( any(position < bound_1) or any(position > bound_2) )
-
-        if  ((not particle_overlaps) and ((not surface_overlaps) or ignore_structure_overlaps)) \
-         and (not out_of_bounds):
-            # All checks passed. Create particle.
-            p = world.new_particle(sid, structure_id, position)
-            i += 1
-            if __debug__:
-                log.info('particle accepted: (%s,\n %s)' % (p[0], p[1]))
-                if ignore_structure_overlaps:
-                    log.warn('explicitly ignoring structure overlaps.')
-        elif __debug__:
-            if particle_overlaps:
-                log.info('\t%d-th particle rejected. Too close to particle. I will keep trying.' % i)
-            if surface_overlaps:
-                log.info('\t%d-th particle rejected. Too close to surface. I will keep trying.' % i)
-            if out_of_bounds:
-                log.info('\t%d-th particle rejected. Out of bounding box. I will keep trying.' % i)
+    if ignore_structure_overlaps:
+        log.warn('explicitly ignoring structure overlaps.')
+
+    # Positions are drawn, checked for overlaps and inserted in C++; a
+    # structure is picked at random for every trial position.  Gives up
+    # (raising NoSpace) after THROW_IN_MAX_TRIALS rejections in a row.
+    world.throw_in_particles(sid, int(n), myrandom.rng,
+                             numpy.array(bound_1, float),
+                             numpy.array(bound_2, float),
+                             ignore_structure_overlaps, THROW_IN_MAX_TRIALS)
+
+    if __debug__:
+        log.info('\n\t%d particles of type %s placed' %
+                 (len(world.get_particle_ids(sid)), structure_type.id))
 
 
 def place_particle(world, sid, position):
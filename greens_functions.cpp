@@ -5,6 +5,7 @@
 #include <boost/python.hpp>
 
 #include "freeFunctions.hpp"
+#include "BDTable.hpp"
 #include "GreensFunction1DAbsAbs.hpp"
 #include "GreensFunction1DRadAbs.hpp"
 #include "GreensFunction1DAbsSinkAbs.hpp"
@@ -16,11 +17,16 @@
 #include "GreensFunction3D.hpp"
 #include "GreensFunction3DRadAbs.hpp"
 #include "GreensFunction3DAbs.hpp"
+#include "binding/Profiler.hpp"
+#include "peer/util/gil.hpp"
 
 BOOST_PYTHON_MODULE( _greens_functions )
 {
     using namespace boost::python;
 
+    // The draw methods release the GIL (see peer/util/gil.hpp).
+    PyEval_InitThreads();
+
     //import_array();
     // free functions
     def( "XP030", XP030 );
@@ -49,6 +55,14 @@ BOOST_PYTHON_MODULE( _greens_functions )
     def( "I_bd_3D", I_bd_3D );
     def( "I_bd_r_3D", I_bd_r_3D );
     def( "drawR_gbd_3D", drawR_gbd_3D );
+    def( "tabulated_I_bd_1D", BDTable::I_bd_1D );
+    def( "tabulated_drawR_gbd_1D", BDTable::drawR_gbd_1D );
+    def( "tabulated_I_bd_3D", BDTable::I_bd_3D );
+    def( "tabulated_drawR_gbd_3D", BDTable::drawR_gbd_3D );
+    def( "tabulated_memory_usage", BDTable::memory_usage );
+
+    // _gfrd registers the Profiler class.
+    binding::register_profiler_functions<Profiler>();
 
     class_<GreensFunction1DAbsAbs>("GreensFunction1DAbsAbs",
                                    init<Real, Real, Real, Real>() )
@@ -61,9 +75,9 @@ BOOST_PYTHON_MODULE( _greens_functions )
         .def( "geta", &GreensFunction1DAbsAbs::geta )
         .def( "setr0", &GreensFunction1DAbsAbs::setr0 )
         .def( "getr0", &GreensFunction1DAbsAbs::getr0 )
-        .def( "drawTime", &GreensFunction1DAbsAbs::drawTime )
-        .def( "drawR", &GreensFunction1DAbsAbs::drawR )
-        .def( "drawEventType", &GreensFunction1DAbsAbs::drawEventType )
+        .def( "drawTime", peer::util::release_gil(&GreensFunction1DAbsAbs::drawTime) )
+        .def( "drawR", peer::util::release_gil(&GreensFunction1DAbsAbs::drawR) )
+        .def( "drawEventType", peer::util::release_gil(&GreensFunction1DAbsAbs::drawEventType) )
         .def( "leaves", &GreensFunction1DAbsAbs::leaves )
         .def( "leavea", &GreensFunction1DAbsAbs::leavea )
         .def( "p_survival", &GreensFunction1DAbsAbs::p_survival )
@@ -83,9 +97,9 @@ BOOST_PYTHON_MODULE( _greens_functions )
         .def( "geta", &GreensFunction1DRadAbs::geta )
         .def( "setr0", &GreensFunction1DRadAbs::setr0 )
         .def( "getr0", &GreensFunction1DRadAbs::getr0 )
-        .def( "drawTime", &GreensFunction1DRadAbs::drawTime )
-        .def( "drawR", &GreensFunction1DRadAbs::drawR )
-        .def( "drawEventType", &GreensFunction1DRadAbs::drawEventType )
+        .def( "drawTime", peer::util::release_gil(&GreensFunction1DRadAbs::drawTime) )
+        .def( "drawR", peer::util::release_gil(&GreensFunction1DRadAbs::drawR) )
+        .def( "drawEventType", peer::util::release_gil(&GreensFunction1DRadAbs::drawEventType) )
         .def( "flux_tot", &GreensFunction1DRadAbs::flux_tot )
         .def( "flux_rad", &GreensFunction1DRadAbs::flux_rad )
         .def( "fluxRatioRadTot", &GreensFunction1DRadAbs::fluxRatioRadTot )
@@ -103,9 +117,9 @@ BOOST_PYTHON_MODULE( _greens_functions )
         .def( "geta", &GreensFunction1DAbsSinkAbs::geta )
         .def( "getr0", &GreensFunction1DAbsSinkAbs::getr0 )
         .def( "getrsink", &GreensFunction1DAbsSinkAbs::getrsink )
-        .def( "drawTime", &GreensFunction1DAbsSinkAbs::drawTime )
-        .def( "drawR", &GreensFunction1DAbsSinkAbs::drawR )
-        .def( "drawEventType", &GreensFunction1DAbsSinkAbs::drawEventType )
+        .def( "drawTime", peer::util::release_gil(&GreensFunction1DAbsSinkAbs::drawTime) )
+        .def( "drawR", peer::util::release_gil(&GreensFunction1DAbsSinkAbs::drawR) )
+        .def( "drawEventType", peer::util::release_gil(&GreensFunction1DAbsSinkAbs::drawEventType) )
         .def( "flux_tot", &GreensFunction1DAbsSinkAbs::flux_tot )
         .def( "flux_leaves", &GreensFunction1DAbsSinkAbs::flux_leaves )
         .def( "flux_leavea", &GreensFunction1DAbsSinkAbs::flux_leavea )
@@ -121,8 +135,8 @@ BOOST_PYTHON_MODULE( _greens_functions )
 					init<const Real, const Real>() )
 	.def( "getD", &GreensFunction2DAbsSym::getD )
 	.def( "geta", &GreensFunction2DAbsSym::geta )
-	.def( "drawTime", &GreensFunction2DAbsSym::drawTime )
-	.def( "drawR", &GreensFunction2DAbsSym::drawR )
+	.def( "drawTime", peer::util::release_gil(&GreensFunction2DAbsSym::drawTime) )
+	.def( "drawR", peer::util::release_gil(&GreensFunction2DAbsSym::drawR) )
 	.def( "p_survival", &GreensFunction2DAbsSym::p_survival )
     .def( "dump", &GreensFunction2DAbsSym::dump )
 	//.def( "p_int_r", &GreensFunction2DAbsSym::p_int_r )
@@ -142,10 +156,10 @@ BOOST_PYTHON_MODULE( _greens_functions )
 	.def( "getkf", &GreensFunction2DRadAbs::getkf )
 	.def( "geth", &GreensFunction2DRadAbs::geth )
 	.def( "getSigma", &GreensFunction2DRadAbs::getSigma )
-	.def( "drawTime", &GreensFunction2DRadAbs::drawTime )
-	.def( "drawEventType", &GreensFunction2DRadAbs::drawEventType )
-	.def( "drawR", &GreensFunction2DRadAbs::drawR )
-	.def( "drawTheta", &GreensFunction2DRadAbs::drawTheta )
+	.def( "drawTime", peer::util::release_gil(&GreensFunction2DRadAbs::drawTime) )
+	.def( "drawEventType", peer::util::release_gil(&GreensFunction2DRadAbs::drawEventType) )
+	.def( "drawR", peer::util::release_gil(&GreensFunction2DRadAbs::drawR) )
+	.def( "drawTheta", peer::util::release_gil(&GreensFunction2DRadAbs::drawTheta) )
 	.def( "getAlpha", &GreensFunction2DRadAbs::getAlpha )
 //	.def( "getAlpha0", &GreensFunction2DRadAbs::getAlpha0 ) // LEGACY; TODO REMOVE
 	.def( "f_alpha", &GreensFunction2DRadAbs::f_alpha )
@@ -164,8 +178,8 @@ BOOST_PYTHON_MODULE( _greens_functions )
     class_<GreensFunction3DSym>("GreensFunction3DSym", init<Real>())
         .def( "getName", &GreensFunction3DSym::getName )
         .def( "getD", &GreensFunction3DSym::getD )
-        .def( "drawTime", &GreensFunction3DSym::drawTime )
-        .def( "drawR", &GreensFunction3DSym::drawR )
+        .def( "drawTime", peer::util::release_gil(&GreensFunction3DSym::drawTime) )
+        .def( "drawR", peer::util::release_gil(&GreensFunction3DSym::drawR) )
         .def( "p_r", &GreensFunction3DSym::p_r )
         .def( "ip_r", &GreensFunction3DSym::ip_r )
         .def( "dump", &GreensFunction3DSym::dump )
@@ -176,8 +190,8 @@ BOOST_PYTHON_MODULE( _greens_functions )
         .def( "getName", &GreensFunction3DAbsSym::getName )
         .def( "getD", &GreensFunction3DAbsSym::getD )
         .def( "geta", &GreensFunction3DAbsSym::geta )
-        .def( "drawTime", &GreensFunction3DAbsSym::drawTime )
-        .def( "drawR", &GreensFunction3DAbsSym::drawR )
+        .def( "drawTime", peer::util::release_gil(&GreensFunction3DAbsSym::drawTime) )
+        .def( "drawR", peer::util::release_gil(&GreensFunction3DAbsSym::drawR) )
         .def( "p_survival", &GreensFunction3DAbsSym::p_survival )
         .def( "p_int_r", &GreensFunction3DAbsSym::p_int_r )
         .def( "p_int_r_free", &GreensFunction3DAbsSym::p_int_r_free )
@@ -191,9 +205,9 @@ BOOST_PYTHON_MODULE( _greens_functions )
         .def( "getD", &GreensFunction3DRadInf::getD )
         .def( "getkf", &GreensFunction3DRadInf::getkf )
         .def( "getSigma", &GreensFunction3DRadInf::getSigma )
-        .def( "drawTime", &GreensFunction3DRadInf::drawTime )
-        .def( "drawR", &GreensFunction3DRadInf::drawR )
-        .def( "drawTheta", &GreensFunction3DRadInf::drawTheta )
+        .def( "drawTime", peer::util::release_gil(&GreensFunction3DRadInf::drawTime) )
+        .def( "drawR", peer::util::release_gil(&GreensFunction3DRadInf::drawR) )
+        .def( "drawTheta", peer::util::release_gil(&GreensFunction3DRadInf::drawTheta) )
 
 //        .def( "p_tot", &GreensFunction3DRadInf::p_tot )
         .def( "p_free", &GreensFunction3DRadInf::p_free )
@@ -213,9 +227,9 @@ BOOST_PYTHON_MODULE( _greens_functions )
         .def( "getD", &GreensFunction3D::getD )
         .def( "getkf", &GreensFunction3D::getkf )
         .def( "getSigma", &GreensFunction3D::getSigma )
-        .def( "drawTime", &GreensFunction3D::drawTime )
-        .def( "drawR", &GreensFunction3D::drawR )
-        .def( "drawTheta", &GreensFunction3D::drawTheta )
+        .def( "drawTime", peer::util::release_gil(&GreensFunction3D::drawTime) )
+        .def( "drawR", peer::util::release_gil(&GreensFunction3D::drawR) )
+        .def( "drawTheta", peer::util::release_gil(&GreensFunction3D::drawTheta) )
 
         .def( "p_r", &GreensFunction3D::p_r )
         .def( "ip_r", &GreensFunction3D::ip_r )
@@ -235,15 +249,16 @@ BOOST_PYTHON_MODULE( _greens_functions )
     class_<GreensFunction3DRadAbs>("GreensFunction3DRadAbs",
                                    init<Real, Real, Real, Real, Real>() )
         .def( "getName", &GreensFunction3DRadAbs::getName )
+        .def( "memory_usage", &GreensFunction3DRadAbs::memory_usage )
         .def( "geta", &GreensFunction3DRadAbs::geta )
         .def( "getD", &GreensFunction3DRadAbs::getD )
         .def( "getkf", &GreensFunction3DRadInf::getkf )
         .def( "getSigma", &GreensFunction3DRadInf::getSigma )
-        .def( "drawTime", &GreensFunction3DRadAbs::drawTime )
+        .def( "drawTime", peer::util::release_gil(&GreensFunction3DRadAbs::drawTime) )
         //.def( "drawTime2", &GreensFunction3DRadAbs::drawTime2 )
-        .def( "drawEventType", &GreensFunction3DRadAbs::drawEventType )
-        .def( "drawR", &GreensFunction3DRadAbs::drawR )
-        .def( "drawTheta", &GreensFunction3DRadAbs::drawTheta )
+        .def( "drawEventType", peer::util::release_gil(&GreensFunction3DRadAbs::drawEventType) )
+        .def( "drawR", peer::util::release_gil(&GreensFunction3DRadAbs::drawR) )
+        .def( "drawTheta", peer::util::release_gil(&GreensFunction3DRadAbs::drawTheta) )
 
         .def( "p_survival", &GreensFunction3DRadAbs::p_survival )
         .def( "dp_survival", &GreensFunction3DRadAbs::dp_survival )
@@ -277,12 +292,13 @@ BOOST_PYTHON_MODULE( _greens_functions )
     class_<GreensFunction3DAbs>("GreensFunction3DAbs",
                                 init<Real, Real, Real>()) 
         .def( "getName", &GreensFunction3DAbs::getName )
+        .def( "memory_usage", &GreensFunction3DAbs::memory_usage )
         .def( "geta", &GreensFunction3DAbs::geta )
         .def( "getD", &GreensFunction3DAbs::getD )
-        .def( "drawTime", &GreensFunction3DAbs::drawTime )
-        .def( "drawR", &GreensFunction3DAbs::drawR )
+        .def( "drawTime", peer::util::release_gil(&GreensFunction3DAbs::drawTime) )
+        .def( "drawR", peer::util::release_gil(&GreensFunction3DAbs::drawR) )
         .def( "drawTheta", 
-              &GreensFunction3DAbs::drawTheta )
+              peer::util::release_gil(&GreensFunction3DAbs::drawTheta) )
 
         .def( "p_survival", 
               &GreensFunction3DAbs::p_survival )
@@ -0,0 +1,73 @@
+#if !defined( __LEGENDRESUM_HPP )
+#define __LEGENDRESUM_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "Defs.hpp"
+
+// Sums the Legendre series c[0] P_0(x) + ... + c[size-1] P_{size-1}(x)
+// with the Clenshaw recurrence; no table of P_n(x) is needed, so a series
+// can be evaluated at many x (e.g. inside a root finder) at the cost of
+// one multiply-add pass over its coefficients.
+inline Real legendreSum(Real const* c, std::size_t size, Real x)
+{
+    // P_{k+1}(x) = ((2k+1) x P_k(x) - k P_{k-1}(x)) / (k+1)
+    Real b1(0.0);
+    Real b2(0.0);
+    for (std::size_t k(size); k-- > 0; )
+    {
+        const Real realk(static_cast<Real>(k));
+        const Real b0(c[k] + (2 * realk + 1) / (realk + 1) * x * b1
+                      - (realk + 1) / (realk + 2) * b2);
+        b2 = b1;
+        b1 = b0;
+    }
+
+    return b1;
+}
+
+inline Real legendreSum(std::vector<Real> const& c, Real x)
+{
+    return c.empty() ? 0.0: legendreSum(&c[0], c.size(), x);
+}
+
+// Coefficients of the Legendre series sum_n (2n+1) p_n P_n(x), the angular
+// density of a pair Green's function with radial terms p_n.
+inline void legendreSum_p_coefficients(std::vector<Real>& c,
+                                       std::vector<Real> const& p_nTable)
+{
+    c.resize(p_nTable.size());
+    for (std::size_t n(0); n < p_nTable.size(); ++n)
+    {
+        c[n] = (2 * n + 1) * p_nTable[n];
+    }
+}
+
+// Coefficients of the integrated angular series
+//   sum_n p_n (P_{n-1}(x) - P_{n+1}(x)),  P_{-1}(x) = 1,
+// rewritten as a plain Legendre series, so that it can be summed with
+// legendreSum: the coefficient of P_m is p_{m+1} - p_{m-1}, and the
+// constant p_0 P_{-1} is folded into that of P_0.
+inline void legendreSum_ip_coefficients(std::vector<Real>& c,
+                                        std::vector<Real> const& p_nTable)
+{
+    const std::size_t size(p_nTable.size());
+
+    c.assign(size == 0 ? 0: size + 1, 0.0);
+    for (std::size_t n(0); n < size; ++n)
+    {
+        if (n > 0)
+        {
+            c[n - 1] += p_nTable[n];
+        }
+        c[n + 1] -= p_nTable[n];
+    }
+
+    if (size > 0)
+    {
+        c[0] += p_nTable[0];
+    }
+}
+
+#endif /* __LEGENDRESUM_HPP */
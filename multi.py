@@ -33,6 +33,8 @@ class Multi(Domain, hasSphericalShell, Others):
         self.dt_hardcore_min = dt_hardcore_min
         self.last_reaction = None
         self.reaction_length = 0
+        self.num_steps = 0
+        self.bd_zone = False    # formed in a BD zone, see bdzones.py
 
     def initialize(self, t):
         self.last_time = t
@@ -83,16 +85,10 @@ class Multi(Domain, hasSphericalShell, Others):
 
     def step(self):
         self.escaped = False
+        self.num_steps += 1
         tx = self.particle_container.create_transaction()
         main = self.main()
 
-        class check_reaction(object):
-            def __init__(self):
-                self.reactions = []
-
-            def __call__(self, ri):
-                self.reactions.append(ri)
-
         class clear_volume(object):
             def __init__(self, outer):
                 self.outer_ = outer
@@ -119,17 +115,22 @@ class Multi(Domain, hasSphericalShell, Others):
 
                 return True
 
-        cr = check_reaction()
+        # the reactions are recorded in C++, without calling back into Python.
+        rrec = main.reaction_recorder
+        if rrec is None:
+            rrec = _gfrd.StreamingReactionRecorder()
+        rrec.time = main.t
+        reactions = rrec.total
         vc = clear_volume(self)
 
         ppg = _gfrd.newBDPropagator(tx, main.network_rules,
                      myrandom.rng, self.dt, main.dissociation_retry_moves, self.reaction_length,
-                     cr, vc, [pid for pid, _ in self.particle_container])
+                     rrec, vc, [pid for pid, _ in self.particle_container])
 
         self.last_event = EventType.MULTI_DIFFUSION     #None
         while ppg():
-            if cr.reactions:
-                self.last_reaction = cr.reactions[-1]
+            if rrec.total != reactions:
+                self.last_reaction = rrec.last_record
                 if len(self.last_reaction.reactants) == 1:
                     self.last_event = EventType.MULTI_UNIMOLECULAR_REACTION
                 else:
@@ -20,6 +20,7 @@
 #include "utils/random.hpp"
 #include "utils/get_default_impl.hpp"
 #include "Logger.hpp"
+#include "Profiler.hpp"
 
 
 #include <iostream>
@@ -102,6 +103,7 @@ public:
     //    in the container that need to be processed.
     bool operator()()
     {
+        PROFILE_SCOPE("newBDPropagator::operator()");
       
         /*** 1. TREAT QUEUE ***/
         // if there are no more particle to treat -> end
@@ -469,6 +471,7 @@ private:
     bool attempt_single_reaction(particle_id_pair const& pp)
     // Handles all monomolecular reactions
     {
+        PROFILE_COUNT("newBDPropagator::attempt_single_reaction");
         reaction_rules const& rules(rules_.query_reaction_rule(pp.second.sid()));
         
         if ((int)::size(rules) == 0)
@@ -916,6 +919,7 @@ private:
     // pp0 is the initiating particle (also no longer in the queue) and pp1 is the target particle (still in the queue).
     // pp0, pp1 and s0,s1 can either be in 3D/2D/1D or mixed.
     {
+        PROFILE_COUNT("newBDPropagator::attempt_pair_reaction");
         reaction_rules const& rules(rules_.query_reaction_rule(pp0.second.sid(), pp1.second.sid()));
         if(::size(rules) == 0)
             throw propagation_error("trying to fire a reaction between particles without a reaction rule.");
@@ -1092,6 +1096,7 @@ private:
     // This handles the 'reaction' (interaction) between a particle and a structure.
     // Returns True if the interaction was succesfull
     {
+        PROFILE_COUNT("newBDPropagator::attempt_interaction");
         // Get the reaction rules for the interaction with this structure.
         reaction_rules const& rules(rules_.query_reaction_rule(pp.second.sid(), product_structure->sid() ));
         if (::size(rules) == 0)
@@ -0,0 +1,190 @@
+#ifndef PEER_UTIL_GIL_HPP
+#define PEER_UTIL_GIL_HPP
+
+#include <Python.h>
+#include <boost/noncopyable.hpp>
+#include <boost/mpl/vector.hpp>
+#include <boost/python/object.hpp>
+#include <boost/python/make_function.hpp>
+#include <boost/python/default_call_policies.hpp>
+
+namespace peer { namespace util {
+
+// Releases the GIL for the lifetime of the object.  Nothing that touches
+// Python objects may run in its scope, except inside a gil_ensure.
+class gil_release: boost::noncopyable
+{
+public:
+    gil_release(): state_(PyEval_SaveThread()) {}
+
+    ~gil_release()
+    {
+        PyEval_RestoreThread(state_);
+    }
+
+private:
+    PyThreadState* const state_;
+};
+
+// Holds the GIL for the lifetime of the object, whether or not the calling
+// thread held it before.  C++ code that calls back into Python from a
+// section that may run under a gil_release must use this.
+class gil_ensure: boost::noncopyable
+{
+public:
+    gil_ensure(): state_(PyGILState_Ensure()) {}
+
+    ~gil_ensure()
+    {
+        PyGILState_Release(state_);
+    }
+
+private:
+    PyGILState_STATE const state_;
+};
+
+namespace detail {
+
+template<typename Tfun_, typename Timpl_, typename Tretval_>
+struct without_gil0
+{
+    Tretval_ operator()(Timpl_& self) const
+    {
+        gil_release nogil;
+        return (self.*fun_)();
+    }
+
+    without_gil0(Tfun_ fun): fun_(fun) {}
+
+    Tfun_ fun_;
+};
+
+template<typename Tfun_, typename Timpl_, typename Tretval_,
+         typename Targ0_>
+struct without_gil1
+{
+    Tretval_ operator()(Timpl_& self, Targ0_ arg0) const
+    {
+        gil_release nogil;
+        return (self.*fun_)(arg0);
+    }
+
+    without_gil1(Tfun_ fun): fun_(fun) {}
+
+    Tfun_ fun_;
+};
+
+template<typename Tfun_, typename Timpl_, typename Tretval_,
+         typename Targ0_, typename Targ1_>
+struct without_gil2
+{
+    Tretval_ operator()(Timpl_& self, Targ0_ arg0, Targ1_ arg1) const
+    {
+        gil_release nogil;
+        return (self.*fun_)(arg0, arg1);
+    }
+
+    without_gil2(Tfun_ fun): fun_(fun) {}
+
+    Tfun_ fun_;
+};
+
+template<typename Tfun_, typename Timpl_, typename Tretval_,
+         typename Targ0_, typename Targ1_, typename Targ2_>
+struct without_gil3
+{
+    Tretval_ operator()(Timpl_& self, Targ0_ arg0, Targ1_ arg1, Targ2_ arg2) const
+    {
+        gil_release nogil;
+        return (self.*fun_)(arg0, arg1, arg2);
+    }
+
+    without_gil3(Tfun_ fun): fun_(fun) {}
+
+    Tfun_ fun_;
+};
+
+} // namespace detail
+
+// Wraps a member function into a Python callable that releases the GIL
+// while the function runs.  The arguments are converted and the result is
+// converted back with the GIL held, so only the member function itself
+// must be free of Python calls (other than through gil_ensure).
+//
+//   class_<T>("T").def("step", peer::util::release_gil(&T::step))
+
+template<typename Timpl_, typename Tretval_>
+inline boost::python::object release_gil(Tretval_(Timpl_::*fun)())
+{
+    return boost::python::make_function(
+        detail::without_gil0<Tretval_(Timpl_::*)(), Timpl_, Tretval_>(fun),
+        boost::python::default_call_policies(),
+        boost::mpl::vector2<Tretval_, Timpl_&>());
+}
+
+template<typename Timpl_, typename Tretval_>
+inline boost::python::object release_gil(Tretval_(Timpl_::*fun)() const)
+{
+    return boost::python::make_function(
+        detail::without_gil0<Tretval_(Timpl_::*)() const, Timpl_ const, Tretval_>(fun),
+        boost::python::default_call_policies(),
+        boost::mpl::vector2<Tretval_, Timpl_ const&>());
+}
+
+template<typename Timpl_, typename Tretval_, typename Targ0_>
+inline boost::python::object release_gil(Tretval_(Timpl_::*fun)(Targ0_))
+{
+    return boost::python::make_function(
+        detail::without_gil1<Tretval_(Timpl_::*)(Targ0_), Timpl_, Tretval_, Targ0_>(fun),
+        boost::python::default_call_policies(),
+        boost::mpl::vector3<Tretval_, Timpl_&, Targ0_>());
+}
+
+template<typename Timpl_, typename Tretval_, typename Targ0_>
+inline boost::python::object release_gil(Tretval_(Timpl_::*fun)(Targ0_) const)
+{
+    return boost::python::make_function(
+        detail::without_gil1<Tretval_(Timpl_::*)(Targ0_) const, Timpl_ const, Tretval_, Targ0_>(fun),
+        boost::python::default_call_policies(),
+        boost::mpl::vector3<Tretval_, Timpl_ const&, Targ0_>());
+}
+
+template<typename Timpl_, typename Tretval_, typename Targ0_, typename Targ1_>
+inline boost::python::object release_gil(Tretval_(Timpl_::*fun)(Targ0_, Targ1_))
+{
+    return boost::python::make_function(
+        detail::without_gil2<Tretval_(Timpl_::*)(Targ0_, Targ1_), Timpl_, Tretval_, Targ0_, Targ1_>(fun),
+        boost::python::default_call_policies(),
+        boost::mpl::vector4<Tretval_, Timpl_&, Targ0_, Targ1_>());
+}
+
+template<typename Timpl_, typename Tretval_, typename Targ0_, typename Targ1_>
+inline boost::python::object release_gil(Tretval_(Timpl_::*fun)(Targ0_, Targ1_) const)
+{
+    return boost::python::make_function(
+        detail::without_gil2<Tretval_(Timpl_::*)(Targ0_, Targ1_) const, Timpl_ const, Tretval_, Targ0_, Targ1_>(fun),
+        boost::python::default_call_policies(),
+        boost::mpl::vector4<Tretval_, Timpl_ const&, Targ0_, Targ1_>());
+}
+
+template<typename Timpl_, typename Tretval_, typename Targ0_, typename Targ1_, typename Targ2_>
+inline boost::python::object release_gil(Tretval_(Timpl_::*fun)(Targ0_, Targ1_, Targ2_))
+{
+    return boost::python::make_function(
+        detail::without_gil3<Tretval_(Timpl_::*)(Targ0_, Targ1_, Targ2_), Timpl_, Tretval_, Targ0_, Targ1_, Targ2_>(fun),
+        boost::python::default_call_policies(),
+        boost::mpl::vector5<Tretval_, Timpl_&, Targ0_, Targ1_, Targ2_>());
+}
+
+template<typename Timpl_, typename Tretval_, typename Targ0_, typename Targ1_, typename Targ2_>
+inline boost::python::object release_gil(Tretval_(Timpl_::*fun)(Targ0_, Targ1_, Targ2_) const)
+{
+    return boost::python::make_function(
+        detail::without_gil3<Tretval_(Timpl_::*)(Targ0_, Targ1_, Targ2_) const, Timpl_ const, Tretval_, Targ0_, Targ1_, Targ2_>(fun),
+        boost::python::default_call_policies(),
+        boost::mpl::vector5<Tretval_, Timpl_ const&, Targ0_, Targ1_, Targ2_>());
+}
+
+} } // namespace peer::util
+
+#endif /* PEER_UTIL_GIL_HPP */
@@ -3,6 +3,7 @@
 
 #include <boost/python.hpp>
 #include "generator.hpp"
+#include "peer/util/gil.hpp"
 
 namespace peer { namespace wrappers {
 
@@ -16,7 +17,12 @@ public:
     pyiterator_generator(boost::python::handle<> iter)
         : iter_(iter), advanced_(false) {}
 
-    virtual ~pyiterator_generator() {}
+    virtual ~pyiterator_generator()
+    {
+        peer::util::gil_ensure gil;
+        iter_.reset();
+        last_.reset();
+    }
 
     virtual bool valid() const
     {
@@ -26,6 +32,7 @@ public:
 
     virtual value_type operator()()
     {
+        peer::util::gil_ensure gil;
         fetch();
         if (!last_)
         {
@@ -43,6 +50,7 @@ public:
 private:
     void fetch()
     {
+        peer::util::gil_ensure gil;
         if (iter_ && !advanced_)
         {
             last_ = boost::python::handle<>(
@@ -39,12 +39,14 @@
 #include "binding/bd_simulator_classes.hpp"
 #include "binding/event_classes.hpp"
 #include "binding/exception_classes.hpp"
+#include "binding/gillespie_simulator_class.hpp"
 #include "binding/matrix_space_classes.hpp"
 #include "binding/model_class.hpp"
 #include "binding/module_functions.hpp"
 #include "binding/multi_particle_container_class.hpp"
 #include "binding/network_rules_class.hpp"
 #include "binding/network_rules_wrapper_class.hpp"
+#include "binding/particle_array_view_class.hpp"
 #include "binding/particle_class.hpp"
 #include "binding/particle_container_class.hpp"
 #include "binding/particle_id_class.hpp"
@@ -52,12 +54,14 @@
 #include "binding/particle_simulator_classes.hpp"
 #include "binding/plane_class.hpp"
 #include "binding/position_converters.hpp"
+#include "binding/profiler_class.hpp"
 #include "binding/python_logger_classes.hpp"
 #include "binding/random_number_generator_class.hpp"
 #include "binding/volume_clearer_classes.hpp"
 #include "binding/reaction_record_classes.hpp"
 #include "binding/shape_converters.hpp"
 #include "binding/shell_classes.hpp"
+#include "binding/shell_scaling_classes.hpp"
 #include "binding/shell_id_class.hpp"
 #include "binding/species_id_class.hpp"
 #include "binding/species_type_class.hpp"
@@ -91,6 +95,9 @@ BOOST_PYTHON_MODULE(_gfrd)
 
     import_array();
 
+    // Long running calls release the GIL (see peer/util/gil.hpp).
+    PyEval_InitThreads();
+
     // GSL error handler: is this the best place for this?
     gsl_set_error_handler(&gsl_error_handler);
 
@@ -124,6 +131,7 @@ BOOST_PYTHON_MODULE(_gfrd)
     b::register_sphere_converters();
     b::register_spherical_shell_class();
     b::register_cylindrical_shell_class();
+    b::register_shell_scaling_classes();
     b::register_shell_id_class();
     b::register_species_id_class();
     b::register_species_type_class();
@@ -131,6 +139,7 @@ BOOST_PYTHON_MODULE(_gfrd)
     b::register_multi_particle_container_class();
     b::register_transaction_classes();
     b::register_world_class();
+    b::register_particle_array_view_class();
     b::register_structure_classes();
     b::register_structure_id_class();
     b::register_structure_type_class();
@@ -140,7 +149,9 @@ BOOST_PYTHON_MODULE(_gfrd)
     b::register_particle_simulator_classes();
     b::register_egfrd_simulator_classes();
     b::register_bd_simulator_classes();
+    b::register_gillespie_simulator_class();
     b::register_python_logger_classes();
+    b::register_profiler_class();
 
     peer::util::register_seq_wrapped_multi_array_converter<b::Length>();
     peer::util::register_ndarray_wrapped_multi_array_converter<b::Length, 2>();
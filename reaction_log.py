@@ -0,0 +1,75 @@
+#!/usr/env python
+
+"""Reading the binary reaction records of a StreamingReactionRecorder.
+
+A record is decoded into a tuple
+
+    (t, reaction_rule_id, reactants, products, positions)
+
+where the reactants and products are lists of (serial, lot) tuples of the
+particle ids and positions is the list of the positions of the products,
+or None if they were not known to the recorder.
+
+"""
+
+import struct
+
+__all__ = [ 'decode_records', 'read_reaction_log', 'MAGIC' ]
+
+MAGIC = 'EGFRDRR1'
+HAS_POSITIONS = 1
+
+_header = struct.Struct('=diBBBx')
+_id = struct.Struct('=Qi')
+_position = struct.Struct('=3d')
+_chunk_header = struct.Struct('=II')
+
+
+def decode_records(data):
+    """Decode a string of records, such as the one returned by
+    StreamingReactionRecorder.buffer(); returns a list."""
+
+    records = []
+    offset = 0
+    while offset < len(data):
+        t, rule_id, n_reactants, n_products, flags = \
+            _header.unpack_from(data, offset)
+        offset += _header.size
+
+        ids = []
+        for i in range(n_reactants + n_products):
+            ids.append(_id.unpack_from(data, offset))
+            offset += _id.size
+
+        positions = None
+        if flags & HAS_POSITIONS:
+            positions = []
+            for i in range(n_products):
+                positions.append(_position.unpack_from(data, offset))
+                offset += _position.size
+
+        records.append((t, rule_id, ids[:n_reactants], ids[n_reactants:],
+                        positions))
+    return records
+
+
+def read_reaction_log(filename):
+    """Iterate over the records in a file written by
+    StreamingReactionRecorder.stream_to(), one chunk at a time."""
+
+    f = open(filename, 'rb')
+    try:
+        if f.read(len(MAGIC)) != MAGIC:
+            raise RuntimeError('%s is not a reaction log.' % filename)
+
+        while True:
+            header = f.read(_chunk_header.size)
+            if len(header) < _chunk_header.size:
+                break
+            size, count = _chunk_header.unpack(header)
+            records = decode_records(f.read(size))
+            assert len(records) == count
+            for record in records:
+                yield record
+    finally:
+        f.close()
@@ -0,0 +1,240 @@
+#!/usr/env python
+
+import math
+
+import numpy
+
+from _gfrd import (
+    PlanarSurface,
+    CylindricalSurface,
+    )
+
+from utils import *
+import myrandom
+
+__all__ = [ 'Reservoir', 'poisson', 'draw_inflow_depth' ]
+
+
+def poisson(mean, rng=myrandom.rng):
+    """Draw a Poisson distributed number with the given mean."""
+
+    if mean <= 0.0:
+        return 0
+
+    if mean > 30.0:
+        # normal approximation, good to a few percent here.
+        return max(0, int(round(rng.normal(mean, math.sqrt(mean)))))
+
+    # Knuth
+    limit = math.exp(-mean)
+    k = 0
+    p = rng.uniform(0.0, 1.0)
+    while p > limit:
+        k += 1
+        p *= rng.uniform(0.0, 1.0)
+    return k
+
+
+def draw_inflow_depth(D, dt, rng=myrandom.rng):
+    """Draw how far a particle that crossed a plane within dt coming
+    from a uniform concentration on the other side has gotten past it.
+
+    The particles past the plane after dt have the density
+    c/2 erfc(x / sqrt(4 D dt)): a particle displaced by s > 0 along the
+    normal comes from the s thick layer behind the plane with a
+    probability proportional to s, and is then uniformly distributed over
+    (0, s).  With s weighted this way the displacement is Rayleigh
+    distributed with scale sqrt(2 D dt).
+
+    """
+    sigma = math.sqrt(2.0 * D * dt)
+    s = sigma * math.sqrt(-2.0 * math.log(1.0 - rng.uniform(0.0, 1.0)))
+    return rng.uniform(0.0, 1.0) * s
+
+
+class Reservoir(object):
+    """A well-mixed reservoir of bulk particles.
+
+    Far from the structures that a bulk species reacts with, its particles
+    only diffuse.  A reservoir represents them by their number, uniformly
+    distributed over the bulk within the box (bound_1, bound_2); particles
+    are only simulated explicitly within 'buffer' of the given planar and
+    cylindrical surfaces.
+
+    Every 'interval' of simulated time, particles flow in from the
+    reservoir across the outer boundary of the buffer layer: their number
+    is Poisson distributed, with as mean the number that crosses a plane
+    from a uniform concentration within the interval,
+    c A sqrt(D interval / pi), and they are placed at their distance past
+    the boundary (see draw_inflow_depth).  An explicit particle that is
+    found beyond the buffer layer when it gets a new domain goes back into
+    the reservoir.
+
+    The outer boundary is taken to be flat on the scale of the diffusion
+    length sqrt(D interval), so the buffer should be larger than that, and
+    than the radius of curved surfaces.  Only the diffusion of the
+    particles is represented in the reservoir, not any reactions in the
+    bulk; the species should only react near the surfaces.
+
+    """
+
+    def __init__(self, world, species, surfaces, buffer, count=0,
+                 bound_1=None, bound_2=None, interval=None):
+
+        self.world = world
+        self.sid = getattr(species, 'id', species)
+        self.species = world.get_species(self.sid)
+
+        if self.species.structure_type_id != world.get_def_structure_type_id():
+            raise RuntimeError('Reservoir: species %s does not live in the bulk.' %
+                               self.sid)
+        if self.species.D <= 0.0:
+            raise RuntimeError('Reservoir: species %s does not diffuse.' %
+                               self.sid)
+
+        self.surfaces = []
+        for surface in surfaces:
+            surface = world.get_structure(getattr(surface, 'id', surface))
+            if not (isinstance(surface, PlanarSurface) or
+                    isinstance(surface, CylindricalSurface)):
+                raise RuntimeError('Reservoir: %s is not a PlanarSurface or '
+                                   'CylindricalSurface.' % surface)
+            self.surfaces.append(surface)
+
+        ws = world.world_size
+        if bound_1 is None:
+            bound_1 = [0, 0, 0]
+        if bound_2 is None:
+            bound_2 = [ws, ws, ws]
+        self.bound_1 = numpy.array(bound_1, float)
+        self.bound_2 = numpy.array(bound_2, float)
+        assert all(self.bound_1 < self.bound_2)
+
+        self.buffer = buffer
+        if interval is None:
+            # a diffusion length of a quarter of the buffer.
+            interval = buffer ** 2 / (32.0 * self.species.D)
+        self.interval = interval
+        self.next_exchange = interval
+
+        self.count = count
+
+        # boundary patches of the buffer layer (see draw_boundary_point)
+        # and their areas
+        self.patches = []
+        zone_volume = 0.0
+        for surface in self.surfaces:
+            shape = surface.shape
+            if isinstance(surface, PlanarSurface):
+                area = 4.0 * shape.half_extent[0] * shape.half_extent[1]
+                for side in [1.0, -1.0]:
+                    if self.in_box(shape.position +
+                                   side * 0.5 * buffer * shape.unit_z):
+                        self.patches.append((surface, side, area))
+                        zone_volume += area * buffer
+            else:
+                unit_x = normalize(crossproduct(shape.unit_z,
+                                                self.least_aligned_axis(shape.unit_z)))
+                unit_y = crossproduct(shape.unit_z, unit_x)
+                area = 2.0 * math.pi * (shape.radius + buffer) * 2.0 * shape.half_length
+                self.patches.append((surface, (unit_x, unit_y), area))
+                zone_volume += math.pi * (shape.radius + buffer) ** 2 * \
+                               2.0 * shape.half_length
+
+        self.area = sum(area for _, _, area in self.patches)
+        # overlapping layers (at the edges of a box of planes) are counted
+        # double; that is negligible when the buffer is thin.
+        self.volume = numpy.prod(self.bound_2 - self.bound_1) - zone_volume
+        assert self.volume > 0.0
+
+        self.inserted = 0
+        self.absorbed = 0
+        self.rejected = 0
+
+    @staticmethod
+    def least_aligned_axis(v):
+        axes = numpy.identity(3)
+        return axes[numpy.argmin(abs(numpy.asarray(v)))]
+
+    def in_box(self, pos):
+        return all(self.bound_1 <= pos) and all(pos <= self.bound_2)
+
+    def concentration(self):
+        return self.count / self.volume
+
+    def distance_to_surfaces(self, pos, ignore=None):
+        """The distance from pos to the closest of the surfaces."""
+
+        distance = numpy.inf
+        for surface in self.surfaces:
+            if surface is ignore:
+                continue
+            pos_transposed = self.world.cyclic_transpose(pos, surface.shape.position)
+            distance = min(distance, self.world.distance(surface.shape, pos_transposed))
+        return distance
+
+    def absorbs(self, pos):
+        """True if a particle at pos is beyond the buffer layer, in the
+        reservoir."""
+        return self.in_box(pos) and self.distance_to_surfaces(pos) > self.buffer
+
+    def draw_boundary_point(self, rng=myrandom.rng):
+        """Draw a point on the outer boundary of the buffer layer, uniformly
+        by area; returns the surface it belongs to, the point and the unit
+        vector pointing into the layer."""
+
+        target = rng.uniform(0.0, self.area)
+        for surface, data, area in self.patches:
+            target -= area
+            if target <= 0.0:
+                break
+
+        shape = surface.shape
+        if isinstance(surface, PlanarSurface):
+            side = data
+            point = shape.position + side * self.buffer * shape.unit_z + \
+                    rng.uniform(-1.0, 1.0) * shape.half_extent[0] * shape.unit_x + \
+                    rng.uniform(-1.0, 1.0) * shape.half_extent[1] * shape.unit_y
+            inward = -side * shape.unit_z
+        else:
+            unit_x, unit_y = data
+            phi = rng.uniform(0.0, 2.0 * math.pi)
+            radial = math.cos(phi) * unit_x + math.sin(phi) * unit_y
+            point = shape.position + \
+                    rng.uniform(-1.0, 1.0) * shape.half_length * shape.unit_z + \
+                    (shape.radius + self.buffer) * radial
+            inward = -radial
+
+        return surface, numpy.array(point), numpy.array(inward)
+
+    def draw_inflow(self, rng=myrandom.rng):
+        """Draw the positions of the particles that flow into the buffer
+        layer within one interval.  The particles are taken from the
+        reservoir; positions that are not inside the buffer layer of this
+        reservoir (because the layers of two surfaces overlap there, or the
+        particle would have crossed the surface) are not returned, and the
+        particles stay in the reservoir."""
+
+        n = min(poisson(self.concentration() * self.area *
+                        math.sqrt(self.species.D * self.interval / math.pi), rng),
+                self.count)
+
+        positions = []
+        for i in range(n):
+            surface, point, inward = self.draw_boundary_point(rng)
+            depth = draw_inflow_depth(self.species.D, self.interval, rng)
+            pos = point + depth * inward
+
+            if depth > self.buffer - self.species.radius or \
+               not self.in_box(point) or \
+               self.distance_to_surfaces(point, surface) < self.buffer:
+                self.rejected += 1
+                continue
+
+            positions.append(pos)
+
+        return positions
+
+    def __str__(self):
+        return 'Reservoir(%s, count=%d, inserted=%d, absorbed=%d, rejected=%d)' % \
+               (self.sid, self.count, self.inserted, self.absorbed, self.rejected)
@@ -0,0 +1,303 @@
+#!/usr/bin/env python
+
+# Standard performance benchmark.
+#
+# Runs a fixed set of scenarios, each with a fixed random seed, and writes
+# one JSON object per scenario (one per line) to stdout, e.g. for
+# appending to a file that tracks performance across commits:
+#
+# $ PYTHONPATH=../.. LOGLEVEL=ERROR python -O bench.py [steps] [seed] [scenario ...] >> bench.log
+#
+# or, from the top build directory, 'make bench'.
+#
+# Every scenario runs in a separate process, so that its peak RSS is its
+# own.  Green's function draw counts are only available when the tree was
+# configured with --enable-profiling; they are null otherwise.
+#
+# The scenarios are:
+#   reversible  dilute 3D reversible binding A + B <-> C (samples/reversible)
+#   hardbody    crowded hard-body particles propagated by BD (samples/hardbody)
+#   membrane    bulk, membrane-bound (2D) and rod-bound (1D) particles in a
+#               closed box (samples/1D+2D+3D_example)
+#   mapk        the dual phosphorylation MAPK network (samples/mapk/model3.py)
+
+import sys
+import os
+import math
+import time
+import resource
+import subprocess
+import json
+
+from egfrd import *
+from bd import *
+from utils import *
+import model
+import gfrdbase
+import myrandom
+import _gfrd
+import _greens_functions
+
+DEFAULT_STEPS = 20000
+DEFAULT_SEED = 0
+
+SCENARIOS = ['reversible', 'hardbody', 'membrane', 'mapk']
+
+
+def setup_reversible():
+    L = 1e-6
+    sigma = 5e-9
+    D = 1e-12
+    D_tot = D * 2
+    tau = sigma * sigma / D_tot
+    kf = 100 * sigma * D_tot
+    koff = 0.1 / tau
+
+    m = model.ParticleModel(L)
+    A = model.Species('A', D, sigma / 2)
+    B = model.Species('B', D, sigma / 2)
+    C = model.Species('C', D, sigma / 2)
+    m.add_species_type(A)
+    m.add_species_type(B)
+    m.add_species_type(C)
+    m.add_reaction_rule(model.create_binding_reaction_rule(A, B, C, kf))
+    m.add_reaction_rule(model.create_unbinding_reaction_rule(C, A, B, koff))
+
+    w = gfrdbase.create_world(m, 6)
+    s = EGFRDSimulator(w, myrandom.rng)
+    throw_in_particles(w, A, 100)
+    throw_in_particles(w, B, 100)
+    return s
+
+
+def setup_hardbody():
+    # about 16 % of the volume taken by the particles.
+    L = 5e-8
+    N = 300
+
+    m = model.ParticleModel(L)
+    A = model.Species('A', 1e-12, 2.5e-9)
+    m.add_species_type(A)
+    m.set_all_repulsive()
+
+    w = gfrdbase.create_world(m, max(3, int((3 * N) ** (1.0 / 3.0))))
+    s = BDSimulator(w, myrandom.rng)
+    throw_in_particles(w, A, N)
+    return s
+
+
+def setup_membrane():
+    ws = 1e-6
+    R_part = 10e-9
+    D = 1e-12
+
+    m = model.ParticleModel(ws)
+    membrane = _gfrd.StructureType()
+    membrane['name'] = 'membrane'
+    m.add_structure_type(membrane)
+    microtubule = _gfrd.StructureType()
+    microtubule['name'] = 'microtubule'
+    m.add_structure_type(microtubule)
+    nr = _gfrd.StructureType()
+    nr['name'] = 'non-reactive'
+    m.add_structure_type(nr)
+
+    A = model.Species('A', D, R_part)
+    Am = model.Species('Am', D / 10, R_part, membrane)
+    At = model.Species('At', D / 10, R_part, microtubule, 0.5e-6)
+    m.add_species_type(A)
+    m.add_species_type(Am)
+    m.add_species_type(At)
+    m.add_reaction_rule(model.create_binding_reaction_rule(A, membrane, Am, 1e-6))
+    m.add_reaction_rule(model.create_unimolecular_reaction_rule(Am, A, 1.0))
+    m.add_reaction_rule(model.create_binding_reaction_rule(A, microtubule, At, 1e-11))
+    m.add_reaction_rule(model.create_unimolecular_reaction_rule(At, A, 1.0))
+
+    w = gfrdbase.create_world(m, 3)
+    create_box(w, membrane, [0.5 * ws, 0.5 * ws, 0.5 * ws],
+               [0.95 * ws, 0.4 * ws, 0.4 * ws], one_sided=True)
+    create_rod(w, microtubule, nr, 'rod', [0.5 * ws, 0.5 * ws, 0.5 * ws],
+               25e-9, [1, 0, 0], 0.3 * ws, back_cap_structure_type=nr)
+
+    s = EGFRDSimulator(w, myrandom.rng)
+    throw_in_particles(w, Am, 40)
+    throw_in_particles(w, At, 10)
+    throw_in_particles(w, A, 40, [0.10 * ws, 0.33 * ws, 0.33 * ws],
+                       [0.90 * ws, 0.66 * ws, 0.66 * ws])
+    return s
+
+
+def setup_mapk():
+    V = 1e-15                   # [l]
+    L = math.pow(V * 1e-3, 1.0 / 3.0)
+    D = 1e-12
+    radius = 2.5e-9
+    ki = math.log(2) / 1e-6
+
+    m = model.ParticleModel(L)
+    species = {}
+    for name in ['K', 'KK', 'P', 'Kp', 'Kpp', 'K_KK', 'Kp_KK', 'Kpp_P',
+                 'Kp_P', 'KKi', 'Pi']:
+        species[name] = model.Species(name, D, radius)
+        m.add_species_type(species[name])
+
+    kD = k_D(D * 2, radius * 2)
+    k1 = k_a(per_M_to_m3(0.02e9), kD)
+    k2 = k_d(1.0, per_M_to_m3(0.02e9), kD)
+    k3 = 1.5
+    k4 = k_a(per_M_to_m3(0.032e9), kD)
+    k5 = k_d(1.0, per_M_to_m3(0.032e9), kD)
+    k6 = 15.0
+
+    def binding(a, b, c, k):
+        m.add_reaction_rule(model.create_binding_reaction_rule(
+            species[a], species[b], species[c], k))
+
+    def unbinding(a, b, c, k):
+        m.add_reaction_rule(model.create_unbinding_reaction_rule(
+            species[a], species[b], species[c], k))
+
+    binding('K', 'KK', 'K_KK', k1)
+    unbinding('K_KK', 'K', 'KK', k2)
+    unbinding('K_KK', 'Kp', 'KKi', k3)
+    binding('Kp', 'KK', 'Kp_KK', k4)
+    unbinding('Kp_KK', 'Kp', 'KK', k5)
+    unbinding('Kp_KK', 'Kpp', 'KKi', k6)
+    binding('Kpp', 'P', 'Kpp_P', k1)
+    unbinding('Kpp_P', 'Kpp', 'P', k2)
+    unbinding('Kpp_P', 'Kp', 'Pi', k3)
+    binding('Kp', 'P', 'Kp_P', k4)
+    unbinding('Kp_P', 'Kp', 'P', k5)
+    unbinding('Kp_P', 'K', 'Pi', k6)
+    m.add_reaction_rule(model.create_unimolecular_reaction_rule(
+        species['KKi'], species['KK'], ki))
+    m.add_reaction_rule(model.create_unimolecular_reaction_rule(
+        species['Pi'], species['P'], ki))
+
+    N_K = int(C2N(200e-9, V))
+    N_KK = int(C2N(50e-9, V))
+    N_P = int(C2N(50e-9, V))
+    N = N_K + N_KK + N_P
+    w = gfrdbase.create_world(m, min(max(3, int((3 * N) ** (1.0 / 3.0))), 60))
+    s = EGFRDSimulator(w, myrandom.rng)
+    throw_in_particles(w, species['K'], N_K)
+    throw_in_particles(w, species['KK'], N_KK)
+    throw_in_particles(w, species['P'], N_P)
+    return s
+
+
+def domain_steps(s):
+    """Return the number of steps taken so far per kind of domain."""
+    if isinstance(s, BDSimulator):
+        return {'bd': s.step_counter}
+
+    return {'single': sum(s.single_steps.values()),
+            'interaction': sum(s.interaction_steps.values()),
+            'pair': sum(s.pair_steps.values()),
+            'multi': s.multi_steps[3]}
+
+
+# Profiler.cpp is built into both extension modules, each with its own
+# instance: the draws of the Green's functions egfrd.py calls directly are
+# counted by _greens_functions, those made from C++ by _gfrd.
+def reset_profilers():
+    _gfrd.Profiler.instance().reset()
+    _greens_functions.reset_profiler()
+
+
+def gf_draws():
+    """Return {Green's function draw method: count}, summed over both
+    modules, or None if the library was not built with
+    --enable-profiling."""
+    if not _gfrd.Profiler.enabled():
+        return None
+
+    retval = {}
+    for stats in (_gfrd.Profiler.instance().stats(),
+                  _greens_functions.profiler_stats()):
+        for name, (count, total_time, max_time) in stats.items():
+            if name.startswith('GreensFunction') and '::draw' in name:
+                retval[name] = retval.get(name, 0) + count
+    return retval
+
+
+def revision():
+    try:
+        p = subprocess.Popen(['git', 'rev-parse', '--short', 'HEAD'],
+                             cwd=os.path.dirname(os.path.abspath(__file__)),
+                             stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        out = p.communicate()[0].strip()
+        if p.returncode == 0:
+            return out
+    except OSError:
+        pass
+    return None
+
+
+def run_scenario(name, steps, seed):
+    myrandom.seed(seed)
+
+    start = time.time()
+    s = globals()['setup_' + name]()
+    # the first step initializes the simulator.
+    s.step()
+    setup_time = time.time() - start
+
+    before = domain_steps(s)
+    t_start = s.t
+    reset_profilers()
+
+    start = time.time()
+    for i in xrange(steps):
+        s.step()
+    wall_time = time.time() - start
+
+    after = domain_steps(s)
+    simulated_time = s.t - t_start
+
+    return {'scenario': name,
+            'revision': revision(),
+            'seed': seed,
+            'steps': steps,
+            'setup_time': setup_time,
+            'wall_time': wall_time,
+            'steps_per_second': steps / wall_time if wall_time > 0 else None,
+            'simulated_time': simulated_time,
+            'events_per_simulated_second':
+                steps / simulated_time if simulated_time > 0 else None,
+            'domain_steps': dict((k, after[k] - before[k]) for k in after),
+            'peak_rss_kb':
+                resource.getrusage(resource.RUSAGE_SELF).ru_maxrss,
+            'gf_draws': gf_draws()}
+
+
+def main(argv):
+    steps = DEFAULT_STEPS
+    seed = DEFAULT_SEED
+    if len(argv) > 1:
+        steps = int(argv[1])
+    if len(argv) > 2:
+        seed = int(argv[2])
+    scenarios = argv[3:] or SCENARIOS
+    for name in scenarios:
+        if name not in SCENARIOS:
+            raise ValueError('unknown scenario: %s' % name)
+
+    if len(scenarios) == 1:
+        print json.dumps(run_scenario(scenarios[0], steps, seed),
+                         sort_keys=True)
+        sys.stdout.flush()
+        return 0
+
+    retval = 0
+    for name in scenarios:
+        args = [sys.executable]
+        if not __debug__:
+            args.append('-O')
+        args += [os.path.abspath(__file__), str(steps), str(seed), name]
+        retval = subprocess.call(args) or retval
+    return retval
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
@@ -0,0 +1,119 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+// Per-call timings of Green's function methods whose cost is dominated by
+// the series summations of funcSum.hpp.
+
+#include <boost/timer.hpp>
+#include <iostream>
+
+#include "GreensFunction1DAbsAbs.hpp"
+#include "GreensFunction3DAbs.hpp"
+#include "GreensFunction3DRadAbs.hpp"
+#include "GreensFunction3DRadInf.hpp"
+
+template<typename Tfun_>
+void time_calls(char const* name, Tfun_ const& f, std::size_t n)
+{
+    Real volatile result(0.);
+    boost::timer timer;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        result = result + f(i);
+    }
+    Real const elapsed(timer.elapsed());
+    std::cout << name << ": " << (elapsed / n * 1e6) << " us/call"
+              << " (" << n << " calls, " << elapsed << " s)" << std::endl;
+}
+
+// Spreads the evaluation times over [t, 2t) so that no result is cached.
+template<typename Tgf_>
+struct p_survival_call
+{
+    Real operator()(std::size_t i) const
+    {
+        return gf.p_survival(t * (1. + (i % 1000) * 1e-3));
+    }
+
+    p_survival_call(Tgf_ const& gf, Real t): gf(gf), t(t) {}
+
+    Tgf_ const& gf;
+    Real const t;
+};
+
+template<typename Tgf_>
+struct p_int_r_call
+{
+    Real operator()(std::size_t i) const
+    {
+        return gf.p_int_r(r, t * (1. + (i % 1000) * 1e-3));
+    }
+
+    p_int_r_call(Tgf_ const& gf, Real r, Real t): gf(gf), r(r), t(t) {}
+
+    Tgf_ const& gf;
+    Real const r;
+    Real const t;
+};
+
+template<typename Tgf_>
+struct p_theta_call
+{
+    Real operator()(std::size_t i) const
+    {
+        return gf.p_theta(theta, r, t * (1. + (i % 1000) * 1e-3));
+    }
+
+    p_theta_call(Tgf_ const& gf, Real theta, Real r, Real t)
+        : gf(gf), theta(theta), r(r), t(t) {}
+
+    Tgf_ const& gf;
+    Real const theta;
+    Real const r;
+    Real const t;
+};
+
+int main()
+{
+    Real const D(1e-12);
+    Real const sigma(1e-8);
+    Real const a(1e-7);
+    Real const r0(5e-8);
+    Real const kf(1e-18);
+    // long enough for both boundaries to be in sight, so that none of the
+    // methods returns through a short-time approximation.
+    Real const t(1e-4);
+
+    {
+        GreensFunction1DAbsAbs const gf(D, r0, sigma, a);
+        time_calls("GreensFunction1DAbsAbs::p_survival",
+                   p_survival_call<GreensFunction1DAbsAbs>(gf, t), 100000);
+    }
+
+    {
+        GreensFunction3DAbs const gf(D, r0, a);
+        time_calls("GreensFunction3DAbs::p_survival",
+                   p_survival_call<GreensFunction3DAbs>(gf, t), 100000);
+        time_calls("GreensFunction3DAbs::p_int_r",
+                   p_int_r_call<GreensFunction3DAbs>(gf, 6e-8, t), 10000);
+        time_calls("GreensFunction3DAbs::p_theta",
+                   p_theta_call<GreensFunction3DAbs>(gf, 1., 6e-8, t), 1000);
+    }
+
+    {
+        GreensFunction3DRadAbs const gf(D, kf, r0, sigma, a);
+        time_calls("GreensFunction3DRadAbs::p_survival",
+                   p_survival_call<GreensFunction3DRadAbs>(gf, t), 10000);
+        time_calls("GreensFunction3DRadAbs::p_int_r",
+                   p_int_r_call<GreensFunction3DRadAbs>(gf, 6e-8, t), 10000);
+    }
+
+    {
+        GreensFunction3DRadInf const gf(D, kf, r0, sigma);
+        time_calls("GreensFunction3DRadInf::p_theta",
+                   p_theta_call<GreensFunction3DRadInf>(gf, 1., 6e-8, t), 10000);
+    }
+
+    return 0;
+}
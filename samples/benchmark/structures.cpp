@@ -0,0 +1,230 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+// Per-call timings of the structure operations that are dispatched on the
+// structure type (apply_boundary, cyclic_transpose, get_pos_sid_pair), on
+// the geometry of samples/1D+2D+3D_example: a box of connected one-sided
+// planes and eight rods with disk caps in a cuboidal bulk.
+
+#include <boost/timer.hpp>
+#include <iostream>
+#include <vector>
+
+#include "utils/pair.hpp"
+#include "World.hpp"
+#include "ParticleSimulator.hpp"
+
+typedef World<CyclicWorldTraits<Real, Real> > world_type;
+typedef world_type::structure_type structure_type;
+typedef world_type::structure_id_type structure_id_type;
+typedef world_type::structure_type_id_type structure_type_id_type;
+typedef world_type::position_type position_type;
+typedef world_type::length_type length_type;
+typedef world_type::traits_type::rng_type rng_type;
+typedef world_type::cuboidal_region_type cuboidal_region_type;
+typedef world_type::planar_surface_type planar_surface_type;
+typedef world_type::cylindrical_surface_type cylindrical_surface_type;
+typedef world_type::disk_surface_type disk_surface_type;
+typedef planar_surface_type::side_enum_type side_type;
+typedef std::pair<position_type, structure_type const*> placement_type;
+
+template<typename Tfun_>
+void time_calls(char const* name, Tfun_ const& f, std::size_t n)
+{
+    Real volatile result(0.);
+    boost::timer timer;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        result = result + f(i);
+    }
+    Real const elapsed(timer.elapsed());
+    std::cout << name << ": " << (elapsed / n * 1e9) << " ns/call"
+              << " (" << n << " calls, " << elapsed << " s)" << std::endl;
+}
+
+struct apply_boundary_call
+{
+    Real operator()(std::size_t i) const
+    {
+        placement_type const& p(placements[i % placements.size()]);
+        return w.apply_boundary(std::make_pair(p.first, p.second->id())).first[0];
+    }
+
+    apply_boundary_call(world_type const& w, std::vector<placement_type> const& placements)
+        : w(w), placements(placements) {}
+
+    world_type const& w;
+    std::vector<placement_type> const& placements;
+};
+
+struct cyclic_transpose_call
+{
+    Real operator()(std::size_t i) const
+    {
+        placement_type const& p(placements[i % placements.size()]);
+        return w.cyclic_transpose(std::make_pair(p.first, p.second->id()), *p.second).first[0];
+    }
+
+    cyclic_transpose_call(world_type const& w, std::vector<placement_type> const& placements)
+        : w(w), placements(placements) {}
+
+    world_type const& w;
+    std::vector<placement_type> const& placements;
+};
+
+// Cycles over (origin placement, target structure) pairs.
+struct get_pos_sid_pair_call
+{
+    Real operator()(std::size_t i) const
+    {
+        std::size_t const k(i % origins.size());
+        return origins[k].second->get_pos_sid_pair(
+            *targets[k], origins[k].first, 5e-9, 1e-9, rng).first[0];
+    }
+
+    get_pos_sid_pair_call(std::vector<placement_type> const& origins,
+                          std::vector<structure_type const*> const& targets,
+                          rng_type& rng)
+        : origins(origins), targets(targets), rng(rng) {}
+
+    std::vector<placement_type> const& origins;
+    std::vector<structure_type const*> const& targets;
+    rng_type& rng;
+};
+
+// As model.create_planar_surface: the plane spans [corner, corner + lx * ux + ly * uy].
+boost::shared_ptr<planar_surface_type>
+add_plane(world_type& w, structure_type_id_type const& sid, structure_id_type const& parent_id,
+          position_type const& corner, position_type const& ux, position_type const& uy,
+          length_type lx, length_type ly)
+{
+    boost::shared_ptr<planar_surface_type> plane(new planar_surface_type("box", sid, parent_id,
+        planar_surface_type::shape_type(add(add(corner, multiply(ux, lx / 2)), multiply(uy, ly / 2)),
+                                        ux, uy, lx / 2, ly / 2, true)));
+    w.add_structure(plane);
+    return plane;
+}
+
+// As gfrdbase.create_rod: a cylinder from position along orientation with a
+// disk cap at either end.
+boost::shared_ptr<cylindrical_surface_type>
+add_rod(world_type& w, structure_type_id_type const& cyl_sid, structure_type_id_type const& cap_sid,
+        structure_id_type const& parent_id, position_type const& position, length_type radius,
+        position_type const& orientation, length_type length,
+        std::vector<boost::shared_ptr<disk_surface_type> >& caps)
+{
+    boost::shared_ptr<cylindrical_surface_type> rod(new cylindrical_surface_type("rod", cyl_sid, parent_id,
+        cylindrical_surface_type::shape_type(add(position, multiply(orientation, length / 2)),
+                                             radius, orientation, length / 2)));
+    w.add_structure(rod);
+    caps.push_back(boost::shared_ptr<disk_surface_type>(new disk_surface_type("front_cap", cap_sid, rod->id(),
+        disk_surface_type::shape_type(add(position, multiply(orientation, length)), radius, orientation))));
+    w.add_structure(caps.back());
+    caps.push_back(boost::shared_ptr<disk_surface_type>(new disk_surface_type("back_cap", cap_sid, rod->id(),
+        disk_surface_type::shape_type(position, radius, multiply(orientation, -1.)))));
+    w.add_structure(caps.back());
+    return rod;
+}
+
+int main()
+{
+    std::size_t const n(5000000);
+    length_type const ws(10e-6);
+    world_type w(ws, 3);
+
+    structure_type_id_type const bulk_sid(SpeciesTypeID::value_type(0, 1));
+    structure_type_id_type const membrane_sid(SpeciesTypeID::value_type(0, 2));
+    structure_type_id_type const microtubule_sid(SpeciesTypeID::value_type(0, 3));
+    structure_type_id_type const cap_sid(SpeciesTypeID::value_type(0, 4));
+
+    boost::shared_ptr<cuboidal_region_type> bulk(new cuboidal_region_type("world", bulk_sid, structure_id_type(),
+        cuboidal_region_type::shape_type(create_vector<position_type>(ws / 2, ws / 2, ws / 2),
+                                         array_gen(ws / 2, ws / 2, ws / 2))));
+    structure_id_type const bulk_id(w.add_structure(bulk));
+
+    // create_box(w, membrane, [0.5*ws, 0.5*ws, 0.5*ws], [0.95*ws, 0.4*ws, 0.4*ws])
+    position_type const ux(1., 0., 0.), uy(0., 1., 0.), uz(0., 0., 1.);
+    length_type const sx(.95 * ws), sy(.4 * ws), sz(.4 * ws);
+    position_type const lower(.5 * ws - sx / 2, .5 * ws - sy / 2, .5 * ws - sz / 2);
+    boost::shared_ptr<planar_surface_type> const
+        front(add_plane(w, membrane_sid, bulk_id, add(lower, multiply(ux, sx)), uz, uy, sz, sy)),
+        back(add_plane(w, membrane_sid, bulk_id, lower, uy, uz, sy, sz)),
+        right(add_plane(w, membrane_sid, bulk_id, add(lower, multiply(uy, sy)), ux, uz, sx, sz)),
+        left(add_plane(w, membrane_sid, bulk_id, lower, uz, ux, sz, sx)),
+        top(add_plane(w, membrane_sid, bulk_id, add(lower, multiply(uz, sz)), uy, ux, sy, sx)),
+        bottom(add_plane(w, membrane_sid, bulk_id, lower, ux, uy, sx, sy));
+    w.connect_structures(*left, side_type(3), *top, side_type(2));
+    w.connect_structures(*left, side_type(2), *bottom, side_type(1));
+    w.connect_structures(*left, side_type(1), *back, side_type(2));
+    w.connect_structures(*left, side_type(0), *front, side_type(1));
+    w.connect_structures(*right, side_type(3), *front, side_type(0));
+    w.connect_structures(*right, side_type(2), *back, side_type(3));
+    w.connect_structures(*right, side_type(1), *bottom, side_type(0));
+    w.connect_structures(*right, side_type(0), *top, side_type(3));
+    w.connect_structures(*top, side_type(1), *back, side_type(0));
+    w.connect_structures(*top, side_type(0), *front, side_type(3));
+    w.connect_structures(*bottom, side_type(3), *front, side_type(2));
+    w.connect_structures(*bottom, side_type(2), *back, side_type(1));
+
+    // Eight rods of radius 25 nm and length 0.45*ws, pairwise pointing away
+    // from the centre.
+    std::vector<boost::shared_ptr<cylindrical_surface_type> > rods;
+    std::vector<boost::shared_ptr<disk_surface_type> > caps;
+    length_type const rpos[2] = { .4 * ws, .6 * ws };
+    for (int i = 0; i < 4; ++i)
+    {
+        position_type const start(.5 * ws, rpos[i / 2], rpos[i % 2]);
+        rods.push_back(add_rod(w, microtubule_sid, cap_sid, bulk_id, start, 25e-9, ux, .45 * ws, caps));
+        rods.push_back(add_rod(w, microtubule_sid, cap_sid, bulk_id, start, 25e-9, multiply(ux, -1.), .45 * ws, caps));
+    }
+
+    // A particle in the bulk, two on every membrane face (one of which has
+    // been displaced across an edge), one on every rod and one on every cap.
+    std::vector<placement_type> placements;
+    placements.push_back(placement_type(position_type(.3 * ws, .2 * ws, .8 * ws), bulk.get()));
+    planar_surface_type const* const faces[6] = { front.get(), back.get(), right.get(), left.get(), top.get(), bottom.get() };
+    for (int i = 0; i < 6; ++i)
+    {
+        planar_surface_type::shape_type const& plane(faces[i]->shape());
+        placements.push_back(placement_type(
+            add(plane.position(), multiply(plane.unit_x(), .3 * plane.half_extent()[0])), faces[i]));
+        placements.push_back(placement_type(
+            add(plane.position(), multiply(plane.unit_x(), 1.01 * plane.half_extent()[0])), faces[i]));
+    }
+    for (std::size_t i = 0; i < rods.size(); ++i)
+    {
+        cylindrical_surface_type::shape_type const& cylinder(rods[i]->shape());
+        placements.push_back(placement_type(
+            add(cylinder.position(), multiply(cylinder.unit_z(), .5 * cylinder.half_length())), rods[i].get()));
+    }
+    for (std::size_t i = 0; i < caps.size(); ++i)
+    {
+        placements.push_back(placement_type(caps[i]->position(), caps[i].get()));
+    }
+
+    // The structure changes of the example's reaction rules: binding to and
+    // unbinding from the membrane and a rod, and from a rod to its cap.
+    std::vector<placement_type> origins;
+    std::vector<structure_type const*> targets;
+    origins.push_back(placement_type(top->position(), bulk.get()));
+    targets.push_back(top.get());
+    origins.push_back(placement_type(top->position(), top.get()));
+    targets.push_back(bulk.get());
+    origins.push_back(placement_type(rods[0]->position(), bulk.get()));
+    targets.push_back(rods[0].get());
+    origins.push_back(placement_type(rods[0]->position(), rods[0].get()));
+    targets.push_back(bulk.get());
+    origins.push_back(placement_type(caps[0]->position(), rods[0].get()));
+    targets.push_back(caps[0].get());
+    origins.push_back(placement_type(caps[0]->position(), caps[0].get()));
+    targets.push_back(bulk.get());
+
+    rng_type rng;
+
+    time_calls("World::apply_boundary", apply_boundary_call(w, placements), n);
+    time_calls("World::cyclic_transpose", cyclic_transpose_call(w, placements), n);
+    time_calls("Structure::get_pos_sid_pair", get_pos_sid_pair_call(origins, targets, rng), n);
+
+    return 0;
+}
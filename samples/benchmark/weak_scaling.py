@@ -0,0 +1,111 @@
+#!/usr/bin/env python
+
+# Weak-scaling benchmark of the distributed eGFRD driver (distributed.py).
+#
+# Simulates reversible binding A + B <-> C at a fixed concentration with
+# k^3 ranks for k = 1, 2, ..., each owning a block of CELLS_PER_RANK^3
+# cells of the same size and PARTICLES_PER_RANK particles on average, and
+# writes one JSON object per number of ranks (one per line):
+#
+# $ PYTHONPATH=../.. LOGLEVEL=ERROR python -O weak_scaling.py [max_ranks] [t_end] >> scaling.log
+#
+# or, from the top build directory, 'make bench-scaling'.
+#
+# The world is a cube, so only cubic numbers of ranks keep both the volume
+# and the cell size per rank constant.  The ranks are local processes;
+# with mpi4py, run_mpi can be used in the same way under mpirun.  Perfect
+# weak scaling keeps the wall time, and so the efficiency (wall time on
+# one rank / wall time), constant.  Every rank still allocates the cells
+# of the whole world (grid_cells), which the peak RSS per rank shows.
+
+import sys
+import time
+import json
+import multiprocessing
+
+import model
+from gfrdbase import throw_in_particles
+from distributed import run_local
+
+PARTICLES_PER_RANK = 300
+L_PER_RANK = 1e-6
+CELLS_PER_RANK = 3
+SIGMA = 5e-9
+D = 1e-12
+DEFAULT_T_END = 1e-3
+
+# set for every run before the ranks are forked.
+L = L_PER_RANK
+
+
+def make_model():
+    D_tot = 2 * D
+    tau = SIGMA ** 2 / D_tot
+    m = model.ParticleModel(L)
+    A = model.Species('A', D, SIGMA / 2)
+    B = model.Species('B', D, SIGMA / 2)
+    C = model.Species('C', D, SIGMA / 2)
+    for species in [A, B, C]:
+        m.add_species_type(species)
+    m.add_reaction_rule(model.create_binding_reaction_rule(A, B, C, 100 * SIGMA * D_tot))
+    m.add_reaction_rule(model.create_unbinding_reaction_rule(C, A, B, 0.1 / tau))
+    return m
+
+
+def populate(world):
+    species = dict((st['name'], st) for st in world.model.species_types)
+    n = int(round((L / L_PER_RANK) ** 3 * PARTICLES_PER_RANK))
+    throw_in_particles(world, species['A'], n // 2)
+    throw_in_particles(world, species['B'], n - n // 2)
+
+
+def run(k, t_end):
+    global L
+    L = L_PER_RANK * k
+    size = k ** 3
+    matrix_size = CELLS_PER_RANK * k
+
+    start = time.time()
+    stats = run_local(size, make_model, populate, matrix_size, t_end,
+                      shape=(k, k, k))
+    wall_time = time.time() - start
+
+    return {'ranks': size,
+            'cell_size': L / matrix_size,
+            'cells_per_rank': [s['cells'] for s in stats],
+            'grid_cells': stats[0]['grid_cells'],
+            'peak_rss_kb_per_rank': [s['peak_rss_kb'] for s in stats],
+            'particles': sum(s['particles'] for s in stats),
+            't_end': t_end,
+            'wall_time': wall_time,
+            'steps': sum(s['steps'] for s in stats),
+            'windows': stats[0]['windows'],
+            'migrated': sum(s['migrated'] for s in stats),
+            'conflicts': sum(s['conflicts'] for s in stats),
+            'ghosts': sum(s['ghosts'] for s in stats),
+            'exchange_time': max(s['exchange_time'] for s in stats)}
+
+
+def main(argv):
+    max_ranks = multiprocessing.cpu_count()
+    t_end = DEFAULT_T_END
+    if len(argv) > 1:
+        max_ranks = int(argv[1])
+    if len(argv) > 2:
+        t_end = float(argv[2])
+
+    k = 1
+    wall_time_1 = None
+    while k ** 3 <= max_ranks:
+        result = run(k, t_end)
+        if wall_time_1 is None:
+            wall_time_1 = result['wall_time']
+        result['efficiency'] = wall_time_1 / result['wall_time']
+        print json.dumps(result, sort_keys=True)
+        sys.stdout.flush()
+        k += 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
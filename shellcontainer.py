@@ -26,6 +26,7 @@ class ShellContainer(object):
 
         self.world = world
         self.user_max_shell_size = numpy.inf    # Note: shell_size is actually the RADIUS of the shell
+        self.touched_domains = None             # if a set, move_shell adds the domain ids to it
 
     def get_matrix_cell_size(self):
         return self.containers[0].cell_size     # cell_size is the width of the (cubic) cell
@@ -54,6 +55,8 @@ class ShellContainer(object):
         shell = shell_id_shell_pair[1]
         container = self.get_container(shell)
         container.update(shell_id_shell_pair)
+        if self.touched_domains is not None:
+            self.touched_domains.add(shell.did)
 
     def remove_shell(self, shell_id_shell_pair):
         shell_id = shell_id_shell_pair[0]
@@ -65,6 +68,15 @@ class ShellContainer(object):
         # Export the distance calculation
         return self.world.distance(pos1, pos2)
 
+    def memory_usage(self):
+        # (live, reserved) bytes of all the shell containers together
+        live, reserved = 0, 0
+        for container in self.containers:
+            l, r = container.memory_usage()
+            live += l
+            reserved += r
+        return live, reserved
+
     def get_intruders(self, position, radius, ignore):
         # gets the intruders in a spherical volume of radius 'radius'?
         # TODO make this surface specific -> in 2D only need to check in cylinder,
@@ -131,7 +143,7 @@ class ShellContainer(object):
 
         partners = []
         for domain, distance in neighbor_domains:
-            if (isinstance (domain, NonInteractionSingle) and domain.is_reset()) or \
+            if (isinstance (domain, NonInteractionSingle) and domain.has_zero_shell()) or \
                isinstance (domain, Multi):
                 partners.append((domain, distance))
 
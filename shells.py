@@ -14,6 +14,9 @@ from _gfrd import (
     Plane,
     PlanarSurface,
     CuboidalRegion,
+    SphericalShellScaling,
+    CylindricalShellScaling,
+    NoSpace,
     )
 
 from utils import *
@@ -253,9 +256,9 @@ class testPair(Others):
     def __init__(self, single1, single2):
         # Note: for the Others superclass nothing is to be initialized.
 
-        # Assert both singles are reset
+        # Assert both singles are reset (the partner may also be immobile)
         assert single1.is_reset()
-        assert single2.is_reset()
+        assert single2.has_zero_shell()
 
         self.single1 = single1
         self.single2 = single2
@@ -1684,6 +1687,33 @@ class SphericaltestShell(testShell):
     def determine_possible_shell(self, base_structure_id, ignore, ignores):
         # This determines the largest possible radius of the spherical testShell or throws an
         # exception if the domain could not be made due to geometrical constraints.
+        # The scaling itself is done by SphericalShellScaling (C++), determine_possible_shell_python
+        # is the reference implementation.
+
+        neighbor_domains, neighbor_surfaces = self.get_neighbors(base_structure_id, ignore, ignores)
+        min_radius = self.apply_safety(self.get_min_radius())
+        max_radius = self.get_max_radius()
+
+        surface_distances = []
+        for surface, distance in neighbor_surfaces:
+            # FIXME ugly hack to make spherical singles overlap with membranes
+            if isinstance(surface, PlanarSurface) and isinstance(self, SphericalSingletestShell):
+                distance += self.pid_particle_pair[1].radius
+            surface_distances.append(distance)
+
+        shapes = [shell_appearance.shape for neighbor, _ in neighbor_domains
+                                         for _, shell_appearance in self.get_neighbor_shell_list(neighbor)]
+
+        try:
+            radius = SphericalShellScaling(self.center, self.world.world_size). \
+                         determine_possible_shell(surface_distances, shapes, min_radius, max_radius)
+        except NoSpace as e:
+            raise ShellmakingError('%s, testShell = %s' % (str(e), self))
+
+        return self.apply_safety(radius)
+
+    def determine_possible_shell_python(self, base_structure_id, ignore, ignores):
+        # Python version of determine_possible_shell; used as a reference in the tests.
 
         neighbor_domains, neighbor_surfaces = self.get_neighbors(base_structure_id, ignore, ignores)
         min_radius = self.apply_safety(self.get_min_radius())
@@ -1851,6 +1881,48 @@ class CylindricaltestShell(testShell):
     def determine_possible_shell(self, base_structure_id, ignore, ignores):
         # This determines the maximum dr, dz_right, dz_left of the cylindrical testShell or
         # throws an exception if the domain could not be made due to geometrical constraints.
+        # The scaling itself is done by CylindricalShellScaling (C++) when the testShell uses
+        # the linear scaling functions r_right/z_right/r_left/z_left defined below.
+
+        if not self.linear_scaling:
+            return self.determine_possible_shell_python(base_structure_id, ignore, ignores)
+
+        neighbor_domains, neighbor_surfaces = self.get_neighbors(base_structure_id, ignore, ignores)
+
+        min_dr, min_dz_right, min_dz_left = self.get_min_dr_dzright_dzleft()
+        max_dr, max_dz_right, max_dz_left = self.get_max_dr_dzright_dzleft()
+        min_dims = self.apply_safety(min_dr, min_dz_right, min_dz_left)
+
+        # first the surfaces, then the shells of the neighboring domains
+        shapes = [surface.shape for surface, _ in neighbor_surfaces]
+        shapes.extend(shell_appearance.shape for neighbor, _ in neighbor_domains
+                                             for _, shell_appearance in self.get_neighbor_shell_list(neighbor))
+
+        try:
+            dr, dz_right, dz_left = self.get_shell_scaling(). \
+                determine_possible_shell(shapes, min_dims, (max_dr, max_dz_right, max_dz_left))
+        except NoSpace as e:
+            raise ShellmakingError('%s, testShell = %s' % (str(e), self))
+
+        # Note that dr, dz_right, dz_left can now actually be smaller than the minimum
+        return self.apply_safety(dr, dz_right, dz_left)
+
+    def get_shell_scaling(self):
+        # The C++ counterpart of the geometric part of this testShell.
+        # FIXME ugly hack to make planar surface singles overlap with membranes
+        if isinstance(self, PlanarSurfaceSingletestShell):
+            plane_distance_offset = self.pid_particle_pair[1].radius
+        else:
+            plane_distance_offset = 0.0
+
+        return CylindricalShellScaling(self.get_referencepoint(), self.get_orientation_vector(),
+                                       self.drdz_right, self.dzdr_right, self.r0_right, self.z0_right,
+                                       self.drdz_left, self.dzdr_left, self.r0_left, self.z0_left,
+                                       self.world.world_size, plane_distance_offset)
+
+    def determine_possible_shell_python(self, base_structure_id, ignore, ignores):
+        # Python version of determine_possible_shell; used as a reference in the tests and for
+        # testShells with non-linear scaling functions.
                 
         neighbor_domains, neighbor_surfaces = self.get_neighbors(base_structure_id, ignore, ignores)
 
@@ -1935,6 +2007,9 @@ class CylindricaltestShell(testShell):
     # These methods are used to calculate the new r/z_right/z_left after one of the parameters 
     # r/z_right/z_left has changed. The scaling centers (r0, z0) and scaling directions drdz
     # are defined differently for every testShell.
+    # Subclasses that override them with non-linear functions must set linear_scaling to False.
+    linear_scaling = True
+
     def r_right(self, z_right):
         return self.drdz_right * (z_right - self.z0_right) + self.r0_right
     def z_right(self, r_right):
@@ -3211,6 +3286,9 @@ class CylindricalSurfaceSinktestShell(CylindricaltestShell, testInteractionSingl
 #####
 class MixedPair2D3DtestShell(CylindricaltestShell, testMixedPair2D3D):
 
+    # r_right and z_right are overridden below
+    linear_scaling = False
+
     def __init__(self, single2D, single3D, geometrycontainer, domains):
         CylindricaltestShell.__init__(self, geometrycontainer, domains)  # this must be first because of world definition
         # The initialization of r0 can fail in testPair.__init__
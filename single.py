@@ -194,7 +194,31 @@ class NonInteractionSingle(Single, NonInteractionSingles):
     def initialize(self, t):
         Single.initialize(self, t)
         self.event_type = EventType.SINGLE_ESCAPE
-
+        self.immobile = False
+
+    def is_static(self):
+        # The particle neither diffuses nor drifts.
+        return self.pid_particle_pair[1].D == 0 and self.pid_particle_pair[1].v == 0
+
+    def is_immobile(self):
+        # An immobile single keeps the zero shell it was created with and only
+        # waits for its unimolecular reaction. Since its particle does not move
+        # it never has to be bursted; a mobile particle that comes near takes
+        # it into a Pair or Multi just like a reset single.
+        return self.immobile
+
+    def has_zero_shell(self):
+        # The single can be taken into a Pair or Multi without bursting it.
+        return self.is_reset() or self.immobile
+
+    def make_immobile(self, t):
+        # Turns the reset single of a static particle into an immobile single.
+        # Only the reaction event is scheduled; the waiting time is exponential
+        # so it may be redrawn whenever the single is taken into another domain.
+        assert self.is_reset() and self.is_static()
+        self.immobile = True
+        self.dt, self.event_type = self.draw_reaction_time_tuple()
+        self.last_time = t
 
     def determine_next_event(self):
         """Return an (event time, event type)-tuple.
@@ -345,9 +369,9 @@ class SphericalSingle(NonInteractionSingle, hasSphericalShell):
         assert isinstance(self.testShell, SphericalSingletestShell)
         assert isinstance(self.shell.shape, Sphere)
         assert self.shell.shape.radius <= self.testShell.get_max_radius()
-        if not self.is_reset():
+        if not self.has_zero_shell():
             assert self.shell.shape.radius*SAFETY >= self.testShell.get_min_radius()
-        if self.is_reset():
+        if self.has_zero_shell():
             assert feq(self.shell.shape.radius, self.pid_particle_pair[1].radius)
 
         assert self.is_reset() ^ (self.dt != 0.0)
@@ -437,12 +461,12 @@ class PlanarSurfaceSingle(NonInteractionSingle, hasCylindricalShell):
 
         max_radius, _, _ = self.testShell.get_max_dr_dzright_dzleft()
         assert self.shell.shape.radius <= max_radius
-        if not self.is_reset():
+        if not self.has_zero_shell():
             min_radius, _, _ = self.testShell.get_min_dr_dzright_dzleft()
             assert self.shell.shape.radius*SAFETY >= min_radius
         assert feq(self.shell.shape.half_length, self.testShell.z_right(self.shell.shape.radius))
         assert feq(self.shell.shape.half_length, self.testShell.z_left (self.shell.shape.radius))
-        if self.is_reset():
+        if self.has_zero_shell():
             assert feq(self.shell.shape.radius, self.pid_particle_pair[1].radius)
 
         assert self.is_reset() ^ (self.dt != 0.0)
@@ -572,7 +596,7 @@ class CylindricalSurfaceSingle(NonInteractionSingle, hasCylindricalShell):
 #        assert self.shell.shape.radius <= self.testShell.get_max_radius()
 #        if not self.is_reset():
 #            assert self.shell.shape.radius >= self.testShell.get_min_radius()
-        if self.is_reset():
+        if self.has_zero_shell():
             assert feq(self.shell.shape.half_length, self.pid_particle_pair[1].radius)
 
         assert self.is_reset() ^ (self.dt != 0.0)
@@ -667,7 +691,7 @@ class DiskSurfaceSingle(NonInteractionSingle, hasCylindricalShell):
         assert isinstance(self.testShell, DiskSurfaceSingletestShell)
         assert isinstance(self.shell.shape, Cylinder)
 
-        if self.is_reset():
+        if self.has_zero_shell():
             assert feq(self.shell.shape.half_length, self.pid_particle_pair[1].radius)
 
         assert self.is_reset() ^ (self.dt != 0.0)
@@ -0,0 +1,66 @@
+#!/usr/bin/env python
+
+import unittest
+import os
+import tempfile
+
+import _gfrd
+
+
+class AsyncFileAppenderTestCase(unittest.TestCase):
+
+    def setUp(self):
+        fd, self.filename = tempfile.mkstemp()
+        os.close(fd)
+
+    def tearDown(self):
+        os.remove(self.filename)
+
+    def read_lines(self):
+        f = open(self.filename)
+        try:
+            return f.read().splitlines()
+        finally:
+            f.close()
+
+    def test_write(self):
+        appender = _gfrd.AsyncFileAppender(self.filename)
+        self.assertEqual(self.filename, appender.filename)
+        appender(_gfrd.LogLevel.INFO, 'test', ['hello, ', 'world'])
+        appender.flush()
+        lines = self.read_lines()
+        self.assertEqual(1, len(lines))
+        self.assertTrue(lines[0].endswith('test: INFO     hello, world'))
+        self.assertEqual(0, appender.dropped)
+
+    def test_capacity(self):
+        appender = _gfrd.AsyncFileAppender(self.filename, 100)
+        self.assertEqual(128, appender.capacity)
+
+    def test_drop(self):
+        appender = _gfrd.AsyncFileAppender(self.filename, 2)
+        for i in range(1000):
+            appender(_gfrd.LogLevel.INFO, 'test', ['%d' % i])
+        # records at or above the blocking level are never dropped.
+        appender(_gfrd.LogLevel.ERROR, 'test', ['last'])
+        appender.flush()
+        del appender
+
+        lines = self.read_lines()
+        records = [l for l in lines if ' test: ' in l]
+        dropped = sum(int(l.split()[1]) for l in lines
+                      if l.endswith('log records dropped'))
+        self.assertEqual(1001, len(records) + dropped)
+        self.assertTrue(records[-1].endswith('last'))
+
+    def test_truncate(self):
+        appender = _gfrd.AsyncFileAppender(self.filename)
+        appender(_gfrd.LogLevel.INFO, 'test', ['x' * 1000])
+        appender.flush()
+        lines = self.read_lines()
+        self.assertEqual(1, len(lines))
+        self.assertTrue(len(lines[0]) < 1000)
+
+
+if __name__ == "__main__":
+    unittest.main()
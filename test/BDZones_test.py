@@ -0,0 +1,63 @@
+#!/usr/bin/env python
+
+import unittest
+
+from bdzones import *
+
+class BDZonesTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.zones = BDZones(1.0, nbins=4, promote=1.0, demote=0.1,
+                             memory=5, min_samples=3)
+        self.pos = [0.1, 0.1, 0.1]
+
+    def tearDown(self):
+        pass
+
+    def test_promote_and_demote(self):
+        self.failIf(self.zones.is_bd_zone(self.pos))
+
+        for i in range(20):
+            self.zones.record_domain(self.pos, 0.0, 1e-6)
+        self.failUnless(self.zones.is_bd_zone(self.pos))
+        self.assertEqual(1, self.zones.promotions)
+        self.assertEqual(1, self.zones.num_zones())
+
+        # other cells are not affected.
+        self.failIf(self.zones.is_bd_zone([0.6, 0.1, 0.1]))
+
+        for i in range(50):
+            self.zones.record_domain(self.pos, 1e-4, 1e-6)
+        self.failIf(self.zones.is_bd_zone(self.pos))
+        self.assertEqual(1, self.zones.demotions)
+
+    def test_hysteresis(self):
+        for i in range(20):
+            self.zones.record(self.pos, 5.0)
+        self.failUnless(self.zones.is_bd_zone(self.pos))
+
+        # between the thresholds the cell keeps its state, either way.
+        for i in range(50):
+            self.zones.record(self.pos, 0.5)
+        self.failUnless(self.zones.is_bd_zone(self.pos))
+
+        for i in range(50):
+            self.zones.record(self.pos, 0.01)
+        self.failIf(self.zones.is_bd_zone(self.pos))
+
+        for i in range(50):
+            self.zones.record(self.pos, 0.5)
+        self.failIf(self.zones.is_bd_zone(self.pos))
+        self.assertEqual(1, self.zones.promotions)
+        self.assertEqual(1, self.zones.demotions)
+
+    def test_cyclic_cells(self):
+        self.assertEqual(self.zones.cell_index([0.1, 0.1, 0.1]),
+                         self.zones.cell_index([1.1, -0.9, 0.1]))
+
+    def test_thresholds(self):
+        self.assertRaises(ValueError, BDZones, 1.0, 4, 0.1, 1.0)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,194 @@
+#!/usr/bin/env python
+
+import unittest
+
+import model
+import myrandom
+from gfrdbase import throw_in_particles, create_world
+from egfrd import EGFRDSimulator
+from distributed import *
+
+
+L = 1e-6
+N = 60
+
+
+def make_model():
+    m = model.ParticleModel(L)
+    m.add_species_type(model.Species('A', 1e-12, 5e-9))
+    return m
+
+
+def populate(world):
+    throw_in_particles(world, list(world.model.species_types)[0], N)
+
+
+# A + B <-> C, relaxing to about half of the A bound within a few ms.
+BINDING_L = 2e-7
+BINDING_N = 30
+BINDING_MATRIX_SIZE = 6
+BINDING_T_END = 2e-2
+BINDING_T_EQUILIBRIUM = 5e-3
+
+
+def make_binding_model():
+    m = model.ParticleModel(BINDING_L)
+    A = model.Species('A', 1e-12, 2.5e-9)
+    B = model.Species('B', 1e-12, 2.5e-9)
+    C = model.Species('C', 1e-12, 2.5e-9)
+    for species in [A, B, C]:
+        m.add_species_type(species)
+    m.add_reaction_rule(model.create_binding_reaction_rule(A, B, C, 1e-18))
+    m.add_reaction_rule(model.create_unbinding_reaction_rule(C, A, B, 2e3))
+    return m
+
+
+def populate_binding(world):
+    species = dict((st['name'], st) for st in world.model.species_types)
+    throw_in_particles(world, species['A'], BINDING_N)
+    throw_in_particles(world, species['B'], BINDING_N)
+
+
+def mean_bound_fraction(counts, window):
+    # The mean of C / (A + C) over the windows that end after
+    # BINDING_T_EQUILIBRIUM.
+    first = int(round(BINDING_T_EQUILIBRIUM / window))
+    fractions = [float(c['C']) / (c['A'] + c['C']) for c in counts[first:]]
+    return sum(fractions) / len(fractions)
+
+
+def serial_counts(window):
+    # The counts of an undecomposed run, sampled at the same times.
+    world = create_world(make_binding_model(), BINDING_MATRIX_SIZE)
+    myrandom.seed(0)
+    populate_binding(world)
+    myrandom.seed(1)
+    sim = EGFRDSimulator(world, myrandom.rng)
+
+    sids = dict((st['name'], st.id) for st in world.model.species_types)
+    counts = []
+    while sim.t < BINDING_T_END:
+        synchronize(sim, min(sim.t + window, BINDING_T_END))
+        counts.append(dict((name, len(world.get_particle_ids(sid)))
+                           for name, sid in sids.items()))
+    return counts
+
+
+class SlabDecompositionTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.d = SlabDecomposition(1.0, 10, 3)
+
+    def test_bounds_follow_cells(self):
+        self.assertEqual(len(self.d.bounds), 4)
+        for bound in self.d.bounds:
+            self.failUnless(abs(bound * 10 - round(bound * 10)) < 1e-12)
+
+    def test_too_many_ranks(self):
+        self.assertRaises(RuntimeError, SlabDecomposition, 1.0, 2, 3)
+
+    def test_owner(self):
+        self.assertEqual(self.d.owner([0.1, 0.5, 0.5]), 0)
+        self.assertEqual(self.d.owner([0.5, 0.5, 0.5]), 1)
+        self.assertEqual(self.d.owner([0.9, 0.5, 0.5]), 2)
+        self.assertEqual(self.d.owner([-0.05, 0.5, 0.5]), 2)
+
+    def test_ghost_ranks(self):
+        self.assertEqual(self.d.ghost_ranks([0.05, 0, 0], 0.1), set([2]))
+        self.assertEqual(self.d.ghost_ranks([0.25, 0, 0], 0.1), set([1]))
+        self.assertEqual(self.d.ghost_ranks([0.45, 0, 0], 0.1), set())
+        self.assertEqual(SlabDecomposition(1.0, 10, 1).ghost_ranks([0.01, 0, 0], 0.1), set())
+
+
+class BlockDecompositionTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.d = BlockDecomposition(2.0, 6, (2, 2, 2))
+
+    def test_balanced_shape(self):
+        self.assertEqual(balanced_shape(1), (1, 1, 1))
+        self.assertEqual(balanced_shape(2), (2, 1, 1))
+        self.assertEqual(balanced_shape(4), (2, 2, 1))
+        self.assertEqual(balanced_shape(8), (2, 2, 2))
+        self.assertEqual(balanced_shape(12), (3, 2, 2))
+
+    def test_cells(self):
+        # the cells, and so the cell size, per rank do not depend on the
+        # number of ranks.
+        for rank in range(8):
+            self.assertEqual(self.d.cells(rank), 27)
+        self.assertEqual(BlockDecomposition(1.0, 3, (1, 1, 1)).cells(0), 27)
+        self.assertEqual(self.d.min_width(), 1.0)
+
+    def test_owner(self):
+        self.assertEqual(self.d.owner([0.5, 0.5, 0.5]), 0)
+        self.assertEqual(self.d.owner([1.5, 0.5, 1.5]), 5)
+        self.assertEqual(self.d.block(5), (1, 0, 1))
+        self.assertEqual(self.d.owner([-0.5, -0.5, -0.5]), 7)
+
+    def test_ghost_ranks(self):
+        # a corner touches all other blocks, a face only one.
+        self.assertEqual(self.d.ghost_ranks([0.05, 0.05, 0.05], 0.3),
+                         set(range(1, 8)))
+        self.assertEqual(self.d.ghost_ranks([0.5, 0.5, 0.95], 0.3), set([4]))
+        self.assertEqual(self.d.ghost_ranks([0.5, 0.5, 0.5], 0.3), set())
+
+
+class DistributedEGFRDTestCase(unittest.TestCase):
+
+    def test_particles_are_conserved(self):
+        stats = run_local(2, make_model, populate, 6, 1e-4, collect=True)
+
+        self.assertEqual(len(stats), 2)
+        particles = sum([s['final_particles'] for s in stats], [])
+        self.assertEqual(len(particles), N)
+        for s in stats:
+            self.failUnless(s['windows'] > 0)
+            d = SlabDecomposition(L, 6, 2)
+            for name, structure, position in s['final_particles']:
+                self.assertEqual(name, 'A')
+                self.assertEqual(d.owner(position), s['rank'])
+
+    def test_synchronize_at_event_time(self):
+        world = create_world(make_model(), 6)
+        myrandom.seed(0)
+        populate(world)
+        sim = EGFRDSimulator(world, myrandom.rng)
+        sim.step()
+
+        # stop alone raises at the time of the next event.
+        t = sim.get_next_time()
+        synchronize(sim, t)
+        self.assertEqual(sim.t, t)
+        for domain in sim.domains.itervalues():
+            self.failUnless(domain.has_zero_shell())
+
+    def test_equilibrium_matches_serial(self):
+        # the default window, a third of the ghost width (one cell) in
+        # diffusion time: about 2e-5 s here.
+        stats = run_local(2, make_binding_model, populate_binding,
+                          BINDING_MATRIX_SIZE, BINDING_T_END)
+
+        window = stats[0]['window']
+        cell_size = BINDING_L / BINDING_MATRIX_SIZE
+        self.assertAlmostEqual(cell_size ** 2 / (54 * 1e-12), window,
+                               delta=1e-6 * window)
+        windows = stats[0]['windows']
+        counts = [dict((name, sum(s['counts'][i][name] for s in stats))
+                       for name in ['A', 'B', 'C'])
+                  for i in range(windows)]
+        for c in counts:
+            self.assertEqual(c['A'] + c['C'], BINDING_N)
+            self.assertEqual(c['B'] + c['C'], BINDING_N)
+
+        serial = serial_counts(window)
+        self.assertEqual(len(serial), windows)
+
+        # the fraction fluctuates by about 0.1 over the relaxation time,
+        # of which the runs cover about ten after equilibrating.
+        self.assertTrue(abs(mean_bound_fraction(counts, window) -
+                            mean_bound_fraction(serial, window)) < 0.15)
+
+
+if __name__ == "__main__":
+    unittest.main()
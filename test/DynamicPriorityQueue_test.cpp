@@ -4,6 +4,8 @@
 
 #define BOOST_TEST_MODULE "DynamicPriorityQueue"
 
+#include <iterator>
+#include <vector>
 #include <boost/mpl/list.hpp>
 #include <boost/test/included/unit_test.hpp>
 #include <boost/test/test_case_template.hpp>
@@ -626,3 +628,62 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(testInterleavedSortingWithPops, DPQ,
     BOOST_CHECK(dpq.empty());
     BOOST_CHECK(dpq.check());
 }
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(testBulkPush, DPQ, both)
+{
+    DPQ dpq;
+    typedef typename DPQ::index_type Index;
+
+    std::vector<int> items;
+    for (int i(0); i != 100; ++i)
+    {
+        items.push_back((i * 37) % 100);
+    }
+
+    // a few items one by one, then a small batch and a large batch.
+    for (Index i(0); i != 10; ++i)
+    {
+        dpq.push(items[i]);
+    }
+    identifier_vector ids;
+    dpq.push(items.begin() + 10, items.begin() + 12, std::back_inserter(ids));
+    BOOST_CHECK(dpq.check());
+    dpq.push(items.begin() + 12, items.end(), std::back_inserter(ids));
+    BOOST_CHECK(dpq.check());
+
+    BOOST_CHECK_EQUAL(Index(100), dpq.size());
+    BOOST_CHECK_EQUAL(Index(90), Index(ids.size()));
+    for (Index i(0); i != ids.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(items[i + 10], dpq.get(ids[i]));
+    }
+
+    int n(0);
+    while (! dpq.empty())
+    {
+        BOOST_CHECK_EQUAL(n, dpq.top().second);
+        dpq.pop();
+        ++n;
+    }
+    BOOST_CHECK_EQUAL(100, n);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(testMemoryUsage, DPQ, both)
+{
+    DPQ dpq;
+    typedef typename DPQ::value_type Value;
+
+    const memory_usage_type empty(dpq.memory_usage());
+    BOOST_CHECK_EQUAL(std::size_t(0), empty.first);
+
+    for (int i(0); i != 100; ++i)
+    {
+        dpq.push(i);
+    }
+    const memory_usage_type full(dpq.memory_usage());
+    BOOST_CHECK(full.first >= 100 * sizeof(Value));
+    BOOST_CHECK(full.second >= full.first);
+
+    dpq.clear();
+    BOOST_CHECK_EQUAL(std::size_t(0), dpq.memory_usage().first);
+}
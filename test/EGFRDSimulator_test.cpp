@@ -55,6 +55,29 @@ void inject_particles(Tworld_& world, Trng_& rng, Tpid_list_& pid_list, typename
     }
 }
 
+// Gives the tests access to the shell matrices, to break a domain on
+// purpose.
+class shell_removing_simulator: public simulator_type
+{
+public:
+    shell_removing_simulator(boost::shared_ptr<world_type> world,
+                             boost::shared_ptr<network_rules_type const> network_rules,
+                             rng_type& rng)
+        : simulator_type(world, network_rules, rng) {}
+
+    // Takes a spherical shell out of its matrix behind the back of its
+    // domain; returns false if there is none.
+    bool remove_spherical_shell()
+    {
+        spherical_shell_matrix_type::iterator const i(ssmat_.begin());
+        if (i == ssmat_.end())
+            return false;
+        touch_domain((*i).second.did());
+        ssmat_.erase(i);
+        return true;
+    }
+};
+
 BOOST_AUTO_TEST_CASE(test)
 {
     typedef world_type::traits_type::particle_id_type particle_id_type;
@@ -116,3 +139,48 @@ BOOST_AUTO_TEST_CASE(test)
     BOOST_TEST_MESSAGE("cylindrical pair: " << s->num_domains_per_type(simulator_type::CYLINDRICAL_PAIR));
     BOOST_TEST_MESSAGE("multi: " << s->num_domains_per_type(simulator_type::MULTI));
 }
+
+BOOST_AUTO_TEST_CASE(incremental_check_finds_missing_shell)
+{
+    typedef world_type::traits_type::particle_id_type particle_id_type;
+
+    LoggerManager::register_logger_manager(
+        "ecell.EGFRDSimulator",
+        boost::shared_ptr<LoggerManager>(
+            new LoggerManager("dummy", Logger::L_WARNING)));
+
+    ParticleModel m;
+
+    m["size"] = "1e-6";
+    m["matrix_size"] = "5";
+
+    boost::shared_ptr<SpeciesType> s1(new SpeciesType());
+    (*s1)["name"] = "S";
+    (*s1)["D"] = "1e-12";
+    (*s1)["radius"] = "5e-9";
+    m.add_species_type(s1);
+
+    world_type::traits_type::rng_type rng;
+
+    std::vector<particle_id_type> S_particles;
+    EGFRDSimulatorFactory<simulator_traits_type> factory(rng);
+    boost::scoped_ptr<simulator_type> prototype(factory(m));
+    inject_particles(*prototype->world(), rng, S_particles, s1->id(), 20);
+
+    shell_removing_simulator s(prototype->world(), prototype->network_rules(), rng);
+    s.paranoiac() = true;
+    s.full_check_interval() = 0;
+
+    // every step checks the domains it touched.
+    for (int i = 100; --i >= 0;)
+        s.step();
+    BOOST_CHECK(s.check_incremental());
+    BOOST_CHECK(s.check_touched());
+
+    BOOST_REQUIRE(s.remove_spherical_shell());
+    BOOST_CHECK(!s.check_touched());
+    BOOST_CHECK(!s.check_incremental());
+
+    // the check forgets the domains it has seen.
+    BOOST_CHECK(s.check_touched());
+}
@@ -133,6 +133,79 @@ class EGFRDSimulatorTestCase(unittest.TestCase):
         for i in range(2):
             self.s.step()
 
+    def test_isolated_immobile_keeps_zero_shell(self):
+        place_particle(self.s.world, self.A, [0.0, 0.0, 0.0])
+        place_particle(self.s.world, self.A, [1e-6, 0.0, 0.0])
+        place_particle(self.s.world, self.S, [5e-6, 5e-6, 5e-6])
+
+        for i in range(10):
+            self.s.step()
+
+        immobile = [domain for domain in self.s.domains.itervalues()
+                    if isinstance(domain, NonInteractionSingle) and
+                       domain.pid_particle_pair[1].sid == self.A.id]
+        self.assertEqual(2, len(immobile))
+        for single in immobile:
+            self.failUnless(single.is_immobile())
+            self.assertEqual(single.pid_particle_pair[1].radius,
+                             single.shell.shape.radius)
+            # without reactions its event is scheduled at t = inf.
+            self.assertEqual(numpy.inf, single.dt)
+            self.assertEqual(numpy.inf,
+                             self.s.scheduler[single.event_id].time)
+
+    def test_observe_bursts_only_observed_domains(self):
+        place_particle(self.s.world, self.S, [0.0, 0.0, 0.0])
+        pid = place_particle(self.s.world, self.B, [5e-6, 5e-6, 5e-6])[0]
+
+        for i in range(10):
+            self.s.step()
+
+        self.assertEqual({self.S.id: 1, self.B.id: 1},
+                         self.s.count_particles([self.S.id, self.B.id]))
+
+        t = self.s.t + self.s.dt / 2
+        observed = self.s.observe(t, species=[self.S.id])
+        self.assertEqual(t, self.s.t)
+        self.assertEqual(1, len(observed))
+        self.assertEqual(self.S.id, observed[0][1].sid)
+
+        # the single of the S particle was bursted, that of B was not.
+        for domain in self.s.domains.itervalues():
+            self.assertEqual(domain.pid_particle_pair[1].sid == self.S.id,
+                             domain.has_zero_shell())
+
+        # B has moved since it was placed; a region covering its shell
+        # still holds it after the burst, and no other particle.
+        domain = [domain for domain in self.s.domains.itervalues()
+                  if domain.pid_particle_pair[0] == pid][0]
+        region = (self.s.world.get_particle(pid)[1].position,
+                  domain.shell.shape.radius)
+        observed = self.s.observe(self.s.t, region=region)
+        self.assertEqual(1, len(observed))
+        self.assertEqual(pid, observed[0][0])
+        self.assertEqual(self.B.id, observed[0][1].sid)
+
+    def test_incremental_check_tracks_touched_domains(self):
+        place_particle(self.s.world, self.S, [0.0, 0.0, 0.0])
+        place_particle(self.s.world, self.S, [5e-6, 5e-6, 5e-6])
+        self.s.initialize()
+
+        # the first check is a full one, and switches the tracking on.
+        self.s.check_incremental(10)
+        self.assertEqual(set(), self.s.touched_domains)
+
+        self.s.step()
+        self.failUnless(self.s.last_event.data in self.s.touched_domains)
+        self.s.check_incremental(10)
+        self.assertEqual(set(), self.s.touched_domains)
+
+        # a domain that lost its shell is found.
+        domain = self.s.domains.values()[0]
+        self.s.touched_domains.add(domain.domain_id)
+        self.s.geometrycontainer.remove_shell(domain.shell_id_shell_pair)
+        self.assertRaises(RuntimeError, self.s.check_touched)
+
 
 class EGFRDSimulatorTestCaseBase(unittest.TestCase):
     """Base class for TestCases below.
@@ -68,6 +68,24 @@ class EventSchedulerTestCase(unittest.TestCase):
         self.assertEqual(1.0, second[1].time)
         self.assertEqual(event1_id, second[0])
 
+    def test_add_events(self):
+
+        scheduler = mod.EventScheduler()
+
+        event1 = mod.PythonEvent(1.0, 1)
+        scheduler.add(event1)
+
+        events = [mod.PythonEvent(t, i) for i, t in enumerate([3.0, 0.5, 2.0])]
+        ids = scheduler.add_events(events)
+
+        self.assertEqual(3, len(ids))
+        self.assertEqual(4, scheduler.size)
+        for id, event in zip(ids, events):
+            self.assertEqual(event, scheduler[id])
+
+        times = [scheduler.pop()[1].time for i in range(4)]
+        self.assertEqual([0.5, 1.0, 2.0, 3.0], times)
+
 
 
 
@@ -0,0 +1,145 @@
+#!/usr/bin/env python
+
+import unittest
+
+import model
+import _gfrd
+import gillespie
+import myrandom
+import utils
+
+
+class GillespieSimulatorTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.m = model.ParticleModel(1e-6)
+        self.A = model.Species('A', 1e-12, 5e-9)
+        self.B = model.Species('B', 1e-12, 5e-9)
+        self.C = model.Species('C', 1e-12, 5e-9)
+        self.m.add_species_type(self.A)
+        self.m.add_species_type(self.B)
+        self.m.add_species_type(self.C)
+        self.volume = 1e-18
+        self.nrw = _gfrd.NetworkRulesWrapper(self.m.network_rules)
+
+    def tearDown(self):
+        pass
+
+    def create_simulator(self, convert_rates=True):
+        return _gfrd._GillespieSimulator(self.m, self.nrw, myrandom.rng,
+                                         self.volume, convert_rates)
+
+    def test_instantiation(self):
+        s = self.create_simulator()
+        self.failIf(s == None)
+        self.assertEqual(0, s.num_reaction_rules)
+        self.assertEqual(3, len(s.get_species_ids()))
+
+    def test_pool(self):
+        s = self.create_simulator()
+        s.throw_in_particles(self.A.id, 10)
+        s.remove_particles(self.A.id, 3)
+        self.assertEqual(7, s.get_pool_size(self.A.id))
+        self.assertRaises(_gfrd.IllegalState,
+                          s.remove_particles, self.A.id, 8)
+
+    def test_decay(self):
+        self.m.add_reaction_rule(
+            model.create_unimolecular_reaction_rule(self.A, self.B, 1e3))
+        s = self.create_simulator()
+        s.throw_in_particles(self.A.id, 100)
+
+        for i in range(100):
+            s.step()
+        self.assertEqual(0, s.get_pool_size(self.A.id))
+        self.assertEqual(100, s.get_pool_size(self.B.id))
+        self.assertEqual(100, s.num_steps)
+        self.assertTrue(s.check())
+
+        # nothing left to fire.
+        s.step()
+        self.assertEqual(float('inf'), s.t)
+
+    def test_step_upto(self):
+        self.m.add_reaction_rule(
+            model.create_unimolecular_reaction_rule(self.A, self.B, 1.0))
+        s = self.create_simulator()
+        s.throw_in_particles(self.A.id, 100)
+
+        while s.step(1e-3):
+            pass
+        self.assertEqual(1e-3, s.t)
+        self.assertTrue(s.next_time > 1e-3)
+
+    def test_rate_conversion(self):
+        ka = 1e-19
+        kd = 1e3
+        self.m.add_reaction_rule(
+            model.create_binding_reaction_rule(self.A, self.B, self.C, ka))
+        self.m.add_reaction_rule(
+            model.create_unbinding_reaction_rule(self.C, self.A, self.B, kd))
+
+        s = self.create_simulator()
+        self.assertEqual(2, s.num_reaction_rules)
+        rates = sorted(s.get_rate(rr.id) for rr in self.nrw.query_reaction_rule(self.A.id, self.B.id))
+        kD = 4 * 3.141592653589793 * 2e-12 * 1e-8
+        self.assertAlmostEqual(1. / (1. / kD + 1. / ka), rates[0],
+                               delta=1e-6 * rates[0])
+
+        # A + B <-> C: gillespie.py caches the reverse rule with its overall
+        # rate kon and converts the unbinding rate with utils.k_off.
+        kon = utils.k_on(ka, kD)
+        koff = utils.k_off(kd, kon, kD)
+        rates = [s.get_rate(rr.id) for rr in self.nrw.query_reaction_rule(self.C.id)]
+        self.assertEqual(1, len(rates))
+        self.assertAlmostEqual(koff, rates[0], delta=1e-6 * koff)
+        self.assertAlmostEqual(1. / (ka / (kd * kD) + 1. / kd), rates[0],
+                               delta=1e-6 * koff)
+
+        s = self.create_simulator(False)
+        rates = sorted(s.get_rate(rr.id) for rr in self.nrw.query_reaction_rule(self.A.id, self.B.id))
+        self.assertEqual(ka, rates[0])
+        rates = [s.get_rate(rr.id) for rr in self.nrw.query_reaction_rule(self.C.id)]
+        self.assertEqual(kd, rates[0])
+
+    def test_binding_equilibrium(self):
+        self.m.add_reaction_rule(
+            model.create_binding_reaction_rule(self.A, self.B, self.C, 1e-19))
+        self.m.add_reaction_rule(
+            model.create_unbinding_reaction_rule(self.C, self.A, self.B, 1e2))
+        s = self.create_simulator()
+        s.throw_in_particles(self.A.id, 500)
+        s.throw_in_particles(self.B.id, 500)
+
+        for i in range(10000):
+            s.step()
+
+        # mass conservation
+        self.assertEqual(500, s.get_pool_size(self.A.id) +
+                              s.get_pool_size(self.C.id))
+        self.assertEqual(500, s.get_pool_size(self.B.id) +
+                              s.get_pool_size(self.C.id))
+        self.assertTrue(s.get_pool_size(self.C.id) > 0)
+        self.assertTrue(s.check())
+
+    def test_python_wrapper(self):
+        self.m.add_reaction_rule(
+            model.create_unimolecular_reaction_rule(self.A, self.B, 1e3))
+        s = gillespie.GillespieSimulator(self.m)
+        self.assertAlmostEqual(1e-6, s.get_world_size(), delta=1e-15)
+        s.throw_in_particles(self.A, 10)
+        self.assertEqual(None, s.last_reaction)
+
+        s.stop(s.get_next_time() * 0.5)
+        self.assertEqual(10, s.get_pool_size(self.A.id))
+
+        for i in range(10):
+            s.step()
+        self.assertEqual(0, s.get_pool_size(self.A.id))
+        self.assertEqual(10, s.get_pool_size(self.B.id))
+        self.assertEqual(self.A.id, s.last_reaction.reactants[0])
+        s.check()
+
+
+if __name__ == "__main__":
+    unittest.main()
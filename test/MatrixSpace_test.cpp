@@ -67,6 +67,106 @@ BOOST_AUTO_TEST_CASE(update)
     }
 }
 
+BOOST_AUTO_TEST_CASE(generation)
+{
+    typedef MatrixSpace<Sphere<double>, int> oc_type;
+    typedef oc_type::position_type pos;
+    oc_type oc(1.0, 10);
+    unsigned long g(oc.generation());
+
+    oc.update(std::make_pair(0, oc_type::mapped_type(pos(0.2, 0.6, 0.4), 0.05)));
+    BOOST_CHECK(oc.generation() != g);
+    g = oc.generation();
+
+    // moving a value around does not touch the storage layout.
+    oc.update(std::make_pair(0, oc_type::mapped_type(pos(0.2, 0.65, 0.4), 0.05)));
+    oc.update(std::make_pair(0, oc_type::mapped_type(pos(0.8, 0.1, 0.4), 0.05)));
+    BOOST_CHECK_EQUAL(g, oc.generation());
+
+    oc.update(std::make_pair(1, oc_type::mapped_type(pos(0.2, 0.6, 0.4), 0.05)));
+    BOOST_CHECK(oc.generation() != g);
+    g = oc.generation();
+
+    BOOST_CHECK(!oc.erase(2));
+    BOOST_CHECK_EQUAL(g, oc.generation());
+    BOOST_CHECK(oc.erase(0));
+    BOOST_CHECK(oc.generation() != g);
+}
+
+BOOST_AUTO_TEST_CASE(insert)
+{
+    typedef MatrixSpace<Sphere<double>, int> oc_type;
+    typedef oc_type::position_type pos;
+    typedef std::pair<int, oc_type::mapped_type> value;
+
+    std::vector<value> values;
+    for (int i = 0; i < 1000; ++i)
+    {
+        values.push_back(value(i, oc_type::mapped_type(
+            pos((i % 10) * .1 + .05, ((i / 10) % 10) * .1 + .05,
+                (i * 7 % 97) * .01), 0.01)));
+    }
+
+    oc_type updated(1.0, 10);
+    for (std::vector<value>::const_iterator i(values.begin());
+         i != values.end(); ++i)
+    {
+        updated.update(*i);
+    }
+
+    // bulk-load half of the values and insert the rest into the result.
+    oc_type loaded(1.0, 10, std::vector<value>(values.begin(), values.begin() + 500));
+    BOOST_CHECK_EQUAL(500, loaded.size());
+    unsigned long const g(loaded.generation());
+    loaded.insert(values.begin() + 500, values.end());
+    BOOST_CHECK(loaded.generation() != g);
+    BOOST_CHECK_EQUAL(updated.size(), loaded.size());
+
+    for (std::vector<value>::const_iterator i(values.begin());
+         i != values.end(); ++i)
+    {
+        oc_type::iterator j(loaded.find((*i).first));
+        BOOST_CHECK(loaded.end() != j);
+        BOOST_CHECK_EQUAL((*i).second, (*j).second);
+
+        oc_type::cell_type const& c(loaded.cell(loaded.index((*i).second.position())));
+        oc_type::cell_type const& d(updated.cell(updated.index((*i).second.position())));
+        BOOST_CHECK_EQUAL(c.size(), d.size());
+        BOOST_CHECK(std::equal(c.begin(), c.end(), d.begin()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(last_modified_around)
+{
+    typedef MatrixSpace<Sphere<double>, int> oc_type;
+    typedef oc_type::position_type pos;
+    oc_type oc(1.0, 10);
+    oc_type::cell_index_type const here(oc.index(pos(0.55, 0.55, 0.55)));
+    oc_type::cell_index_type const corner(oc.index(pos(0.05, 0.05, 0.05)));
+
+    oc.update(std::make_pair(0, oc_type::mapped_type(pos(0.55, 0.55, 0.55), 0.01)));
+    unsigned long const t0(oc.last_modified_around(here));
+    BOOST_CHECK_EQUAL(oc.last_modified(), t0);
+
+    // far away; the neighborhood of 'here' is not affected.
+    oc.update(std::make_pair(1, oc_type::mapped_type(pos(0.15, 0.15, 0.15), 0.01)));
+    BOOST_CHECK_EQUAL(t0, oc.last_modified_around(here));
+
+    // resizing in place is a modification.
+    oc.update(std::make_pair(0, oc_type::mapped_type(pos(0.55, 0.55, 0.55), 0.02)));
+    unsigned long const t1(oc.last_modified_around(here));
+    BOOST_CHECK(t1 > t0);
+
+    // an adjacent cell, across the periodic boundary.
+    unsigned long const c0(oc.last_modified_around(corner));
+    oc.update(std::make_pair(2, oc_type::mapped_type(pos(0.95, 0.95, 0.95), 0.01)));
+    BOOST_CHECK(oc.last_modified_around(corner) > c0);
+    BOOST_CHECK_EQUAL(t1, oc.last_modified_around(here));
+
+    BOOST_CHECK(oc.erase(0));
+    BOOST_CHECK(oc.last_modified_around(here) > t1);
+}
+
 BOOST_AUTO_TEST_CASE(erase)
 {
     typedef MatrixSpace<Sphere<double>, int> oc_type;
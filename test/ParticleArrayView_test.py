@@ -0,0 +1,113 @@
+#!/usr/bin/env python
+
+import unittest
+
+import numpy
+
+import _gfrd
+from _gfrd import Particle, ParticleArrayView
+import model
+import gfrdbase
+
+
+class ParticleArrayViewTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.m = model.ParticleModel(1e-5)
+        self.A = model.Species('A', 1e-12, 5e-9)
+        self.B = model.Species('B', 2e-12, 1e-8)
+        self.m.add_species_type(self.A)
+        self.m.add_species_type(self.B)
+        self.w = gfrdbase.create_world(self.m, 10)
+        self.pids = []
+        for sid, position in ((self.A.id, [1e-6, 2e-6, 3e-6]),
+                              (self.B.id, [4e-6, 5e-6, 6e-6]),
+                              (self.A.id, [7e-6, 8e-6, 9e-6])):
+            gfrdbase.place_particle(self.w, sid, position)
+
+    def tearDown(self):
+        pass
+
+    def test_matches_world(self):
+        view = ParticleArrayView(self.w)
+        self.assertTrue(view.valid)
+        self.assertEqual(3, len(view))
+
+        positions = view.positions
+        self.assertEqual((3, 3), positions.shape)
+        radii, D, serials, lots, species = \
+            view.radii, view.D, view.serials, view.lots, view.species_serials
+
+        for i, (pid, particle) in enumerate(self.w):
+            self.assertEqual(pid.serial, serials[i])
+            self.assertEqual(pid.lot, lots[i])
+            self.assertEqual(particle.sid.serial, species[i])
+            self.assertTrue(numpy.all(particle.position == positions[i]))
+            self.assertEqual(particle.radius, radii[i])
+            self.assertEqual(particle.D, D[i])
+
+    def test_read_only(self):
+        positions = ParticleArrayView(self.w).positions
+        def assign():
+            positions[0, 0] = 0.
+        self.assertRaises(Exception, assign)
+
+    def test_moves_are_visible_in_new_arrays(self):
+        view = ParticleArrayView(self.w)
+        positions = view.positions
+        pid, particle = iter(self.w).next()
+        index = list(view.serials).index(pid.serial)
+
+        new_position = numpy.array([2e-6, 2e-6, 2e-6])
+        self.w.update_particle((pid, Particle(new_position, particle.radius,
+                                              particle.D, particle.v,
+                                              particle.sid,
+                                              particle.structure_id)))
+        self.assertTrue(view.valid)
+        # earlier arrays are snapshots, new ones show the move.
+        self.assertTrue(numpy.all(particle.position == positions[index]))
+        self.assertTrue(numpy.all(new_position == view.positions[index]))
+
+    def test_stale_after_removal(self):
+        view = ParticleArrayView(self.w)
+        generation = self.w.generation
+        self.assertEqual(generation, view.generation)
+
+        pid, _ = iter(self.w).next()
+        self.w.remove_particle(pid)
+        self.assertNotEqual(generation, self.w.generation)
+        self.assertFalse(view.valid)
+        self.assertRaises(Exception, lambda: view.positions)
+
+        view = ParticleArrayView(self.w)
+        self.assertEqual(2, view.positions.shape[0])
+
+    def test_arrays_outlive_structural_changes(self):
+        view = ParticleArrayView(self.w)
+        positions, serials = view.positions, view.serials
+        expected = [(pid.serial, particle.position.copy())
+                    for pid, particle in self.w]
+
+        # removing a particle moves the last one into its slot and adding
+        # more may reallocate the storage; the arrays are not affected.
+        pid, _ = iter(self.w).next()
+        self.w.remove_particle(pid)
+        for i in range(100):
+            gfrdbase.place_particle(self.w, self.A.id,
+                                    [1e-6, 1e-6 + i * 5e-8, 5e-6])
+        del view
+
+        self.assertEqual(3, len(serials))
+        for i, (serial, position) in enumerate(expected):
+            self.assertEqual(serial, serials[i])
+            self.assertTrue(numpy.all(position == positions[i]))
+
+    def test_empty(self):
+        w = gfrdbase.create_world(self.m, 10)
+        view = ParticleArrayView(w)
+        self.assertEqual((0, 3), view.positions.shape)
+        self.assertEqual(0, len(view.radii))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,56 @@
+#!/usr/bin/env python
+
+import unittest
+
+import json
+
+import _greens_functions as mod
+import _gfrd
+
+
+class ProfilerTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.profiler = _gfrd.Profiler.instance()
+        self.profiler.reset()
+        mod.reset_profiler()
+
+    def tearDown(self):
+        pass
+
+    def test_instance(self):
+        self.assertTrue(_gfrd.Profiler.instance() is not None)
+        # only _gfrd registers the class.
+        self.assertFalse(hasattr(mod, 'Profiler'))
+
+    def test_to_json(self):
+        data = json.loads(self.profiler.to_json())
+        self.assertEqual(_gfrd.Profiler.enabled(), data['enabled'])
+        self.assertEqual(len(self.profiler.stats()), len(data['entries']))
+
+        data = json.loads(mod.profiler_to_json())
+        self.assertEqual(mod.profiler_enabled(), data['enabled'])
+        self.assertEqual(len(mod.profiler_stats()), len(data['entries']))
+
+    def test_draw_is_counted(self):
+        gf = mod.GreensFunction3DSym(1e-12)
+        for i in range(10):
+            gf.drawR(0.5, 1e-3)
+
+        # the draws are counted by the profiler of _greens_functions.
+        stats = mod.profiler_stats()
+        if not mod.profiler_enabled():
+            self.assertEqual({}, stats)
+            return
+
+        count, total_time, max_time = stats['GreensFunction3DSym::drawR']
+        self.assertEqual(10, count)
+        self.assertTrue(total_time >= max_time >= 0.0)
+        self.assertFalse('GreensFunction3DSym::drawR' in self.profiler.stats())
+
+        mod.reset_profiler()
+        self.assertEqual(0, mod.profiler_stats()['GreensFunction3DSym::drawR'][0])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,93 @@
+#!/usr/bin/env python
+
+import unittest
+
+import math
+import numpy
+
+import _gfrd
+
+from egfrd import *
+from reservoir import *
+
+import model
+import gfrdbase
+import myrandom
+
+
+class ReservoirTestCase(unittest.TestCase):
+
+    def setUp(self):
+        myrandom.seed(0)
+        self.L = 1e-6
+        self.m = model.ParticleModel(self.L)
+        self.membrane_type = _gfrd.StructureType()
+        self.membrane_type['name'] = 'membrane'
+        self.m.add_structure_type(self.membrane_type)
+        self.A = model.Species('A', 1e-12, 5e-9)
+        self.m.add_species_type(self.A)
+        self.w = gfrdbase.create_world(self.m, 3)
+        self.membrane = model.create_double_sided_planar_surface(self.membrane_type.id, 'membrane',
+                                                                [0, 0, self.L / 2],
+                                                                [1, 0, 0], [0, 1, 0],
+                                                                self.L, self.L,
+                                                                self.w.get_def_structure_id())
+        self.w.add_structure(self.membrane)
+        self.s = EGFRDSimulator(self.w, myrandom.rng)
+
+    def test_poisson(self):
+        for mean in [0.5, 5.0, 50.0]:
+            n = 2000
+            samples = [poisson(mean) for i in range(n)]
+            average = sum(samples) / float(n)
+            self.failUnless(abs(average - mean) < 4 * math.sqrt(mean / n))
+
+    def test_inflow_depth(self):
+        # E[depth] = E[U] E[S] = sqrt(2 D dt) sqrt(pi / 2) / 2
+        D, dt = 1e-12, 1e-6
+        n = 4000
+        depths = [draw_inflow_depth(D, dt) for i in range(n)]
+        self.failIf(min(depths) < 0.0)
+        expected = 0.5 * math.sqrt(2 * D * dt) * math.sqrt(math.pi / 2)
+        self.failUnless(abs(numpy.mean(depths) - expected) < 0.05 * expected)
+
+    def test_species_must_live_in_bulk(self):
+        Am = model.Species('Am', 1e-12, 5e-9, self.membrane_type)
+        self.m.add_species_type(Am)
+        self.assertRaises(RuntimeError, Reservoir, self.w, Am, [self.membrane], 5e-8)
+
+    def test_bulk_particles_are_absorbed(self):
+        buffer = 1e-7
+        N = 100
+        throw_in_particles(self.w, self.A, N)
+        reservoir = self.s.add_reservoir(self.A, [self.membrane], buffer)
+
+        for i in range(N):
+            self.s.step()
+
+        # almost all particles start beyond the layer.
+        self.failUnless(reservoir.absorbed > 0)
+        self.assertEqual(reservoir.count + len(self.w.get_particle_ids(self.A.id)), N)
+        self.assertEqual(self.s.count_particles([self.A.id])[self.A.id], N)
+
+    def test_particles_flow_in(self):
+        buffer = 1e-7
+        N = 1000
+        reservoir = self.s.add_reservoir(self.A, [self.membrane], buffer, N)
+        place_particle(self.w, self.A, [self.L / 2, self.L / 2, self.L / 4])
+
+        while reservoir.inserted == 0:
+            self.s.step()
+
+        for pid in self.w.get_particle_ids(self.A.id):
+            pos = self.w.get_particle(pid)[1].position
+            if abs(pos[2] - self.L / 2) < buffer:
+                break
+        else:
+            self.fail('no particle in the buffer layer')
+
+        self.assertEqual(reservoir.count + len(self.w.get_particle_ids(self.A.id)), N + 1)
+
+
+if __name__ == "__main__":
+    unittest.main()
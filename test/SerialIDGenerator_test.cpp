@@ -0,0 +1,61 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+// the wrap-around of the serials is only reachable with the 32-bit serials
+// of the compact identifiers.
+#ifndef ENABLE_COMPACT_IDS
+#define ENABLE_COMPACT_IDS 1
+#endif
+
+#define BOOST_TEST_MODULE "SerialIDGenerator_test"
+
+#include <climits>
+#include <boost/test/included/unit_test.hpp>
+#include "ParticleID.hpp"
+#include "SerialIDGenerator.hpp"
+
+typedef SerialIDGenerator<ParticleID> generator_type;
+
+BOOST_AUTO_TEST_CASE(compact_size)
+{
+    BOOST_CHECK_EQUAL(sizeof(ParticleID), 8);
+    BOOST_CHECK_EQUAL(sizeof(ParticleID::lot_type), 2);
+}
+
+BOOST_AUTO_TEST_CASE(sequence)
+{
+    generator_type gen;
+    BOOST_CHECK(gen() == ParticleID(ParticleID::value_type(0, 1)));
+    BOOST_CHECK(gen() == ParticleID(ParticleID::value_type(0, 2)));
+
+    generator_type gen5(5, 10);
+    BOOST_CHECK(gen5() == ParticleID(ParticleID::value_type(5, 11)));
+}
+
+BOOST_AUTO_TEST_CASE(serial_wrap_advances_lot)
+{
+    generator_type gen(3, UINT_MAX - 2);
+    BOOST_CHECK(gen() == ParticleID(ParticleID::value_type(3, UINT_MAX - 1)));
+    BOOST_CHECK(gen() == ParticleID(ParticleID::value_type(3, UINT_MAX)));
+
+    // zero is the null serial and is skipped.
+    ParticleID const wrapped(gen());
+    BOOST_CHECK(wrapped);
+    BOOST_CHECK_EQUAL(wrapped().first, 4);
+    BOOST_CHECK_EQUAL(wrapped().second, 1u);
+    BOOST_CHECK(gen() == ParticleID(ParticleID::value_type(4, 2)));
+}
+
+BOOST_AUTO_TEST_CASE(lot_wrap_stays_unsigned)
+{
+    generator_type gen(USHRT_MAX, UINT_MAX);
+    ParticleID const wrapped(gen());
+    BOOST_CHECK_EQUAL(wrapped().first, 0);
+    BOOST_CHECK_EQUAL(wrapped().second, 1u);
+
+    generator_type gen_signed(SHRT_MAX, UINT_MAX);
+    ParticleID const past_signed(gen_signed());
+    BOOST_CHECK_EQUAL(past_signed().first, SHRT_MAX + 1);
+    BOOST_CHECK(past_signed.lot() > 0);
+}
@@ -0,0 +1,212 @@
+#!/usr/bin/env python
+
+import unittest
+
+import numpy
+import math
+import random
+
+import _gfrd
+from _gfrd import *
+import shells
+from shells import CylindricaltestShell
+
+
+class GeometryContainerStub(object):
+    def __init__(self, world):
+        self.world = world
+
+
+class LinearCylindricaltestShell(CylindricaltestShell):
+    # A cylindrical testShell with given linear scaling parameters, for comparing the
+    # python scaling functions with the C++ ones.
+
+    def __init__(self, world, reference_point, orientation_vector, drdz_right, r0_right, z0_right,
+                 drdz_left, r0_left, z0_left):
+        CylindricaltestShell.__init__(self, GeometryContainerStub(world), None)
+
+        self.reference_point = numpy.array(reference_point)
+        self.orientation_vector = numpy.array(orientation_vector)
+
+        self.drdz_right = drdz_right
+        self.dzdr_right = 1.0 / drdz_right if drdz_right != 0.0 else numpy.inf
+        self.r0_right = r0_right
+        self.z0_right = z0_right
+        self.drdz_left = drdz_left
+        self.dzdr_left = 1.0 / drdz_left if drdz_left != 0.0 else numpy.inf
+        self.r0_left = r0_left
+        self.z0_left = z0_left
+
+        self.right_scalingangle = self.get_right_scalingangle()
+        self.left_scalingangle  = self.get_left_scalingangle()
+        self.tan_right_scalingangle = math.tan(self.right_scalingangle)
+        self.tan_left_scalingangle  = math.tan(self.left_scalingangle)
+
+    def get_referencepoint(self):
+        return self.reference_point
+
+    def get_orientation_vector(self):
+        return self.orientation_vector
+
+
+class ShellScalingTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.world_size = 1.0
+        self.world = World(self.world_size, 5)
+        random.seed(0)
+
+    def tearDown(self):
+        pass
+
+    def assert_dims_equal(self, expected, actual):
+        for e, a in zip(expected, actual):
+            if numpy.isinf(e):
+                self.assertTrue(numpy.isinf(a))
+            else:
+                self.assertTrue(abs(e - a) <= 1e-6 * max(abs(e), 1e-9), '%s != %s' % (expected, actual))
+
+    def compare(self, shape, python_function, testShell, dims):
+        scaling = testShell.get_shell_scaling()
+        try:
+            expected = python_function(shape, testShell, *dims)
+        except shells.testShellError:
+            # a failed scaling has to come out of C++ as NoSpace
+            self.assertRaises(NoSpace, scaling.scale_to, shape, *dims)
+            return False
+        except ValueError:
+            # the python version hits a math domain error for a few perpendicular
+            # cylinders on the z-scaling testShell; there is nothing to compare with.
+            return False
+        self.assert_dims_equal(expected, scaling.scale_to(shape, *dims))
+        return True
+
+    def make_testShells(self):
+        center = [0.5, 0.5, 0.5]
+        unit_z = [0, 0, 1]
+        return [
+            # r scales only (PlanarSurfaceSingle like)
+            LinearCylindricaltestShell(self.world, center, unit_z, numpy.inf, 0.0, 0.01, numpy.inf, 0.0, 0.01),
+            # z scales only (CylindricalSurfaceSingle like)
+            LinearCylindricaltestShell(self.world, center, unit_z, 0.0, 0.01, 0.0, 0.0, 0.01, 0.0),
+            # cones with different opening angles on both sides
+            LinearCylindricaltestShell(self.world, center, unit_z, 0.5, 0.0, 0.0, 2.0, 0.0, 0.0),
+            LinearCylindricaltestShell(self.world, center, unit_z, 1.0, 0.0, 0.0, 1.0, 0.0, 0.0),
+            ]
+
+    def random_position(self, testShell, distance):
+        offset = numpy.array([random.uniform(-1, 1) for _ in range(3)])
+        offset *= distance / numpy.linalg.norm(offset)
+        return testShell.get_referencepoint() + offset
+
+    def test_scale_to_sphere(self):
+        dims = (0.3, 0.3, 0.3)
+        for testShell in self.make_testShells():
+            for _ in range(200):
+                position = self.random_position(testShell, random.uniform(0.1, 0.4))
+                sphere = Sphere(position, random.uniform(0.01, 0.09))
+                self.compare(sphere, shells.get_dr_dzright_dzleft_to_SphericalShape, testShell, dims)
+
+    def test_scale_to_parallel_cylinder(self):
+        dims = (0.3, 0.3, 0.3)
+        for testShell in self.make_testShells():
+            for _ in range(200):
+                position = self.random_position(testShell, random.uniform(0.2, 0.4))
+                cylinder = Cylinder(position, random.uniform(0.01, 0.09), [0, 0, 1], random.uniform(0.01, 0.09))
+                self.compare(cylinder, shells.get_dr_dzright_dzleft_to_CylindricalShape, testShell, dims)
+
+    def test_scale_to_perpendicular_cylinder(self):
+        dims = (0.3, 0.3, 0.3)
+        total = 0
+        compared = 0
+        for testShell in self.make_testShells():
+            for _ in range(200):
+                position = self.random_position(testShell, random.uniform(0.2, 0.4))
+                cylinder = Cylinder(position, random.uniform(0.01, 0.09), [1, 0, 0], random.uniform(0.01, 0.09))
+                total += 1
+                if self.compare(cylinder, shells.get_dr_dzright_dzleft_to_CylindricalShape, testShell, dims):
+                    compared += 1
+        # only a handful of these cylinders overlap the reference point or
+        # fail in the python version.
+        self.assertTrue(compared >= 0.9 * total, '%d of %d compared' % (compared, total))
+
+    def test_scale_to_perpendicular_cylinder_edge_hits_edge(self):
+        # The edge of the cone hits the edge of the cylinder, which needs the root finder.
+        testShell = self.make_testShells()[3]
+        cylinder = Cylinder([0.7, 0.53, 0.7], 0.05, [1, 0, 0], 0.05)
+        dims = (0.3, 0.3, 0.3)
+        self.assertTrue(self.compare(cylinder, shells.get_dr_dzright_dzleft_to_CylindricalShape, testShell, dims))
+        self.assert_dims_equal((0.151208, 0.151208, 0.151208),
+                               testShell.get_shell_scaling().scale_to(cylinder, *dims))
+
+    def test_scale_to_disk(self):
+        dims = (0.3, 0.3, 0.3)
+        for testShell in self.make_testShells():
+            for _ in range(100):
+                position = self.random_position(testShell, random.uniform(0.2, 0.4))
+                disk = Disk(position, random.uniform(0.01, 0.09), [0, 1, 0])
+                self.compare(disk, shells.get_dr_dzright_dzleft_to_DiskShape, testShell, dims)
+
+    def test_scale_to_plane(self):
+        dims = (0.3, 0.3, 0.3)
+        for testShell in self.make_testShells():
+            for unit_x, unit_y in (([1, 0, 0], [0, 1, 0]), ([1, 0, 0], [0, 0, 1])):
+                position = self.random_position(testShell, 0.2)
+                plane = Plane(position, unit_x, unit_y, 0.5, 0.5, False)
+                self.compare(plane, shells.get_dr_dzright_dzleft_to_PlanarShape, testShell, dims)
+
+    def test_overlapping_cylinder(self):
+        # A neighbor overlapping the reference point scales the shell to a negative radius. This
+        # has to raise NoSpace, so that the testShell turns it into a ShellmakingError and egfrd.py
+        # can fall back on another domain type instead of aborting.
+        testShell = self.make_testShells()[0]
+        cylinder = Cylinder([0.52, 0.5, 0.5], 0.05, [0, 0, 1], 0.05)
+        dims = (0.3, 0.3, 0.3)
+
+        self.assertRaises(shells.testShellError, shells.get_dr_dzright_dzleft_to_CylindricalShape,
+                          cylinder, testShell, *dims)
+        self.assertRaises(NoSpace, testShell.get_shell_scaling().scale_to, cylinder, *dims)
+
+        class SurfaceStub(object):
+            shape = cylinder
+
+        testShell.get_neighbors = lambda base_structure_id, ignore, ignores: ([], [(SurfaceStub(), 0.0)])
+        testShell.get_min_dr_dzright_dzleft = lambda: (0.0, 0.0, 0.0)
+        testShell.get_max_dr_dzright_dzleft = lambda: dims
+        testShell.apply_safety = lambda r, z_right, z_left: (r, z_right, z_left)
+        self.assertRaises(shells.ShellmakingError, testShell.determine_possible_shell, None, [], [])
+
+    def test_spherical_scale_to(self):
+        center = numpy.array([0.5, 0.5, 0.5])
+        scaling = SphericalShellScaling(center, self.world_size)
+        for _ in range(100):
+            position = center + numpy.array([random.uniform(-0.45, 0.45) for _ in range(3)])
+            sphere = Sphere(position, 0.01)
+            cylinder = Cylinder(position, 0.01, [0, 0, 1], 0.02)
+            self.assertAlmostEqual(min(0.3, self.world.distance(sphere, center)),
+                                   scaling.scale_to(sphere, 0.3))
+            self.assertAlmostEqual(min(0.3, self.world.distance(cylinder, center)),
+                                   scaling.scale_to(cylinder, 0.3))
+
+    def test_determine_possible_shell(self):
+        center = numpy.array([0.5, 0.5, 0.5])
+        scaling = SphericalShellScaling(center, self.world_size)
+        shapes = [Sphere([0.5, 0.5, 0.8], 0.1), Cylinder([0.5, 0.75, 0.5], 0.05, [0, 0, 1], 0.1)]
+
+        self.assertAlmostEqual(0.2, scaling.determine_possible_shell([0.25], shapes, 0.1, 0.3))
+        self.assertAlmostEqual(0.12, scaling.determine_possible_shell([0.12], shapes, 0.1, 0.3))
+        self.assertRaises(NoSpace, scaling.determine_possible_shell, [0.05], shapes, 0.1, 0.3)
+        self.assertRaises(NoSpace, scaling.determine_possible_shell, [], shapes, 0.25, 0.3)
+
+        testShell = self.make_testShells()[0]
+        expected = (0.3, 0.01, 0.01)
+        for shape in shapes:
+            expected = shells.get_dr_dzright_dzleft_to_SphericalShape(shape, testShell, *expected) \
+                       if isinstance(shape, Sphere) else \
+                       shells.get_dr_dzright_dzleft_to_CylindricalShape(shape, testShell, *expected)
+        self.assert_dims_equal(expected, testShell.get_shell_scaling().
+                               determine_possible_shell(shapes, (0.0, 0.0, 0.0), (0.3, 0.01, 0.01)))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,189 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#define BOOST_TEST_MODULE "StreamingReactionRecorder_test"
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/test/included/unit_test.hpp>
+#include "Vector3.hpp"
+#include "ParticleID.hpp"
+#include "ReactionRecord.hpp"
+#include "StreamingReactionRecorderImpl.hpp"
+
+typedef ReactionRecord<ParticleID, int> reaction_record_type;
+
+struct particle_stub
+{
+    Vector3<double> position_;
+
+    Vector3<double> const& position() const
+    {
+        return position_;
+    }
+};
+
+struct container_stub
+{
+    typedef Vector3<double> position_type;
+    typedef std::pair<ParticleID, particle_stub> particle_id_pair;
+
+    bool has_particle(ParticleID const& pid) const
+    {
+        return particles.find(pid) != particles.end();
+    }
+
+    particle_id_pair get_particle(ParticleID const& pid) const
+    {
+        return *particles.find(pid);
+    }
+
+    std::map<ParticleID, particle_stub> particles;
+};
+
+typedef StreamingReactionRecorderImpl<reaction_record_type, container_stub> recorder_type;
+
+static std::size_t const RECORD_HEADER_SIZE(16);
+static std::size_t const ID_SIZE(12);
+
+static ParticleID pid(unsigned long long serial)
+{
+    return ParticleID(ParticleID::value_type(0, serial));
+}
+
+static void react(recorder_type& rrec, int rid, unsigned long long reactant, unsigned long long product)
+{
+    std::vector<ParticleID> products(1, pid(product));
+    rrec(reaction_record_type(rid, products, pid(reactant)));
+}
+
+BOOST_AUTO_TEST_CASE(counters)
+{
+    recorder_type rrec;
+    react(rrec, 1, 1, 2);
+    react(rrec, 1, 2, 3);
+    react(rrec, 2, 3, 4);
+
+    BOOST_CHECK_EQUAL(rrec.total(), 3);
+    BOOST_CHECK_EQUAL(rrec.count(1), 2);
+    BOOST_CHECK_EQUAL(rrec.count(2), 1);
+    BOOST_CHECK_EQUAL(rrec.count(3), 0);
+    BOOST_CHECK_EQUAL(rrec.counts().size(), 2);
+
+    reaction_record_type const last(rrec.last_record());
+    BOOST_CHECK_EQUAL(last.reaction_rule_id(), 2);
+    BOOST_CHECK(last.reactants()[0] == pid(3));
+    BOOST_CHECK(last.products()[0] == pid(4));
+}
+
+BOOST_AUTO_TEST_CASE(filter)
+{
+    recorder_type rrec;
+    rrec.keep_last(10);
+    rrec.select(2);
+    react(rrec, 1, 1, 2);
+    react(rrec, 2, 2, 3);
+    react(rrec, 1, 3, 4);
+
+    BOOST_CHECK_EQUAL(rrec.total(), 3);
+    BOOST_CHECK_EQUAL(rrec.streamed(), 1);
+    BOOST_CHECK_EQUAL(rrec.buffer().size(), RECORD_HEADER_SIZE + 2 * ID_SIZE);
+
+    rrec.select_all();
+    react(rrec, 1, 4, 5);
+    BOOST_CHECK_EQUAL(rrec.streamed(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer)
+{
+    recorder_type rrec;
+    rrec.keep_last(2);
+    for (int i(0); i < 5; ++i)
+    {
+        rrec.set_time(i);
+        react(rrec, i, i + 1, i + 2);
+    }
+
+    std::string const buffer(rrec.buffer());
+    std::size_t const record_size(RECORD_HEADER_SIZE + 2 * ID_SIZE);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 2 * record_size);
+
+    double t;
+    int rid;
+    std::memcpy(&t, buffer.data(), sizeof(t));
+    std::memcpy(&rid, buffer.data() + sizeof(t), sizeof(rid));
+    BOOST_CHECK_EQUAL(t, 3.);
+    BOOST_CHECK_EQUAL(rid, 3);
+    std::memcpy(&t, buffer.data() + record_size, sizeof(t));
+    BOOST_CHECK_EQUAL(t, 4.);
+}
+
+BOOST_AUTO_TEST_CASE(positions)
+{
+    container_stub container;
+    particle_stub p = { Vector3<double>(1., 2., 3.) };
+    container.particles[pid(2)] = p;
+
+    recorder_type rrec(&container);
+    rrec.keep_last(2);
+    react(rrec, 1, 1, 2);
+    react(rrec, 1, 2, 3);
+
+    std::string const buffer(rrec.buffer());
+    std::size_t const record_size(RECORD_HEADER_SIZE + 2 * ID_SIZE);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 2 * record_size + 3 * sizeof(double));
+    BOOST_CHECK_EQUAL(buffer[14], recorder_type::HAS_POSITIONS);
+    BOOST_CHECK_EQUAL(buffer[record_size + 3 * sizeof(double) + 14], 0);
+
+    double pos[3];
+    std::memcpy(pos, buffer.data() + RECORD_HEADER_SIZE + 2 * ID_SIZE, sizeof(pos));
+    BOOST_CHECK_EQUAL(pos[0], 1.);
+    BOOST_CHECK_EQUAL(pos[2], 3.);
+}
+
+BOOST_AUTO_TEST_CASE(chunked_file)
+{
+    char const* filename("StreamingReactionRecorder_test.log");
+    std::size_t const record_size(RECORD_HEADER_SIZE + 2 * ID_SIZE);
+    {
+        recorder_type rrec;
+        rrec.stream_to(filename, 2 * record_size);
+        for (int i(0); i < 5; ++i)
+        {
+            react(rrec, 1, i + 1, i + 2);
+        }
+        rrec.close();
+    }
+
+    std::FILE* file(std::fopen(filename, "rb"));
+    BOOST_REQUIRE(file);
+    char magic[8];
+    BOOST_REQUIRE_EQUAL(std::fread(magic, 1, 8, file), 8);
+    BOOST_CHECK(std::memcmp(magic, "EGFRDRR1", 8) == 0);
+
+    std::vector<unsigned int> counts;
+    unsigned int header[2];
+    while (std::fread(header, sizeof(header), 1, file) == 1)
+    {
+        BOOST_CHECK_EQUAL(header[0], header[1] * record_size);
+        counts.push_back(header[1]);
+        std::fseek(file, header[0], SEEK_CUR);
+    }
+    std::fclose(file);
+    std::remove(filename);
+
+    BOOST_REQUIRE_EQUAL(counts.size(), 3);
+    BOOST_CHECK_EQUAL(counts[0], 2);
+    BOOST_CHECK_EQUAL(counts[1], 2);
+    BOOST_CHECK_EQUAL(counts[2], 1);
+}
+
+BOOST_AUTO_TEST_CASE(cannot_open)
+{
+    recorder_type rrec;
+    BOOST_CHECK_THROW(rrec.stream_to("/nonexistent/reactions.log", 1024), illegal_argument);
+}
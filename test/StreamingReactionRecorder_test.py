@@ -0,0 +1,70 @@
+#!/usr/bin/env python
+
+import os
+import tempfile
+import unittest
+
+import _gfrd
+from reaction_log import *
+
+
+def pid(serial):
+    return _gfrd.ParticleID(0, serial)
+
+
+class StreamingReactionRecorderTestCase(unittest.TestCase):
+
+    def setUp(self):
+        self.rrec = _gfrd.StreamingReactionRecorder()
+
+    def test_counters(self):
+        self.rrec.record(1, [pid(1)], [pid(2)])
+        self.rrec.record(2, [pid(2), pid(3)], [pid(4)])
+        self.rrec.record(1, [pid(4)], [])
+
+        self.assertEqual(self.rrec.total, 3)
+        self.assertEqual(self.rrec.count(1), 2)
+        self.assertEqual(self.rrec.counts(), {1: 2, 2: 1})
+
+        last = self.rrec.last_record
+        self.assertEqual(last.reaction_rule_id, 1)
+        self.assertEqual(last.reactants, (pid(4),))
+        self.assertEqual(last.products, ())
+
+    def test_ring_buffer(self):
+        self.rrec.keep_last(2)
+        self.rrec.select(2)
+        for i in range(5):
+            self.rrec.time = i * 0.5
+            self.rrec.record(2 - i % 2, [pid(i + 1)], [pid(i + 2)])
+
+        self.assertEqual(self.rrec.total, 5)
+        self.assertEqual(self.rrec.streamed, 3)
+
+        records = decode_records(self.rrec.buffer())
+        self.assertEqual(len(records), 2)
+        self.assertEqual(records[0], (1.0, 2, [(3, 0)], [(4, 0)], None))
+        self.assertEqual(records[1], (2.0, 2, [(5, 0)], [(6, 0)], None))
+
+    def test_stream_to_file(self):
+        fd, filename = tempfile.mkstemp()
+        os.close(fd)
+        try:
+            self.rrec.stream_to(filename, 100)
+            for i in range(10):
+                self.rrec.record(0, [pid(i + 1)], [pid(i + 2), pid(i + 3)])
+            self.rrec.close()
+
+            records = list(read_reaction_log(filename))
+            self.assertEqual(len(records), 10)
+            self.assertEqual(records[-1][3], [(11, 0), (12, 0)])
+        finally:
+            os.unlink(filename)
+
+    def test_cannot_open(self):
+        self.assertRaises(RuntimeError, self.rrec.stream_to,
+                          '/nonexistent/reactions.log')
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -8,6 +8,7 @@
 #include "MatrixSpace.hpp"
 #include "Sphere.hpp"
 #include "Cylinder.hpp"
+#include "Shell.hpp"
 #include "filters.hpp"
 
 template<typename Toc_>
@@ -82,3 +83,70 @@ BOOST_AUTO_TEST_CASE(cylinders)
     BOOST_CHECK(col.result.end() == col.result.find(2));
     BOOST_CHECK(col.result.end() == col.result.find(3));
 }
+
+BOOST_AUTO_TEST_CASE(shells)
+{
+    // Shells have their distances computed in batches; these must equal
+    // the distances to the nearest periodic image computed one by one.
+    typedef double length_type;
+    typedef Sphere<length_type> sphere_type;
+    typedef Cylinder<length_type> cylinder_type;
+    typedef MatrixSpace<Shell<sphere_type, int>, int> soc_type;
+    typedef MatrixSpace<Shell<cylinder_type, int>, int> coc_type;
+    typedef soc_type::position_type pos;
+    soc_type soc(1.0, 5);
+    coc_type coc(1.0, 5);
+
+    for (int i(0); i < 200; ++i)
+    {
+        const pos p(std::fmod(i * 0.377, 1.0), std::fmod(i * 0.613, 1.0),
+                    std::fmod(i * 0.859, 1.0));
+        soc.update(std::make_pair(i, soc_type::mapped_type(i,
+                sphere_type(p, 0.01 + std::fmod(i * 0.031, 0.08)))));
+        coc.update(std::make_pair(i, coc_type::mapped_type(i,
+                cylinder_type(p, 0.01 + std::fmod(i * 0.031, 0.08),
+                              normalize(pos(1., i % 3, i % 5)),
+                              0.01 + std::fmod(i * 0.017, 0.08)))));
+    }
+    // moving and removing shells must keep the copies of the shapes in step.
+    for (int i(0); i < 200; i += 7)
+    {
+        soc.erase(i);
+        coc.erase(i);
+    }
+    for (int i(1); i < 200; i += 7)
+    {
+        soc.update(std::make_pair(i, soc_type::mapped_type(i,
+                sphere_type(pos(0.99, 0.01, 0.5), 0.05))));
+        coc.update(std::make_pair(i, coc_type::mapped_type(i,
+                cylinder_type(pos(0.99, 0.01, 0.5), 0.05, pos(0., 0., 1.), 0.1))));
+    }
+
+    // compare with what the shells would yield one by one.
+    const sphere_type s(pos(0.02, 0.97, 0.5), 0.2);
+    collector<soc_type> scol, sref;
+    take_neighbor_cyclic(soc, scol, s);
+    soc.each_neighbor_cyclic(soc.index(s.position()),
+        neighbor_filter<soc_type, collector<soc_type>, sphere_type>(sref, s));
+    collector<coc_type> ccol, cref;
+    take_neighbor_cyclic(coc, ccol, s);
+    coc.each_neighbor_cyclic(coc.index(s.position()),
+        neighbor_filter<coc_type, collector<coc_type>, sphere_type>(cref, s));
+
+    BOOST_CHECK(!sref.result.empty());
+    BOOST_CHECK_EQUAL(sref.result.size(), scol.result.size());
+    for (std::map<int, length_type>::const_iterator i(sref.result.begin());
+         i != sref.result.end(); ++i)
+    {
+        BOOST_CHECK(scol.result.find((*i).first) != scol.result.end());
+        BOOST_CHECK_SMALL((*i).second - scol.result[(*i).first], 1e-12);
+    }
+    BOOST_CHECK(!cref.result.empty());
+    BOOST_CHECK_EQUAL(cref.result.size(), ccol.result.size());
+    for (std::map<int, length_type>::const_iterator i(cref.result.begin());
+         i != cref.result.end(); ++i)
+    {
+        BOOST_CHECK(ccol.result.find((*i).first) != ccol.result.end());
+        BOOST_CHECK_SMALL((*i).second - ccol.result[(*i).first], 1e-12);
+    }
+}
@@ -220,6 +220,31 @@ class FreeFunctionsTestCase(unittest.TestCase):
         self.failIf(r <= sigma)
 
 
+    def test_tabulated_drawR_gbd(self):
+
+        D = 1e-12
+        t = 1e-11
+        sigma = 2e-9
+        v = 0.01
+
+        self.assertEqual(mod.I_bd_3D(sigma, t, D),
+                         mod.tabulated_I_bd_3D(sigma, t, D))
+        self.assertEqual(mod.I_bd_1D(sigma, t, D, v),
+                         mod.tabulated_I_bd_1D(sigma, t, D, v))
+
+        self.assertEqual(sigma, mod.tabulated_drawR_gbd_3D(0.0, sigma, t, D))
+        self.assertEqual(sigma,
+                         mod.tabulated_drawR_gbd_1D(0.0, sigma, t, D, v))
+
+        for rnd in [1e-3, 0.1, 0.3, 0.5, 0.7, 0.9, 0.999]:
+            r = mod.drawR_gbd_3D(rnd, sigma, t, D)
+            r2 = mod.tabulated_drawR_gbd_3D(rnd, sigma, t, D)
+            self.assertAlmostEqual(0.0, (r2 - r) / (r - sigma), 5)
+
+            r = mod.drawR_gbd_1D(rnd, sigma, t, D, v)
+            r2 = mod.tabulated_drawR_gbd_1D(rnd, sigma, t, D, v)
+            self.assertAlmostEqual(0.0, (r2 - r) / (r - sigma), 5)
+
     def test_p_reaction_irr_t_inf(self):
         
         D = 1e-12
@@ -0,0 +1,112 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#define BOOST_TEST_MODULE "legendreSum_test"
+
+#include <cmath>
+#include <vector>
+#include <boost/test/included/unit_test.hpp>
+#include <boost/test/floating_point_comparison.hpp>
+
+#include "legendreSum.hpp"
+
+typedef std::vector<Real> RealVector;
+
+// P_{-1}(x), ..., P_{max_n}(x) by the upward recurrence.
+static RealVector legendre_table(unsigned int max_n, Real x)
+{
+    RealVector table(max_n + 2);
+    table[0] = 1.0;
+    table[1] = 1.0;
+    if (max_n >= 1)
+    {
+        table[2] = x;
+    }
+    for (unsigned int n(1); n < max_n; ++n)
+    {
+        table[n + 2] = ((2 * n + 1) * x * table[n + 1] - n * table[n]) / (n + 1);
+    }
+    return table;
+}
+
+static RealVector coefficients(unsigned int size)
+{
+    RealVector p_nTable;
+    for (unsigned int n(0); n < size; ++n)
+    {
+        p_nTable.push_back(std::pow(-0.7, static_cast<Real>(n)) / (n + 1));
+    }
+    return p_nTable;
+}
+
+BOOST_AUTO_TEST_CASE(clenshaw)
+{
+    const RealVector c(coefficients(40));
+
+    for (Real x(-1.0); x <= 1.0; x += 0.125)
+    {
+        const RealVector lgndTable(legendre_table(c.size(), x));
+
+        Real sum(0.0);
+        for (unsigned int n(0); n < c.size(); ++n)
+        {
+            sum += c[n] * lgndTable[n + 1];
+        }
+
+        BOOST_CHECK_CLOSE(legendreSum(c, x), sum, 1e-10);
+    }
+
+    BOOST_CHECK_EQUAL(legendreSum(RealVector(), 0.5), 0.0);
+    BOOST_CHECK_EQUAL(legendreSum(RealVector(1, 2.0), 0.5), 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(ip_coefficients)
+{
+    for (unsigned int size(1); size < 40; size += 7)
+    {
+        const RealVector p_nTable(coefficients(size));
+        RealVector c;
+        legendreSum_ip_coefficients(c, p_nTable);
+        BOOST_CHECK_EQUAL(c.size(), size + 1);
+
+        for (Real x(-1.0); x <= 1.0; x += 0.125)
+        {
+            const RealVector lgndTable(legendre_table(size, x));
+
+            // sum_n p_n (P_{n-1}(x) - P_{n+1}(x))
+            Real sum(0.0);
+            for (unsigned int n(0); n < size; ++n)
+            {
+                sum += p_nTable[n] * (lgndTable[n] - lgndTable[n + 2]);
+            }
+
+            BOOST_CHECK_SMALL(legendreSum(c, x) - sum, 1e-12);
+        }
+
+        // the integral vanishes at theta == 0.
+        BOOST_CHECK_SMALL(legendreSum(c, 1.0), 1e-12);
+    }
+
+    RealVector c;
+    legendreSum_ip_coefficients(c, RealVector());
+    BOOST_CHECK(c.empty());
+}
+
+BOOST_AUTO_TEST_CASE(p_coefficients)
+{
+    const RealVector p_nTable(coefficients(20));
+    RealVector c;
+    legendreSum_p_coefficients(c, p_nTable);
+
+    const Real x(0.3);
+    const RealVector lgndTable(legendre_table(p_nTable.size(), x));
+
+    Real sum(0.0);
+    for (unsigned int n(0); n < p_nTable.size(); ++n)
+    {
+        sum += p_nTable[n] * lgndTable[n + 1] * (2 * n + 1);
+    }
+
+    BOOST_CHECK_CLOSE(legendreSum(c, x), sum, 1e-10);
+}
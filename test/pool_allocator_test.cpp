@@ -0,0 +1,93 @@
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif /* HAVE_CONFIG_H */
+
+#define BOOST_TEST_MODULE "pool_allocator"
+
+#include <boost/test/included/unit_test.hpp>
+#include <map>
+#include <vector>
+
+#include "utils/pool_allocator.hpp"
+
+namespace {
+
+struct base: public pooled_object
+{
+    virtual ~base() {}
+};
+
+struct derived: public base
+{
+    derived(): payload() {}
+
+    char payload[100];
+};
+
+fixed_size_pool::statistics stats_of(std::size_t size)
+{
+    return get_size_class_pools().pools[
+        (size - 1) / POOL_GRANULARITY].stats();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(blocks_are_reused)
+{
+    fixed_size_pool pool(32);
+    void* const a(pool.allocate());
+    void* const b(pool.allocate());
+    BOOST_CHECK(a != b);
+    BOOST_CHECK_EQUAL(2ul, pool.stats().live);
+    pool.deallocate(a);
+    void* const c(pool.allocate());
+#ifndef DISABLE_OBJECT_POOLS
+    BOOST_CHECK_EQUAL(a, c);
+    BOOST_CHECK_EQUAL(1ul, pool.stats().slabs);
+#endif
+    pool.deallocate(c);
+    pool.deallocate(b);
+    BOOST_CHECK_EQUAL(0ul, pool.stats().live);
+    BOOST_CHECK_EQUAL(3ul, pool.stats().allocations);
+}
+
+BOOST_AUTO_TEST_CASE(pooled_objects)
+{
+    unsigned long const live(stats_of(sizeof(derived)).live);
+    base* const p(new derived());
+    BOOST_CHECK_EQUAL(live + 1, stats_of(sizeof(derived)).live);
+    delete p;
+    BOOST_CHECK_EQUAL(live, stats_of(sizeof(derived)).live);
+}
+
+BOOST_AUTO_TEST_CASE(steady_state_is_allocation_free)
+{
+    typedef std::map<int, boost::shared_ptr<base>, std::less<int>,
+                     pool_allocator<std::pair<const int, boost::shared_ptr<base> > > >
+            map_type;
+    map_type m;
+    for (int i(0); i < 100; ++i)
+    {
+        m[i] = pooled_shared_ptr<base>(new derived());
+    }
+
+    std::vector<fixed_size_pool::statistics> const before(pool_statistics());
+    // replacing the entries one by one must only reuse freed blocks.
+    for (int j(0); j < 10; ++j)
+    {
+        for (int i(0); i < 100; ++i)
+        {
+            m.erase(i);
+            m[i] = pooled_shared_ptr<base>(new derived());
+        }
+    }
+    std::vector<fixed_size_pool::statistics> const after(pool_statistics());
+
+    BOOST_CHECK_EQUAL(before.size(), after.size());
+    for (std::size_t i(0); i < before.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(before[i].block_size, after[i].block_size);
+        BOOST_CHECK_EQUAL(before[i].live, after[i].live);
+        BOOST_CHECK_EQUAL(before[i].slabs, after[i].slabs);
+    }
+}
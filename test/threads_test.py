@@ -0,0 +1,74 @@
+#!/usr/bin/env python
+
+import unittest
+import threading
+
+import _gfrd
+import _greens_functions
+import model
+import myrandom
+
+
+def run_in_threads(functions):
+    results = [None] * len(functions)
+    def run(i):
+        results[i] = functions[i]()
+    threads = [threading.Thread(target=run, args=(i,))
+               for i in range(len(functions))]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    return results
+
+
+class ThreadsTestCase(unittest.TestCase):
+
+    def setUp(self):
+        pass
+
+    def tearDown(self):
+        pass
+
+    def draw(self):
+        # every thread uses its own instance (see GreensFunction.hpp).
+        gf = _greens_functions.GreensFunction3DRadAbs(1e-12, 1e-8, 5e-8,
+                                                      1e-8, 1e-7)
+        return [(gf.drawTime(rnd), gf.drawR(rnd, 1e-5),
+                 gf.drawTheta(rnd, 6e-8, 1e-5))
+                for rnd in (0.1, 0.3, 0.5, 0.7, 0.9)]
+
+    def test_greens_functions(self):
+        expected = self.draw()
+        for result in run_in_threads([self.draw] * 4):
+            self.assertEqual(expected, result)
+
+    def run_gillespie(self):
+        m = model.ParticleModel(1e-6)
+        A = model.Species('A', 1e-12, 5e-9)
+        B = model.Species('B', 1e-12, 5e-9)
+        m.add_species_type(A)
+        m.add_species_type(B)
+        m.add_reaction_rule(
+            model.create_unimolecular_reaction_rule(A, B, 1e3))
+        m.add_reaction_rule(
+            model.create_unimolecular_reaction_rule(B, A, 1e3))
+
+        # every simulator needs its own generator.
+        rng = myrandom.create_gsl_rng()
+        rng.seed(42)
+        s = _gfrd._GillespieSimulator(
+            m, _gfrd.NetworkRulesWrapper(m.network_rules), rng, 1e-18, True)
+        s.throw_in_particles(A.id, 100)
+        for i in range(1000):
+            s.step()
+        return s.t, s.get_pool_size(A.id)
+
+    def test_simulators(self):
+        expected = self.run_gillespie()
+        for result in run_in_threads([self.run_gillespie] * 4):
+            self.assertEqual(expected, result)
+
+
+if __name__ == "__main__":
+    unittest.main()
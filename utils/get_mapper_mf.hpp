@@ -10,6 +10,8 @@
 #else
 #include <map>
 #endif /* HAVE_UNORDERED_MAP */
+#include <functional>
+#include "utils/pool_allocator.hpp"
 
 template<typename Tkey_, typename Tval_>
 struct get_mapper_mf
@@ -25,4 +27,25 @@ struct get_mapper_mf
 #endif
 };
 
+// Same as get_mapper_mf, but the nodes are taken from the object pools
+// (see pool_allocator.hpp); for maps whose entries come and go with the
+// domains.
+template<typename Tkey_, typename Tval_>
+struct get_pooled_mapper_mf
+{
+    typedef pool_allocator<std::pair<const Tkey_, Tval_> > allocator_type;
+#if defined(HAVE_UNORDERED_MAP)
+    typedef std::unordered_map<Tkey_, Tval_, std::hash<Tkey_>,
+                               std::equal_to<Tkey_>, allocator_type> type;
+#elif defined(HAVE_TR1_UNORDERED_MAP)
+    typedef std::tr1::unordered_map<Tkey_, Tval_, std::tr1::hash<Tkey_>,
+                                    std::equal_to<Tkey_>, allocator_type> type;
+#elif defined(HAVE_BOOST_UNORDERED_MAP_HPP)
+    typedef boost::unordered_map<Tkey_, Tval_, boost::hash<Tkey_>,
+                                 std::equal_to<Tkey_>, allocator_type> type;
+#else 
+    typedef std::map<Tkey_, Tval_, std::less<Tkey_>, allocator_type> type;
+#endif
+};
+
 #endif /* GET_MAPPER_MF_HPP */
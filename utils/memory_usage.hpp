@@ -0,0 +1,36 @@
+#ifndef MEMORY_USAGE_HPP
+#define MEMORY_USAGE_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// (live, reserved): the bytes taken by the elements of a container and the
+// bytes it has allocated for them.  For node-based containers the size of a
+// node is estimated as the element plus the three pointers the usual
+// red-black tree and hash table implementations keep next to it.
+typedef std::pair<std::size_t, std::size_t> memory_usage_type;
+
+inline memory_usage_type& add_memory_usage(memory_usage_type& lhs,
+                                           memory_usage_type const& rhs)
+{
+    lhs.first += rhs.first;
+    lhs.second += rhs.second;
+    return lhs;
+}
+
+template<typename T_, typename Talloc_>
+inline memory_usage_type vector_memory_usage(std::vector<T_, Talloc_> const& v)
+{
+    return memory_usage_type(v.size() * sizeof(T_), v.capacity() * sizeof(T_));
+}
+
+template<typename Tcntnr_>
+inline memory_usage_type node_memory_usage(Tcntnr_ const& c)
+{
+    typedef typename Tcntnr_::value_type value_type;
+    return memory_usage_type(c.size() * sizeof(value_type),
+                             c.size() * (sizeof(value_type) + 3 * sizeof(void*)));
+}
+
+#endif /* MEMORY_USAGE_HPP */
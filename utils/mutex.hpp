@@ -0,0 +1,58 @@
+#ifndef UTILS_MUTEX_HPP
+#define UTILS_MUTEX_HPP
+
+#include <pthread.h>
+#include <boost/noncopyable.hpp>
+
+// A POSIX mutex.  It is an aggregate so that instances with static storage
+// duration can be initialized statically, before any dynamic initializer
+// (such as a static Logger& log_(Logger::get_logger(...))) runs:
+//
+//   static mutex m = MUTEX_INITIALIZER;
+//
+// Other instances must be initialized with init().
+struct mutex
+{
+    void init()
+    {
+        pthread_mutex_init(&impl_, NULL);
+    }
+
+    void destroy()
+    {
+        pthread_mutex_destroy(&impl_);
+    }
+
+    void lock()
+    {
+        pthread_mutex_lock(&impl_);
+    }
+
+    void unlock()
+    {
+        pthread_mutex_unlock(&impl_);
+    }
+
+    pthread_mutex_t impl_;
+};
+
+#define MUTEX_INITIALIZER { PTHREAD_MUTEX_INITIALIZER }
+
+class scoped_lock: boost::noncopyable
+{
+public:
+    explicit scoped_lock(mutex& m): mutex_(m)
+    {
+        mutex_.lock();
+    }
+
+    ~scoped_lock()
+    {
+        mutex_.unlock();
+    }
+
+private:
+    mutex& mutex_;
+};
+
+#endif /* UTILS_MUTEX_HPP */
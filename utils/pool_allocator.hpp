@@ -0,0 +1,274 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+#include <boost/checked_delete.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include "utils/mutex.hpp"
+
+// Free-list pools for the small objects that the simulator creates and
+// destroys at every step: domains, their events, the shared_ptr control
+// blocks owning them and the nodes of the maps indexing domains and shells.
+//
+// Blocks are handed out from slabs in size classes of POOL_GRANULARITY
+// bytes; a freed block goes back onto the free list of its class and is
+// reused by the next allocation of that class.  Slabs are never returned to
+// the system (objects may still be released after static destruction, e.g.
+// when Python tears down its modules), so the memory held by the pools is
+// their high-water mark.
+//
+// The counters of every class tell whether stepping is allocation-free in
+// the steady state: once the pools are warm, the number of slabs stops
+// growing.  Configure with --disable-object-pools to forward every request
+// to the global operator new instead (for memory checkers); the counters
+// are kept in either case.
+
+enum
+{
+    POOL_GRANULARITY = 16,
+    POOL_MAX_BLOCK_SIZE = 512,
+    POOL_NUM_SIZE_CLASSES = POOL_MAX_BLOCK_SIZE / POOL_GRANULARITY,
+    POOL_SLAB_SIZE = 16384
+};
+
+class fixed_size_pool: boost::noncopyable
+{
+public:
+    struct statistics
+    {
+        std::size_t block_size;
+        unsigned long allocations;      // blocks handed out so far
+        unsigned long live;             // blocks not yet returned
+        unsigned long slabs;            // slabs taken from the system
+
+        statistics(): block_size(0), allocations(0), live(0), slabs(0) {}
+    };
+
+public:
+    explicit fixed_size_pool(std::size_t block_size = POOL_GRANULARITY)
+        : free_(0)
+    {
+        stats_.block_size = block_size;
+        mutex_.init();
+    }
+
+    void* allocate()
+    {
+        scoped_lock lock(mutex_);
+        ++stats_.allocations;
+        ++stats_.live;
+#ifdef DISABLE_OBJECT_POOLS
+        return ::operator new(stats_.block_size);
+#else
+        if (!free_)
+        {
+            grow();
+        }
+        block* const retval(free_);
+        free_ = free_->next;
+        return retval;
+#endif
+    }
+
+    void deallocate(void* p)
+    {
+        scoped_lock lock(mutex_);
+        --stats_.live;
+#ifdef DISABLE_OBJECT_POOLS
+        ::operator delete(p);
+#else
+        block* const b(static_cast<block*>(p));
+        b->next = free_;
+        free_ = b;
+#endif
+    }
+
+    statistics stats() const
+    {
+        return stats_;
+    }
+
+    void set_block_size(std::size_t block_size)
+    {
+        stats_.block_size = block_size;
+    }
+
+private:
+    struct block
+    {
+        block* next;
+    };
+
+    void grow()
+    {
+        std::size_t const n(POOL_SLAB_SIZE / stats_.block_size);
+        char* const slab(static_cast<char*>(
+            ::operator new(n * stats_.block_size)));
+        ++stats_.slabs;
+        for (std::size_t i(n); i > 0; --i)
+        {
+            block* const b(reinterpret_cast<block*>(
+                slab + (i - 1) * stats_.block_size));
+            b->next = free_;
+            free_ = b;
+        }
+    }
+
+private:
+    block* free_;
+    statistics stats_;
+    mutex mutex_;
+};
+
+// The pool of each size class, and a counter for requests too large for
+// any of them.
+struct size_class_pools: boost::noncopyable
+{
+    size_class_pools(): oversized_allocations(0)
+    {
+        for (std::size_t i(0); i < POOL_NUM_SIZE_CLASSES; ++i)
+        {
+            pools[i].set_block_size((i + 1) * POOL_GRANULARITY);
+        }
+    }
+
+    fixed_size_pool pools[POOL_NUM_SIZE_CLASSES];
+    unsigned long oversized_allocations;
+};
+
+inline size_class_pools& get_size_class_pools()
+{
+    static size_class_pools pools;
+    return pools;
+}
+
+inline void* pool_allocate(std::size_t size)
+{
+    if (size == 0 || size > POOL_MAX_BLOCK_SIZE)
+    {
+        __sync_fetch_and_add(&get_size_class_pools().oversized_allocations, 1);
+        return ::operator new(size);
+    }
+    return get_size_class_pools().pools[
+        (size - 1) / POOL_GRANULARITY].allocate();
+}
+
+inline void pool_deallocate(void* p, std::size_t size)
+{
+    if (!p)
+    {
+        return;
+    }
+    if (size == 0 || size > POOL_MAX_BLOCK_SIZE)
+    {
+        ::operator delete(p);
+        return;
+    }
+    get_size_class_pools().pools[(size - 1) / POOL_GRANULARITY].deallocate(p);
+}
+
+// The statistics of the size classes that have been used.
+inline std::vector<fixed_size_pool::statistics> pool_statistics()
+{
+    std::vector<fixed_size_pool::statistics> retval;
+    for (std::size_t i(0); i < POOL_NUM_SIZE_CLASSES; ++i)
+    {
+        fixed_size_pool::statistics const s(
+            get_size_class_pools().pools[i].stats());
+        if (s.allocations)
+        {
+            retval.push_back(s);
+        }
+    }
+    return retval;
+}
+
+// A base class that makes new and delete of the derived classes use the
+// pools.  The class hierarchy must have a virtual destructor, so that
+// delete is passed the size of the most derived object.
+struct pooled_object
+{
+    static void* operator new(std::size_t size)
+    {
+        return pool_allocate(size);
+    }
+
+    static void operator delete(void* p, std::size_t size)
+    {
+        pool_deallocate(p, size);
+    }
+
+    static void* operator new(std::size_t, void* p)
+    {
+        return p;
+    }
+
+    static void operator delete(void*, void*) {}
+};
+
+// A std::allocator taking single objects from the pools; used for the
+// nodes of node-based containers and for shared_ptr control blocks.
+template<typename T_>
+struct pool_allocator: public std::allocator<T_>
+{
+    typedef std::allocator<T_> base_type;
+    typedef typename base_type::pointer pointer;
+    typedef typename base_type::size_type size_type;
+
+    template<typename U_>
+    struct rebind
+    {
+        typedef pool_allocator<U_> other;
+    };
+
+    pool_allocator() {}
+
+    pool_allocator(pool_allocator const& that): base_type(that) {}
+
+    template<typename U_>
+    pool_allocator(pool_allocator<U_> const& that): base_type(that) {}
+
+    pointer allocate(size_type n, void const* = 0)
+    {
+        return n == 1 ? static_cast<pointer>(pool_allocate(sizeof(T_))):
+                        base_type::allocate(n);
+    }
+
+    void deallocate(pointer p, size_type n)
+    {
+        if (n == 1)
+        {
+            pool_deallocate(p, sizeof(T_));
+        }
+        else
+        {
+            base_type::deallocate(p, n);
+        }
+    }
+};
+
+template<typename T_, typename U_>
+inline bool operator==(pool_allocator<T_> const&, pool_allocator<U_> const&)
+{
+    return true;
+}
+
+template<typename T_, typename U_>
+inline bool operator!=(pool_allocator<T_> const&, pool_allocator<U_> const&)
+{
+    return false;
+}
+
+// A shared_ptr owning p whose control block comes from the pools.
+template<typename T_>
+inline boost::shared_ptr<T_> pooled_shared_ptr(T_* p)
+{
+    return boost::shared_ptr<T_>(p, boost::checked_deleter<T_>(),
+                                 pool_allocator<T_>());
+}
+
+#endif /* POOL_ALLOCATOR_HPP */
@@ -0,0 +1,107 @@
+#ifndef TRACKING_ALLOCATOR_HPP
+#define TRACKING_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+struct ParticleID;
+struct ShellID;
+
+// The subsystems the tracked allocations are attributed to.
+enum memory_subsystem
+{
+    MEMORY_PARTICLES,   // MatrixSpace of particles
+    MEMORY_SHELLS,      // MatrixSpaces of shells
+    MEMORY_SCHEDULER,   // DynamicPriorityQueue of the EventScheduler
+    MEMORY_OTHER,       // other MatrixSpaces
+    NUM_MEMORY_SUBSYSTEMS
+};
+
+inline char const* memory_subsystem_name(memory_subsystem subsystem)
+{
+    static char const* const names[NUM_MEMORY_SUBSYSTEMS] = {
+        "particles", "shells", "scheduler", "other" };
+    return names[subsystem];
+}
+
+// The bytes currently allocated through tracking_allocator per subsystem.
+inline long* tracked_memory()
+{
+    static long bytes[NUM_MEMORY_SUBSYSTEMS];
+    return bytes;
+}
+
+// A std::allocator that counts what it allocates in tracked_memory().
+template<typename T_, memory_subsystem Vsubsystem_>
+struct tracking_allocator: public std::allocator<T_>
+{
+    typedef std::allocator<T_> base_type;
+    typedef typename base_type::pointer pointer;
+    typedef typename base_type::size_type size_type;
+
+    template<typename U_>
+    struct rebind
+    {
+        typedef tracking_allocator<U_, Vsubsystem_> other;
+    };
+
+    tracking_allocator() {}
+
+    tracking_allocator(tracking_allocator const& that): base_type(that) {}
+
+    template<typename U_>
+    tracking_allocator(tracking_allocator<U_, Vsubsystem_> const& that)
+        : base_type(that) {}
+
+    pointer allocate(size_type n, void const* hint = 0)
+    {
+        pointer const retval(base_type::allocate(n, hint));
+        __sync_fetch_and_add(&tracked_memory()[Vsubsystem_],
+                             static_cast<long>(n * sizeof(T_)));
+        return retval;
+    }
+
+    void deallocate(pointer p, size_type n)
+    {
+        __sync_fetch_and_sub(&tracked_memory()[Vsubsystem_],
+                             static_cast<long>(n * sizeof(T_)));
+        base_type::deallocate(p, n);
+    }
+};
+
+// The containers of the tracked classes; plain std::vectors unless
+// ENABLE_MEMORY_TRACKING is defined (configure --enable-memory-tracking).
+template<memory_subsystem Vsubsystem_>
+struct tracked
+{
+    template<typename T_>
+    struct vector
+    {
+#ifdef ENABLE_MEMORY_TRACKING
+        typedef std::vector<T_, tracking_allocator<T_, Vsubsystem_> > type;
+#else
+        typedef std::vector<T_> type;
+#endif
+    };
+};
+
+template<typename Tkey_>
+struct memory_subsystem_of
+{
+    static const memory_subsystem value = MEMORY_OTHER;
+};
+
+template<>
+struct memory_subsystem_of<ParticleID>
+{
+    static const memory_subsystem value = MEMORY_PARTICLES;
+};
+
+template<>
+struct memory_subsystem_of<ShellID>
+{
+    static const memory_subsystem value = MEMORY_SHELLS;
+};
+
+#endif /* TRACKING_ALLOCATOR_HPP */
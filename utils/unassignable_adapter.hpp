@@ -240,7 +240,7 @@ public:
         cntnr_.reserve(n);
     }
 
-    size_type capacity()
+    size_type capacity() const
     {
         return cntnr_.capacity();
     }